@@ -38,6 +38,7 @@
 #define	OPT_BLD_CATEGORIES	"bldcat"
 #define	OPT_RUN_CATEGORIES	"runcat"
 #define	OPT_MAX_SIZE		"maxsize"
+#define	OPT_BLD_THREADS		"bldthreads"
 #define	OPT_ITER_NUM		"iter"
 #define	OPT_VERBOSE		"verbose"
 #define	OPT_IPV6		"ipv6"
@@ -96,6 +97,7 @@ static struct {
 	const char         *rule_file;
 	const char         *trace_file;
 	size_t              max_size;
+	uint32_t            bld_threads;
 	uint32_t            bld_categories;
 	uint32_t            run_categories;
 	uint32_t            nb_rules;
@@ -110,6 +112,7 @@ static struct {
 	void               *traces;
 	struct rte_acl_ctx *acx;
 } config = {
+	.bld_threads = 1,
 	.bld_categories = 3,
 	.run_categories = 1,
 	.nb_rules = RULE_NUM,
@@ -761,6 +764,40 @@ add_cb_rules(FILE *f, struct rte_acl_ctx *ctx)
 	return 0;
 }
 
+/*
+ * Build ACL context with 1, 2, 4, ... threads up to the given number
+ * and report time spent and memory used by each build.
+ */
+static int
+acx_build(struct rte_acl_config *cfg)
+{
+	int ret;
+	uint32_t n;
+	struct rte_acl_build_stats st;
+
+	ret = 0;
+	for (n = 1; n != 0; n = (n == config.bld_threads) ? 0 :
+			RTE_MIN(n * 2, config.bld_threads)) {
+
+		rte_acl_set_build_workers(config.acx, n);
+		ret = rte_acl_build(config.acx, cfg);
+		if (ret != 0)
+			break;
+
+		rte_acl_get_build_stats(config.acx, &st);
+		dump_verbose(DUMP_NONE, stdout,
+			"rte_acl_build(%u) with %u threads: %u tries, "
+			"%u nodes, build time: %" PRIu64 " us, "
+			"gen time: %" PRIu64 " us, peak memory: %zu bytes, "
+			"runtime memory: %zu bytes\n",
+			config.bld_categories, st.num_workers, st.num_tries,
+			st.num_nodes, st.build_time, st.gen_time,
+			st.peak_mem, st.rt_mem);
+	}
+
+	return ret;
+}
+
 static void
 acx_init(void)
 {
@@ -810,7 +847,7 @@ acx_init(void)
 	fclose(f);
 
 	/* perform build. */
-	ret = rte_acl_build(config.acx, &cfg);
+	ret = acx_build(&cfg);
 
 	dump_verbose(DUMP_NONE, stdout,
 		"rte_acl_build(%u) finished with %d\n",
@@ -963,6 +1000,10 @@ print_usage(const char *prgname)
 		"[--" OPT_MAX_SIZE
 			"=<size limit (in bytes) for runtime ACL strucutures> "
 			"leave 0 for default behaviour]\n"
+		"[--" OPT_BLD_THREADS
+			"=<max number of threads to build with> "
+			"builds with 1, 2, 4, ... threads up to the given number "
+			"and reports build time for each]\n"
 		"[--" OPT_ITER_NUM "=<number of iterations to perform>]\n"
 		"[--" OPT_VERBOSE "=<verbose level>]\n"
 		"[--" OPT_SEARCH_ALG "=%s]\n"
@@ -984,6 +1025,7 @@ dump_config(FILE *f)
 	fprintf(f, "%s:%u\n", OPT_BLD_CATEGORIES, config.bld_categories);
 	fprintf(f, "%s:%u\n", OPT_RUN_CATEGORIES, config.run_categories);
 	fprintf(f, "%s:%zu\n", OPT_MAX_SIZE, config.max_size);
+	fprintf(f, "%s:%u\n", OPT_BLD_THREADS, config.bld_threads);
 	fprintf(f, "%s:%u\n", OPT_ITER_NUM, config.iter_num);
 	fprintf(f, "%s:%u\n", OPT_VERBOSE, config.verbose);
 	fprintf(f, "%s:%u(%s)\n", OPT_SEARCH_ALG, config.alg.alg,
@@ -1011,6 +1053,7 @@ get_input_opts(int argc, char **argv)
 		{OPT_TRACE_NUM, 1, 0, 0},
 		{OPT_RULE_NUM, 1, 0, 0},
 		{OPT_MAX_SIZE, 1, 0, 0},
+		{OPT_BLD_THREADS, 1, 0, 0},
 		{OPT_TRACE_STEP, 1, 0, 0},
 		{OPT_BLD_CATEGORIES, 1, 0, 0},
 		{OPT_RUN_CATEGORIES, 1, 0, 0},
@@ -1040,6 +1083,10 @@ get_input_opts(int argc, char **argv)
 		} else if (strcmp(lgopts[opt_idx].name, OPT_MAX_SIZE) == 0) {
 			config.max_size = get_ulong_opt(optarg,
 				lgopts[opt_idx].name, 0, SIZE_MAX);
+		} else if (strcmp(lgopts[opt_idx].name,
+				OPT_BLD_THREADS) == 0) {
+			config.bld_threads = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 1, RTE_MAX_LCORE);
 		} else if (strcmp(lgopts[opt_idx].name, OPT_TRACE_NUM) == 0) {
 			config.nb_traces = get_ulong_opt(optarg,
 				lgopts[opt_idx].name, 1, UINT32_MAX);
@@ -148,6 +148,34 @@ evt_service_setup(uint32_t service_id)
 	return 0;
 }
 
+/*
+ * Map the scheduler service of the event device. A multi-thread safe
+ * scheduler, such as the sharded event/sw one, scales with the number of
+ * cores running it, so it is mapped to all the service cores.
+ */
+static inline int
+evt_sched_service_setup(uint32_t service_id)
+{
+	int32_t core_cnt;
+	uint32_t core_array[RTE_MAX_LCORE];
+
+	if (rte_service_probe_capability(service_id,
+			RTE_SERVICE_CAP_MT_SAFE) != 1)
+		return evt_service_setup(service_id);
+
+	core_cnt = rte_service_lcore_list(core_array,
+			RTE_MAX_LCORE);
+	if (core_cnt <= 0)
+		return -ENOENT;
+	while (core_cnt--) {
+		if (rte_service_map_lcore_set(service_id,
+				core_array[core_cnt], 1))
+			return -ENOENT;
+	}
+
+	return 0;
+}
+
 static inline int
 evt_configure_eventdev(struct evt_options *opt, uint8_t nb_queues,
 		uint8_t nb_ports)
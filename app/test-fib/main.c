@@ -12,6 +12,9 @@
 #include <rte_ip.h>
 #include <rte_random.h>
 #include <rte_malloc.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_rcu_qsbr.h>
 #include <rte_lpm.h>
 #include <rte_lpm6.h>
 #include <rte_fib.h>
@@ -34,6 +37,7 @@
 #define	DEF_LOOKUP_IPS_NUM	0x100000
 #define BURST_SZ		64
 #define DEFAULT_LPM_TBL8	100000U
+#define CHURN_FRACT		10
 
 #define CMP_FLAG		(1 << 0)
 #define CMP_ALL_FLAG		(1 << 1)
@@ -41,13 +45,30 @@
 #define FIB_RIB_TYPE		(1 << 3)
 #define FIB_V4_DIR_TYPE		(1 << 4)
 #define FIB_V6_TRIE_TYPE	(1 << 4)
-#define FIB_TYPE_MASK		(FIB_RIB_TYPE|FIB_V4_DIR_TYPE|FIB_V6_TRIE_TYPE)
+#define FIB_V4_DIR16_TYPE	(1 << 5)
+#define FIB_TYPE_MASK		(FIB_RIB_TYPE|FIB_V4_DIR_TYPE|FIB_V6_TRIE_TYPE|\
+				FIB_V4_DIR16_TYPE)
 #define SHUFFLE_FLAG		(1 << 7)
 #define DRY_RUN_FLAG		(1 << 8)
+#define CHURN_FLAG		(1 << 9)
+#define BULK_FLAG		(1 << 10)
 
 static char *distrib_string;
 static char line[LINE_MAX];
 
+enum {
+	CHURN_RCU_NONE,
+	CHURN_RCU_DQ,
+	CHURN_RCU_SYNC
+};
+
+static struct {
+	void		*fib;
+	uint32_t	stop;
+	uint64_t	nb_updates;
+	uint64_t	nb_failed;
+} churn;
+
 enum {
 	RT_PREFIX,
 	RT_NEXTHOP,
@@ -88,6 +109,7 @@ static struct {
 	const char	*lookup_ips_file;
 	const char	*routes_file_s;
 	const char	*lookup_ips_file_s;
+	const char	*snapshot_file;
 	void		*rt;
 	void		*lookup_tbl;
 	uint32_t	nb_routes;
@@ -100,6 +122,7 @@ static struct {
 	uint8_t		rnd_lookup_ips_ratio;
 	uint8_t		print_fract;
 	uint8_t		lookup_fn;
+	uint8_t		churn_rcu;
 } config = {
 	.routes_file = NULL,
 	.lookup_ips_file = NULL,
@@ -112,7 +135,8 @@ static struct {
 	.ent_sz = 4,
 	.rnd_lookup_ips_ratio = 0,
 	.print_fract = 10,
-	.lookup_fn = 0
+	.lookup_fn = 0,
+	.churn_rcu = CHURN_RCU_NONE
 };
 
 struct rt_rule_4 {
@@ -161,6 +185,8 @@ get_fib_type(void)
 	} else {
 		if ((config.flags & FIB_TYPE_MASK) == FIB_V4_DIR_TYPE)
 			return RTE_FIB_DIR24_8;
+		if ((config.flags & FIB_TYPE_MASK) == FIB_V4_DIR16_TYPE)
+			return RTE_FIB_DIR16_8_8;
 		if ((config.flags & FIB_TYPE_MASK) == FIB_RIB_TYPE)
 			return RTE_FIB_DUMMY;
 	}
@@ -632,20 +658,28 @@ print_usage(void)
 		"[-b <fib algorithm>]\n\tavailable options for ipv4\n"
 		"\t\trib - RIB based FIB\n"
 		"\t\tdir - DIR24_8 based FIB\n"
+		"\t\tdir16 - DIR16_8_8 compressed FIB\n"
 		"\tavailable options for ipv6:\n"
 		"\t\trib - RIB based FIB\n"
 		"\t\ttrie - TRIE based FIB\n"
 		"defaults are: dir for ipv4 and trie for ipv6\n"
-		"[-e <entry size (valid only for dir and trie fib types): "
-		"1/2/4/8 (default 4)>]\n"
+		"[-e <entry size (valid only for dir, dir16 and trie fib "
+		"types): 1/2/4/8 (default 4)>]\n"
 		"[-g <number of tbl8's for dir24_8 or trie FIBs>]\n"
 		"[-w <path to the file to dump routing table>]\n"
 		"[-u <path to the file to dump ip's for lookup>]\n"
 		"[-v <type of loookup function:"
 		"\ts1, s2, s3 (3 types of scalar), v (vector) -"
 		" for DIR24_8 based FIB\n"
-		"\ts, v - for TRIE based ipv6 FIB>]\n",
-		config.prgname);
+		"\ts, v - for DIR16_8_8 based FIB\n"
+		"\ts, v - for TRIE based ipv6 FIB>]\n"
+		"[-m <measure lookup while another lcore deletes and adds back"
+		" 1/%d of the routes, RCU mode of the FIB:\n"
+		"\tnone, dq, sync>]\n"
+		"[-k <add routes with one bulk call instead of one by one>]\n"
+		"[-p <path to the file to save the built FIB into and"
+		" restore it from>]\n",
+		config.prgname, CHURN_FRACT);
 }
 
 static int
@@ -678,6 +712,17 @@ check_config(void)
 		printf("-e 1 is valid only for ipv4\n");
 		return -1;
 	}
+
+	if ((config.flags & CHURN_FLAG) && (rte_lcore_count() < 2)) {
+		printf("-m option needs at least 2 lcores\n");
+		return -1;
+	}
+
+	if ((config.flags & CHURN_FLAG) &&
+			(config.nb_routes < CHURN_FRACT)) {
+		printf("-m option needs at least %d routes\n", CHURN_FRACT);
+		return -1;
+	}
 	return 0;
 }
 
@@ -687,8 +732,8 @@ parse_opts(int argc, char **argv)
 	int opt;
 	char *endptr;
 
-	while ((opt = getopt(argc, argv, "f:t:n:d:l:r:c6ab:e:g:w:u:sv:")) !=
-			-1) {
+	while ((opt = getopt(argc, argv,
+			"f:t:n:d:l:r:c6ab:e:g:w:u:sv:m:kp:")) != -1) {
 		switch (opt) {
 		case 'f':
 			config.routes_file = optarg;
@@ -753,6 +798,9 @@ parse_opts(int argc, char **argv)
 			} else if (strcmp(optarg, "dir") == 0) {
 				config.flags &= ~FIB_TYPE_MASK;
 				config.flags |= FIB_V4_DIR_TYPE;
+			} else if (strcmp(optarg, "dir16") == 0) {
+				config.flags &= ~FIB_TYPE_MASK;
+				config.flags |= FIB_V4_DIR16_TYPE;
 			} else if (strcmp(optarg, "trie") == 0) {
 				config.flags &= ~FIB_TYPE_MASK;
 				config.flags |= FIB_V6_TRIE_TYPE;
@@ -792,6 +840,26 @@ parse_opts(int argc, char **argv)
 			}
 			print_usage();
 			rte_exit(-EINVAL, "Invalid option -v %s\n", optarg);
+		case 'm':
+			config.flags |= CHURN_FLAG;
+			if (strcmp(optarg, "none") == 0) {
+				config.churn_rcu = CHURN_RCU_NONE;
+				break;
+			} else if (strcmp(optarg, "dq") == 0) {
+				config.churn_rcu = CHURN_RCU_DQ;
+				break;
+			} else if (strcmp(optarg, "sync") == 0) {
+				config.churn_rcu = CHURN_RCU_SYNC;
+				break;
+			}
+			print_usage();
+			rte_exit(-EINVAL, "Invalid option -m %s\n", optarg);
+		case 'k':
+			config.flags |= BULK_FLAG;
+			break;
+		case 'p':
+			config.snapshot_file = optarg;
+			break;
 		default:
 			print_usage();
 			rte_exit(-EINVAL, "Invalid options\n");
@@ -826,6 +894,229 @@ print_depth_err(void)
 		"-d 0:0 option or remove /0 prefix from routes file\n");
 }
 
+/*
+ * Deletes and adds back the first 1/CHURN_FRACT of the routes
+ * until the lookup lcore is done.
+ */
+static int
+churn_writer(__rte_unused void *arg)
+{
+	struct rt_rule_4 *rt4 = (struct rt_rule_4 *)config.rt;
+	struct rt_rule_6 *rt6 = (struct rt_rule_6 *)config.rt;
+	uint32_t i, n = config.nb_routes / CHURN_FRACT;
+	int ret;
+
+	while (__atomic_load_n(&churn.stop, __ATOMIC_RELAXED) == 0) {
+		for (i = 0; i < n; i++) {
+			if (config.flags & IPV6_FLAG)
+				rte_fib6_delete(churn.fib, rt6[i].addr,
+					rt6[i].depth);
+			else
+				rte_fib_delete(churn.fib, rt4[i].addr,
+					rt4[i].depth);
+			churn.nb_updates++;
+		}
+		for (i = 0; i < n; i++) {
+			if (config.flags & IPV6_FLAG)
+				ret = rte_fib6_add(churn.fib, rt6[i].addr,
+					rt6[i].depth, rt6[i].nh);
+			else
+				ret = rte_fib_add(churn.fib, rt4[i].addr,
+					rt4[i].depth, rt4[i].nh);
+			/* DQ mode may be out of tbl8s until the next round */
+			if (ret != 0)
+				churn.nb_failed++;
+			churn.nb_updates++;
+		}
+	}
+
+	return 0;
+}
+
+static struct rte_rcu_qsbr *
+churn_rcu_init(void *fib)
+{
+	struct rte_rcu_qsbr *qsv;
+	size_t sz;
+	int ret;
+
+	if (config.churn_rcu == CHURN_RCU_NONE)
+		return NULL;
+
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (qsv == NULL) {
+		printf("Can not alloc RCU QSBR variable\n");
+		return NULL;
+	}
+	rte_rcu_qsbr_init(qsv, 1);
+
+	if (config.flags & IPV6_FLAG) {
+		struct rte_fib6_rcu_config rcu_cfg = {0};
+
+		rcu_cfg.v = qsv;
+		rcu_cfg.mode = (config.churn_rcu == CHURN_RCU_DQ) ?
+			RTE_FIB6_QSBR_MODE_DQ : RTE_FIB6_QSBR_MODE_SYNC;
+		ret = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	} else {
+		struct rte_fib_rcu_config rcu_cfg = {0};
+
+		rcu_cfg.v = qsv;
+		rcu_cfg.mode = (config.churn_rcu == CHURN_RCU_DQ) ?
+			RTE_FIB_QSBR_MODE_DQ : RTE_FIB_QSBR_MODE_SYNC;
+		ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	}
+	if (ret != 0) {
+		printf("Can not attach RCU QSBR to FIB, err %d\n", rte_errno);
+		rte_free(qsv);
+		return NULL;
+	}
+
+	rte_rcu_qsbr_thread_register(qsv, 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+	return qsv;
+}
+
+/*
+ * Measure lookup on the main lcore while a worker lcore
+ * keeps updating the FIB.
+ */
+static int
+run_churn(void *fib)
+{
+	struct rte_rcu_qsbr *qsv;
+	uint64_t start, acc, tsc;
+	uint64_t fib_nh[BURST_SZ];
+	uint32_t *tbl4 = config.lookup_tbl;
+	uint8_t *tbl6 = config.lookup_tbl;
+	unsigned int lcore;
+	uint32_t i;
+	int ret = 0;
+
+	qsv = churn_rcu_init(fib);
+	if ((qsv == NULL) && (config.churn_rcu != CHURN_RCU_NONE))
+		return -1;
+
+	churn.fib = fib;
+	churn.stop = 0;
+	churn.nb_updates = 0;
+	churn.nb_failed = 0;
+	lcore = rte_get_next_lcore(-1, 1, 0);
+	rte_eal_remote_launch(churn_writer, NULL, lcore);
+
+	acc = 0;
+	tsc = rte_rdtsc_precise();
+	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
+		start = rte_rdtsc_precise();
+		if (config.flags & IPV6_FLAG)
+			ret = rte_fib6_lookup_bulk(fib,
+				(uint8_t (*)[16])(tbl6 + i*16),
+				fib_nh, BURST_SZ);
+		else
+			ret = rte_fib_lookup_bulk(fib, tbl4 + i, fib_nh,
+				BURST_SZ);
+		acc += rte_rdtsc_precise() - start;
+		if (qsv != NULL)
+			rte_rcu_qsbr_quiescent(qsv, 0);
+		if (ret != 0)
+			break;
+	}
+	tsc = rte_rdtsc_precise() - tsc;
+
+	__atomic_store_n(&churn.stop, 1, __ATOMIC_RELAXED);
+	if (qsv != NULL)
+		rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_eal_wait_lcore(lcore);
+
+	if (ret != 0) {
+		printf("FIB lookup fails, err %d\n", ret);
+		return -ret;
+	}
+	printf("AVG FIB lookup under churn %.1f\n", (double)acc / (double)i);
+	printf("FIB updates during lookup %"PRIu64" (%.1f per Mcycle), "
+		"failed adds %"PRIu64"\n", churn.nb_updates,
+		(double)churn.nb_updates * 1000000 / (double)tsc,
+		churn.nb_failed);
+
+	return 0;
+}
+
+static int
+add_bulk_4(struct rte_fib *fib, struct rt_rule_4 *rt)
+{
+	struct rte_fib_route *routes;
+	uint64_t start;
+	uint32_t i;
+	int ret;
+
+	routes = rte_malloc(NULL, sizeof(*routes) * config.nb_routes, 0);
+	if (routes == NULL) {
+		printf("Can not alloc routes for bulk add\n");
+		return -ENOMEM;
+	}
+	for (i = 0; i < config.nb_routes; i++) {
+		routes[i].ip = rt[i].addr;
+		routes[i].depth = rt[i].depth;
+		routes[i].next_hop = rt[i].nh;
+	}
+
+	start = rte_rdtsc_precise();
+	ret = rte_fib_add_bulk(fib, routes, config.nb_routes);
+	start = rte_rdtsc_precise() - start;
+	rte_free(routes);
+	if (ret != 0) {
+		printf("Can not add routes to FIB in bulk, err %d\n", ret);
+		return ret;
+	}
+	printf("FIB bulk add %"PRIu64", AVG %"PRIu64"\n", start,
+		start / config.nb_routes);
+	return 0;
+}
+
+static int
+save_restore_4(struct rte_fib *fib)
+{
+	struct rte_fib *fib_rst;
+	uint32_t *tbl4 = config.lookup_tbl;
+	uint64_t nh[BURST_SZ], nh_rst[BURST_SZ];
+	uint64_t start;
+	uint32_t i, j;
+	int ret;
+
+	start = rte_rdtsc_precise();
+	ret = rte_fib_save(fib, config.snapshot_file);
+	if (ret != 0) {
+		printf("Can not save FIB to %s, err %d\n",
+			config.snapshot_file, ret);
+		return ret;
+	}
+	printf("FIB save %"PRIu64"\n", rte_rdtsc_precise() - start);
+
+	start = rte_rdtsc_precise();
+	fib_rst = rte_fib_restore("test_restored", -1, config.snapshot_file);
+	if (fib_rst == NULL) {
+		printf("Can not restore FIB from %s, err %d\n",
+			config.snapshot_file, rte_errno);
+		return -rte_errno;
+	}
+	printf("FIB restore %"PRIu64"\n", rte_rdtsc_precise() - start);
+
+	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
+		rte_fib_lookup_bulk(fib, tbl4 + i, nh, BURST_SZ);
+		rte_fib_lookup_bulk(fib_rst, tbl4 + i, nh_rst, BURST_SZ);
+		for (j = 0; j < BURST_SZ; j++) {
+			if (nh[j] != nh_rst[j]) {
+				printf("FAIL\n");
+				rte_fib_free(fib_rst);
+				return -1;
+			}
+		}
+	}
+	printf("Saved and restored FIB lookup returns same values\n");
+	rte_fib_free(fib_rst);
+	return 0;
+}
+
 static int
 run_v4(void)
 {
@@ -861,7 +1152,8 @@ run_v4(void)
 		conf.dir24_8.nh_sz = __builtin_ctz(config.ent_sz);
 		conf.dir24_8.num_tbl8 = RTE_MIN(config.tbl8,
 			get_max_nh(conf.dir24_8.nh_sz));
-	}
+	} else if (conf.type == RTE_FIB_DIR16_8_8)
+		conf.dir16_8_8.nh_sz = __builtin_ctz(config.ent_sz);
 
 	fib = rte_fib_create("test", -1, &conf);
 	if (fib == NULL) {
@@ -869,7 +1161,20 @@ run_v4(void)
 		return -rte_errno;
 	}
 
-	if (config.lookup_fn != 0) {
+	if ((config.lookup_fn != 0) && (conf.type == RTE_FIB_DIR16_8_8)) {
+		if (config.lookup_fn == 1)
+			ret = rte_fib_select_lookup(fib,
+				RTE_FIB_LOOKUP_DIR16_8_8_SCALAR);
+		else if (config.lookup_fn == 2)
+			ret = rte_fib_select_lookup(fib,
+				RTE_FIB_LOOKUP_DIR16_8_8_VECTOR_AVX512);
+		else
+			ret = -EINVAL;
+		if (ret != 0) {
+			printf("Can not init lookup function\n");
+			return ret;
+		}
+	} else if (config.lookup_fn != 0) {
 		if (config.lookup_fn == 1)
 			ret = rte_fib_select_lookup(fib,
 				RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO);
@@ -890,20 +1195,32 @@ run_v4(void)
 		}
 	}
 
-	for (k = config.print_fract, i = 0; k > 0; k--) {
-		start = rte_rdtsc_precise();
-		for (j = 0; j < (config.nb_routes - i) / k; j++) {
-			ret = rte_fib_add(fib, rt[i + j].addr, rt[i + j].depth,
-				rt[i + j].nh);
-			if (unlikely(ret != 0)) {
-				printf("Can not add a route to FIB, err %d\n",
-					ret);
-				return -ret;
+	if (config.flags & BULK_FLAG) {
+		ret = add_bulk_4(fib, rt);
+		if (ret != 0)
+			return ret;
+	} else {
+		for (k = config.print_fract, i = 0; k > 0; k--) {
+			start = rte_rdtsc_precise();
+			for (j = 0; j < (config.nb_routes - i) / k; j++) {
+				ret = rte_fib_add(fib, rt[i + j].addr,
+					rt[i + j].depth, rt[i + j].nh);
+				if (unlikely(ret != 0)) {
+					printf("Can not add a route to FIB, "
+						"err %d\n", ret);
+					return -ret;
+				}
 			}
+			printf("AVG FIB add %"PRIu64"\n",
+				(rte_rdtsc_precise() - start) / j);
+			i += j;
 		}
-		printf("AVG FIB add %"PRIu64"\n",
-			(rte_rdtsc_precise() - start) / j);
-		i += j;
+	}
+
+	if (config.snapshot_file != NULL) {
+		ret = save_restore_4(fib);
+		if (ret != 0)
+			return ret;
 	}
 
 	if (config.flags & CMP_FLAG) {
@@ -978,6 +1295,12 @@ run_v4(void)
 		printf("FIB and LPM lookup returns same values\n");
 	}
 
+	if (config.flags & CHURN_FLAG) {
+		ret = run_churn(fib);
+		if (ret != 0)
+			return ret;
+	}
+
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
 		for (j = 0; j < (config.nb_routes - i) / k; j++)
@@ -1025,6 +1348,84 @@ dump_rt_6(struct rt_rule_6 *rt)
 	return 0;
 }
 
+static int
+add_bulk_6(struct rte_fib6 *fib, struct rt_rule_6 *rt)
+{
+	struct rte_fib6_route *routes;
+	uint64_t start;
+	uint32_t i;
+	int ret;
+
+	routes = rte_malloc(NULL, sizeof(*routes) * config.nb_routes, 0);
+	if (routes == NULL) {
+		printf("Can not alloc routes for bulk add\n");
+		return -ENOMEM;
+	}
+	for (i = 0; i < config.nb_routes; i++) {
+		memcpy(routes[i].ip, rt[i].addr, 16);
+		routes[i].depth = rt[i].depth;
+		routes[i].next_hop = rt[i].nh;
+	}
+
+	start = rte_rdtsc_precise();
+	ret = rte_fib6_add_bulk(fib, routes, config.nb_routes);
+	start = rte_rdtsc_precise() - start;
+	rte_free(routes);
+	if (ret != 0) {
+		printf("Can not add routes to FIB in bulk, err %d\n", ret);
+		return ret;
+	}
+	printf("FIB bulk add %"PRIu64", AVG %"PRIu64"\n", start,
+		start / config.nb_routes);
+	return 0;
+}
+
+static int
+save_restore_6(struct rte_fib6 *fib)
+{
+	struct rte_fib6 *fib_rst;
+	uint8_t *tbl6 = config.lookup_tbl;
+	uint64_t nh[BURST_SZ], nh_rst[BURST_SZ];
+	uint64_t start;
+	uint32_t i, j;
+	int ret;
+
+	start = rte_rdtsc_precise();
+	ret = rte_fib6_save(fib, config.snapshot_file);
+	if (ret != 0) {
+		printf("Can not save FIB to %s, err %d\n",
+			config.snapshot_file, ret);
+		return ret;
+	}
+	printf("FIB save %"PRIu64"\n", rte_rdtsc_precise() - start);
+
+	start = rte_rdtsc_precise();
+	fib_rst = rte_fib6_restore("test_restored", -1, config.snapshot_file);
+	if (fib_rst == NULL) {
+		printf("Can not restore FIB from %s, err %d\n",
+			config.snapshot_file, rte_errno);
+		return -rte_errno;
+	}
+	printf("FIB restore %"PRIu64"\n", rte_rdtsc_precise() - start);
+
+	for (i = 0; i < config.nb_lookup_ips; i += BURST_SZ) {
+		rte_fib6_lookup_bulk(fib, (uint8_t (*)[16])(tbl6 + i*16),
+			nh, BURST_SZ);
+		rte_fib6_lookup_bulk(fib_rst, (uint8_t (*)[16])(tbl6 + i*16),
+			nh_rst, BURST_SZ);
+		for (j = 0; j < BURST_SZ; j++) {
+			if (nh[j] != nh_rst[j]) {
+				printf("FAIL\n");
+				rte_fib6_free(fib_rst);
+				return -1;
+			}
+		}
+	}
+	printf("Saved and restored FIB lookup returns same values\n");
+	rte_fib6_free(fib_rst);
+	return 0;
+}
+
 static int
 run_v6(void)
 {
@@ -1084,20 +1485,32 @@ run_v6(void)
 		}
 	}
 
-	for (k = config.print_fract, i = 0; k > 0; k--) {
-		start = rte_rdtsc_precise();
-		for (j = 0; j < (config.nb_routes - i) / k; j++) {
-			ret = rte_fib6_add(fib, rt[i + j].addr,
-				rt[i + j].depth, rt[i + j].nh);
-			if (unlikely(ret != 0)) {
-				printf("Can not add a route to FIB, err %d\n",
-					ret);
-				return -ret;
+	if (config.flags & BULK_FLAG) {
+		ret = add_bulk_6(fib, rt);
+		if (ret != 0)
+			return ret;
+	} else {
+		for (k = config.print_fract, i = 0; k > 0; k--) {
+			start = rte_rdtsc_precise();
+			for (j = 0; j < (config.nb_routes - i) / k; j++) {
+				ret = rte_fib6_add(fib, rt[i + j].addr,
+					rt[i + j].depth, rt[i + j].nh);
+				if (unlikely(ret != 0)) {
+					printf("Can not add a route to FIB, "
+						"err %d\n", ret);
+					return -ret;
+				}
 			}
+			printf("AVG FIB add %"PRIu64"\n",
+				(rte_rdtsc_precise() - start) / j);
+			i += j;
 		}
-		printf("AVG FIB add %"PRIu64"\n",
-			(rte_rdtsc_precise() - start) / j);
-		i += j;
+	}
+
+	if (config.snapshot_file != NULL) {
+		ret = save_restore_6(fib);
+		if (ret != 0)
+			return ret;
 	}
 
 	if (config.flags & CMP_FLAG) {
@@ -1176,6 +1589,12 @@ run_v6(void)
 		printf("FIB and LPM lookup returns same values\n");
 	}
 
+	if (config.flags & CHURN_FLAG) {
+		ret = run_churn(fib);
+		if (ret != 0)
+			return ret;
+	}
+
 	for (k = config.print_fract, i = 0; k > 0; k--) {
 		start = rte_rdtsc_precise();
 		for (j = 0; j < (config.nb_routes - i) / k; j++)
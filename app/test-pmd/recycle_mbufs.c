@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_branch_prediction.h>
+#include <rte_mbuf.h>
+#include <rte_ethdev.h>
+
+#include "testpmd.h"
+
+/*
+ * Forwarding of packets in I/O mode, recycling the mbufs of completed
+ * transmissions directly into the Rx queue instead of the mempool.
+ */
+static void
+pkt_burst_recycle_mbufs(struct fwd_stream *fs)
+{
+	struct rte_mbuf *pkts_burst[MAX_PKT_BURST];
+	uint16_t nb_rx;
+	uint16_t nb_tx;
+	uint32_t retry;
+	uint64_t start_tsc = 0;
+
+	get_start_cycles(&start_tsc);
+
+	/*
+	 * Refill the Rx queue with the mbufs transmitted by previous bursts.
+	 */
+	if (fs->recycle_rxq_info.mp != NULL)
+		rte_eth_recycle_mbufs(fs->rx_port, fs->rx_queue,
+				fs->tx_port, fs->tx_queue,
+				&fs->recycle_rxq_info);
+
+	/*
+	 * Receive a burst of packets and forward them.
+	 */
+	nb_rx = rte_eth_rx_burst(fs->rx_port, fs->rx_queue,
+			pkts_burst, nb_pkt_per_burst);
+	inc_rx_burst_stats(fs, nb_rx);
+	if (unlikely(nb_rx == 0))
+		return;
+	fs->rx_packets += nb_rx;
+
+	nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue,
+			pkts_burst, nb_rx);
+	/*
+	 * Retry if necessary
+	 */
+	if (unlikely(nb_tx < nb_rx) && fs->retry_enabled) {
+		retry = 0;
+		while (nb_tx < nb_rx && retry++ < burst_tx_retry_num) {
+			rte_delay_us(burst_tx_delay_time);
+			nb_tx += rte_eth_tx_burst(fs->tx_port, fs->tx_queue,
+					&pkts_burst[nb_tx], nb_rx - nb_tx);
+		}
+	}
+	fs->tx_packets += nb_tx;
+	inc_tx_burst_stats(fs, nb_tx);
+	if (unlikely(nb_tx < nb_rx)) {
+		fs->fwd_dropped += (nb_rx - nb_tx);
+		do {
+			rte_pktmbuf_free(pkts_burst[nb_tx]);
+		} while (++nb_tx < nb_rx);
+	}
+
+	get_end_cycles(fs, start_tsc);
+}
+
+static void
+recycle_mbufs_begin(portid_t pi)
+{
+	struct fwd_stream *fs;
+	streamid_t sm_id;
+	int ret;
+
+	for (sm_id = 0; sm_id < cur_fwd_config.nb_fwd_streams; sm_id++) {
+		fs = fwd_streams[sm_id];
+		if (fs->rx_port != pi)
+			continue;
+
+		ret = rte_eth_recycle_rx_queue_info_get(fs->rx_port,
+				fs->rx_queue, &fs->recycle_rxq_info);
+		if (ret == 0)
+			ret = rte_eth_recycle_rx_queue_set(fs->rx_port,
+					fs->rx_queue, 1);
+		if (ret != 0) {
+			printf("Port %u Rx queue %u: cannot recycle mbufs (%d), using io forwarding\n",
+			       fs->rx_port, fs->rx_queue, ret);
+			fs->recycle_rxq_info.mp = NULL;
+		}
+	}
+}
+
+static void
+recycle_mbufs_end(portid_t pi)
+{
+	struct fwd_stream *fs;
+	streamid_t sm_id;
+
+	for (sm_id = 0; sm_id < cur_fwd_config.nb_fwd_streams; sm_id++) {
+		fs = fwd_streams[sm_id];
+		if (fs->rx_port != pi || fs->recycle_rxq_info.mp == NULL)
+			continue;
+
+		rte_eth_recycle_rx_queue_set(fs->rx_port, fs->rx_queue, 0);
+		fs->recycle_rxq_info.mp = NULL;
+	}
+}
+
+struct fwd_engine recycle_mbufs_engine = {
+	.fwd_mode_name  = "recycle_mbufs",
+	.port_fwd_begin = recycle_mbufs_begin,
+	.port_fwd_end   = recycle_mbufs_end,
+	.packet_fwd     = pkt_burst_recycle_mbufs,
+};
@@ -128,6 +128,8 @@ struct fwd_stream {
 	streamid_t peer_addr; /**< index of peer ethernet address of packets */
 
 	unsigned int retry_enabled;
+	/**< recycling information of rx_queue, mp is NULL if not supported */
+	struct rte_eth_recycle_rxq_info recycle_rxq_info;
 
 	/* "read-write" results */
 	uint64_t rx_packets;  /**< received packets */
@@ -293,6 +295,7 @@ extern struct fwd_engine csum_fwd_engine;
 extern struct fwd_engine icmp_echo_engine;
 extern struct fwd_engine noisy_vnf_engine;
 extern struct fwd_engine five_tuple_swap_fwd_engine;
+extern struct fwd_engine recycle_mbufs_engine;
 #ifdef RTE_LIBRTE_IEEE1588
 extern struct fwd_engine ieee1588_fwd_engine;
 #endif
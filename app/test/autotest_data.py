@@ -219,6 +219,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Staged ordered ring autotest",
+        "Command": "soring_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Spinlock autotest",
         "Command": "spinlock_autotest",
@@ -658,6 +664,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Malloc performance autotest",
+        "Command": "malloc_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Mempool performance autotest",
         "Command": "mempool_perf_autotest",
@@ -797,6 +809,12 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Staged ordered ring performance autotest",
+        "Command": "soring_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     #
     # Please always make sure that ring_perf is the last test!
     #
@@ -13,8 +13,12 @@
 #include <rte_ip.h>
 #include <rte_acl.h>
 #include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test_acl.h"
+#include "../../lib/librte_acl/acl.h"
 
 #define	BIT_SIZEOF(x) (sizeof(x) * CHAR_BIT)
 
@@ -1716,6 +1720,454 @@ test_u32_range(void)
 	return rc;
 }
 
+/*
+ * Compare classify results of the incrementally updated context
+ * with the context built from scratch, with the scalar method called
+ * directly if requested.
+ */
+static int
+test_incr_cmp(struct rte_acl_ctx *acx, struct rte_acl_ctx *ref,
+	struct ipv4_7tuple test_data[], size_t dim, int scalar)
+{
+	int32_t ret;
+	uint32_t i;
+	const uint8_t *data[dim];
+	uint32_t results[dim * RTE_ACL_MAX_CATEGORIES];
+	uint32_t ref_results[dim * RTE_ACL_MAX_CATEGORIES];
+
+	bswap_test_data(test_data, dim, 1);
+
+	for (i = 0; i < dim; i++)
+		data[i] = (uint8_t *)&test_data[i];
+
+	if (scalar) {
+		ret = rte_acl_classify_scalar(acx, data, results, dim,
+			RTE_ACL_MAX_CATEGORIES);
+		if (ret == 0)
+			ret = rte_acl_classify_scalar(ref, data, ref_results,
+				dim, RTE_ACL_MAX_CATEGORIES);
+	} else {
+		ret = rte_acl_classify(acx, data, results, dim,
+			RTE_ACL_MAX_CATEGORIES);
+		if (ret == 0)
+			ret = rte_acl_classify(ref, data, ref_results, dim,
+				RTE_ACL_MAX_CATEGORIES);
+	}
+
+	bswap_test_data(test_data, dim, 0);
+
+	if (ret != 0) {
+		printf("Line %i: classify failed!\n", __LINE__);
+		return ret;
+	}
+
+	for (i = 0; i != dim * RTE_ACL_MAX_CATEGORIES; i++) {
+		if (results[i] != ref_results[i]) {
+			printf("Line %i: Error in results at %u "
+				"(expected %"PRIu32" got %"PRIu32")!\n",
+				__LINE__, i / RTE_ACL_MAX_CATEGORIES,
+				ref_results[i], results[i]);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Build reference context from the given rules.
+ */
+static struct rte_acl_ctx *
+test_incr_ref(const struct acl_ipv4vlan_rule *rules, uint32_t num)
+{
+	int32_t ret;
+	struct rte_acl_ctx *ref;
+	struct rte_acl_param prm;
+
+	prm = acl_param;
+	prm.name = "acl_ref";
+	ref = rte_acl_create(&prm);
+	if (ref == NULL)
+		return NULL;
+
+	ret = rte_acl_add_rules(ref, (const struct rte_acl_rule *)rules, num);
+	if (ret == 0)
+		ret = rte_acl_ipv4vlan_build(ref, ipv4_7tuple_layout,
+			RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		rte_acl_free(ref);
+		return NULL;
+	}
+
+	return ref;
+}
+
+/*
+ * Test incremental add/delete of the rules and merge.
+ */
+static int
+test_incr(void)
+{
+	int32_t ret;
+	uint32_t i, n, num, half;
+	size_t sz;
+	struct rte_acl_ctx *acx, *ref;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_acl_rcu_config rcu_cfg = {0};
+	struct acl_ipv4vlan_rule rules[RTE_DIM(acl_test_rules)];
+	struct acl_ipv4vlan_rule left[RTE_DIM(acl_test_rules)];
+
+	num = RTE_DIM(acl_test_rules);
+	half = num / 2;
+
+	memset(rules, 0, sizeof(rules));
+	for (i = 0; i != num; i++)
+		acl_ipv4vlan_convert_rule(acl_test_rules + i, rules + i);
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	if (qsv == NULL || rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE) != 0) {
+		printf("Line %i: Error creating RCU QSBR variable!\n",
+			__LINE__);
+		rte_free(qsv);
+		rte_acl_free(acx);
+		return -1;
+	}
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_ACL_QSBR_MODE_DQ;
+
+	ref = NULL;
+
+	/* incremental update of not built context should fail. */
+	ret = rte_acl_incr_add(acx, (struct rte_acl_rule *)rules, 1);
+	if (ret != -EINVAL) {
+		printf("Line %i: incremental add to not built context "
+			"returned: %d\n", __LINE__, ret);
+		ret = -1;
+		goto err;
+	}
+
+	ret = rte_acl_rcu_qsbr_add(acx, &rcu_cfg);
+	if (ret != 0) {
+		printf("Line %i: Error adding RCU QSBR variable!\n",
+			__LINE__);
+		goto err;
+	}
+
+	ret = rte_acl_rcu_qsbr_add(acx, &rcu_cfg);
+	if (ret != -EEXIST) {
+		printf("Line %i: RCU QSBR variable added twice!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	/* build with the first half, add the rest one by one. */
+	ret = rte_acl_add_rules(acx, (struct rte_acl_rule *)rules, half);
+	if (ret == 0)
+		ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+			RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	for (i = half; i != num; i++) {
+		ret = rte_acl_incr_add(acx, (struct rte_acl_rule *)(rules + i),
+			1);
+		if (ret != 0) {
+			printf("Line %i: incremental add of rule %u failed, "
+				"error code: %d\n", __LINE__, i, ret);
+			goto err;
+		}
+	}
+
+	ret = test_classify_run(acx, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0) {
+		printf("Line %i: classify after incremental add failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	/* delete rules that are not present. */
+	ret = rte_acl_incr_del(acx, (struct rte_acl_rule *)rules, 1);
+	if (ret == 0)
+		ret = rte_acl_incr_del(acx, (struct rte_acl_rule *)rules, 1);
+	if (ret != -ENOENT) {
+		printf("Line %i: delete of missing rule returned: %d\n",
+			__LINE__, ret);
+		ret = -1;
+		goto err;
+	}
+
+	/* delete every third rule, both main and added ones. */
+	n = 0;
+	for (i = 1; i != num; i++) {
+		if (i % 3 == 0) {
+			ret = rte_acl_incr_del(acx,
+				(struct rte_acl_rule *)(rules + i), 1);
+			if (ret != 0) {
+				printf("Line %i: incremental delete of rule %u "
+					"failed, error code: %d\n",
+					__LINE__, i, ret);
+				goto err;
+			}
+		} else
+			left[n++] = rules[i];
+	}
+
+	ref = test_incr_ref(left, n);
+	if (ref == NULL) {
+		printf("Line %i: Building reference ACL context failed!\n",
+			__LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	ret = test_incr_cmp(acx, ref, acl_test_data, RTE_DIM(acl_test_data),
+		0);
+	if (ret != 0) {
+		printf("Line %i: classify after incremental delete failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	ret = rte_acl_incr_merge(acx);
+	if (ret == 0)
+		ret = test_incr_cmp(acx, ref, acl_test_data,
+			RTE_DIM(acl_test_data), 0);
+	if (ret != 0) {
+		printf("Line %i: classify after merge failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* bring all the rules back. */
+	ret = rte_acl_incr_add(acx, (struct rte_acl_rule *)rules, 1);
+	for (i = 3; i < num && ret == 0; i += 3)
+		ret = rte_acl_incr_add(acx, (struct rte_acl_rule *)(rules + i),
+			1);
+	if (ret == 0)
+		ret = test_classify_run(acx, acl_test_data,
+			RTE_DIM(acl_test_data));
+	if (ret != 0) {
+		printf("Line %i: classify after incremental add failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+err:
+	rte_acl_free(ref);
+	rte_acl_free(acx);
+	rte_free(qsv);
+	return ret;
+}
+
+/*
+ * Test that the classify methods called directly keep using the last
+ * full build after incremental updates and merges. No RCU variable is
+ * used, so the replaced run-time structures are freed at once.
+ */
+static int
+test_incr_direct(void)
+{
+	int32_t ret;
+	uint32_t i, num, half;
+	struct rte_acl_ctx *acx, *ref;
+	struct acl_ipv4vlan_rule rules[RTE_DIM(acl_test_rules)];
+
+	num = RTE_DIM(acl_test_rules);
+	half = num / 2;
+
+	memset(rules, 0, sizeof(rules));
+	for (i = 0; i != num; i++)
+		acl_ipv4vlan_convert_rule(acl_test_rules + i, rules + i);
+
+	/* reference is the full build with the first half. */
+	ref = test_incr_ref(rules, half);
+	if (ref == NULL) {
+		printf("Line %i: Building reference ACL context failed!\n",
+			__LINE__);
+		return -1;
+	}
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		rte_acl_free(ref);
+		return -1;
+	}
+
+	ret = rte_acl_add_rules(acx, (struct rte_acl_rule *)rules, half);
+	if (ret == 0)
+		ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+			RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* merge twice, so that the base taken over from acx is released. */
+	for (i = half; i != num && ret == 0; i++)
+		ret = rte_acl_incr_add(acx, (struct rte_acl_rule *)(rules + i),
+			1);
+	if (ret == 0)
+		ret = rte_acl_incr_merge(acx);
+	if (ret == 0)
+		ret = rte_acl_incr_del(acx, (struct rte_acl_rule *)rules, 1);
+	if (ret == 0)
+		ret = rte_acl_incr_merge(acx);
+	if (ret != 0) {
+		printf("Line %i: incremental update failed, "
+			"error code: %d\n", __LINE__, ret);
+		goto err;
+	}
+
+	ret = test_incr_cmp(acx, ref, acl_test_data, RTE_DIM(acl_test_data),
+		1);
+	if (ret != 0) {
+		printf("Line %i: direct classify after merge failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	/* the full build brings the direct classify up to date. */
+	ret = rte_acl_add_rules(acx, (struct rte_acl_rule *)rules, 1);
+	if (ret == 0)
+		ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+			RTE_ACL_MAX_CATEGORIES);
+	if (ret == 0)
+		ret = test_classify_run(acx, acl_test_data,
+			RTE_DIM(acl_test_data));
+	if (ret != 0)
+		printf("Line %i: classify after full build failed!\n",
+			__LINE__);
+err:
+	rte_acl_free(ref);
+	rte_acl_free(acx);
+	return ret;
+}
+
+#define	TEST_MT_RULES	0x400
+#define	TEST_MT_DATA	0x400
+#define	TEST_MT_THREADS	4
+
+/*
+ * Test that the build with several threads gives the same
+ * run-time structures as the single-threaded one.
+ */
+static int
+test_mt_build(void)
+{
+	int32_t ret;
+	uint32_t i;
+	struct rte_acl_ctx *acx, *ref;
+	struct rte_acl_param prm;
+	struct rte_acl_config cfg;
+	struct rte_acl_build_stats st, ref_st;
+	const struct rte_acl_ipv4vlan_rule *r;
+	static struct rte_acl_ipv4vlan_rule rules[TEST_MT_RULES];
+	static struct ipv4_7tuple data[TEST_MT_DATA];
+
+	/* generate rules with random prefixes and port ranges. */
+	for (i = 0; i != RTE_DIM(rules); i++) {
+		memset(&rules[i], 0, sizeof(rules[i]));
+		rules[i].data.userdata = i + 1;
+		rules[i].data.priority = i + 1;
+		rules[i].data.category_mask = 1 + rte_rand_max(
+			RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES, uint32_t));
+		rules[i].proto = rte_rand_max(4);
+		rules[i].proto_mask = (rte_rand() & 1) ? UINT8_MAX : 0;
+		rules[i].src_addr = rte_rand();
+		rules[i].src_mask_len = rte_rand_max(33);
+		rules[i].dst_addr = rte_rand();
+		rules[i].dst_mask_len = rte_rand_max(33);
+		rules[i].src_port_low = rte_rand_max(1000);
+		rules[i].src_port_high = rules[i].src_port_low +
+			rte_rand_max(3000);
+		rules[i].dst_port_low = rte_rand_max(1000);
+		rules[i].dst_port_high = rules[i].dst_port_low +
+			rte_rand_max(3000);
+	}
+
+	/* generate packets that hit some of the rules. */
+	for (i = 0; i != RTE_DIM(data); i++) {
+		r = &rules[rte_rand_max(RTE_DIM(rules))];
+		memset(&data[i], 0, sizeof(data[i]));
+		data[i].proto = r->proto;
+		data[i].ip_src = r->src_addr;
+		data[i].ip_dst = r->dst_addr;
+		data[i].port_src = r->src_port_low + rte_rand_max(1000);
+		data[i].port_dst = r->dst_port_high;
+	}
+
+	prm = acl_param;
+	prm.max_rule_num = RTE_DIM(rules);
+	acx = rte_acl_create(&prm);
+	prm.name = "acl_ref";
+	ref = rte_acl_create(&prm);
+	if (acx == NULL || ref == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	ret = rte_acl_ipv4vlan_add_rules(acx, rules, RTE_DIM(rules));
+	if (ret == 0)
+		ret = rte_acl_ipv4vlan_add_rules(ref, rules, RTE_DIM(rules));
+	if (ret != 0) {
+		printf("Line %i: Adding rules to ACL context failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, RTE_ACL_MAX_CATEGORIES);
+
+	ret = rte_acl_build(ref, &cfg);
+	if (ret == 0)
+		ret = rte_acl_set_build_workers(acx, TEST_MT_THREADS);
+	if (ret == 0)
+		ret = rte_acl_build(acx, &cfg);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	rte_acl_get_build_stats(acx, &st);
+	rte_acl_get_build_stats(ref, &ref_st);
+
+	if (st.num_workers != TEST_MT_THREADS || ref_st.num_workers != 1 ||
+			st.num_tries != ref_st.num_tries ||
+			st.num_nodes != ref_st.num_nodes ||
+			st.rt_mem != ref_st.rt_mem) {
+		printf("Line %i: Build stats mismatch: "
+			"threads: %u/%u, tries: %u/%u, nodes: %u/%u, "
+			"runtime memory: %zu/%zu\n", __LINE__,
+			st.num_workers, ref_st.num_workers,
+			st.num_tries, ref_st.num_tries,
+			st.num_nodes, ref_st.num_nodes,
+			st.rt_mem, ref_st.rt_mem);
+		ret = -EINVAL;
+		goto err;
+	}
+
+	ret = test_incr_cmp(acx, ref, data, RTE_DIM(data), 0);
+	if (ret != 0)
+		printf("Line %i: %s failed!\n", __LINE__, __func__);
+
+err:
+	rte_acl_free(ref);
+	rte_acl_free(acx);
+	return ret;
+}
+
 static int
 test_acl(void)
 {
@@ -1737,6 +2189,12 @@ test_acl(void)
 		return -1;
 	if (test_u32_range() < 0)
 		return -1;
+	if (test_incr() < 0)
+		return -1;
+	if (test_incr_direct() < 0)
+		return -1;
+	if (test_mt_build() < 0)
+		return -1;
 
 	return 0;
 }
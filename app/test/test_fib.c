@@ -6,9 +6,13 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <rte_ip.h>
 #include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
 #include <rte_fib.h>
 
 #include "test.h"
@@ -21,9 +25,15 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_invalid_rcu(void);
+static int32_t test_fib_rcu_dq(void);
+static int32_t test_add_bulk(void);
+static int32_t test_save_restore(void);
+static int32_t test_dir16_8_8(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
+#define BULK_ROUTES	1024
 
 /*
  * Check that rte_fib_create fails gracefully for incorrect user input
@@ -61,11 +71,24 @@ test_create_invalid(void)
 		"Call succeeded with invalid parameters\n");
 	config.max_routes = MAX_ROUTES;
 
-	config.type = RTE_FIB_DIR24_8 + 1;
+	config.type = RTE_FIB_DIR16_8_8 + 1;
 	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
 
+	config.type = RTE_FIB_DIR16_8_8;
+	config.dir16_8_8.nh_sz = RTE_FIB_DIR24_8_8B + 1;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	config.dir16_8_8.nh_sz = RTE_FIB_DIR24_8_1B;
+	config.default_nh = UINT8_MAX;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+	config.default_nh = 0;
+
 	config.type = RTE_FIB_DIR24_8;
 	config.dir24_8.num_tbl8 = MAX_TBL8;
 
@@ -316,6 +339,7 @@ test_lookup(void)
 {
 	struct rte_fib *fib = NULL;
 	struct rte_fib_conf config;
+	enum rte_fib_dir24_8_nh_sz nh_sz;
 	uint64_t def_nh = 100;
 	int ret;
 
@@ -368,6 +392,494 @@ test_lookup(void)
 		"Check_fib fails for DIR24_8_8B type\n");
 	rte_fib_free(fib);
 
+	config.type = RTE_FIB_DIR16_8_8;
+	for (nh_sz = RTE_FIB_DIR24_8_1B; nh_sz <= RTE_FIB_DIR24_8_8B;
+			nh_sz++) {
+		config.dir16_8_8.nh_sz = nh_sz;
+		fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+		ret = check_fib(fib);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+			"Check_fib fails for DIR16_8_8 type\n");
+		rte_fib_free(fib);
+	}
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * rte_fib_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to FIB
+ *  - Add another RCU QSBR variable to FIB
+ *  - Check returns
+ */
+int32_t
+test_invalid_rcu(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status != 0, "Invalid QSBR mode test failed\n");
+
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+
+	/* Attach RCU QSBR to FIB */
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Create and attach another RCU QSBR to FIB table */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv2 != NULL, "Can not allocate memory for RCU\n");
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_SYNC;
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status != 0, "Secondary RCU was mistakenly attached\n");
+
+	rte_fib_free(fib);
+
+	/* RIB based FIB hands the variable down to the RIB */
+	config.type = RTE_FIB_DUMMY;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status != 0, "Secondary RCU was mistakenly attached\n");
+
+	rte_fib_free(fib);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * rte_fib_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Create DIR24_8 FIB with the minimal number of tbl8 groups
+ *  - Add RCU QSBR variable to FIB
+ *  - Register a reader thread (not a real thread)
+ *  - Writer adds and deletes a /32 route in every /24 it has
+ *    a tbl8 group for, parking all of them on the defer queue
+ *  - Writer re-adds a route (no available tbl8 group)
+ *  - Reader reports quiescent state
+ *  - Writer re-adds the route
+ *  - Reader looks the route up
+ */
+int32_t
+test_fib_rcu_dq(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	int32_t status;
+	uint32_t i, ip, num_tbl8;
+	uint64_t next_hop = 1, next_hop_return;
+	uint8_t depth = 32;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	/* rounded up to the size of the tbl8 bitmap slab */
+	num_tbl8 = 64;
+	config.dir24_8.num_tbl8 = num_tbl8;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to FIB table */
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "Can not register RCU reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	for (i = 0; i < num_tbl8; i++) {
+		ip = RTE_IPV4(192, 0, i, 100);
+		status = rte_fib_add(fib, ip, depth, next_hop);
+		RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+		status = rte_fib_delete(fib, ip, depth);
+		RTE_TEST_ASSERT(status == 0, "Failed to delete a route\n");
+	}
+
+	/* All tbl8 groups are waiting for the reader */
+	ip = RTE_IPV4(198, 51, 100, 100);
+	status = rte_fib_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status != 0, "tbl8 group was reused too early\n");
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	status = rte_fib_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+
+	status = rte_fib_lookup_bulk(fib, &ip, &next_hop_return, 1);
+	RTE_TEST_ASSERT((status == 0) && (next_hop_return == next_hop),
+		"Lookup and check fails\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	status = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "Can not unregister RCU reader\n");
+
+	rte_fib_free(fib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Distinct routes spread over the address space with prefix lengths
+ * from /16 to /32, so that they overlap and half of them need tbl8s.
+ */
+static void
+gen_bulk_routes(struct rte_fib_route *routes, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		routes[i].ip = i * 2654435761U;
+		routes[i].depth = 16 + i % 17;
+		routes[i].next_hop = i + 1;
+	}
+}
+
+/*
+ * Check that two FIBs return the same next hops for the first and
+ * the last address of every route.
+ */
+static int
+compare_fibs(struct rte_fib *fib1, struct rte_fib *fib2,
+	const struct rte_fib_route *routes, unsigned int n)
+{
+	uint32_t ips[2];
+	uint64_t nh1[2], nh2[2];
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < n; i++) {
+		ips[0] = routes[i].ip;
+		ips[1] = routes[i].ip |
+			(uint32_t)((1ULL << (32 - routes[i].depth)) - 1);
+		ret = rte_fib_lookup_bulk(fib1, ips, nh1, 2);
+		ret |= rte_fib_lookup_bulk(fib2, ips, nh2, 2);
+		if ((ret != 0) || (nh1[0] != nh2[0]) || (nh1[1] != nh2[1]))
+			return TEST_FAILED;
+	}
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that rte_fib_add_bulk() builds the same FIB as adding the routes
+ * one by one, for an empty FIB and for a FIB that has part of the routes
+ * already installed with other next hops.
+ */
+int32_t
+test_add_bulk(void)
+{
+	struct rte_fib *fib_seq = NULL;
+	struct rte_fib *fib_bulk = NULL;
+	struct rte_fib_conf config;
+	struct rte_fib_route *routes;
+	unsigned int i;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+
+	routes = rte_malloc(NULL, sizeof(*routes) * BULK_ROUTES, 0);
+	RTE_TEST_ASSERT(routes != NULL, "Failed to allocate routes\n");
+	gen_bulk_routes(routes, BULK_ROUTES);
+
+	fib_seq = rte_fib_create("seq", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib_seq != NULL, "Failed to create FIB\n");
+	fib_bulk = rte_fib_create("bulk", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib_bulk != NULL, "Failed to create FIB\n");
+
+	ret = rte_fib_add_bulk(NULL, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+
+	ret = rte_fib_add_bulk(fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add routes in bulk\n");
+	for (i = 0; i < BULK_ROUTES; i++) {
+		ret = rte_fib_add(fib_seq, routes[i].ip, routes[i].depth,
+			routes[i].next_hop);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = compare_fibs(fib_seq, fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after bulk add\n");
+
+	/* Change every third next hop, half of the routes are new */
+	rte_fib_free(fib_bulk);
+	fib_bulk = rte_fib_create("bulk", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib_bulk != NULL, "Failed to create FIB\n");
+	for (i = 0; i < BULK_ROUTES; i += 2) {
+		ret = rte_fib_add(fib_bulk, routes[i].ip, routes[i].depth,
+			routes[i].next_hop);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	for (i = 0; i < BULK_ROUTES; i += 3) {
+		routes[i].next_hop += BULK_ROUTES;
+		ret = rte_fib_add(fib_seq, routes[i].ip, routes[i].depth,
+			routes[i].next_hop);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = rte_fib_add_bulk(fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add routes in bulk\n");
+	ret = compare_fibs(fib_seq, fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after bulk add\n");
+
+	/* The same prefix twice is rejected */
+	routes[0] = routes[BULK_ROUTES - 1];
+	ret = rte_fib_add_bulk(fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Duplicate prefix was accepted\n");
+
+	rte_fib_free(fib_seq);
+	rte_fib_free(fib_bulk);
+	rte_free(routes);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Save a FIB into a file, restore it and check that the restored FIB
+ * returns the same next hops and can still be updated.
+ */
+int32_t
+test_save_restore(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib *fib_rst = NULL;
+	struct rte_fib_conf config;
+	struct rte_fib_route *routes;
+	char path[] = "/tmp/fib_snapshot_XXXXXX";
+	unsigned int i;
+	int fd, ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_2B;
+	config.dir24_8.num_tbl8 = MAX_TBL8 - 1;
+
+	routes = rte_malloc(NULL, sizeof(*routes) * BULK_ROUTES, 0);
+	RTE_TEST_ASSERT(routes != NULL, "Failed to allocate routes\n");
+	gen_bulk_routes(routes, BULK_ROUTES);
+
+	fd = mkstemp(path);
+	RTE_TEST_ASSERT(fd >= 0, "Failed to create a temporary file\n");
+	close(fd);
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib_add(fib, 0, 0, BULK_ROUTES + 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib_add_bulk(fib, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add routes in bulk\n");
+
+	ret = rte_fib_save(NULL, path);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = rte_fib_save(fib, path);
+	RTE_TEST_ASSERT(ret == 0, "Failed to save FIB\n");
+
+	fib_rst = rte_fib_restore(__func__, SOCKET_ID_ANY, path);
+	RTE_TEST_ASSERT(fib_rst == NULL, "FIB restored under a used name\n");
+	fib_rst = rte_fib_restore("restored", SOCKET_ID_ANY, path);
+	RTE_TEST_ASSERT(fib_rst != NULL, "Failed to restore FIB\n");
+	unlink(path);
+
+	ret = compare_fibs(fib, fib_rst, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after restore\n");
+
+	/* Both the RIB and the tbl8 pool have to be usable */
+	for (i = 0; i < BULK_ROUTES; i += 2) {
+		ret = rte_fib_delete(fib, routes[i].ip, routes[i].depth);
+		ret |= rte_fib_delete(fib_rst, routes[i].ip, routes[i].depth);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+	for (i = 0; i < BULK_ROUTES; i += 4) {
+		ret = rte_fib_add(fib, routes[i].ip | 0x80, 25, i);
+		ret |= rte_fib_add(fib_rst, routes[i].ip | 0x80, 25, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = compare_fibs(fib, fib_rst, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after update\n");
+
+	rte_fib_free(fib);
+	rte_fib_free(fib_rst);
+	rte_free(routes);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Compare the next hops of two FIBs for the route boundaries and for
+ * addresses spread over the whole address space, with every lookup
+ * implementation of the second FIB.
+ */
+static int
+compare_dir16_8_8(struct rte_fib *fib_ref, struct rte_fib *fib,
+	const struct rte_fib_route *routes, unsigned int n)
+{
+	static const enum rte_fib_lookup_type types[] = {
+		RTE_FIB_LOOKUP_DIR16_8_8_SCALAR,
+		RTE_FIB_LOOKUP_DIR16_8_8_VECTOR_AVX512,
+	};
+	uint32_t ips[BULK_ROUTES];
+	uint64_t nh_ref[BULK_ROUTES], nh[BULK_ROUTES];
+	unsigned int i, j, k;
+	int ret;
+
+	for (i = 0; i < RTE_DIM(types); i++) {
+		ret = rte_fib_select_lookup(fib, types[i]);
+		if ((ret != 0) &&
+				(types[i] != RTE_FIB_LOOKUP_DIR16_8_8_SCALAR))
+			continue;
+		RTE_TEST_ASSERT(ret == 0, "Failed to select lookup\n");
+
+		ret = compare_fibs(fib_ref, fib, routes, n);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ\n");
+		for (j = 0; j < 64; j++) {
+			for (k = 0; k < BULK_ROUTES; k++)
+				ips[k] = (j * BULK_ROUTES + k) * 2246822519U;
+			ret = rte_fib_lookup_bulk(fib_ref, ips, nh_ref,
+				BULK_ROUTES);
+			ret |= rte_fib_lookup_bulk(fib, ips, nh, BULK_ROUTES);
+			RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+			RTE_TEST_ASSERT(memcmp(nh_ref, nh, sizeof(nh)) == 0,
+				"FIBs differ\n");
+		}
+	}
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that a DIR16_8_8 FIB returns the same next hops as a DIR24_8 FIB
+ * after bulk additions, deletions, next hop changes and changes of
+ * short prefixes covering many /16s.
+ */
+int32_t
+test_dir16_8_8(void)
+{
+	struct rte_fib *fib_ref = NULL;
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	struct rte_fib_route *routes;
+	unsigned int i;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_8B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+
+	routes = rte_malloc(NULL, sizeof(*routes) * BULK_ROUTES, 0);
+	RTE_TEST_ASSERT(routes != NULL, "Failed to allocate routes\n");
+	gen_bulk_routes(routes, BULK_ROUTES);
+
+	fib_ref = rte_fib_create("ref", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib_ref != NULL, "Failed to create FIB\n");
+	config.type = RTE_FIB_DIR16_8_8;
+	config.dir16_8_8.nh_sz = RTE_FIB_DIR24_8_2B;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	ret = rte_fib_add(fib, 0, 0, UINT16_MAX);
+	RTE_TEST_ASSERT(ret < 0, "Next hop too big for nh_sz accepted\n");
+
+	for (i = 0; i < BULK_ROUTES; i++) {
+		ret = rte_fib_add(fib_ref, routes[i].ip, routes[i].depth,
+			routes[i].next_hop);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = rte_fib_add_bulk(fib, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add routes in bulk\n");
+	ret = compare_dir16_8_8(fib_ref, fib, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after bulk add\n");
+
+	for (i = 0; i < BULK_ROUTES; i += 2) {
+		ret = rte_fib_delete(fib_ref, routes[i].ip, routes[i].depth);
+		ret |= rte_fib_delete(fib, routes[i].ip, routes[i].depth);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+	for (i = 1; i < BULK_ROUTES; i += 3) {
+		ret = rte_fib_add(fib_ref, routes[i].ip, routes[i].depth, i);
+		ret |= rte_fib_add(fib, routes[i].ip, routes[i].depth, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = compare_dir16_8_8(fib_ref, fib, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after update\n");
+
+	/* Prefixes shorter than /16 cover many blocks */
+	for (i = 0; i < BULK_ROUTES; i += 64) {
+		ret = rte_fib_add(fib_ref, routes[i].ip, 4 + i % 13, i + 7);
+		ret |= rte_fib_add(fib, routes[i].ip, 4 + i % 13, i + 7);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = compare_dir16_8_8(fib_ref, fib, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after update\n");
+	for (i = 0; i < BULK_ROUTES; i += 128) {
+		ret = rte_fib_delete(fib_ref, routes[i].ip, 4 + i % 13);
+		ret |= rte_fib_delete(fib, routes[i].ip, 4 + i % 13);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+	ret = compare_dir16_8_8(fib_ref, fib, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after delete\n");
+
+	rte_fib_free(fib_ref);
+	rte_fib_free(fib);
+	rte_free(routes);
+
 	return TEST_SUCCESS;
 }
 
@@ -381,6 +893,11 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_invalid_rcu),
+	TEST_CASE(test_fib_rcu_dq),
+	TEST_CASE(test_add_bulk),
+	TEST_CASE(test_save_restore),
+	TEST_CASE(test_dir16_8_8),
 	TEST_CASES_END()
 	}
 };
@@ -6,9 +6,12 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include <rte_memory.h>
 #include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
 #include <rte_rib6.h>
 #include <rte_fib6.h>
 
@@ -22,10 +25,15 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_invalid_rcu(void);
+static int32_t test_fib6_rcu_dq(void);
+static int32_t test_add_bulk(void);
+static int32_t test_save_restore(void);
 
 #define MAX_ROUTES	(1 << 16)
 /** Maximum number of tbl8 for 2-byte entries */
 #define MAX_TBL8	(1 << 15)
+#define BULK_ROUTES	1024
 
 /*
  * Check that rte_fib6_create fails gracefully for incorrect user input
@@ -380,6 +388,372 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * rte_fib6_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to FIB
+ *  - Add another RCU QSBR variable to FIB
+ *  - Check returns
+ */
+int32_t
+test_invalid_rcu(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_fib6_rcu_config rcu_cfg = {0};
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = MAX_TBL8;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status != 0, "Invalid QSBR mode test failed\n");
+
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_DQ;
+
+	/* Attach RCU QSBR to FIB */
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Create and attach another RCU QSBR to FIB table */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv2 != NULL, "Can not allocate memory for RCU\n");
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_SYNC;
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status != 0, "Secondary RCU was mistakenly attached\n");
+
+	rte_fib6_free(fib);
+
+	/* RIB based FIB hands the variable down to the RIB */
+	config.type = RTE_FIB6_DUMMY;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status != 0, "Secondary RCU was mistakenly attached\n");
+
+	rte_fib6_free(fib);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * rte_fib6_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Create TRIE FIB with two tbl8 groups
+ *  - Add RCU QSBR variable to FIB
+ *  - Register a reader thread (not a real thread)
+ *  - Writer adds and deletes a /32 route, parking both
+ *    tbl8 groups on the defer queue
+ *  - Writer re-adds a route (no available tbl8 group)
+ *  - Reader reports quiescent state
+ *  - Writer re-adds the route
+ *  - Reader looks the route up
+ */
+int32_t
+test_fib6_rcu_dq(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	int32_t status;
+	uint8_t ip[1][RTE_FIB6_IPV6_ADDR_SIZE] = { {0x20, 0x01, 0x0d, 0xb8} };
+	uint64_t next_hop = 1, next_hop_return;
+	uint8_t depth = 32;
+	struct rte_fib6_rcu_config rcu_cfg = {0};
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = 3;
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_FIB6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to FIB table */
+	status = rte_fib6_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "Can not register RCU reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	status = rte_fib6_add(fib, ip[0], depth, next_hop);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+	/*
+	 * The route uses one tbl8 group, deleting it needs a transient one
+	 * and both of them end up on the defer queue.
+	 */
+	status = rte_fib6_delete(fib, ip[0], depth);
+	RTE_TEST_ASSERT(status == 0, "Failed to delete a route\n");
+
+	/* All tbl8 groups are waiting for the reader */
+	status = rte_fib6_add(fib, ip[0], depth, next_hop);
+	RTE_TEST_ASSERT(status != 0, "tbl8 group was reused too early\n");
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	status = rte_fib6_add(fib, ip[0], depth, next_hop);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+
+	status = rte_fib6_lookup_bulk(fib, ip, &next_hop_return, 1);
+	RTE_TEST_ASSERT((status == 0) && (next_hop_return == next_hop),
+		"Lookup and check fails\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	status = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "Can not unregister RCU reader\n");
+
+	rte_fib6_free(fib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Distinct routes spread over the address space with prefix lengths
+ * from /16 to /64, so that they overlap and most of them need tbl8s.
+ */
+static void
+gen_bulk_routes(struct rte_fib6_route *routes, unsigned int n)
+{
+	uint32_t h1, h2;
+	unsigned int i;
+	int j;
+
+	for (i = 0; i < n; i++) {
+		h1 = i * 2654435761U;
+		h2 = h1 ^ (i * 40503U);
+		for (j = 0; j < 4; j++) {
+			routes[i].ip[j] = h1 >> (24 - j * 8);
+			routes[i].ip[j + 4] = h2 >> (24 - j * 8);
+		}
+		memset(&routes[i].ip[8], 0, RTE_FIB6_IPV6_ADDR_SIZE - 8);
+		routes[i].depth = 16 + i % 49;
+		routes[i].next_hop = i + 1;
+	}
+}
+
+/*
+ * Check that two FIBs return the same next hops for the first and
+ * the last address of every route.
+ */
+static int
+compare_fibs(struct rte_fib6 *fib1, struct rte_fib6 *fib2,
+	const struct rte_fib6_route *routes, unsigned int n)
+{
+	uint8_t ips[2][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t nh1[2], nh2[2];
+	unsigned int i;
+	int j, ret;
+
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++) {
+			ips[0][j] = routes[i].ip[j];
+			ips[1][j] = routes[i].ip[j] |
+				(uint8_t)~get_msk_part(routes[i].depth, j);
+		}
+		ret = rte_fib6_lookup_bulk(fib1, ips, nh1, 2);
+		ret |= rte_fib6_lookup_bulk(fib2, ips, nh2, 2);
+		if ((ret != 0) || (nh1[0] != nh2[0]) || (nh1[1] != nh2[1]))
+			return TEST_FAILED;
+	}
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that rte_fib6_add_bulk() builds the same FIB as adding the routes
+ * one by one, for an empty FIB and for a FIB that has part of the routes
+ * already installed with other next hops.
+ */
+int32_t
+test_add_bulk(void)
+{
+	struct rte_fib6 *fib_seq = NULL;
+	struct rte_fib6 *fib_bulk = NULL;
+	struct rte_fib6_conf config;
+	struct rte_fib6_route *routes;
+	unsigned int i;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = MAX_TBL8;
+
+	routes = rte_malloc(NULL, sizeof(*routes) * BULK_ROUTES, 0);
+	RTE_TEST_ASSERT(routes != NULL, "Failed to allocate routes\n");
+	gen_bulk_routes(routes, BULK_ROUTES);
+
+	fib_seq = rte_fib6_create("seq", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib_seq != NULL, "Failed to create FIB\n");
+	fib_bulk = rte_fib6_create("bulk", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib_bulk != NULL, "Failed to create FIB\n");
+
+	ret = rte_fib6_add_bulk(NULL, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+
+	ret = rte_fib6_add_bulk(fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add routes in bulk\n");
+	for (i = 0; i < BULK_ROUTES; i++) {
+		ret = rte_fib6_add(fib_seq, routes[i].ip, routes[i].depth,
+			routes[i].next_hop);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = compare_fibs(fib_seq, fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after bulk add\n");
+
+	/* Change every third next hop, half of the routes are new */
+	rte_fib6_free(fib_bulk);
+	fib_bulk = rte_fib6_create("bulk", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib_bulk != NULL, "Failed to create FIB\n");
+	for (i = 0; i < BULK_ROUTES; i += 2) {
+		ret = rte_fib6_add(fib_bulk, routes[i].ip, routes[i].depth,
+			routes[i].next_hop);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	for (i = 0; i < BULK_ROUTES; i += 3) {
+		routes[i].next_hop += BULK_ROUTES;
+		ret = rte_fib6_add(fib_seq, routes[i].ip, routes[i].depth,
+			routes[i].next_hop);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = rte_fib6_add_bulk(fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add routes in bulk\n");
+	ret = compare_fibs(fib_seq, fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after bulk add\n");
+
+	/* The same prefix twice is rejected */
+	routes[0] = routes[BULK_ROUTES - 1];
+	ret = rte_fib6_add_bulk(fib_bulk, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Duplicate prefix was accepted\n");
+
+	rte_fib6_free(fib_seq);
+	rte_fib6_free(fib_bulk);
+	rte_free(routes);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Save a FIB into a file, restore it and check that the restored FIB
+ * returns the same next hops and can still be updated.
+ */
+int32_t
+test_save_restore(void)
+{
+	struct rte_fib6 *fib = NULL;
+	struct rte_fib6 *fib_rst = NULL;
+	struct rte_fib6_conf config;
+	struct rte_fib6_route *routes;
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	char path[] = "/tmp/fib6_snapshot_XXXXXX";
+	unsigned int i;
+	int fd, ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 0;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_2B;
+	config.trie.num_tbl8 = MAX_TBL8 - 1;
+
+	routes = rte_malloc(NULL, sizeof(*routes) * BULK_ROUTES, 0);
+	RTE_TEST_ASSERT(routes != NULL, "Failed to allocate routes\n");
+	gen_bulk_routes(routes, BULK_ROUTES);
+
+	fd = mkstemp(path);
+	RTE_TEST_ASSERT(fd >= 0, "Failed to create a temporary file\n");
+	close(fd);
+
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = rte_fib6_add(fib, ip, 0, BULK_ROUTES + 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib6_add_bulk(fib, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add routes in bulk\n");
+
+	ret = rte_fib6_save(NULL, path);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = rte_fib6_save(fib, path);
+	RTE_TEST_ASSERT(ret == 0, "Failed to save FIB\n");
+
+	fib_rst = rte_fib6_restore(__func__, SOCKET_ID_ANY, path);
+	RTE_TEST_ASSERT(fib_rst == NULL, "FIB restored under a used name\n");
+	fib_rst = rte_fib6_restore("restored", SOCKET_ID_ANY, path);
+	RTE_TEST_ASSERT(fib_rst != NULL, "Failed to restore FIB\n");
+	unlink(path);
+
+	ret = compare_fibs(fib, fib_rst, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after restore\n");
+
+	/* Both the RIB and the tbl8 pool have to be usable */
+	for (i = 0; i < BULK_ROUTES; i += 2) {
+		ret = rte_fib6_delete(fib, routes[i].ip, routes[i].depth);
+		ret |= rte_fib6_delete(fib_rst, routes[i].ip,
+			routes[i].depth);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+	for (i = 0; i < BULK_ROUTES; i += 4) {
+		memcpy(ip, routes[i].ip, RTE_FIB6_IPV6_ADDR_SIZE);
+		ip[15] = 0x80;
+		ret = rte_fib6_add(fib, ip, 121, i);
+		ret |= rte_fib6_add(fib_rst, ip, 121, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	}
+	ret = compare_fibs(fib, fib_rst, routes, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "FIBs differ after update\n");
+
+	rte_fib6_free(fib);
+	rte_fib6_free(fib_rst);
+	rte_free(routes);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib6_fast_tests = {
 	.suite_name = "fib6 autotest",
 	.setup = NULL,
@@ -390,6 +764,10 @@ static struct unit_test_suite fib6_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_invalid_rcu),
+	TEST_CASE(test_fib6_rcu_dq),
+	TEST_CASE(test_add_bulk),
+	TEST_CASE(test_save_restore),
 	TEST_CASES_END()
 	}
 };
@@ -12,6 +12,7 @@
 #include <rte_random.h>
 #include <rte_branch_prediction.h>
 #include <rte_ip.h>
+#include <rte_malloc.h>
 #include <rte_fib.h>
 
 #include "test.h"
@@ -316,34 +317,39 @@ print_route_distribution(const struct route_rule *table, uint32_t n)
 	printf("\n");
 }
 
+/* Memory allocated from the DPDK heaps of all the sockets */
+static size_t
+get_heap_allocated(void)
+{
+	struct rte_malloc_socket_stats stats;
+	size_t total = 0;
+	int i;
+
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
+		if (rte_malloc_get_socket_stats(i, &stats) == 0)
+			total += stats.heap_allocsz_bytes;
+	}
+	return total;
+}
+
 static int
-test_fib_perf(void)
+run_fib_perf(const char *name, struct rte_fib_conf *config)
 {
 	struct rte_fib *fib = NULL;
-	struct rte_fib_conf config;
-
-	config.max_routes = 2000000;
-	config.type = RTE_FIB_DIR24_8;
-	config.default_nh = 0;
-	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
-	config.dir24_8.num_tbl8 = 65535;
 	uint64_t begin, total_time;
 	unsigned int i, j;
 	uint32_t next_hop_add = 0xAA;
 	int status = 0;
 	int64_t count = 0;
+	size_t mem_base;
 
-	rte_srand(rte_rdtsc());
-
-	generate_large_route_rule_table();
+	printf("\n%s:\n", name);
 
-	printf("No. routes = %u\n", (unsigned int) NUM_ROUTE_ENTRIES);
-
-	print_route_distribution(large_route_table,
-		(uint32_t) NUM_ROUTE_ENTRIES);
-
-	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	mem_base = get_heap_allocated();
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, config);
 	TEST_FIB_ASSERT(fib != NULL);
+	printf("Empty FIB memory: %zu KB\n",
+		(get_heap_allocated() - mem_base) >> 10);
 
 	/* Measue add. */
 	begin = rte_rdtsc();
@@ -360,6 +366,8 @@ test_fib_perf(void)
 
 	printf("Average FIB Add: %g cycles\n",
 			(double)total_time / NUM_ROUTE_ENTRIES);
+	printf("Populated FIB memory: %zu KB\n",
+		(get_heap_allocated() - mem_base) >> 10);
 
 	/* Measure bulk Lookup */
 	total_time = 0;
@@ -398,7 +406,7 @@ test_fib_perf(void)
 				large_route_table[i].depth);
 	}
 
-	total_time += rte_rdtsc() - begin;
+	total_time = rte_rdtsc() - begin;
 
 	printf("Average FIB Delete: %g cycles\n",
 			(double)total_time / NUM_ROUTE_ENTRIES);
@@ -408,4 +416,42 @@ test_fib_perf(void)
 	return 0;
 }
 
+/*
+ * Compare memory footprint and throughput of the FIB algorithms
+ * on the same route table.
+ */
+static int
+test_fib_perf(void)
+{
+	struct rte_fib_conf config;
+	int ret;
+
+	rte_srand(rte_rdtsc());
+
+	generate_large_route_rule_table();
+
+	printf("No. routes = %u\n", (unsigned int) NUM_ROUTE_ENTRIES);
+
+	print_route_distribution(large_route_table,
+		(uint32_t) NUM_ROUTE_ENTRIES);
+
+	config.max_routes = 2000000;
+	config.type = RTE_FIB_DIR24_8;
+	config.default_nh = 0;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = 65535;
+	ret = run_fib_perf("DIR24_8, 4 byte next hops", &config);
+	if (ret != 0)
+		return ret;
+
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_8B;
+	ret = run_fib_perf("DIR24_8, 8 byte next hops", &config);
+	if (ret != 0)
+		return ret;
+
+	config.type = RTE_FIB_DIR16_8_8;
+	config.dir16_8_8.nh_sz = RTE_FIB_DIR24_8_8B;
+	return run_fib_perf("DIR16_8_8, 8 byte next hops", &config);
+}
+
 REGISTER_TEST_COMMAND(fib_perf_autotest, test_fib_perf);
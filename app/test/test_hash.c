@@ -18,6 +18,10 @@
 #include <rte_eal.h>
 #include <rte_ip.h>
 #include <rte_string_fns.h>
+#include <rte_vect.h>
+#ifdef RTE_ARCH_X86
+#include <rte_cpuflags.h>
+#endif
 
 #include "test.h"
 
@@ -997,6 +1001,257 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+/*
+ * Add keys to a resizable table well beyond its initial size, checking
+ * they are all found while it grows, then delete half of them.
+ */
+#define RESIZE_KEYS 4096
+static int test_resizable_table(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resize",
+		.entries = 64,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE
+	};
+	struct rte_hash *handle = NULL;
+	const void *bulk_keys[32];
+	uint32_t keys[32];
+	void *data[32];
+	void *d;
+	uint64_t hit_mask;
+	uint32_t i, k, iter = 0;
+	int pos, resizing = 0;
+
+	/* Cannot grow the extendable buckets */
+	params.extra_flag |= RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle != NULL,
+		"resizable table created with ext table");
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		pos = rte_hash_add_key_data(handle, &i,
+				(void *)((uintptr_t)i + 1));
+		RETURN_IF_ERROR(pos < 0, "failed to add key %u (%d)", i, pos);
+
+		/* Count the buckets left to move, without moving them */
+		if (rte_hash_resize_step(handle, 0) > 0)
+			resizing++;
+
+		for (k = 0; k <= i; k++) {
+			pos = rte_hash_lookup_data(handle, &k, &d);
+			RETURN_IF_ERROR(pos < 0 || d != (void *)((uintptr_t)k + 1),
+				"failed to find key %u after adding key %u",
+				k, i);
+		}
+	}
+	RETURN_IF_ERROR(resizing == 0, "table did not grow");
+	RETURN_IF_ERROR(rte_hash_max_key_id(handle) < RESIZE_KEYS,
+		"not enough key slots (%d)", rte_hash_max_key_id(handle));
+	RETURN_IF_ERROR(rte_hash_count(handle) != RESIZE_KEYS,
+		"wrong number of keys (%d)", rte_hash_count(handle));
+
+	/* Iterate while a resize may still be in progress */
+	for (k = 0; rte_hash_iterate(handle, bulk_keys, &d, &iter) >= 0; k++)
+		RETURN_IF_ERROR(d != (void *)((uintptr_t)
+				*(const uint32_t *)bulk_keys[0] + 1),
+				"wrong data iterated");
+	RETURN_IF_ERROR(k != RESIZE_KEYS, "iterated %u keys", k);
+
+	RETURN_IF_ERROR(rte_hash_resize_step(handle, UINT32_MAX) != 0,
+		"resize did not complete");
+
+	for (i = 0; i < RESIZE_KEYS; i += 2) {
+		pos = rte_hash_del_key(handle, &i);
+		RETURN_IF_ERROR(pos < 0, "failed to delete key %u", i);
+	}
+
+	for (i = 0; i < 32; i++) {
+		keys[i] = i;
+		bulk_keys[i] = &keys[i];
+	}
+	pos = rte_hash_lookup_bulk_data(handle, bulk_keys, 32, &hit_mask, data);
+	RETURN_IF_ERROR(pos != 16 || hit_mask != 0xaaaaaaaaULL,
+			"bulk lookup found %d keys", pos);
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+/*
+ * Add and delete keys in bursts larger than the prefetch burst.
+ */
+#define BULK_KEYS 100
+static int test_add_del_bulk(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_bulk",
+		.entries = 256,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+	};
+	struct rte_hash *handle = NULL;
+	const void *bulk_keys[BULK_KEYS];
+	uint32_t keys[BULK_KEYS];
+	void *data[BULK_KEYS];
+	int32_t pos[BULK_KEYS], pos2[BULK_KEYS];
+	void *d;
+	uint32_t i;
+	int ret;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < BULK_KEYS; i++) {
+		keys[i] = i;
+		bulk_keys[i] = &keys[i];
+		data[i] = (void *)((uintptr_t)i + 1);
+	}
+
+	ret = rte_hash_add_key_bulk_data(handle, bulk_keys, data, BULK_KEYS,
+					 pos);
+	RETURN_IF_ERROR(ret != BULK_KEYS, "added %d keys", ret);
+	for (i = 0; i < BULK_KEYS; i++) {
+		RETURN_IF_ERROR(rte_hash_lookup_data(handle, &i, &d) != pos[i] ||
+				d != data[i], "failed to find key %u", i);
+	}
+
+	/* Adding the keys again updates their data */
+	for (i = 0; i < BULK_KEYS; i++)
+		data[i] = (void *)((uintptr_t)i + 2);
+	ret = rte_hash_add_key_bulk_data(handle, bulk_keys, data, BULK_KEYS,
+					 pos2);
+	RETURN_IF_ERROR(ret != BULK_KEYS, "updated %d keys", ret);
+	RETURN_IF_ERROR(memcmp(pos, pos2, sizeof(pos)) != 0,
+			"updated keys moved");
+	RETURN_IF_ERROR(rte_hash_count(handle) != BULK_KEYS,
+			"wrong number of keys (%d)", rte_hash_count(handle));
+
+	/* Delete the even keys, and keys not in the table */
+	for (i = 0; i < BULK_KEYS; i++)
+		keys[i] = i & 1 ? i + BULK_KEYS : i;
+	ret = rte_hash_del_key_bulk(handle, bulk_keys, BULK_KEYS, pos2);
+	RETURN_IF_ERROR(ret != BULK_KEYS / 2, "deleted %d keys", ret);
+	for (i = 0; i < BULK_KEYS; i++) {
+		RETURN_IF_ERROR(pos2[i] != (i & 1 ? -ENOENT : pos[i]),
+				"wrong position %d deleting key %u",
+				pos2[i], keys[i]);
+		RETURN_IF_ERROR((rte_hash_lookup(handle, &i) < 0) != !(i & 1),
+				"key %u found after delete", i);
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+static void
+aging_expire_cb(const void *key, void *data, int32_t position, void *arg)
+{
+	unsigned int *expired = arg;
+
+	if (data == (void *)((uintptr_t)*(const uint32_t *)key + 1) &&
+			position >= 0)
+		(*expired)++;
+}
+
+/*
+ * Expire the keys which are not looked up.
+ *  - add keys, a first walk stamps them
+ *  - look up and touch the odd keys, expire the even ones
+ *  - expire the odd keys, walking one bucket at a time
+ */
+static int test_aging(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_aging",
+		.entries = 64,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE
+	};
+	struct rte_hash *handle = NULL;
+	const void *bulk_keys[16];
+	uint32_t keys[16];
+	void *data[16];
+	void *d;
+	uint64_t hit_mask;
+	unsigned int expired = 0;
+	uint32_t i;
+	int pos, ret = 0;
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	RETURN_IF_ERROR(rte_hash_expire_step(handle, 1, 10, 64, NULL,
+				NULL) != -EINVAL,
+		"expired keys of a table without aging");
+	rte_hash_free(handle);
+
+	params.extra_flag |= RTE_HASH_EXTRA_FLAGS_AGING;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < 32; i++) {
+		pos = rte_hash_add_key_data(handle, &i,
+				(void *)((uintptr_t)i + 1));
+		RETURN_IF_ERROR(pos < 0, "failed to add key %u (%d)", i, pos);
+	}
+
+	/* First walk, all the keys get the timestamp 1 */
+	ret = rte_hash_expire_step(handle, 1, 10, 64, aging_expire_cb,
+				   &expired);
+	RETURN_IF_ERROR(ret != 0, "expired %d new keys", ret);
+
+	for (i = 0; i < 16; i++) {
+		keys[i] = 2 * i + 1;
+		bulk_keys[i] = &keys[i];
+	}
+	ret = rte_hash_lookup_bulk_data_touch(handle, bulk_keys, 16, 20,
+					      &hit_mask, data);
+	RETURN_IF_ERROR(ret != 16 || hit_mask != 0xffff,
+			"bulk lookup found %d keys", ret);
+
+	ret = rte_hash_expire_step(handle, 20, 10, 64, aging_expire_cb,
+				   &expired);
+	RETURN_IF_ERROR(ret != 16 || expired != 16,
+			"expired %d keys, %u in callback", ret, expired);
+	RETURN_IF_ERROR(rte_hash_count(handle) != 16,
+			"wrong number of keys (%d)", rte_hash_count(handle));
+	for (i = 0; i < 32; i++) {
+		pos = rte_hash_lookup_data(handle, &i, &d);
+		RETURN_IF_ERROR((pos < 0) != !(i & 1),
+				"key %u found after expiry: %d", i, pos);
+	}
+
+	ret = rte_hash_expire_step(handle, 25, 10, 64, NULL, NULL);
+	RETURN_IF_ERROR(ret != 0, "expired %d keys seen recently", ret);
+
+	expired = 0;
+	for (i = 0; i < 64; i++) {
+		pos = rte_hash_expire_step(handle, 40, 10, 1, aging_expire_cb,
+					   &expired);
+		RETURN_IF_ERROR(pos < 0, "failed to expire keys (%d)", pos);
+		ret += pos;
+	}
+	RETURN_IF_ERROR(ret != 16 || expired != 16,
+			"expired %d keys, %u in callback", ret, expired);
+	RETURN_IF_ERROR(rte_hash_count(handle) != 0,
+			"wrong number of keys (%d)", rte_hash_count(handle));
+
+	rte_hash_free(handle);
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -2174,9 +2429,186 @@ test_hash_rcu_qsbr_sync_mode(uint8_t ext_bkt)
 
 }
 
+#define RESIZE_LF_KEYS		4096
+#define RESIZE_LF_READER_KEYS	32
+
+static volatile uint32_t resize_lf_misses;
+
+/*
+ * Reader thread looking up keys of a resizable table with RCU.
+ */
+static int
+test_hash_rcu_qsbr_resize_reader(void *arg)
+{
+	const void *bulk_keys[RESIZE_LF_READER_KEYS];
+	uint32_t keys[RESIZE_LF_READER_KEYS];
+	void *data[RESIZE_LF_READER_KEYS];
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t hit_mask;
+	uint32_t i;
+	void *d;
+
+	RTE_SET_USED(arg);
+	for (i = 0; i < RESIZE_LF_READER_KEYS; i++) {
+		keys[i] = i;
+		bulk_keys[i] = &keys[i];
+	}
+
+	(void)rte_rcu_qsbr_thread_register(g_qsv, lcore_id);
+	rte_rcu_qsbr_thread_online(g_qsv, lcore_id);
+
+	do {
+		for (i = 0; i < RESIZE_LF_READER_KEYS; i++)
+			if (rte_hash_lookup_data(g_handle, &i, &d) < 0 ||
+					d != (void *)((uintptr_t)i + 1))
+				__atomic_fetch_add(&resize_lf_misses, 1,
+						   __ATOMIC_RELAXED);
+
+		if (rte_hash_lookup_bulk_data(g_handle, bulk_keys,
+				RESIZE_LF_READER_KEYS, &hit_mask, data) !=
+				RESIZE_LF_READER_KEYS)
+			__atomic_fetch_add(&resize_lf_misses, 1,
+					   __ATOMIC_RELAXED);
+
+		rte_rcu_qsbr_quiescent(g_qsv, lcore_id);
+	} while (!writer_done);
+
+	rte_rcu_qsbr_thread_offline(g_qsv, lcore_id);
+	(void)rte_rcu_qsbr_thread_unregister(g_qsv, lcore_id);
+
+	return 0;
+}
+
+/*
+ * Lock free lookups while a resizable table grows.
+ * Several readers keep looking up the first keys added, while the writer
+ * adds keys until the table grew several times. The readers must find the
+ * keys during all the resizes.
+ */
+static int
+test_hash_rcu_qsbr_resize(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_rcu_qsbr_resize",
+		.entries = 64,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+			      RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	unsigned int lcore_id;
+	int32_t status;
+	uint32_t i;
+	size_t sz;
+	int pos;
+
+	printf("\n# Running RCU QSBR resizable table lock free test\n");
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores, skipping\n");
+		return 0;
+	}
+
+	g_qsv = NULL;
+	g_handle = rte_hash_create(&params);
+	RETURN_IF_ERROR_RCU_QSBR(g_handle == NULL, "Hash creation failed");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	g_qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RETURN_IF_ERROR_RCU_QSBR(g_qsv == NULL,
+				 "RCU QSBR variable creation failed");
+
+	status = rte_rcu_qsbr_init(g_qsv, RTE_MAX_LCORE);
+	RETURN_IF_ERROR_RCU_QSBR(status != 0,
+				 "RCU QSBR variable initialization failed");
+
+	rcu_cfg.v = g_qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_SYNC;
+	status = rte_hash_rcu_qsbr_add(g_handle, &rcu_cfg);
+	RETURN_IF_ERROR_RCU_QSBR(status != 0,
+				 "Attach RCU QSBR to hash table failed");
+
+	for (i = 0; i < RESIZE_LF_READER_KEYS; i++) {
+		pos = rte_hash_add_key_data(g_handle, &i,
+				(void *)((uintptr_t)i + 1));
+		RETURN_IF_ERROR_RCU_QSBR(pos < 0, "failed to add key %u", i);
+	}
+
+	resize_lf_misses = 0;
+	writer_done = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(test_hash_rcu_qsbr_resize_reader, NULL,
+				      lcore_id);
+
+	for (; i < RESIZE_LF_KEYS; i++) {
+		pos = rte_hash_add_key_data(g_handle, &i,
+				(void *)((uintptr_t)i + 1));
+		RETURN_IF_ERROR_RCU_QSBR(pos < 0, "failed to add key %u (%d)",
+					 i, pos);
+	}
+	RETURN_IF_ERROR_RCU_QSBR(rte_hash_resize_step(g_handle,
+						      UINT32_MAX) != 0,
+				 "resize did not complete");
+
+	writer_done = 1;
+	rte_eal_mp_wait_lcore();
+
+	RETURN_IF_ERROR_RCU_QSBR(rte_hash_max_key_id(g_handle) <
+				 RESIZE_LF_KEYS, "table did not grow");
+	RETURN_IF_ERROR_RCU_QSBR(resize_lf_misses != 0,
+				 "readers missed keys %u times",
+				 resize_lf_misses);
+
+	rte_hash_free(g_handle);
+	rte_free(g_qsv);
+
+	return 0;
+}
+
 /*
  * Do all unit and performance tests.
  */
+/*
+ * Run the bulk lookup tests again with the AVX512 signature compare, which
+ * is used by the tables created while the max SIMD bitwidth allows it.
+ */
+static int
+test_hash_bulk_avx512(void)
+{
+#ifdef RTE_ARCH_X86
+	uint16_t bitwidth = rte_vect_get_max_simd_bitwidth();
+	int ret = 0;
+
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0 ||
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) <= 0 ||
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_BMI2) <= 0) {
+		printf("AVX512 not supported, skipping AVX512 bulk lookup tests\n");
+		return 0;
+	}
+	if (bitwidth < RTE_VECT_SIMD_512 &&
+			rte_vect_set_max_simd_bitwidth(RTE_VECT_SIMD_512) != 0) {
+		printf("Max SIMD bitwidth is forced, skipping AVX512 bulk lookup tests\n");
+		return 0;
+	}
+
+	if (test_five_keys() < 0 || test_extendable_bucket() < 0 ||
+			test_resizable_table() < 0 || test_aging() < 0 ||
+			test_add_del_bulk() < 0 ||
+			test_hash_rcu_qsbr_sync_mode(0) < 0)
+		ret = -1;
+
+	if (bitwidth < RTE_VECT_SIMD_512)
+		rte_vect_set_max_simd_bitwidth(bitwidth);
+	return ret;
+#else
+	return 0;
+#endif
+}
+
 static int
 test_hash(void)
 {
@@ -2208,6 +2640,12 @@ test_hash(void)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_resizable_table() < 0)
+		return -1;
+	if (test_aging() < 0)
+		return -1;
+	if (test_add_del_bulk() < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
@@ -2250,6 +2688,12 @@ test_hash(void)
 	if (test_hash_rcu_qsbr_sync_mode(1) < 0)
 		return -1;
 
+	if (test_hash_rcu_qsbr_resize() < 0)
+		return -1;
+
+	if (test_hash_bulk_avx512() < 0)
+		return -1;
+
 	return 0;
 }
 
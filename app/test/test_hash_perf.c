@@ -636,6 +636,148 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 	return 0;
 }
 
+/* Table sizes and key length of the bulk add and delete performance test */
+#define BULK_MIN_ENTRIES (1 << 20)
+#define BULK_MAX_ENTRIES (1 << 26)
+#define BULK_KEY_LEN 16
+
+enum bulk_operations {
+	BULK_ADD = 0,
+	BULK_ADD_BULK,
+	BULK_DELETE,
+	BULK_DELETE_BULK,
+	NUM_BULK_OPERATIONS
+};
+
+/* Generate a burst of distinct keys, without storing all of them */
+static void
+get_bulk_keys(uint32_t first, uint32_t num,
+		uint64_t bulk_keys[][BULK_KEY_LEN / sizeof(uint64_t)],
+		const void **key_ptrs)
+{
+	uint32_t i;
+
+	for (i = 0; i < num; i++) {
+		bulk_keys[i][0] = (first + i) * 0x9e3779b97f4a7c15ULL;
+		bulk_keys[i][1] = first + i;
+		key_ptrs[i] = bulk_keys[i];
+	}
+}
+
+static int
+timed_bulk_add_del(struct rte_hash *handle, uint32_t keys_to_add,
+		unsigned int bulk, uint64_t *add_cycles, uint64_t *del_cycles)
+{
+	uint64_t bulk_keys[RTE_HASH_LOOKUP_BULK_MAX]
+			[BULK_KEY_LEN / sizeof(uint64_t)];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i, j, burst;
+	uint64_t start_tsc;
+	int ret;
+
+	/* The keys are generated in both the single and bulk cases */
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < keys_to_add; i += burst) {
+		burst = RTE_MIN(keys_to_add - i,
+				(uint32_t)RTE_HASH_LOOKUP_BULK_MAX);
+		get_bulk_keys(i, burst, bulk_keys, key_ptrs);
+		for (j = 0; j < burst; j++)
+			data[j] = (void *)((uintptr_t)i + j);
+
+		if (bulk)
+			ret = rte_hash_add_key_bulk_data(handle, key_ptrs,
+							 data, burst, NULL);
+		else
+			for (ret = 0; ret < (int)burst; ret++)
+				if (rte_hash_add_key_data(handle,
+						key_ptrs[ret], data[ret]) < 0)
+					break;
+		if (ret != (int)burst) {
+			printf("Failed to add keys %u to %u\n", i, i + burst);
+			return -1;
+		}
+	}
+	*add_cycles = (rte_rdtsc() - start_tsc) / keys_to_add;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < keys_to_add; i += burst) {
+		burst = RTE_MIN(keys_to_add - i,
+				(uint32_t)RTE_HASH_LOOKUP_BULK_MAX);
+		get_bulk_keys(i, burst, bulk_keys, key_ptrs);
+
+		if (bulk)
+			ret = rte_hash_del_key_bulk(handle, key_ptrs, burst,
+						    NULL);
+		else
+			for (ret = 0; ret < (int)burst; ret++)
+				if (rte_hash_del_key(handle,
+						key_ptrs[ret]) < 0)
+					break;
+		if (ret != (int)burst) {
+			printf("Failed to delete keys %u to %u\n",
+				i, i + burst);
+			return -1;
+		}
+	}
+	*del_cycles = (rte_rdtsc() - start_tsc) / keys_to_add;
+
+	return 0;
+}
+
+/*
+ * Compare adding and deleting keys one by one and in bursts, in tables
+ * too large for the cache.
+ */
+static int
+bulk_add_del_perf_test(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_bulk",
+		.key_len = BULK_KEY_LEN,
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	uint64_t bulk_cycles[NUM_BULK_OPERATIONS];
+	struct rte_hash *handle;
+	uint32_t entries;
+	unsigned int bulk;
+
+	printf("\n\n *** Hash bulk add/delete performance test results ***\n");
+	printf("Results (in CPU cycles/operation)\n");
+	printf("\n%-18s%-18s%-18s%-18s%-18s\n",
+		"Entries", "Add", "Add_bulk", "Delete", "Delete_bulk");
+
+	for (entries = BULK_MIN_ENTRIES; entries <= BULK_MAX_ENTRIES;
+			entries <<= 2) {
+		params.entries = entries;
+		handle = rte_hash_create(&params);
+		if (handle == NULL) {
+			printf("%-18u%s\n", entries,
+				"not enough memory, skipped");
+			continue;
+		}
+
+		for (bulk = 0; bulk <= 1; bulk++) {
+			if (timed_bulk_add_del(handle, entries * ADD_PERCENT,
+					bulk, &bulk_cycles[BULK_ADD + bulk],
+					&bulk_cycles[BULK_DELETE + bulk]) < 0) {
+				rte_hash_free(handle);
+				return -1;
+			}
+		}
+
+		printf("%-18u", entries);
+		for (bulk = 0; bulk < NUM_BULK_OPERATIONS; bulk++)
+			printf("%-18"PRIu64, bulk_cycles[bulk]);
+		printf("\n");
+		rte_hash_free(handle);
+	}
+
+	return 0;
+}
+
 /* Control operation of performance testing of fbk hash. */
 #define LOAD_FACTOR 0.667	/* How full to make the hash table. */
 #define TEST_SIZE 1000000	/* How many operations to time. */
@@ -743,6 +885,9 @@ test_hash_perf(void)
 	if (run_all_tbl_perf_tests(1, 0, 1) < 0)
 		return -1;
 
+	if (bulk_add_del_perf_test() < 0)
+		return -1;
+
 	if (fbk_hash_perf_test() < 0)
 		return -1;
 
@@ -17,6 +17,7 @@
 #include <rte_per_lcore.h>
 #include <rte_launch.h>
 #include <rte_eal.h>
+#include <rte_errno.h>
 #include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_cycles.h>
@@ -816,6 +817,150 @@ test_zero_aligned_alloc(void)
 	return -1;
 }
 
+/*
+ * Objects served by the malloc cache must honour the rte_zmalloc() and
+ * rte_realloc() semantics, and be returned to the heap when flushed.
+ */
+static int
+test_malloc_cache(void)
+{
+	const size_t sz = 200;
+	char *p1, *p2;
+	size_t i;
+
+	if (rte_malloc_cache_enable() != 0) {
+		printf("%s: cannot enable malloc cache\n", __func__);
+		return -1;
+	}
+
+	p1 = rte_malloc(NULL, sz, 0);
+	if (p1 == NULL)
+		goto err_return;
+	memset(p1, 0xa5, sz);
+	rte_free(p1);
+
+	/* same size class, so the dirty object should come back */
+	p2 = rte_zmalloc(NULL, sz, 0);
+	if (p2 == NULL)
+		goto err_return;
+	for (i = 0; i < sz; i++) {
+		if (p2[i] != 0) {
+			printf("%s: cached object not zeroed\n", __func__);
+			rte_free(p2);
+			goto err_return;
+		}
+	}
+
+	/* growing the object must keep its content */
+	memset(p2, 0x5a, sz);
+	p1 = rte_realloc(p2, 8 * sz, 0);
+	if (p1 == NULL) {
+		rte_free(p2);
+		goto err_return;
+	}
+	for (i = 0; i < sz; i++) {
+		if ((unsigned char)p1[i] != 0x5a) {
+			printf("%s: realloc lost content\n", __func__);
+			rte_free(p1);
+			goto err_return;
+		}
+	}
+	rte_free(p1);
+
+	/* a double free must not put the object in the cache twice */
+	p1 = rte_malloc(NULL, sz, 0);
+	if (p1 == NULL)
+		goto err_return;
+	rte_free(p1);
+	rte_free(p1);
+	p1 = rte_malloc(NULL, sz, 0);
+	p2 = rte_malloc(NULL, sz, 0);
+	if (p1 != NULL && p1 == p2) {
+		printf("%s: double freed object cached twice\n", __func__);
+		rte_free(p1);
+		goto err_return;
+	}
+	rte_free(p1);
+	rte_free(p2);
+
+	/* objects not eligible for caching still work as usual */
+	p1 = rte_malloc(NULL, sz, 4096);
+	if (p1 == NULL || !rte_is_aligned(p1, 4096))
+		goto err_return;
+	rte_free(p1);
+
+	rte_malloc_cache_flush();
+	return rte_malloc_cache_disable();
+
+err_return:
+	rte_malloc_cache_disable();
+	return -1;
+}
+
+static int
+is_zeroed(const char *p, size_t sz)
+{
+	size_t i;
+
+	for (i = 0; i < sz; i++)
+		if (p[i] != 0)
+			return 0;
+	return 1;
+}
+
+static int
+test_malloc_lazy_zero(void)
+{
+	const size_t sz = 1 << 20;
+	char *p;
+
+	if (rte_malloc_lazy_zero_enable() != 0) {
+		if (rte_errno == ENOTSUP) {
+			printf("%s: lazy zeroing not supported, skipping\n",
+					__func__);
+			return 0;
+		}
+		return -1;
+	}
+
+	p = rte_malloc(NULL, sz, 0);
+	if (p == NULL)
+		goto err_return;
+	memset(p, 0xa5, sz);
+	rte_free(p);
+
+	/* freed memory was left dirty, zmalloc must clear it */
+	p = rte_zmalloc(NULL, sz, 0);
+	if (p == NULL)
+		goto err_return;
+	if (!is_zeroed(p, sz)) {
+		printf("%s: dirty memory not zeroed by rte_zmalloc\n", __func__);
+		rte_free(p);
+		goto err_return;
+	}
+	memset(p, 0x5a, sz);
+	rte_free(p);
+
+	/* once scrubbed, free memory is clean even for plain rte_malloc */
+	while (rte_malloc_heap_scrub(SOCKET_ID_ANY, sz / 16) != 0)
+		;
+	p = rte_malloc(NULL, sz, 0);
+	if (p == NULL)
+		goto err_return;
+	if (!is_zeroed(p, sz)) {
+		printf("%s: dirty memory not zeroed by scrubber\n", __func__);
+		rte_free(p);
+		goto err_return;
+	}
+	rte_free(p);
+
+	return rte_malloc_lazy_zero_disable();
+
+err_return:
+	rte_malloc_lazy_zero_disable();
+	return -1;
+}
+
 static int
 test_malloc_bad_params(void)
 {
@@ -1009,6 +1154,20 @@ test_malloc(void)
 	}
 	else printf("test_realloc() passed\n");
 
+	if (test_malloc_cache() < 0) {
+		printf("test_malloc_cache() failed\n");
+		return -1;
+	}
+	else
+		printf("test_malloc_cache() passed\n");
+
+	if (test_malloc_lazy_zero() < 0) {
+		printf("test_malloc_lazy_zero() failed\n");
+		return -1;
+	}
+	else
+		printf("test_malloc_lazy_zero() passed\n");
+
 	/*----------------------------*/
 	RTE_LCORE_FOREACH_WORKER(lcore_id) {
 		rte_eal_remote_launch(test_align_overlap_per_lcore, NULL, lcore_id);
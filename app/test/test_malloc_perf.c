@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <rte_atomic.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+
+#include "test.h"
+
+#define MAX_BURST 64
+#define ITERATIONS 100000
+
+/*
+ * Object sizes and burst sizes, marked volatile so they aren't treated as
+ * compile-time constants.
+ */
+static volatile size_t obj_sizes[] = {64, 256, 1024, 4096};
+static volatile unsigned int bulk_sizes[] = {1, 8, MAX_BURST};
+
+static rte_atomic32_t lcore_barrier;
+
+struct thread_args {
+	size_t obj_sz;
+	unsigned int bulk_sz;
+	int failed;
+	double avg;
+};
+
+/*
+ * Allocate and free bursts of objects, and compute the average cycle cost
+ * of one rte_malloc()/rte_free() pair.
+ */
+static int
+malloc_free_loop(void *args)
+{
+	struct thread_args *t = args;
+	const unsigned int bulk_sz = t->bulk_sz;
+	const size_t obj_sz = t->obj_sz;
+	void *objs[MAX_BURST];
+	uint64_t start;
+	unsigned int i, j;
+
+	t->failed = 0;
+
+	rte_atomic32_dec(&lcore_barrier);
+	while (rte_atomic32_read(&lcore_barrier) != 0)
+		rte_pause();
+
+	start = rte_rdtsc();
+
+	for (i = 0; i < ITERATIONS; i++) {
+		for (j = 0; j < bulk_sz; j++) {
+			objs[j] = rte_malloc(NULL, obj_sz, 0);
+			if (objs[j] == NULL)
+				break;
+		}
+		if (j != bulk_sz)
+			t->failed = 1;
+		while (j != 0)
+			rte_free(objs[--j]);
+		if (t->failed)
+			break;
+	}
+
+	/* nothing to average if the first bulk already failed */
+	t->avg = 0;
+	if (i != 0)
+		t->avg = (double)(rte_rdtsc() - start) / ((double)i * bulk_sz);
+
+	/* give the cached objects back before the next run */
+	rte_malloc_cache_flush();
+
+	return 0;
+}
+
+/* Run malloc_free_loop() simultaneously on all lcores. */
+static int
+run_on_all_cores(size_t obj_sz, unsigned int bulk_sz, double *avg)
+{
+	struct thread_args args[RTE_MAX_LCORE];
+	unsigned int lcore_id;
+	int failed;
+
+	rte_atomic32_set(&lcore_barrier, rte_lcore_count());
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		args[lcore_id].obj_sz = obj_sz;
+		args[lcore_id].bulk_sz = bulk_sz;
+		if (rte_eal_remote_launch(malloc_free_loop, &args[lcore_id],
+				lcore_id) != 0)
+			rte_panic("Failed to launch lcore %u\n", lcore_id);
+	}
+
+	lcore_id = rte_lcore_id();
+	args[lcore_id].obj_sz = obj_sz;
+	args[lcore_id].bulk_sz = bulk_sz;
+	malloc_free_loop(&args[lcore_id]);
+
+	rte_eal_mp_wait_lcore();
+
+	*avg = 0;
+	failed = 0;
+	RTE_LCORE_FOREACH(lcore_id) {
+		*avg += args[lcore_id].avg;
+		failed |= args[lcore_id].failed;
+	}
+	*avg /= rte_lcore_count();
+
+	return failed ? -1 : 0;
+}
+
+static int
+run_all_sizes(void)
+{
+	unsigned int i, j;
+	double avg;
+
+	for (i = 0; i < RTE_DIM(obj_sizes); i++) {
+		for (j = 0; j < RTE_DIM(bulk_sizes); j++) {
+			if (run_on_all_cores(obj_sizes[i], bulk_sizes[j],
+					&avg) != 0) {
+				printf("Allocation failed (size: %zu, burst: %u)\n",
+				       obj_sizes[i], bulk_sizes[j]);
+				return -1;
+			}
+			printf("Average cycles per malloc/free (size: %zu, burst: %u): %.2F\n",
+			       obj_sizes[i], bulk_sizes[j], avg);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Measure the cost of freeing a large block, which depends on whether freed
+ * memory is cleared right away or lazily.
+ */
+static void
+free_large(const char *mode)
+{
+	static const size_t sizes[] = {1 << 20, 16 << 20, 64 << 20};
+	uint64_t start;
+	unsigned int i;
+	void *p;
+
+	for (i = 0; i < RTE_DIM(sizes); i++) {
+		p = rte_malloc(NULL, sizes[i], 0);
+		if (p == NULL) {
+			printf("Cannot allocate %zu bytes, skipping\n", sizes[i]);
+			continue;
+		}
+		memset(p, 0xa5, sizes[i]);
+
+		start = rte_rdtsc();
+		rte_free(p);
+		printf("Cycles to free %zu bytes (%s): %"PRIu64"\n",
+		       sizes[i], mode, rte_rdtsc() - start);
+	}
+}
+
+static int
+test_malloc_perf(void)
+{
+	int ret;
+
+	rte_atomic32_init(&lcore_barrier);
+
+	printf("\n### Testing on %u lcores without malloc cache ###\n",
+	       rte_lcore_count());
+	if (run_all_sizes() != 0)
+		return -1;
+
+	if (rte_malloc_cache_enable() != 0) {
+		printf("Cannot enable malloc cache\n");
+		return -1;
+	}
+
+	printf("\n### Testing on %u lcores with malloc cache ###\n",
+	       rte_lcore_count());
+	ret = run_all_sizes();
+
+	rte_malloc_cache_disable();
+	if (ret != 0)
+		return ret;
+
+	printf("\n### Freeing large blocks ###\n");
+	free_large("zero on free");
+	if (rte_malloc_lazy_zero_enable() == 0) {
+		free_large("lazy zeroing");
+		rte_malloc_lazy_zero_disable();
+		while (rte_malloc_heap_scrub(SOCKET_ID_ANY, 1 << 20) != 0)
+			;
+	}
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(malloc_perf_autotest, test_malloc_perf);
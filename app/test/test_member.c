@@ -665,6 +665,162 @@ test_member_loadfactor(void)
 	return 0;
 }
 
+/*
+ * Sequence of operations for cuckoo filter
+ *
+ *  - fill the filter with generated keys
+ *  - lookup all keys: no false negative
+ *  - delete all keys: lookup and delete miss
+ *
+ */
+static int
+test_member_cf(void)
+{
+	struct rte_member_setsum *setsum_cf;
+	member_set_t set_id, set_ids[RTE_MEMBER_LOOKUP_BULK_MAX];
+	const void *key_array[RTE_MEMBER_LOOKUP_BULK_MAX];
+	unsigned int i, j, false_hit = 0;
+	int ret;
+
+	params.name = "test_member_cf";
+	params.type = RTE_MEMBER_TYPE_CF;
+	params.key_len = KEY_SIZE;
+	params.num_keys = MAX_ENTRIES;
+	setsum_cf = rte_member_create(&params);
+	TEST_ASSERT(setsum_cf != NULL, "Creation of cuckoo filter fail");
+
+	TEST_ASSERT(rte_member_add(setsum_cf, &generated_keys[0], 2) ==
+			-EINVAL, "cuckoo filter add with set id 2 should fail");
+
+	for (i = 0; i < MAX_ENTRIES; i++) {
+		ret = rte_member_add(setsum_cf, &generated_keys[i], 1);
+		if (ret < 0) {
+			rte_member_free(setsum_cf);
+			printf("cuckoo filter full with %u keys\n", i);
+			return -1;
+		}
+	}
+
+	for (i = 0; i < MAX_ENTRIES; i += RTE_MEMBER_LOOKUP_BULK_MAX) {
+		for (j = 0; j < RTE_MEMBER_LOOKUP_BULK_MAX; j++)
+			key_array[j] = &generated_keys[i + j];
+		ret = rte_member_lookup_bulk(setsum_cf, key_array,
+				RTE_MEMBER_LOOKUP_BULK_MAX, set_ids);
+		if (ret != RTE_MEMBER_LOOKUP_BULK_MAX) {
+			rte_member_free(setsum_cf);
+			printf("cuckoo filter bulk lookup false negative\n");
+			return -1;
+		}
+		for (j = 0; j < RTE_MEMBER_LOOKUP_BULK_MAX; j++) {
+			if (set_ids[j] != 1) {
+				rte_member_free(setsum_cf);
+				printf("cuckoo filter bulk lookup set error\n");
+				return -1;
+			}
+		}
+	}
+
+	for (i = 0; i < MAX_ENTRIES; i++) {
+		if (rte_member_delete(setsum_cf, &generated_keys[i], 1) < 0) {
+			rte_member_free(setsum_cf);
+			printf("cuckoo filter delete error\n");
+			return -1;
+		}
+	}
+
+	/* The filter is empty, nothing can be found */
+	for (i = 0; i < MAX_ENTRIES; i++)
+		false_hit += rte_member_lookup(setsum_cf, &generated_keys[i],
+				&set_id);
+	ret = rte_member_delete(setsum_cf, &generated_keys[0], 1);
+	rte_member_free(setsum_cf);
+
+	TEST_ASSERT(false_hit == 0, "cuckoo filter lookup after delete");
+	TEST_ASSERT(ret == -ENOENT, "cuckoo filter delete miss error");
+
+	printf("cuckoo filter test success\n");
+	return 0;
+}
+
+/*
+ * Sequence of operations for sketch
+ *
+ *  - add count to keys, single and bulk
+ *  - query the counts: never less than added
+ *  - report heavy hitters: sorted by count
+ *  - reset: counts are 0
+ *
+ */
+static int
+test_member_sketch(void)
+{
+	struct rte_member_setsum *setsum_sketch;
+	struct rte_member_sketch_parameters sketch_params = {
+		.error_rate = 0.001,
+		.top_k = 2,
+	};
+	const void *key_array[NUM_SAMPLES];
+	const void *hh_keys[NUM_SAMPLES];
+	uint64_t counts[NUM_SAMPLES], hh_counts[NUM_SAMPLES];
+	uint64_t count;
+	member_set_t set_id;
+	int i, ret;
+
+	params.name = "test_member_sketch";
+	params.type = RTE_MEMBER_TYPE_SKETCH;
+	params.key_len = sizeof(struct flow_key);
+	params.false_positive_rate = 0.01;
+	TEST_ASSERT(rte_member_create(&params) == NULL,
+			"Creation of sketch without its parameters succeeded");
+	setsum_sketch = rte_member_sketch_create(&params, &sketch_params);
+	TEST_ASSERT(setsum_sketch != NULL, "Creation of sketch fail");
+
+	/* Key i is counted (i + 1) * 100 in total */
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		key_array[i] = &keys[i];
+		counts[i] = (i + 1) * 50;
+		rte_member_add_count(setsum_sketch, &keys[i], counts[i]);
+	}
+	rte_member_add_count_bulk(setsum_sketch, key_array, NUM_SAMPLES,
+			counts);
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_query_count(setsum_sketch, &keys[i], &count);
+		if (ret != 1 || count < (uint64_t)(i + 1) * 100) {
+			rte_member_free(setsum_sketch);
+			printf("sketch query count error\n");
+			return -1;
+		}
+	}
+
+	ret = rte_member_report_heavyhitter(setsum_sketch, hh_keys, hh_counts);
+	if (ret != 2 || memcmp(hh_keys[0], &keys[4], sizeof(keys[4])) != 0 ||
+			memcmp(hh_keys[1], &keys[3], sizeof(keys[3])) != 0 ||
+			hh_counts[0] < hh_counts[1]) {
+		rte_member_free(setsum_sketch);
+		printf("sketch heavy hitter report error\n");
+		return -1;
+	}
+
+	/* Sketch has no set id */
+	if (rte_member_lookup(setsum_sketch, &keys[0], &set_id) != -EINVAL ||
+			rte_member_delete(setsum_sketch, &keys[0], 1) !=
+			-EINVAL) {
+		rte_member_free(setsum_sketch);
+		printf("sketch lookup and delete should fail\n");
+		return -1;
+	}
+
+	rte_member_reset(setsum_sketch);
+	ret = rte_member_query_count_bulk(setsum_sketch, key_array,
+			NUM_SAMPLES, counts);
+	rte_member_free(setsum_sketch);
+	TEST_ASSERT(ret == 0, "sketch reset error");
+
+	printf("sketch test success\n");
+	return 0;
+}
+
 static void
 perform_free(void)
 {
@@ -707,6 +863,14 @@ test_member(void)
 		rte_member_free(setsum_cache);
 		return -1;
 	}
+	if (test_member_cf() < 0) {
+		perform_free();
+		return -1;
+	}
+	if (test_member_sketch() < 0) {
+		perform_free();
+		return -1;
+	}
 
 	perform_free();
 	return 0;
@@ -24,6 +24,11 @@
 #define VBF_SET_CNT 16
 #define BURST_SIZE 64
 #define VBF_FALSE_RATE 0.03
+#define SKETCH_KEYSIZE 13 /* IPv4 5-tuple, unpadded */
+#define SKETCH_STREAM_LEN (KEYS_TO_ADD * 2)
+#define SKETCH_ERROR_RATE 0.0001
+#define SKETCH_FALSE_RATE 0.01
+#define SKETCH_TOP_K 16
 
 static unsigned int test_socket_id;
 
@@ -31,6 +36,7 @@ enum sstype {
 	HT = 0,
 	CACHE,
 	VBF,
+	CF,
 	NUM_TYPE
 };
 
@@ -140,6 +146,7 @@ setup_keys_and_data(struct member_perf_params *params, unsigned int cycle,
 
 		data[HT][i] = data[CACHE][i] = (rte_rand() & 0x7FFE) + 1;
 		data[VBF][i] = rte_rand() % VBF_SET_CNT + 1;
+		data[CF][i] = 1;
 	}
 
 	/* Remove duplicates from the keys array */
@@ -197,6 +204,13 @@ setup_keys_and_data(struct member_perf_params *params, unsigned int cycle,
 	params->setsum[VBF] = rte_member_create(&member_params);
 	if (params->setsum[VBF] == NULL)
 		fprintf(stderr, "VBF create fail\n");
+
+	member_params.name = "test_member_cf";
+	member_params.type = RTE_MEMBER_TYPE_CF;
+	member_params.num_keys = entry_cnt;
+	params->setsum[CF] = rte_member_create(&member_params);
+	if (params->setsum[CF] == NULL)
+		fprintf(stderr, "CF create fail\n");
 	for (i = 0; i < NUM_TYPE; i++) {
 		if (params->setsum[i] == NULL)
 			return -1;
@@ -251,8 +265,10 @@ timed_lookups(struct member_perf_params *params, int type)
 				printf("lookup wrong internally");
 				return -1;
 			}
-			if (type == HT && result == RTE_MEMBER_NO_MATCH) {
-				printf("HT mode shouldn't have false negative");
+			if ((type == HT || type == CF) &&
+					result == RTE_MEMBER_NO_MATCH) {
+				printf("HT and CF mode shouldn't have "
+					"false negative");
 				return -1;
 			}
 			if (result != data[type][j])
@@ -612,6 +628,158 @@ run_all_tbl_perf_tests(void)
 	return 0;
 }
 
+/* Keys are counted with a skewed distribution, a few keys are heavy hitters */
+static uint32_t sketch_stream[SKETCH_STREAM_LEN];
+static uint64_t sketch_real[KEYS_TO_ADD];
+
+static int
+real_count_compare(const void *a, const void *b)
+{
+	uint64_t ca = sketch_real[*(const uint32_t *)a];
+	uint64_t cb = sketch_real[*(const uint32_t *)b];
+
+	return (ca < cb) - (ca > cb);
+}
+
+static int
+run_sketch_perf_tests(void)
+{
+	unsigned int i, j, k;
+	uint64_t start_tsc, add_cycles, add_bulk_cycles;
+	uint64_t query_cycles, query_bulk_cycles;
+	uint64_t count, counts[BURST_SIZE];
+	uint64_t hh_counts[SKETCH_TOP_K];
+	const void *hh_keys[SKETCH_TOP_K];
+	const void *keys_burst[BURST_SIZE];
+	static uint32_t order[KEYS_TO_ADD];
+	uint64_t overestimate = 0;
+	unsigned int hh_hits = 0;
+	struct rte_member_sketch_parameters sketch_params;
+	struct rte_member_setsum *setsum;
+	int ret;
+
+	/* Unique keys, the key index is part of the key */
+	for (i = 0; i < KEYS_TO_ADD; i++) {
+		for (j = 0; j < SKETCH_KEYSIZE; j++)
+			keys[i][j] = rte_rand() & 0xFF;
+		memcpy(keys[i], &i, sizeof(i));
+		sketch_real[i] = 0;
+		order[i] = i;
+	}
+
+	/* Zipf like stream, smaller key indexes are much more frequent */
+	for (i = 0; i < SKETCH_STREAM_LEN; i++) {
+		sketch_stream[i] = (rte_rand() % KEYS_TO_ADD) >>
+				(rte_rand() % 16);
+		sketch_real[sketch_stream[i]]++;
+	}
+
+	member_params.name = "test_member_sketch";
+	member_params.type = RTE_MEMBER_TYPE_SKETCH;
+	member_params.key_len = SKETCH_KEYSIZE;
+	member_params.false_positive_rate = SKETCH_FALSE_RATE;
+	member_params.socket_id = test_socket_id;
+	sketch_params.error_rate = SKETCH_ERROR_RATE;
+	sketch_params.top_k = SKETCH_TOP_K;
+	setsum = rte_member_sketch_create(&member_params, &sketch_params);
+	if (setsum == NULL) {
+		printf("sketch create fail\n");
+		return -1;
+	}
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < SKETCH_STREAM_LEN; i++) {
+		ret = rte_member_add_count(setsum, keys[sketch_stream[i]], 1);
+		if (ret < 0) {
+			printf("Error %d in rte_member_add_count\n", ret);
+			goto error;
+		}
+	}
+	add_cycles = (rte_rdtsc() - start_tsc) / SKETCH_STREAM_LEN;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < KEYS_TO_ADD; i++) {
+		ret = rte_member_query_count(setsum, keys[i], &count);
+		if (ret < 0 || count < sketch_real[i]) {
+			printf("sketch query count is wrong\n");
+			goto error;
+		}
+		overestimate += count - sketch_real[i];
+	}
+	query_cycles = (rte_rdtsc() - start_tsc) / KEYS_TO_ADD;
+
+	/* Heavy hitters accuracy, compare with the real top-k keys */
+	qsort(order, KEYS_TO_ADD, sizeof(order[0]), real_count_compare);
+	ret = rte_member_report_heavyhitter(setsum, hh_keys, hh_counts);
+	if (ret < 0 || ret > SKETCH_TOP_K) {
+		printf("sketch report heavy hitters is wrong\n");
+		goto error;
+	}
+	for (k = 0; k < (unsigned int)ret; k++) {
+		for (j = 0; j < SKETCH_TOP_K; j++) {
+			if (memcmp(hh_keys[k], keys[order[j]],
+					SKETCH_KEYSIZE) == 0) {
+				hh_hits++;
+				break;
+			}
+		}
+	}
+
+	rte_member_reset(setsum);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < SKETCH_STREAM_LEN / BURST_SIZE; i++) {
+		for (k = 0; k < BURST_SIZE; k++)
+			keys_burst[k] = keys[sketch_stream[i * BURST_SIZE + k]];
+		ret = rte_member_add_count_bulk(setsum, keys_burst,
+				BURST_SIZE, NULL);
+		if (ret < 0) {
+			printf("Error %d in rte_member_add_count_bulk\n", ret);
+			goto error;
+		}
+	}
+	add_bulk_cycles = (rte_rdtsc() - start_tsc) / SKETCH_STREAM_LEN;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < KEYS_TO_ADD / BURST_SIZE; i++) {
+		for (k = 0; k < BURST_SIZE; k++)
+			keys_burst[k] = keys[i * BURST_SIZE + k];
+		ret = rte_member_query_count_bulk(setsum, keys_burst,
+				BURST_SIZE, counts);
+		if (ret < 0) {
+			printf("sketch query count bulk is wrong\n");
+			goto error;
+		}
+		for (k = 0; k < BURST_SIZE; k++) {
+			if (counts[k] < sketch_real[i * BURST_SIZE + k]) {
+				printf("sketch count bulk underestimated\n");
+				goto error;
+			}
+		}
+	}
+	query_bulk_cycles = (rte_rdtsc() - start_tsc) / KEYS_TO_ADD;
+
+	rte_member_free(setsum);
+
+	printf("\nSketch results (in CPU cycles/operation)\n");
+	printf("-----------------------------------\n");
+	printf("\n%-18s%-18s%-18s%-18s%-18s\n",
+			"Keysize", "Add_count", "Add_count_bulk",
+			"Query_count", "Query_count_bulk");
+	printf("%-18d%-18"PRIu64"%-18"PRIu64"%-18"PRIu64"%-18"PRIu64"\n",
+			SKETCH_KEYSIZE, add_cycles, add_bulk_cycles,
+			query_cycles, query_bulk_cycles);
+	printf("\nAverage overestimate per key: %f (total count %u)\n",
+			(double)overestimate / KEYS_TO_ADD, SKETCH_STREAM_LEN);
+	printf("Real top-%u keys found in reported heavy hitters: %u\n",
+			SKETCH_TOP_K, hh_hits);
+	return 0;
+
+error:
+	rte_member_free(setsum);
+	return -1;
+}
+
 static int
 test_member_perf(void)
 {
@@ -619,6 +787,9 @@ test_member_perf(void)
 	if (run_all_tbl_perf_tests() < 0)
 		return -1;
 
+	if (run_sketch_perf_tests() < 0)
+		return -1;
+
 	return 0;
 }
 
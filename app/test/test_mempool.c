@@ -27,6 +27,7 @@
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
 #include <rte_mbuf.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test.h"
 
@@ -448,6 +449,190 @@ test_mempool_same_name_twice_creation(void)
 	return 0;
 }
 
+/*
+ * RCU deferred put: the objects only come back to the mempool once the
+ * reader reported a quiescent state after they were put.
+ */
+static int
+test_mempool_rcu(void)
+{
+	struct rte_mempool_rcu_config cfg = {0};
+	struct rte_rcu_qsbr *v = NULL;
+	struct rte_mempool *mp;
+	void *objs[40];
+	unsigned int avail, i;
+	size_t sz;
+	int ret = -1;
+
+	mp = rte_mempool_create("test_mempool_rcu", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, 32, 0,
+		NULL, NULL, NULL, NULL, SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		RET_ERR();
+
+	sz = rte_rcu_qsbr_get_memsize(1);
+	v = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (v == NULL || rte_rcu_qsbr_init(v, 1) != 0)
+		GOTO_ERR(ret, out);
+	rte_rcu_qsbr_thread_register(v, 0);
+	rte_rcu_qsbr_thread_online(v, 0);
+
+	if (rte_mempool_put_rcu(mp, NULL, v) != -EINVAL)
+		GOTO_ERR(ret, out);
+	cfg.v = v;
+	if (rte_mempool_rcu_qsbr_add(mp, &cfg) != 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_rcu_qsbr_add(mp, &cfg) != -EEXIST)
+		GOTO_ERR(ret, out);
+
+	avail = rte_mempool_avail_count(mp);
+	if (rte_mempool_get_bulk(mp, objs, RTE_DIM(objs)) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_put_rcu(mp, objs[0], NULL) != -EINVAL)
+		GOTO_ERR(ret, out);
+
+	/* one full batch is queued, the remaining objects wait in a batch */
+	for (i = 0; i < RTE_DIM(objs); i++)
+		if (rte_mempool_put_rcu(mp, objs[i], v) != 0)
+			GOTO_ERR(ret, out);
+	if (rte_mempool_rcu_reclaim(mp) != 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_avail_count(mp) != avail - RTE_DIM(objs))
+		GOTO_ERR(ret, out);
+
+	/* grace period is over */
+	rte_rcu_qsbr_quiescent(v, 0);
+	if (rte_mempool_rcu_reclaim(mp) != 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_avail_count(mp) != avail)
+		GOTO_ERR(ret, out);
+
+	rte_mempool_dump(stdout, mp);
+	ret = 0;
+
+out:
+	if (v != NULL) {
+		rte_rcu_qsbr_thread_offline(v, 0);
+		rte_rcu_qsbr_thread_unregister(v, 0);
+	}
+	rte_mempool_free(mp);
+	rte_free(v);
+	return ret;
+}
+
+/*
+ * RCU deferred put: freeing the mempool while objects wait for a grace
+ * period reclaims them and releases the defer queue, so a mempool with
+ * the same name can use RCU again.
+ */
+static int
+test_mempool_rcu_free(void)
+{
+	struct rte_mempool_rcu_config cfg = {0};
+	struct rte_rcu_qsbr *v = NULL;
+	struct rte_mempool *mp = NULL;
+	void *objs[RTE_MEMPOOL_RCU_BATCH_SIZE];
+	unsigned int i, loop;
+	size_t sz;
+	int ret = -1;
+
+	sz = rte_rcu_qsbr_get_memsize(1);
+	v = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (v == NULL || rte_rcu_qsbr_init(v, 1) != 0)
+		GOTO_ERR(ret, out);
+	cfg.v = v;
+
+	for (loop = 0; loop != 2; loop++) {
+		mp = rte_mempool_create("test_mempool_rcu_free", MEMPOOL_SIZE,
+			MEMPOOL_ELT_SIZE, 0, 0,
+			NULL, NULL, NULL, NULL, SOCKET_ID_ANY, 0);
+		if (mp == NULL)
+			GOTO_ERR(ret, out);
+		if (rte_mempool_rcu_qsbr_add(mp, &cfg) != 0)
+			GOTO_ERR(ret, out);
+
+		/* queue a full batch, the reader did not report since */
+		rte_rcu_qsbr_thread_register(v, 0);
+		rte_rcu_qsbr_thread_online(v, 0);
+		if (rte_mempool_get_bulk(mp, objs, RTE_DIM(objs)) < 0)
+			GOTO_ERR(ret, out);
+		for (i = 0; i < RTE_DIM(objs); i++)
+			if (rte_mempool_put_rcu(mp, objs[i], v) != 0)
+				GOTO_ERR(ret, out);
+		if (rte_mempool_rcu_reclaim(mp) != 0)
+			GOTO_ERR(ret, out);
+		if (rte_mempool_avail_count(mp) != MEMPOOL_SIZE - RTE_DIM(objs))
+			GOTO_ERR(ret, out);
+		rte_rcu_qsbr_thread_offline(v, 0);
+		rte_rcu_qsbr_thread_unregister(v, 0);
+
+		rte_mempool_free(mp);
+		mp = NULL;
+	}
+	ret = 0;
+
+out:
+	rte_mempool_free(mp);
+	rte_free(v);
+	return ret;
+}
+
+/*
+ * Adaptive cache: a lcore which only gets objects makes its cache grow,
+ * a lcore which only puts objects back makes it shrink again.
+ */
+static int
+test_mempool_cache_adaptive(void)
+{
+	struct rte_mempool_cache_adapt *ad;
+	struct rte_mempool_cache *cache;
+	struct rte_mempool *mp;
+	void **objs;
+	unsigned int i, n, grown;
+	int ret = -1;
+
+	n = 4096;
+	objs = malloc(n * sizeof(void *));
+	if (objs == NULL)
+		RET_ERR();
+
+	mp = rte_mempool_create("test_mempool_adaptive", 2 * n - 1, 64, 32, 0,
+		NULL, NULL, NULL, NULL, SOCKET_ID_ANY,
+		MEMPOOL_F_CACHE_ADAPTIVE);
+	if (mp == NULL)
+		GOTO_ERR(ret, out);
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache == NULL || !cache->adaptive || cache->size != 32)
+		GOTO_ERR(ret, out);
+	ad = &mp->cache_adapt[rte_lcore_id()];
+
+	/* consumer: the cache refills more objects at once */
+	for (i = 0; i < n; i += 8)
+		if (rte_mempool_generic_get(mp, &objs[i], 8, cache) < 0)
+			GOTO_ERR(ret, out);
+	grown = cache->size;
+	if (grown <= 32 || ad->stats.resize == 0)
+		GOTO_ERR(ret, out);
+
+	/* producer: the cache keeps fewer objects */
+	for (i = 0; i < n; i += 8)
+		rte_mempool_generic_put(mp, &objs[i], 8, cache);
+	if (cache->size >= grown)
+		GOTO_ERR(ret, out);
+	if (cache->flushthresh < cache->size ||
+			cache->flushthresh > 2 * ad->max_size)
+		GOTO_ERR(ret, out);
+
+	rte_mempool_dump(stdout, mp);
+	ret = 0;
+
+out:
+	rte_mempool_free(mp);
+	free(objs);
+	return ret;
+}
+
 static void
 walk_cb(struct rte_mempool *mp, void *userdata __rte_unused)
 {
@@ -643,6 +828,15 @@ test_mempool(void)
 	if (test_mempool_same_name_twice_creation() < 0)
 		GOTO_ERR(ret, err);
 
+	if (test_mempool_rcu() < 0)
+		GOTO_ERR(ret, err);
+
+	if (test_mempool_rcu_free() < 0)
+		GOTO_ERR(ret, err);
+
+	if (test_mempool_cache_adaptive() < 0)
+		GOTO_ERR(ret, err);
+
 	/* test the stack handler */
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		GOTO_ERR(ret, err);
@@ -22,10 +22,12 @@
 #include <rte_lcore.h>
 #include <rte_atomic.h>
 #include <rte_branch_prediction.h>
+#include <rte_errno.h>
 #include <rte_mempool.h>
 #include <rte_spinlock.h>
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
+#include <rte_ring.h>
 
 #include "test.h"
 
@@ -61,6 +63,11 @@
  *
  *      - 32
  *      - 128
+ *
+ *    A last test splits the work between a consumer core, which gets
+ *    objects and passes them to a producer core through a ring, and the
+ *    producer core, which puts them back. It compares the number of pool
+ *    accesses with the default per-lcore cache and with the adaptive one.
  */
 
 #define N 65536
@@ -279,6 +286,174 @@ do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+/* number of objects exchanged in the producer/consumer test */
+#define PC_N_OBJS (1 << 22)
+#define PC_BULK 32
+#define PC_CACHE_SIZE 64
+#define PC_POOL_SIZE 8191
+#define PC_RING_SIZE 2048
+
+static rte_atomic64_t pc_enq_ops;
+static rte_atomic64_t pc_deq_ops;
+
+/* ring based handler counting the accesses to the pool */
+static int
+pc_count_alloc(struct rte_mempool *mp)
+{
+	char rg_name[RTE_RING_NAMESIZE];
+	struct rte_ring *r;
+
+	snprintf(rg_name, sizeof(rg_name), RTE_MEMPOOL_MZ_FORMAT, mp->name);
+	r = rte_ring_create(rg_name, rte_align32pow2(mp->size + 1),
+			mp->socket_id, 0);
+	if (r == NULL)
+		return -rte_errno;
+	mp->pool_data = r;
+	return 0;
+}
+
+static void
+pc_count_free(struct rte_mempool *mp)
+{
+	rte_ring_free(mp->pool_data);
+}
+
+static int
+pc_count_enqueue(struct rte_mempool *mp, void * const *obj_table,
+		unsigned int n)
+{
+	rte_atomic64_inc(&pc_enq_ops);
+	return rte_ring_mp_enqueue_bulk(mp->pool_data,
+			obj_table, n, NULL) == 0 ? -ENOBUFS : 0;
+}
+
+static int
+pc_count_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	rte_atomic64_inc(&pc_deq_ops);
+	return rte_ring_mc_dequeue_bulk(mp->pool_data,
+			obj_table, n, NULL) == 0 ? -ENOBUFS : 0;
+}
+
+static unsigned int
+pc_count_get_count(const struct rte_mempool *mp)
+{
+	return rte_ring_count(mp->pool_data);
+}
+
+static const struct rte_mempool_ops pc_count_ops = {
+	.name = "perf_test_count",
+	.alloc = pc_count_alloc,
+	.free = pc_count_free,
+	.enqueue = pc_count_enqueue,
+	.dequeue = pc_count_dequeue,
+	.get_count = pc_count_get_count,
+};
+
+MEMPOOL_REGISTER_OPS(pc_count_ops);
+
+struct pc_args {
+	struct rte_mempool *mp;
+	struct rte_ring *r;
+};
+
+/* put back all the objects received from the consumer */
+static int
+pc_producer(void *arg)
+{
+	struct pc_args *args = arg;
+	void *obj_table[PC_BULK];
+	unsigned int n, count = 0;
+
+	while (rte_atomic32_read(&synchro) == 0)
+		;
+
+	while (count < PC_N_OBJS) {
+		n = rte_ring_sc_dequeue_burst(args->r, obj_table, PC_BULK,
+				NULL);
+		if (n == 0)
+			continue;
+		rte_mempool_put_bulk(args->mp, obj_table, n);
+		count += n;
+	}
+
+	return 0;
+}
+
+/* get objects from the pool and hand them over to the producer */
+static int
+pc_consumer(struct pc_args *args)
+{
+	void *obj_table[PC_BULK];
+	unsigned int count = 0;
+
+	while (count < PC_N_OBJS) {
+		if (rte_mempool_get_bulk(args->mp, obj_table, PC_BULK) < 0)
+			continue;
+		while (rte_ring_sp_enqueue_bulk(args->r, obj_table, PC_BULK,
+				NULL) == 0)
+			;
+		count += PC_BULK;
+	}
+
+	return 0;
+}
+
+static int
+do_pc_mempool_test(const char *name, unsigned int flags)
+{
+	struct rte_mempool *mp;
+	struct rte_ring *r = NULL;
+	struct pc_args args;
+	unsigned int lcore_id;
+	uint64_t start, cycles;
+	int ret = -1;
+
+	mp = rte_mempool_create_empty(name, PC_POOL_SIZE, MEMPOOL_ELT_SIZE,
+			PC_CACHE_SIZE, 0, SOCKET_ID_ANY, flags);
+	if (mp == NULL)
+		RET_ERR();
+	if (rte_mempool_set_ops_byname(mp, "perf_test_count", NULL) < 0)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_populate_default(mp) < 0)
+		GOTO_ERR(ret, out);
+
+	r = rte_ring_create("perf_test_pc_ring", PC_RING_SIZE, SOCKET_ID_ANY,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (r == NULL)
+		GOTO_ERR(ret, out);
+
+	args.mp = mp;
+	args.r = r;
+	rte_atomic32_set(&synchro, 0);
+	rte_atomic64_set(&pc_enq_ops, 0);
+	rte_atomic64_set(&pc_deq_ops, 0);
+
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+	rte_eal_remote_launch(pc_producer, &args, lcore_id);
+
+	start = rte_rdtsc();
+	rte_atomic32_set(&synchro, 1);
+	pc_consumer(&args);
+	if (rte_eal_wait_lcore(lcore_id) < 0)
+		GOTO_ERR(ret, out);
+	cycles = rte_rdtsc() - start;
+
+	printf("mempool_autotest producer/consumer %s: cycles_per_obj=%.2F "
+	       "pool_enq_ops=%" PRId64 " pool_deq_ops=%" PRId64 "\n",
+	       (flags & MEMPOOL_F_CACHE_ADAPTIVE) ? "adaptive cache" :
+	       "default cache", (double)cycles / PC_N_OBJS,
+	       rte_atomic64_read(&pc_enq_ops), rte_atomic64_read(&pc_deq_ops));
+	if (flags & MEMPOOL_F_CACHE_ADAPTIVE)
+		rte_mempool_dump(stdout, mp);
+
+	ret = 0;
+out:
+	rte_ring_free(r);
+	rte_mempool_free(mp);
+	return ret;
+}
+
 static int
 test_mempool_perf(void)
 {
@@ -387,6 +562,17 @@ test_mempool_perf(void)
 
 	rte_mempool_list_dump(stdout);
 
+	if (rte_lcore_count() < 2) {
+		printf("not enough lcores for producer/consumer test\n");
+	} else {
+		printf("start producer/consumer test\n");
+		if (do_pc_mempool_test("perf_test_pc", 0) < 0)
+			goto err;
+		if (do_pc_mempool_test("perf_test_pc_adaptive",
+				MEMPOOL_F_CACHE_ADAPTIVE) < 0)
+			goto err;
+	}
+
 	ret = 0;
 
 err:
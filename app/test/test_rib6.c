@@ -8,6 +8,8 @@
 #include <stdlib.h>
 
 #include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
 #include <rte_rib6.h>
 
 #include "test.h"
@@ -21,6 +23,7 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_rcu_dq(void);
 
 #define MAX_DEPTH 128
 #define MAX_RULES (1 << 22)
@@ -328,6 +331,77 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Check that a removed node is not reused while a reader is still
+ * online and is reclaimed once the reader reports quiescent state
+ */
+int32_t
+test_rcu_dq(void)
+{
+	struct rte_rib6 *rib = NULL;
+	struct rte_rib6_node *node;
+	struct rte_rib6_conf config;
+	struct rte_rib6_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	size_t sz;
+	int ret;
+
+	uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE] = {0x20, 0x01, 0x0d, 0xb8};
+	uint8_t depth = 24;
+
+	config.max_nodes = 1;
+	config.ext_sz = 0;
+
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	ret = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(ret == 0, "Can not initialize RCU\n");
+
+	ret = rte_rib6_rcu_qsbr_add(rib, NULL);
+	RTE_TEST_ASSERT(ret != 0, "RCU added with invalid config\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_RIB6_QSBR_MODE_DQ;
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Can not attach RCU to RIB\n");
+
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret != 0, "RCU attached twice\n");
+
+	ret = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(ret == 0, "Can not register RCU reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	node = rte_rib6_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node != NULL, "Failed to insert rule\n");
+
+	rte_rib6_remove(rib, ip, depth);
+
+	/* The only node is waiting for the reader */
+	node = rte_rib6_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node == NULL, "Node was reused too early\n");
+
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	node = rte_rib6_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node != NULL, "Failed to insert rule\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	ret = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(ret == 0, "Can not unregister RCU reader\n");
+
+	rte_rib6_free(rib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib6_tests = {
 	.suite_name = "rib6 autotest",
 	.setup = NULL,
@@ -339,6 +413,7 @@ static struct unit_test_suite rib6_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_rcu_dq),
 		TEST_CASES_END()
 	}
 };
@@ -298,6 +298,19 @@ static const struct {
 			.felem = rte_ring_dequeue_bulk_elem,
 		},
 	},
+	{
+		.desc = "MP_SEQ/MC_SEQ sync mode",
+		.api_type = TEST_RING_ELEM_BULK | TEST_RING_THREAD_DEF,
+		.create_flags = RING_F_MP_SEQ_ENQ | RING_F_MC_SEQ_DEQ,
+		.enq = {
+			.flegacy = rte_ring_enqueue_bulk,
+			.felem = rte_ring_enqueue_bulk_elem,
+		},
+		.deq = {
+			.flegacy = rte_ring_dequeue_bulk,
+			.felem = rte_ring_dequeue_bulk_elem,
+		},
+	},
 	{
 		.desc = "MP/MC sync mode",
 		.api_type = TEST_RING_ELEM_BURST | TEST_RING_THREAD_DEF,
@@ -363,6 +376,19 @@ static const struct {
 			.felem = rte_ring_dequeue_burst_elem,
 		},
 	},
+	{
+		.desc = "MP_SEQ/MC_SEQ sync mode",
+		.api_type = TEST_RING_ELEM_BURST | TEST_RING_THREAD_DEF,
+		.create_flags = RING_F_MP_SEQ_ENQ | RING_F_MC_SEQ_DEQ,
+		.enq = {
+			.flegacy = rte_ring_enqueue_burst,
+			.felem = rte_ring_enqueue_burst_elem,
+		},
+		.deq = {
+			.flegacy = rte_ring_dequeue_burst,
+			.felem = rte_ring_dequeue_burst_elem,
+		},
+	},
 	{
 		.desc = "SP/SC sync mode (ZC)",
 		.api_type = TEST_RING_ELEM_BULK | TEST_RING_THREAD_SPSC,
@@ -547,6 +573,15 @@ test_ring_negative_tests(void)
 		if (rp != NULL)
 			goto test_fail;
 
+		/* SEQ mode must be used by both producers and consumers */
+		rp = test_ring_create("test_ring_seq", esize[i], RING_SIZE,
+					SOCKET_ID_ANY,
+					RING_F_MP_SEQ_ENQ | RING_F_SC_DEQ);
+		if (rp != NULL) {
+			printf("Test failed to detect mixed SEQ mode\n");
+			goto test_fail;
+		}
+
 		rp = test_ring_create("test_ring_negative", esize[i], RING_SIZE,
 					SOCKET_ID_ANY,
 					RING_F_SP_ENQ | RING_F_SC_DEQ);
@@ -1191,6 +1226,58 @@ test_ring_with_exact_size(void)
 	return -1;
 }
 
+/*
+ * Check the statistics of a ring, when the library collects them.
+ */
+static int
+test_ring_stats(void)
+{
+	struct rte_ring_stats stats;
+	struct rte_ring *r;
+	void *obj[8] = { NULL };
+	int ret;
+
+	r = rte_ring_create("test_ring_stats", 8, SOCKET_ID_ANY,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (r == NULL)
+		return -1;
+
+	ret = rte_ring_stats_get(r, &stats);
+	if (ret == -ENOTSUP) {
+		printf("Ring statistics not collected, skipping\n");
+		rte_ring_free(r);
+		return 0;
+	}
+
+	/* full ring after a partial burst, then 7 objects out in one burst */
+	rte_ring_enqueue_bulk(r, obj, 5, NULL);
+	rte_ring_enqueue_burst(r, obj, 5, NULL);
+	rte_ring_enqueue_bulk(r, obj, 1, NULL);
+	rte_ring_dequeue_bulk(r, obj, 8, NULL);
+	rte_ring_dequeue_burst(r, obj, 8, NULL);
+
+	rte_ring_stats_get(r, &stats);
+	TEST_RING_VERIFY(stats.enq_success_bulk == 2, r, goto fail);
+	TEST_RING_VERIFY(stats.enq_success_objs == 7, r, goto fail);
+	TEST_RING_VERIFY(stats.enq_partial_bulk == 1, r, goto fail);
+	TEST_RING_VERIFY(stats.enq_fail_bulk == 1, r, goto fail);
+	TEST_RING_VERIFY(stats.deq_success_bulk == 1, r, goto fail);
+	TEST_RING_VERIFY(stats.deq_success_objs == 7, r, goto fail);
+	TEST_RING_VERIFY(stats.deq_fail_bulk == 1, r, goto fail);
+	TEST_RING_VERIFY(stats.max_used == 7, r, goto fail);
+
+	rte_ring_stats_reset(r);
+	rte_ring_stats_get(r, &stats);
+	TEST_RING_VERIFY(stats.enq_success_bulk == 0, r, goto fail);
+
+	rte_ring_free(r);
+	return 0;
+
+fail:
+	rte_ring_free(r);
+	return -1;
+}
+
 static int
 test_ring(void)
 {
@@ -1208,6 +1295,9 @@ test_ring(void)
 	if (test_ring_with_exact_size() < 0)
 		goto test_fail;
 
+	if (test_ring_stats() < 0)
+		goto test_fail;
+
 	/* Burst and bulk operations with sp/sc, mp/mc and default.
 	 * The test cases are split into smaller test cases to
 	 * help clang compile faster.
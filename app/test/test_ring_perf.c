@@ -421,6 +421,128 @@ run_on_all_cores(struct rte_ring *r, const int esize)
 	return 0;
 }
 
+/*
+ * Sync modes compared when many lcores share a ring, using the default
+ * enqueue/dequeue API of each mode.
+ */
+static const struct {
+	const char *desc;
+	unsigned int flags;
+} sync_modes[] = {
+	{ "MP/MC", 0 },
+	{ "MP_RTS/MC_RTS", RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ },
+	{ "MP_HTS/MC_HTS", RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ },
+	{ "MP_SEQ/MC_SEQ", RING_F_MP_SEQ_ENQ | RING_F_MC_SEQ_DEQ },
+};
+
+#define CONTENTION_MAX_LCORES 64
+
+struct contention_params {
+	struct rte_ring *r;
+	int esize;
+	unsigned int size;
+};
+
+static int
+contention_loop_fn(void *p)
+{
+	const struct contention_params *params = p;
+	const unsigned int api_type = TEST_RING_THREAD_DEF | TEST_RING_ELEM_BULK;
+	const unsigned int lcore = rte_lcore_id();
+	const uint64_t hz = rte_get_timer_hz();
+	uint64_t begin, lcount = 0;
+	void *burst;
+
+	burst = test_ring_calloc(MAX_BURST, params->esize);
+	if (burst == NULL)
+		return -1;
+
+	/* wait synchro for workers */
+	if (lcore != rte_get_main_lcore())
+		while (rte_atomic32_read(&synchro) == 0)
+			rte_pause();
+
+	begin = rte_get_timer_cycles();
+	while (rte_get_timer_cycles() - begin < hz * TIME_MS / 1000) {
+		lcount += test_ring_enqueue(params->r, burst, params->esize,
+				params->size, api_type);
+		test_ring_dequeue(params->r, burst, params->esize,
+				params->size, api_type);
+	}
+	queue_count[lcore] = lcount;
+
+	rte_free(burst);
+
+	return 0;
+}
+
+/*
+ * Run enqueue/dequeue loops on 2, 4, ... up to CONTENTION_MAX_LCORES lcores
+ * at once, each lcore being both a producer and a consumer, and report the
+ * average cost of moving one object through the ring.
+ */
+static int
+run_contention(const int esize)
+{
+	struct contention_params param;
+	unsigned int i, m, c, n, nb;
+	uint64_t total;
+	double cycles;
+
+	for (m = 0; m < RTE_DIM(sync_modes); m++) {
+		param.esize = esize;
+		param.r = test_ring_create(RING_NAME, esize, RING_SIZE,
+				rte_socket_id(), sync_modes[m].flags);
+		if (param.r == NULL)
+			return -1;
+
+		for (nb = 2; nb <= RTE_MIN(rte_lcore_count(),
+				(unsigned int)CONTENTION_MAX_LCORES); nb *= 2) {
+			for (i = 0; i < RTE_DIM(bulk_sizes); i++) {
+				param.size = bulk_sizes[i];
+
+				/* clear synchro and start nb - 1 workers */
+				rte_atomic32_set(&synchro, 0);
+				n = 1;
+				RTE_LCORE_FOREACH_WORKER(c) {
+					if (n == nb)
+						break;
+					rte_eal_remote_launch(
+						contention_loop_fn, &param, c);
+					n++;
+				}
+
+				/* start synchro and launch test on main */
+				rte_atomic32_set(&synchro, 1);
+				contention_loop_fn(&param);
+				rte_eal_mp_wait_lcore();
+
+				total = queue_count[rte_get_main_lcore()];
+				n = 1;
+				RTE_LCORE_FOREACH_WORKER(c) {
+					if (n == nb)
+						break;
+					total += queue_count[c];
+					n++;
+				}
+
+				cycles = (double)rte_get_timer_hz() * TIME_MS /
+					1000 * nb / RTE_MAX(total, 1ULL);
+				test_ring_print_test_string(
+					TEST_RING_IGNORE_API_TYPE, esize,
+					param.size, 0);
+				printf(": %s, %u lcores, bulk (size: %u): %.2F\n",
+					sync_modes[m].desc, nb, param.size,
+					cycles);
+			}
+		}
+
+		rte_ring_free(param.r);
+	}
+
+	return 0;
+}
+
 /*
  * Test function that determines how long an enqueue + dequeue of a single item
  * takes on a single lcore. Result is for comparison with the bulk enq+deq.
@@ -559,6 +681,10 @@ test_ring_perf_esize(const int esize)
 
 	rte_ring_free(r);
 
+	printf("\n### Testing sync modes under contention ###\n");
+	if (run_contention(esize) < 0)
+		return -1;
+
 	return 0;
 
 test_fail:
@@ -992,6 +992,182 @@ service_active_two_cores(void)
 	return unregister_all();
 }
 
+#define SCHED_NB_SERVICES 100
+
+static uint64_t sched_calls[SCHED_NB_SERVICES];
+
+static int32_t
+sched_count_cb(void *args)
+{
+	uint64_t *calls = args;
+
+	(*calls)++;
+	return 0;
+}
+
+static int32_t
+sched_idle_cb(void *args)
+{
+	uint64_t *calls = args;
+
+	(*calls)++;
+	return -EAGAIN;
+}
+
+/* register and start a service counting its calls in sched_calls[idx] */
+static int
+sched_register(uint32_t idx, rte_service_func cb, uint32_t *id)
+{
+	struct rte_service_spec service;
+
+	memset(&service, 0, sizeof(service));
+	snprintf(service.name, sizeof(service.name), "sched_service_%u", idx);
+	service.callback = cb;
+	service.callback_userdata = &sched_calls[idx];
+	sched_calls[idx] = 0;
+
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, id),
+			"Register of service %u failed", idx);
+	rte_service_component_runstate_set(*id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(*id, 1),
+			"Error: Service start returned non-zero");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(*id, slcore_id, 1),
+			"Enabling valid service and core failed");
+
+	return TEST_SUCCESS;
+}
+
+/* run the service core for a while, then stop it */
+static int
+sched_run(void)
+{
+	uint32_t i, count = rte_service_get_count();
+
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+	rte_delay_ms(100);
+
+	/* the services must be stopped to stop their only service core */
+	for (i = 0; i < count; i++)
+		rte_service_runstate_set(i, 0);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_may_be_active(slcore_id),
+			"Service lcore not stopped after waiting");
+	rte_eal_wait_lcore(slcore_id);
+	for (i = 0; i < count; i++)
+		rte_service_runstate_set(i, 1);
+
+	return TEST_SUCCESS;
+}
+
+/* run more services than the bits of a 64-bit mask on one core */
+static int
+service_many(void)
+{
+	uint32_t i, id;
+
+	unregister_all();
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+
+	for (i = 0; i < SCHED_NB_SERVICES; i++)
+		TEST_ASSERT_SUCCESS(sched_register(i, sched_count_cb, &id),
+				"Cannot register service %u", i);
+	TEST_ASSERT_EQUAL(SCHED_NB_SERVICES,
+			rte_service_lcore_count_services(slcore_id),
+			"Not all services mapped to the service core");
+
+	TEST_ASSERT_SUCCESS(sched_run(), "Cannot run the service core");
+
+	for (i = 0; i < SCHED_NB_SERVICES; i++)
+		TEST_ASSERT(sched_calls[i] > 0, "Service %u not called", i);
+
+	return unregister_all();
+}
+
+/* check the calls of services with different weights and budgets */
+static int
+service_weight_budget(void)
+{
+	uint32_t heavy, light;
+
+	unregister_all();
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_SUCCESS(sched_register(0, sched_count_cb, &heavy),
+			"Cannot register service");
+	TEST_ASSERT_SUCCESS(sched_register(1, sched_count_cb, &light),
+			"Cannot register service");
+
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_set_weight(heavy, 0),
+			"Zero weight didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_set_weight(UINT32_MAX, 1),
+			"Invalid service id didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(0, rte_service_set_weight(heavy, 4),
+			"Setting a valid weight failed");
+
+	TEST_ASSERT_SUCCESS(sched_run(), "Cannot run the service core");
+	TEST_ASSERT(sched_calls[0] >= 4 * (sched_calls[1] - 1) &&
+		    sched_calls[0] <= 4 * (sched_calls[1] + 1),
+		    "Weight 4 service called %"PRIu64" times, other one %"
+		    PRIu64" times", sched_calls[0], sched_calls[1]);
+
+	/* a budget of one cycle allows a single call per round */
+	TEST_ASSERT_EQUAL(0, rte_service_set_cycle_budget(heavy, 1),
+			"Setting a valid cycle budget failed");
+	sched_calls[0] = 0;
+	sched_calls[1] = 0;
+
+	TEST_ASSERT_SUCCESS(sched_run(), "Cannot run the service core");
+	TEST_ASSERT(sched_calls[0] + 1 >= sched_calls[1] &&
+		    sched_calls[0] <= sched_calls[1] + 1,
+		    "Budgeted service called %"PRIu64" times, other one %"
+		    PRIu64" times", sched_calls[0], sched_calls[1]);
+
+	return unregister_all();
+}
+
+/* check that a service reporting no work is skipped */
+static int
+service_idle_skip(void)
+{
+	uint32_t idle, busy;
+	uint64_t idle_calls;
+
+	unregister_all();
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_SUCCESS(sched_register(0, sched_idle_cb, &idle),
+			"Cannot register service");
+	TEST_ASSERT_SUCCESS(sched_register(1, sched_count_cb, &busy),
+			"Cannot register service");
+	rte_service_set_stats_enable(idle, 1);
+
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_set_idle_skip_max(idle,
+			UINT16_MAX + 1),
+			"Too many rounds to skip didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(0, rte_service_set_idle_skip_max(idle, 16),
+			"Setting a valid number of rounds to skip failed");
+
+	TEST_ASSERT_SUCCESS(sched_run(), "Cannot run the service core");
+
+	/* the idle service is called once every 17 rounds at most */
+	TEST_ASSERT(sched_calls[0] > 0 && sched_calls[0] * 8 < sched_calls[1],
+		    "Idle service called %"PRIu64" times, busy one %"PRIu64
+		    " times", sched_calls[0], sched_calls[1]);
+
+	TEST_ASSERT_EQUAL(0, rte_service_attr_get(idle,
+			RTE_SERVICE_ATTR_IDLE_CALL_COUNT, &idle_calls),
+			"Valid attr_get() call didn't return success");
+	TEST_ASSERT_EQUAL(sched_calls[0], idle_calls,
+			"Idle call count %"PRIu64", expected %"PRIu64,
+			idle_calls, sched_calls[0]);
+
+	return unregister_all();
+}
+
 static struct unit_test_suite service_tests  = {
 	.suite_name = "service core test suite",
 	.setup = testsuite_setup,
@@ -1014,6 +1190,9 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_app_lcore_mt_unsafe),
 		TEST_CASE_ST(dummy_register, NULL, service_may_be_active),
 		TEST_CASE_ST(dummy_register, NULL, service_active_two_cores),
+		TEST_CASE_ST(dummy_register, NULL, service_many),
+		TEST_CASE_ST(dummy_register, NULL, service_weight_budget),
+		TEST_CASE_ST(dummy_register, NULL, service_idle_skip),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -0,0 +1,180 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_soring.h>
+
+#include "test.h"
+
+/*
+ * Staged ordered ring functional tests, run on a single lcore:
+ * - creation parameter checks
+ * - objects go through all stages and are dequeued in enqueue order
+ * - out of order release does not let objects overtake each other
+ * - objects modified in place or on release are seen by the next stages
+ */
+
+#define SORING_NAME "SORING_TEST"
+#define SORING_SIZE 64
+#define NB_STAGES 3
+
+static int
+test_soring_create(void)
+{
+	struct rte_soring *s;
+
+	s = rte_soring_create(SORING_NAME, sizeof(uint32_t), SORING_SIZE, 0,
+			SOCKET_ID_ANY, 0);
+	TEST_ASSERT(s == NULL && rte_errno == EINVAL,
+		"created a soring without stage");
+
+	s = rte_soring_create(SORING_NAME, sizeof(uint32_t), SORING_SIZE,
+			NB_STAGES, SOCKET_ID_ANY, RING_F_MP_RTS_ENQ);
+	TEST_ASSERT(s == NULL && rte_errno == EINVAL,
+		"created a soring with unsupported flags");
+
+	s = rte_soring_create(SORING_NAME, 3, SORING_SIZE, NB_STAGES,
+			SOCKET_ID_ANY, 0);
+	TEST_ASSERT(s == NULL, "created a soring with invalid element size");
+
+	s = rte_soring_create(SORING_NAME, sizeof(uint32_t), SORING_SIZE - 1,
+			NB_STAGES, SOCKET_ID_ANY, 0);
+	TEST_ASSERT(s == NULL, "created a soring with invalid size");
+
+	s = rte_soring_create(SORING_NAME, sizeof(uint32_t), SORING_SIZE - 1,
+			NB_STAGES, SOCKET_ID_ANY, RING_F_EXACT_SZ);
+	TEST_ASSERT_NOT_NULL(s, "cannot create exact size soring");
+	TEST_ASSERT_EQUAL(rte_soring_free_count(s), SORING_SIZE - 1,
+		"wrong exact size soring capacity");
+	rte_soring_free(s);
+
+	return 0;
+}
+
+static int
+test_soring_order(struct rte_soring *s)
+{
+	uint32_t objs[SORING_SIZE], out[SORING_SIZE];
+	uint32_t ftoken[4], i, n, stage;
+
+	for (i = 0; i < RTE_DIM(objs); i++)
+		objs[i] = i;
+
+	n = rte_soring_enqueue_bulk(s, objs, 16, NULL);
+	TEST_ASSERT_EQUAL(n, 16, "enqueue failed");
+
+	/* nothing reached the consumer yet */
+	n = rte_soring_dequeue_burst(s, out, 16, NULL);
+	TEST_ASSERT_EQUAL(n, 0, "dequeued objects before any stage");
+
+	/* a stage cannot acquire objects the previous one did not release */
+	n = rte_soring_acquire_burst(s, out, 1, 16, &ftoken[0], NULL);
+	TEST_ASSERT_EQUAL(n, 0, "stage 1 acquired objects before stage 0");
+
+	/* acquire stage 0 in 4 chunks, release them in reverse order */
+	for (i = 0; i < 4; i++) {
+		n = rte_soring_acquire_bulk(s, out + i * 4, 0, 4, &ftoken[i],
+				NULL);
+		TEST_ASSERT_EQUAL(n, 4, "stage 0 acquire failed");
+	}
+	for (i = 0; i < 16; i++)
+		TEST_ASSERT_EQUAL(out[i], i, "stage 0 acquired wrong object");
+
+	for (i = 3; i != 0; i--) {
+		rte_soring_release(s, NULL, 0, 4, ftoken[i]);
+		n = rte_soring_acquire_burst(s, out, 1, 16, &ftoken[0], NULL);
+		TEST_ASSERT_EQUAL(n, 0,
+			"stage 1 acquired objects overtaking stage 0");
+	}
+	rte_soring_release(s, NULL, 0, 4, ftoken[0]);
+
+	/* go through the last stages, modifying the objects */
+	for (stage = 1; stage < NB_STAGES; stage++) {
+		n = rte_soring_acquire_burst(s, out, stage, SORING_SIZE,
+				&ftoken[0], NULL);
+		TEST_ASSERT_EQUAL(n, 16, "stage %u acquired %u objects",
+			stage, n);
+		for (i = 0; i < n; i++)
+			out[i] += 100;
+		rte_soring_release(s, out, stage, n, ftoken[0]);
+	}
+
+	n = rte_soring_dequeue_bulk(s, out, 16, NULL);
+	TEST_ASSERT_EQUAL(n, 16, "dequeue failed");
+	for (i = 0; i < n; i++)
+		TEST_ASSERT_EQUAL(out[i], i + 200, "dequeued wrong object");
+
+	TEST_ASSERT_EQUAL(rte_soring_count(s), 0, "soring not empty");
+	return 0;
+}
+
+static int
+test_soring_zc(struct rte_soring *s)
+{
+	struct rte_ring_zc_data zcd;
+	uint32_t objs[SORING_SIZE], out[SORING_SIZE];
+	uint32_t ftoken, i, n, stage, *p;
+
+	for (i = 0; i < RTE_DIM(objs); i++)
+		objs[i] = i;
+
+	/* fill the ring so that the zero copy areas wrap around */
+	n = rte_soring_enqueue_burst(s, objs, SORING_SIZE, NULL);
+	TEST_ASSERT_EQUAL(n, SORING_SIZE - 1, "enqueue failed");
+
+	for (stage = 0; stage < NB_STAGES; stage++) {
+		n = rte_soring_acquire_zc_burst(s, stage, SORING_SIZE, &zcd,
+				&ftoken, NULL);
+		TEST_ASSERT_EQUAL(n, SORING_SIZE - 1,
+			"stage %u acquired %u objects", stage, n);
+		p = zcd.ptr1;
+		for (i = 0; i < zcd.n1; i++)
+			p[i] += 1;
+		p = zcd.ptr2;
+		for (; i < n; i++)
+			p[i - zcd.n1] += 1;
+		rte_soring_release(s, NULL, stage, n, ftoken);
+	}
+
+	n = rte_soring_dequeue_burst(s, out, SORING_SIZE, NULL);
+	TEST_ASSERT_EQUAL(n, SORING_SIZE - 1, "dequeue failed");
+	for (i = 0; i < n; i++)
+		TEST_ASSERT_EQUAL(out[i], i + NB_STAGES,
+			"dequeued wrong object");
+
+	return 0;
+}
+
+static int
+test_soring(void)
+{
+	struct rte_soring *s;
+	int ret;
+
+	if (test_soring_create() != 0)
+		return -1;
+
+	s = rte_soring_create(SORING_NAME, sizeof(uint32_t), SORING_SIZE,
+			NB_STAGES, SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT_NOT_NULL(s, "cannot create soring");
+
+	ret = test_soring_order(s);
+	/* move the positions so that the next test wraps around */
+	if (ret == 0)
+		ret = test_soring_order(s);
+	if (ret == 0)
+		ret = test_soring_zc(s);
+	if (ret == 0)
+		rte_soring_dump(stdout, s);
+
+	rte_soring_free(s);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(soring_autotest, test_soring);
@@ -0,0 +1,199 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+#include <rte_soring.h>
+
+#include "test.h"
+
+/*
+ * Staged ordered ring performance test.
+ *
+ * The main lcore enqueues sequence numbers and dequeues them back, while
+ * all worker lcores move them through NB_STAGES processing stages. The same
+ * pipeline is built once with a staged ordered ring, and once with a chain
+ * of NB_STAGES + 1 rings, one per hop. Reports the cycles spent per object
+ * by the main lcore, and for the chain of rings, the number of objects
+ * dequeued out of order.
+ */
+
+#define RING_SIZE 4096
+#define NB_STAGES 3
+#define MAX_BURST 32
+#define NB_OBJS (1 << 22)
+
+static const volatile unsigned int bulk_sizes[] = { 8, MAX_BURST };
+
+static struct rte_soring *sor;
+static struct rte_ring *chain[NB_STAGES + 1];
+static volatile unsigned int bsize;
+static volatile int stop;
+
+/* per object processing of variable length, so workers finish out of order */
+static inline void
+process(const uint32_t *objs, uint32_t n)
+{
+	uint32_t i, j;
+
+	for (i = 0; i < n; i++)
+		for (j = 0; j < (objs[i] & 0xf); j++)
+			rte_pause();
+}
+
+static int
+soring_worker(void *arg __rte_unused)
+{
+	uint32_t objs[MAX_BURST];
+	uint32_t ftoken, n, stage;
+
+	while (!stop) {
+		for (stage = 0; stage != NB_STAGES; stage++) {
+			n = rte_soring_acquire_burst(sor, objs, stage, bsize,
+					&ftoken, NULL);
+			if (n == 0)
+				continue;
+			process(objs, n);
+			rte_soring_release(sor, NULL, stage, n, ftoken);
+		}
+	}
+	return 0;
+}
+
+static int
+chain_worker(void *arg __rte_unused)
+{
+	uint32_t objs[MAX_BURST];
+	uint32_t i, n, stage;
+
+	while (!stop) {
+		for (stage = 0; stage != NB_STAGES; stage++) {
+			n = rte_ring_dequeue_burst_elem(chain[stage], objs,
+					sizeof(objs[0]), bsize, NULL);
+			if (n == 0)
+				continue;
+			process(objs, n);
+			for (i = 0; i != n; )
+				i += rte_ring_enqueue_burst_elem(
+						chain[stage + 1], objs + i,
+						sizeof(objs[0]), n - i, NULL);
+		}
+	}
+	return 0;
+}
+
+/*
+ * Feed the pipeline from the main lcore and check the order of the objects
+ * coming out of it.
+ */
+static uint64_t
+run_main(int use_soring, uint64_t *ooo)
+{
+	uint32_t objs[MAX_BURST];
+	uint32_t seq_in = 0, seq_out = 0, i, n;
+	uint64_t start;
+
+	*ooo = 0;
+	start = rte_rdtsc();
+
+	while (seq_out != NB_OBJS) {
+		n = RTE_MIN(bsize, NB_OBJS - seq_in);
+		for (i = 0; i < n; i++)
+			objs[i] = seq_in + i;
+		if (use_soring)
+			n = rte_soring_enqueue_burst(sor, objs, n, NULL);
+		else
+			n = rte_ring_enqueue_burst_elem(chain[0], objs,
+					sizeof(objs[0]), n, NULL);
+		seq_in += n;
+
+		if (use_soring)
+			n = rte_soring_dequeue_burst(sor, objs, bsize, NULL);
+		else
+			n = rte_ring_dequeue_burst_elem(chain[NB_STAGES], objs,
+					sizeof(objs[0]), bsize, NULL);
+		for (i = 0; i < n; i++) {
+			if (objs[i] != seq_out)
+				(*ooo)++;
+			seq_out++;
+		}
+	}
+
+	return rte_rdtsc() - start;
+}
+
+static void
+run_test(int use_soring)
+{
+	unsigned int lcore_id;
+	uint64_t cycles, ooo;
+
+	stop = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(use_soring ? soring_worker : chain_worker,
+				NULL, lcore_id);
+
+	cycles = run_main(use_soring, &ooo);
+
+	stop = 1;
+	rte_eal_mp_wait_lcore();
+
+	printf("%s: burst %u, %u workers: %.2F cycles per object, "
+	       "%"PRIu64" out of order\n",
+	       use_soring ? "soring" : "ring chain", bsize,
+	       rte_lcore_count() - 1, (double)cycles / NB_OBJS, ooo);
+}
+
+static int
+test_soring_perf(void)
+{
+	char name[RTE_RING_NAMESIZE];
+	unsigned int i;
+	int ret = -1;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for soring_perf_autotest, expecting at least 2\n");
+		return TEST_SKIPPED;
+	}
+
+	sor = rte_soring_create("SORING_PERF", sizeof(uint32_t), RING_SIZE,
+			NB_STAGES, rte_socket_id(), 0);
+	if (sor == NULL) {
+		printf("Cannot create soring\n");
+		return -1;
+	}
+
+	for (i = 0; i != RTE_DIM(chain); i++) {
+		snprintf(name, sizeof(name), "SORING_PERF_%u", i);
+		chain[i] = rte_ring_create_elem(name, sizeof(uint32_t),
+				RING_SIZE, rte_socket_id(), 0);
+		if (chain[i] == NULL) {
+			printf("Cannot create ring %s\n", name);
+			goto exit;
+		}
+	}
+
+	for (i = 0; i != RTE_DIM(bulk_sizes); i++) {
+		bsize = bulk_sizes[i];
+		run_test(1);
+		run_test(0);
+	}
+	ret = 0;
+
+exit:
+	for (i = 0; i != RTE_DIM(chain); i++)
+		rte_ring_free(chain[i]);
+	rte_soring_free(sor);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(soring_perf_autotest, test_soring_perf);
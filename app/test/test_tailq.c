@@ -10,6 +10,8 @@
 #include <sys/queue.h>
 
 #include <rte_eal.h>
+#include <rte_eal_memconfig.h>
+#include <rte_errno.h>
 #include <rte_string_fns.h>
 #include <rte_tailq.h>
 
@@ -115,6 +117,67 @@ test_tailq_lookup(void)
 	return 0;
 }
 
+#define INDEX_TEST_ENTRIES 1000
+
+static int
+test_tailq_index(void)
+{
+	static struct rte_tailq_entry entries[INDEX_TEST_ENTRIES];
+	struct rte_tailq_head *head = rte_dummy_dyn_tailq.head;
+	char name[RTE_TAILQ_NAMESIZE];
+	unsigned int i;
+	int ret = 0;
+
+	rte_mcfg_tailq_write_lock();
+
+	/* enough entries to force the index to grow a few times */
+	for (i = 0; i < INDEX_TEST_ENTRIES; i++) {
+		snprintf(name, sizeof(name), "dummy_%u", i);
+		if (rte_eal_tailq_index_add(head, name, &entries[i]) < 0) {
+			printf("Error, cannot index %s\n", name);
+			ret = 1;
+			goto out;
+		}
+	}
+
+	if (rte_eal_tailq_index_add(head, "dummy_0", &entries[0]) == 0 ||
+			rte_errno != EEXIST) {
+		printf("Error, indexing the same name twice did not fail\n");
+		ret = 1;
+		goto out;
+	}
+
+	/* remove odd entries, even ones must still be found */
+	for (i = 1; i < INDEX_TEST_ENTRIES; i += 2) {
+		snprintf(name, sizeof(name), "dummy_%u", i);
+		if (rte_eal_tailq_index_del(head, name) != &entries[i]) {
+			printf("Error, cannot remove %s from index\n", name);
+			ret = 1;
+			goto out;
+		}
+	}
+
+	for (i = 0; i < INDEX_TEST_ENTRIES; i++) {
+		snprintf(name, sizeof(name), "dummy_%u", i);
+		if (rte_eal_tailq_index_lookup(head, name) !=
+				(i % 2 ? NULL : &entries[i])) {
+			printf("Error, wrong index lookup result for %s\n",
+					name);
+			ret = 1;
+			goto out;
+		}
+	}
+
+out:
+	for (i = 0; i < INDEX_TEST_ENTRIES; i++) {
+		snprintf(name, sizeof(name), "dummy_%u", i);
+		rte_eal_tailq_index_del(head, name);
+	}
+	rte_mcfg_tailq_write_unlock();
+
+	return ret;
+}
+
 static int
 test_tailq(void)
 {
@@ -122,6 +185,7 @@ test_tailq(void)
 	ret |= test_tailq_early();
 	ret |= test_tailq_create();
 	ret |= test_tailq_lookup();
+	ret |= test_tailq_index();
 	return ret;
 }
 
@@ -5,6 +5,7 @@
 #include <rte_common.h>
 #include <rte_eal.h>
 #include <rte_ip.h>
+#include <rte_random.h>
 
 #include "test.h"
 
@@ -74,6 +75,106 @@ uint8_t default_rss_key[] = {
 0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
 };
 
+#define BULK_NUM_TUPLES 64
+
+/* Compare the bulk hash with rte_softrss() for all tuple lengths */
+static int
+test_thash_bulk(void)
+{
+	struct rte_thash_bulk_ctx *ctx;
+	uint32_t tuples[BULK_NUM_TUPLES][RTE_THASH_BULK_LEN_MAX];
+	const uint32_t *tuple_ptrs[BULK_NUM_TUPLES];
+	uint32_t hashes[BULK_NUM_TUPLES];
+	uint8_t rss_key[RTE_THASH_BULK_LEN_MAX * 4 + 4];
+	uint32_t i, j, len;
+
+	for (i = 0; i < RTE_DIM(rss_key); i++)
+		rss_key[i] = rte_rand();
+
+	for (len = 1; len <= RTE_THASH_BULK_LEN_MAX; len++) {
+		ctx = rte_thash_bulk_ctx_create(rss_key, len * 4 + 4, len,
+			SOCKET_ID_ANY);
+		if (ctx == NULL) {
+			printf("Can not create bulk context for len %u\n", len);
+			return -1;
+		}
+		for (i = 0; i < BULK_NUM_TUPLES; i++) {
+			for (j = 0; j < len; j++)
+				tuples[i][j] = rte_rand();
+			tuple_ptrs[i] = tuples[i];
+		}
+		rte_thash_bulk(ctx, tuple_ptrs, hashes, BULK_NUM_TUPLES);
+		rte_thash_bulk_ctx_free(ctx);
+
+		for (i = 0; i < BULK_NUM_TUPLES; i++) {
+			if (hashes[i] != rte_softrss(tuples[i], len, rss_key)) {
+				printf("Bulk hash mismatch for len %u\n", len);
+				return -1;
+			}
+		}
+	}
+
+	/* Too short key */
+	ctx = rte_thash_bulk_ctx_create(rss_key, RTE_THASH_V4_L4_LEN * 4,
+		RTE_THASH_V4_L4_LEN, SOCKET_ID_ANY);
+	if (ctx != NULL) {
+		rte_thash_bulk_ctx_free(ctx);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Adjust the source port so that the flows land on each RETA entry */
+static int
+test_thash_adjust(void)
+{
+	struct rte_thash_adjust adj;
+	union rte_thash_tuple tuple;
+	uint32_t i, q, hash, new_hash;
+	const uint32_t reta_mask = 0x7f;
+	int ret;
+
+	ret = rte_thash_adjust_init(&adj, default_rss_key,
+		RTE_DIM(default_rss_key), RTE_THASH_V4_SPORT_OFFSET, 16,
+		reta_mask);
+	if (ret != 0) {
+		printf("Can not init adjust for source port\n");
+		return -1;
+	}
+
+	for (i = 0; i < RTE_DIM(v4_tbl); i++) {
+		for (q = 0; q <= reta_mask; q++) {
+			tuple.v4.src_addr = v4_tbl[i].src_ip;
+			tuple.v4.dst_addr = v4_tbl[i].dst_ip;
+			tuple.v4.sport = v4_tbl[i].src_port;
+			tuple.v4.dport = v4_tbl[i].dst_port;
+
+			hash = rte_softrss((uint32_t *)&tuple,
+				RTE_THASH_V4_L4_LEN, default_rss_key);
+			new_hash = rte_thash_adjust_tuple(&adj,
+				(uint32_t *)&tuple, hash, q);
+			hash = rte_softrss((uint32_t *)&tuple,
+				RTE_THASH_V4_L4_LEN, default_rss_key);
+			if (hash != new_hash || (hash & reta_mask) != q ||
+					tuple.v4.dport != v4_tbl[i].dst_port ||
+					tuple.v4.src_addr != v4_tbl[i].src_ip) {
+				printf("Adjusted tuple hash is wrong\n");
+				return -1;
+			}
+		}
+	}
+
+	/* 4 field bits can not control 7 hash bits */
+	ret = rte_thash_adjust_init(&adj, default_rss_key,
+		RTE_DIM(default_rss_key), RTE_THASH_V4_SPORT_OFFSET, 4,
+		reta_mask);
+	if (ret != -EINVAL)
+		return -1;
+
+	return 0;
+}
+
 static int
 test_thash(void)
 {
@@ -137,6 +238,13 @@ test_thash(void)
 				(rss_l3l4 != v6_tbl[i].hash_l3l4))
 			return -1;
 	}
+
+	if (test_thash_bulk() < 0)
+		return -1;
+
+	if (test_thash_adjust() < 0)
+		return -1;
+
 	return 0;
 }
 
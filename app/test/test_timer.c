@@ -495,6 +495,317 @@ timer_basic_main_loop(__rte_unused void *arg)
 	return 0;
 }
 
+#define NB_WHEEL_TIMERS 10000
+#define NB_WHEEL_PERIODS 5
+
+static int wheel_cb_count;
+static int wheel_period_count;
+
+/* callback for timing wheel tests, called by rte_timer_alt_manage() */
+static void
+timer_wheel_cb(struct rte_timer *tim)
+{
+	/* timers must not run before their expiry time */
+	if (rte_get_timer_cycles() < tim->expire)
+		test_failed = 1;
+
+	if (tim->period != 0)
+		wheel_period_count++;
+	else if (tim->arg == NULL)
+		wheel_cb_count++;
+	else
+		test_failed = 1; /* stopped timer */
+}
+
+/* run timers expiring over all the levels of a timing wheel */
+static int
+timer_wheel_test(void)
+{
+	uint64_t hz = rte_get_timer_hz();
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_timer *timers, periodic_tim;
+	uint32_t data_id;
+	uint64_t end;
+	int i, ret;
+
+	ret = rte_timer_data_alloc(&data_id);
+	if (ret < 0) {
+		printf("- Cannot allocate timer data\n");
+		return -1;
+	}
+	/* small resolution, so that timers go through all the levels */
+	ret = rte_timer_data_set_backend(data_id, RTE_TIMER_BACKEND_WHEEL, 64);
+	if (ret < 0) {
+		printf("- Cannot select timing wheel\n");
+		rte_timer_data_dealloc(data_id);
+		return -1;
+	}
+
+	timers = rte_malloc(NULL, sizeof(*timers) * NB_WHEEL_TIMERS, 0);
+	if (timers == NULL) {
+		printf("- Cannot allocate memory for timers\n");
+		rte_timer_data_dealloc(data_id);
+		return -1;
+	}
+
+	test_failed = 0;
+	wheel_cb_count = 0;
+	wheel_period_count = 0;
+
+	/* stop every other timer, passing a non NULL argument to detect
+	 * the callbacks of stopped timers
+	 */
+	for (i = 0; i < NB_WHEEL_TIMERS; i++) {
+		rte_timer_init(&timers[i]);
+		rte_timer_alt_reset(data_id, &timers[i], rte_rand() % hz,
+				    SINGLE, lcore_id, NULL,
+				    (void *)(uintptr_t)(i % 2));
+	}
+	for (i = 1; i < NB_WHEEL_TIMERS; i += 2)
+		rte_timer_alt_stop(data_id, &timers[i]);
+
+	rte_timer_init(&periodic_tim);
+	rte_timer_alt_reset(data_id, &periodic_tim, hz / 10, PERIODICAL,
+			    lcore_id, NULL, NULL);
+
+	/* all timers expire within one second */
+	end = rte_get_timer_cycles() + hz + hz / 10;
+	while (rte_get_timer_cycles() < end) {
+		rte_timer_alt_manage(data_id, NULL, 0, timer_wheel_cb);
+		rte_delay_us(3);
+	}
+
+	rte_timer_alt_stop(data_id, &periodic_tim);
+	ret = rte_timer_data_set_backend(data_id,
+					 RTE_TIMER_BACKEND_SKIPLIST, 0);
+	rte_timer_data_dealloc(data_id);
+	rte_free(timers);
+
+	if (test_failed || ret != 0 ||
+	    wheel_cb_count != NB_WHEEL_TIMERS / 2 ||
+	    wheel_period_count < NB_WHEEL_PERIODS) {
+		printf("Test Failed\n");
+		printf("- Expected %d callbacks, got %d, %d periods\n",
+		       NB_WHEEL_TIMERS / 2, wheel_cb_count,
+		       wheel_period_count);
+		return -1;
+	}
+
+	printf("Test OK\n");
+	return 0;
+}
+
+#define NB_HANDOFF_TIMERS 1000
+#define HANDOFF_RING_SIZE 64
+
+static uint32_t handoff_data_id;
+static volatile int handoff_done;
+static volatile int handoff_cb_count;
+
+/* callback for handoff tests, called by rte_timer_alt_manage() */
+static void
+timer_handoff_cb(struct rte_timer *tim)
+{
+	/* stopped timers have a non NULL argument */
+	if (tim->arg != NULL || tim->status.owner != (int16_t)rte_lcore_id())
+		test_failed = 1;
+	handoff_cb_count++;
+}
+
+static int
+timer_handoff_worker_loop(__rte_unused void *arg)
+{
+	while (!handoff_done)
+		rte_timer_alt_manage(handoff_data_id, NULL, 0,
+				     timer_handoff_cb);
+	return 0;
+}
+
+/* reset and stop timers of another lcore, handing the updates off to it */
+static int
+timer_handoff_test(void)
+{
+	uint64_t hz = rte_get_timer_hz();
+	struct rte_timer *timers, **tims;
+	void **args;
+	unsigned int worker;
+	uint64_t end;
+	int i, n, ret;
+
+	ret = rte_timer_data_alloc(&handoff_data_id);
+	if (ret < 0) {
+		printf("- Cannot allocate timer data\n");
+		return -1;
+	}
+	/* small rings, so that some requests fall back to the list lock */
+	ret = rte_timer_data_set_handoff(handoff_data_id, HANDOFF_RING_SIZE);
+	if (ret < 0) {
+		printf("- Cannot enable handoff\n");
+		rte_timer_data_dealloc(handoff_data_id);
+		return -1;
+	}
+
+	timers = rte_malloc(NULL, sizeof(*timers) * NB_HANDOFF_TIMERS, 0);
+	tims = rte_malloc(NULL, sizeof(*tims) * NB_HANDOFF_TIMERS, 0);
+	args = rte_malloc(NULL, sizeof(*args) * NB_HANDOFF_TIMERS, 0);
+	if (timers == NULL || tims == NULL || args == NULL) {
+		printf("- Cannot allocate memory for timers\n");
+		rte_free(timers);
+		rte_free(tims);
+		rte_free(args);
+		rte_timer_data_dealloc(handoff_data_id);
+		return -1;
+	}
+
+	test_failed = 0;
+	handoff_done = 0;
+	handoff_cb_count = 0;
+	worker = rte_get_next_lcore(-1, 1, 0);
+	rte_eal_remote_launch(timer_handoff_worker_loop, NULL, worker);
+
+	for (i = 0; i < NB_HANDOFF_TIMERS; i++) {
+		rte_timer_init(&timers[i]);
+		tims[i] = &timers[i];
+		args[i] = (void *)(uintptr_t)(i % 2);
+	}
+	n = rte_timer_alt_reset_bulk(handoff_data_id, tims, NB_HANDOFF_TIMERS,
+				     hz / 10, SINGLE, worker, NULL, args);
+	if (n != NB_HANDOFF_TIMERS)
+		test_failed = 1;
+
+	/* stop every other timer, retrying while the worker has not
+	 * processed the request adding it
+	 */
+	for (i = 0; i < NB_HANDOFF_TIMERS / 2; i++)
+		tims[i] = &timers[i * 2 + 1];
+	for (i = 0; i < NB_HANDOFF_TIMERS / 2; i += n) {
+		n = rte_timer_alt_stop_bulk(handoff_data_id, &tims[i],
+					    NB_HANDOFF_TIMERS / 2 - i);
+		if (n <= 0) {
+			n = 0;
+			rte_pause();
+		}
+	}
+
+	end = rte_get_timer_cycles() + hz;
+	while (handoff_cb_count < NB_HANDOFF_TIMERS / 2 &&
+	       rte_get_timer_cycles() < end)
+		rte_delay_us(100);
+	/* let the stopped timers expire, if they were not stopped */
+	rte_delay_ms(100);
+
+	handoff_done = 1;
+	rte_eal_wait_lcore(worker);
+
+	ret = rte_timer_data_set_handoff(handoff_data_id, 0);
+	rte_timer_data_dealloc(handoff_data_id);
+	rte_free(timers);
+	rte_free(tims);
+	rte_free(args);
+
+	if (test_failed || ret != 0 ||
+	    handoff_cb_count != NB_HANDOFF_TIMERS / 2) {
+		printf("Test Failed\n");
+		printf("- Expected %d callbacks, got %d\n",
+		       NB_HANDOFF_TIMERS / 2, handoff_cb_count);
+		return -1;
+	}
+
+	printf("Test OK\n");
+	return 0;
+}
+
+static volatile int handoff_sync_go;
+static volatile int handoff_sync_ret;
+
+static void
+timer_handoff_sync_cb(__rte_unused struct rte_timer *tim,
+		      __rte_unused void *arg)
+{
+	handoff_cb_count++;
+}
+
+/* stop and reset timers handed off to this lcore, before processing them */
+static int
+timer_handoff_sync_worker(void *arg)
+{
+	struct rte_timer *tims = arg;
+	uint64_t end;
+
+	while (!handoff_sync_go)
+		rte_pause();
+
+	rte_timer_stop_sync(&tims[0]);
+	rte_timer_reset_sync(&tims[1], 0, SINGLE, rte_lcore_id(),
+			     timer_handoff_sync_cb, NULL);
+
+	end = rte_get_timer_cycles() + rte_get_timer_hz();
+	while (handoff_cb_count == 0 && rte_get_timer_cycles() < end)
+		rte_timer_manage();
+
+	handoff_sync_ret = 0;
+	return 0;
+}
+
+/* update timers handed off to an lcore which did not process them yet */
+static int
+timer_handoff_sync_test(void)
+{
+	uint64_t hz = rte_get_timer_hz();
+	static struct rte_timer tims[3];
+	unsigned int worker;
+	uint64_t end;
+	int i, ret;
+
+	/* the *_sync functions use the default timer data */
+	ret = rte_timer_data_set_handoff(0, HANDOFF_RING_SIZE);
+	if (ret < 0) {
+		printf("- Cannot enable handoff\n");
+		return -1;
+	}
+
+	test_failed = 0;
+	handoff_cb_count = 0;
+	handoff_sync_go = 0;
+	handoff_sync_ret = -1;
+	worker = rte_get_next_lcore(-1, 1, 0);
+	rte_eal_remote_launch(timer_handoff_sync_worker, tims, worker);
+
+	for (i = RTE_DIM(tims) - 1; i >= 0; i--) {
+		rte_timer_init(&tims[i]);
+		if (rte_timer_reset(&tims[i], hz, SINGLE, worker,
+				    timer_handoff_sync_cb, NULL) != 0)
+			test_failed = 1;
+		/* another lcore processes the request instead of failing */
+		if (i == 2 && (rte_timer_stop(&tims[i]) != 0 ||
+			       rte_timer_pending(&tims[i])))
+			test_failed = 1;
+	}
+
+	handoff_sync_go = 1;
+	end = rte_get_timer_cycles() + 2 * hz;
+	while (handoff_sync_ret != 0 && rte_get_timer_cycles() < end)
+		rte_delay_us(100);
+	if (handoff_sync_ret != 0) {
+		printf("- Worker stuck updating handed off timers\n");
+		return -1;
+	}
+	rte_eal_wait_lcore(worker);
+
+	if (rte_timer_pending(&tims[0]) || rte_timer_pending(&tims[1]))
+		test_failed = 1;
+	ret = rte_timer_data_set_handoff(0, 0);
+
+	if (test_failed || ret != 0 || handoff_cb_count != 1) {
+		printf("Test Failed\n");
+		printf("- Expected 1 callback, got %d\n", handoff_cb_count);
+		return -1;
+	}
+
+	printf("Test OK\n");
+	return 0;
+}
+
 static int
 timer_sanity_check(void)
 {
@@ -593,6 +904,16 @@ test_timer(void)
 		rte_timer_stop_sync(&mytiminfo[i].tim);
 	}
 
+	printf("\nStart timer wheel tests\n");
+	if (timer_wheel_test() < 0)
+		return TEST_FAILED;
+
+	printf("\nStart timer handoff tests\n");
+	if (timer_handoff_test() < 0)
+		return TEST_FAILED;
+	if (timer_handoff_sync_test() < 0)
+		return TEST_FAILED;
+
 	rte_timer_dump_stats(stdout);
 
 	return TEST_SUCCESS;
@@ -15,12 +15,13 @@
 #include <rte_malloc.h>
 #include <rte_pause.h>
 
-#define MAX_ITERATIONS 1000000
+#define MAX_ITERATIONS 10000000
+#define MIN_ITERATIONS 1000000
 
 int outstanding_count = 0;
 
 static void
-timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
+timer_cb(struct rte_timer *t __rte_unused)
 {
 	outstanding_count--;
 }
@@ -34,30 +35,29 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #endif
 
 static int
-test_timer_perf(void)
+timer_perf(uint32_t data_id, struct rte_timer *tms, unsigned int max_timers)
 {
 	unsigned iterations = 100;
 	unsigned i;
-	struct rte_timer *tms;
 	uint64_t start_tsc, end_tsc, delay_start;
 	unsigned lcore_id = rte_lcore_id();
 
-	tms = rte_malloc(NULL, sizeof(*tms) * MAX_ITERATIONS, 0);
-
-	for (i = 0; i < MAX_ITERATIONS; i++)
+	for (i = 0; i < max_timers; i++)
 		rte_timer_init(&tms[i]);
 
 	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
 	const uint64_t ticks_per_ms = rte_get_tsc_hz()/1000;
 	const uint64_t ticks_per_us = ticks_per_ms/1000;
+	/* timing wheel rounds the expiry time up to its resolution */
+	const uint64_t slack = rte_get_timer_hz() / 1000;
 
-	while (iterations <= MAX_ITERATIONS) {
+	while (iterations <= max_timers) {
 
 		printf("Appending %u timers\n", iterations);
 		start_tsc = rte_rdtsc();
 		for (i = 0; i < iterations; i++)
-			rte_timer_reset(&tms[i], ticks, SINGLE, lcore_id,
-					timer_cb, NULL);
+			rte_timer_alt_reset(data_id, &tms[i], ticks, SINGLE,
+					    lcore_id, NULL, NULL);
 		end_tsc = rte_rdtsc();
 		printf("Time for %u timers: %"PRIu64" (%"PRIu64"ms), ", iterations,
 				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
@@ -71,7 +71,7 @@ test_timer_perf(void)
 
 		start_tsc = rte_rdtsc();
 		while (outstanding_count)
-			rte_timer_manage();
+			rte_timer_alt_manage(data_id, NULL, 0, timer_cb);
 		end_tsc = rte_rdtsc();
 		printf("Time for %u callbacks: %"PRIu64" (%"PRIu64"ms), ", iterations,
 				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
@@ -82,8 +82,9 @@ test_timer_perf(void)
 		printf("Resetting %u timers\n", iterations);
 		start_tsc = rte_rdtsc();
 		for (i = 0; i < iterations; i++)
-			rte_timer_reset(&tms[i], rte_rand() % ticks, SINGLE, lcore_id,
-					timer_cb, NULL);
+			rte_timer_alt_reset(data_id, &tms[i],
+					    rte_rand() % ticks, SINGLE,
+					    lcore_id, NULL, NULL);
 		end_tsc = rte_rdtsc();
 		printf("Time for %u timers: %"PRIu64" (%"PRIu64"ms), ", iterations,
 				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
@@ -93,10 +94,10 @@ test_timer_perf(void)
 		outstanding_count = iterations;
 
 		delay_start = rte_get_timer_cycles();
-		while (rte_get_timer_cycles() < delay_start + ticks)
+		while (rte_get_timer_cycles() < delay_start + ticks + slack)
 			do_delay();
 
-		rte_timer_manage();
+		rte_timer_alt_manage(data_id, NULL, 0, timer_cb);
 		if (outstanding_count != 0) {
 			printf("Error: outstanding callback count = %d\n", outstanding_count);
 			return -1;
@@ -111,24 +112,64 @@ test_timer_perf(void)
 	/* measure time to poll an empty timer list */
 	start_tsc = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		rte_timer_manage();
+		rte_timer_alt_manage(data_id, NULL, 0, timer_cb);
 	end_tsc = rte_rdtsc();
 	printf("\nTime per rte_timer_manage with zero timers: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
 	/* measure time to poll a timer list with timers, but without
 	 * calling any callbacks */
-	rte_timer_reset(&tms[0], ticks * 100, SINGLE, lcore_id,
-			timer_cb, NULL);
+	rte_timer_alt_reset(data_id, &tms[0], ticks * 100, SINGLE, lcore_id,
+			    NULL, NULL);
 	start_tsc = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		rte_timer_manage();
+		rte_timer_alt_manage(data_id, NULL, 0, timer_cb);
 	end_tsc = rte_rdtsc();
 	printf("Time per rte_timer_manage with zero callbacks: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
+	rte_timer_alt_stop(data_id, &tms[0]);
 
-	rte_free(tms);
 	return 0;
 }
 
+static int
+test_timer_perf(void)
+{
+	unsigned int max_timers = MAX_ITERATIONS;
+	struct rte_timer *tms;
+	uint32_t data_id;
+	int ret;
+
+	tms = rte_malloc(NULL, sizeof(*tms) * max_timers, 0);
+	if (tms == NULL) {
+		max_timers = MIN_ITERATIONS;
+		tms = rte_malloc(NULL, sizeof(*tms) * max_timers, 0);
+		if (tms == NULL) {
+			printf("Cannot allocate memory for timers\n");
+			return -1;
+		}
+	}
+
+	ret = rte_timer_data_alloc(&data_id);
+	if (ret < 0) {
+		printf("Cannot allocate timer data\n");
+		rte_free(tms);
+		return -1;
+	}
+
+	printf("Skiplist timers\n\n");
+	ret = timer_perf(data_id, tms, max_timers);
+	if (ret == 0) {
+		printf("\nTiming wheel timers\n\n");
+		ret = rte_timer_data_set_backend(data_id,
+				RTE_TIMER_BACKEND_WHEEL, 0);
+		if (ret == 0)
+			ret = timer_perf(data_id, tms, max_timers);
+	}
+
+	rte_timer_data_dealloc(data_id);
+	rte_free(tms);
+	return ret;
+}
+
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);
@@ -41,6 +41,7 @@
 #define RTE_LOG_DP_LEVEL RTE_LOG_INFO
 #define RTE_BACKTRACE 1
 #define RTE_MAX_VFIO_CONTAINERS 64
+#define RTE_SERVICE_NUM_MAX 256
 
 /* bsd module defines */
 #define RTE_CONTIGMEM_MAX_NUM_BUFS 64
@@ -23,6 +23,7 @@
 #define MIN_BURST_SIZE_ARG "min_burst"
 #define DEQ_BURST_SIZE_ARG "deq_burst"
 #define REFIL_ONCE_ARG "refill_once"
+#define SCHED_SHARDS_ARG "sched_shards"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
@@ -118,7 +119,9 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 		}
 	}
 
-	p->unlinks_in_progress += unlinked;
+	/* each shard acks the unlinks for its own buffers */
+	for (i = 0; i < sw->shard_count; i++)
+		sw->shards[i].ports[p->id].unlinks_in_progress += unlinked;
 	rte_smp_mb();
 
 	return unlinked;
@@ -127,9 +130,81 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 static int
 sw_port_unlinks_in_progress(struct rte_eventdev *dev, void *port)
 {
-	RTE_SET_USED(dev);
+	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = port;
-	return p->unlinks_in_progress;
+	unsigned int i;
+	int unlinks = 0;
+
+	for (i = 0; i < sw->shard_count; i++)
+		unlinks += sw->shards[i].ports[p->id].unlinks_in_progress;
+	return unlinks;
+}
+
+static void
+sw_port_shadow_release(struct sw_port *p)
+{
+	rte_event_ring_free(p->rx_worker_ring);
+	rte_event_ring_free(p->cq_worker_ring);
+	memset(p, 0, sizeof(*p));
+}
+
+/* Sets up the port shadow of a shard other than the first one, whose port
+ * shadows are the device ports.
+ */
+static int
+sw_port_shadow_setup(struct rte_eventdev *dev, struct sw_shard *sh,
+		uint8_t port_id, const struct rte_event_port_conf *conf)
+{
+	struct sw_port *p = &sh->ports[port_id];
+	char buf[RTE_RING_NAMESIZE];
+	unsigned int i;
+
+	*p = (struct sw_port){0}; /* zero entire structure */
+	p->id = port_id;
+	p->sw = sh->sw;
+
+	/* free the rings of a previous setup, as for the device ports */
+	snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_rx", dev->data->dev_id,
+			port_id, sh->id);
+	struct rte_event_ring *existing_ring = rte_event_ring_lookup(buf);
+	if (existing_ring)
+		rte_event_ring_free(existing_ring);
+
+	p->rx_worker_ring = rte_event_ring_create(buf, MAX_SW_PROD_Q_DEPTH,
+			dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (p->rx_worker_ring == NULL) {
+		SW_LOG_ERR("Error creating RX worker ring for port %d, shard %d\n",
+			port_id, sh->id);
+		return -1;
+	}
+
+	snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_cq", dev->data->dev_id,
+			port_id, sh->id);
+	existing_ring = rte_event_ring_lookup(buf);
+	if (existing_ring)
+		rte_event_ring_free(existing_ring);
+
+	p->cq_worker_ring = rte_event_ring_create(buf, conf->dequeue_depth,
+			dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (p->cq_worker_ring == NULL) {
+		rte_event_ring_free(p->rx_worker_ring);
+		p->rx_worker_ring = NULL;
+		SW_LOG_ERR("Error creating CQ worker ring for port %d, shard %d\n",
+			port_id, sh->id);
+		return -1;
+	}
+	sh->cq_ring_space[port_id] = conf->dequeue_depth;
+
+	/* set hist list contents to empty */
+	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
+		p->hist_list[i].fid = -1;
+		p->hist_list[i].qid = -1;
+	}
+
+	p->initialized = 1;
+	return 0;
 }
 
 static int
@@ -151,8 +226,12 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		 * available in the port (p->inflight_credits). We must return
 		 * the sum to no leak credits
 		 */
-		int possible_inflights = p->inflight_credits + p->inflights;
+		int possible_inflights = p->inflight_credits;
+		for (i = 0; i < sw->shard_count; i++)
+			possible_inflights +=
+				sw->shards[i].ports[port_id].inflights;
 		rte_atomic32_sub(&sw->inflights, possible_inflights);
+		rte_free(p->rel_shards);
 	}
 
 	*p = (struct sw_port){0}; /* zero entire structure */
@@ -198,27 +277,62 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 				port_id);
 		return -1;
 	}
-	sw->cq_ring_space[port_id] = conf->dequeue_depth;
+	sw->shards[0].cq_ring_space[port_id] = conf->dequeue_depth;
 
 	/* set hist list contents to empty */
 	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
 		p->hist_list[i].fid = -1;
 		p->hist_list[i].qid = -1;
 	}
+
+	if (sw->shard_count > 1) {
+		p->rel_shards = rte_zmalloc_socket(NULL, SW_PORT_REL_SHARDS,
+				RTE_CACHE_LINE_SIZE, dev->data->socket_id);
+		if (p->rel_shards == NULL) {
+			SW_LOG_ERR("Error allocating release list for port %d\n",
+					port_id);
+			goto err_rings;
+		}
+		for (i = 1; i < sw->shard_count; i++)
+			if (sw_port_shadow_setup(dev, &sw->shards[i], port_id,
+					conf) < 0)
+				goto err_shadows;
+	}
 	dev->data->ports[port_id] = p;
 
 	rte_smp_wmb();
 	p->initialized = 1;
 	return 0;
+
+err_shadows:
+	while (--i > 0)
+		sw_port_shadow_release(&sw->shards[i].ports[port_id]);
+	rte_free(p->rel_shards);
+	p->rel_shards = NULL;
+err_rings:
+	rte_event_ring_free(p->rx_worker_ring);
+	rte_event_ring_free(p->cq_worker_ring);
+	p->rx_worker_ring = NULL;
+	p->cq_worker_ring = NULL;
+	return -1;
 }
 
 static void
 sw_port_release(void *port)
 {
 	struct sw_port *p = (void *)port;
+	struct sw_evdev *sw;
+	unsigned int i;
+
 	if (p == NULL)
 		return;
 
+	sw = p->sw;
+	if (sw != NULL)
+		for (i = 1; i < sw->shard_count; i++)
+			sw_port_shadow_release(&sw->shards[i].ports[p->id]);
+
+	rte_free(p->rel_shards);
 	rte_event_ring_free(p->rx_worker_ring);
 	rte_event_ring_free(p->cq_worker_ring);
 	memset(p, 0, sizeof(*p));
@@ -363,7 +477,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(&sw->shards[sw->qid_shard[i]], &qid->iq[j]);
 	}
 }
 
@@ -385,12 +499,21 @@ sw_qids_empty(struct sw_evdev *sw)
 static int
 sw_ports_empty(struct sw_evdev *sw)
 {
-	unsigned int i;
+	unsigned int i, s;
 
-	for (i = 0; i < sw->port_count; i++) {
-		if ((rte_event_ring_count(sw->ports[i].rx_worker_ring)) ||
-		     rte_event_ring_count(sw->ports[i].cq_worker_ring))
+	for (s = 0; s < sw->shard_count; s++) {
+		struct sw_shard *sh = &sw->shards[s];
+
+		if (sh->xfer_ring && rte_event_ring_count(sh->xfer_ring))
 			return 0;
+
+		for (i = 0; i < sw->port_count; i++) {
+			struct sw_port *p = &sh->ports[i];
+
+			if ((rte_event_ring_count(p->rx_worker_ring)) ||
+			     rte_event_ring_count(p->cq_worker_ring))
+				return 0;
+		}
 	}
 
 	return 1;
@@ -423,9 +546,9 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_shard *sh,
+		struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -437,7 +560,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(sh, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -452,7 +575,8 @@ sw_drain_queues(struct rte_eventdev *dev)
 
 	for (i = 0; i < sw->qid_count; i++) {
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, &sw->shards[sw->qid_shard[i]],
+					&sw->qids[i].iq[j]);
 	}
 }
 
@@ -469,7 +593,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(&sw->shards[sw->qid_shard[i]],
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -511,6 +636,7 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	const struct rte_eventdev_data *data = dev->data;
 	const struct rte_event_dev_config *conf = &data->dev_conf;
+	uint32_t num_qids, s;
 	int num_chunks, i;
 
 	sw->qid_count = conf->nb_event_queues;
@@ -518,28 +644,60 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	sw->nb_events_limit = conf->nb_events_limit;
 	rte_atomic32_set(&sw->inflights, 0);
 
-	/* Number of chunks sized for worst-case spread of events across IQs */
-	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
-			sw->qid_count*SW_IQS_MAX*2;
+	for (s = 0; s < sw->shard_count; s++) {
+		struct sw_shard *sh = &sw->shards[s];
 
-	/* If this is a reconfiguration, free the previous IQ allocation. All
-	 * IQ chunk references were cleaned out of the QIDs in sw_stop(), and
-	 * will be reinitialized in sw_start().
-	 */
-	if (sw->chunks)
-		rte_free(sw->chunks);
+		/* QIDs are spread round-robin over the shards */
+		num_qids = (sw->qid_count + sw->shard_count - 1 - s) /
+				sw->shard_count;
 
-	sw->chunks = rte_malloc_socket(NULL,
-				       sizeof(struct sw_queue_chunk) *
-				       num_chunks,
-				       0,
-				       sw->data->socket_id);
-	if (!sw->chunks)
-		return -ENOMEM;
+		/* Number of chunks sized for worst-case spread of events
+		 * across IQs
+		 */
+		num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
+				num_qids*SW_IQS_MAX*2;
 
-	sw->chunk_list_head = NULL;
-	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+		/* If this is a reconfiguration, free the previous IQ
+		 * allocation. All IQ chunk references were cleaned out of the
+		 * QIDs in sw_stop(), and will be reinitialized in sw_start().
+		 */
+		if (sh->chunks)
+			rte_free(sh->chunks);
+
+		sh->chunks = rte_malloc_socket(NULL,
+					       sizeof(struct sw_queue_chunk) *
+					       num_chunks,
+					       0,
+					       sw->data->socket_id);
+		if (!sh->chunks)
+			return -ENOMEM;
+
+		sh->chunk_list_head = NULL;
+		for (i = 0; i < num_chunks; i++)
+			iq_free_chunk(sh, &sh->chunks[i]);
+
+		if (sw->shard_count == 1)
+			continue;
+
+		/* Every event in flight may be forwarded to the same shard,
+		 * so the ring to forward events to a shard can't overflow.
+		 */
+		char buf[RTE_RING_NAMESIZE];
+		snprintf(buf, sizeof(buf), "sw%d_s%u_xfer", data->dev_id, s);
+		struct rte_event_ring *existing_ring =
+				rte_event_ring_lookup(buf);
+		if (existing_ring)
+			rte_event_ring_free(existing_ring);
+
+		sh->xfer_ring = rte_event_ring_create(buf,
+				SW_INFLIGHT_EVENTS_TOTAL, data->socket_id,
+				RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (sh->xfer_ring == NULL) {
+			SW_LOG_ERR("Error creating xfer ring for shard %d\n",
+					s);
+			return -ENOMEM;
+		}
+	}
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
@@ -624,16 +782,41 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	static const char * const q_type_strings[] = {
 			"Ordered", "Atomic", "Parallel", "Directed"
 	};
-	uint32_t i;
+	struct sw_point_stats stats = {0};
+	uint64_t sched_called = 0, sched_cq_qid_called = 0;
+	uint64_t sched_no_iq_enqueues = 0, sched_no_cq_enqueues = 0;
+	uint32_t i, s;
 	fprintf(f, "EventDev %s: ports %d, qids %d\n", "todo-fix-name",
 			sw->port_count, sw->qid_count);
 
+	for (s = 0; s < sw->shard_count; s++) {
+		const struct sw_shard *sh = &sw->shards[s];
+
+		stats.rx_pkts += sh->stats.rx_pkts;
+		stats.rx_dropped += sh->stats.rx_dropped;
+		stats.tx_pkts += sh->stats.tx_pkts;
+		sched_called += sh->sched_called;
+		sched_cq_qid_called += sh->sched_cq_qid_called;
+		sched_no_iq_enqueues += sh->sched_no_iq_enqueues;
+		sched_no_cq_enqueues += sh->sched_no_cq_enqueues;
+	}
+
 	fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
-		sw->stats.rx_pkts, sw->stats.rx_dropped, sw->stats.tx_pkts);
-	fprintf(f, "\tsched calls: %"PRIu64"\n", sw->sched_called);
-	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
-	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
-	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+		stats.rx_pkts, stats.rx_dropped, stats.tx_pkts);
+	fprintf(f, "\tsched calls: %"PRIu64"\n", sched_called);
+	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sched_cq_qid_called);
+	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sched_no_iq_enqueues);
+	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sched_no_cq_enqueues);
+	if (sw->shard_count > 1) {
+		for (s = 0; s < sw->shard_count; s++) {
+			const struct sw_shard *sh = &sw->shards[s];
+
+			fprintf(f, "\tshard %u: qids %u, rx %"PRIu64
+				", tx %"PRIu64", xfer %"PRIu64"\n", s,
+				sh->qid_count, sh->stats.rx_pkts,
+				sh->stats.tx_pkts, sh->sched_xfer_pkts);
+		}
+	}
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -651,13 +834,23 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 		}
 		fprintf(f, "  Port %d %s\n", i,
 			p->is_directed ? " (SingleCons)" : "");
+		struct sw_point_stats port_stats = {0};
+		uint32_t port_inflights = 0;
+		for (s = 0; s < sw->shard_count; s++) {
+			const struct sw_port *sp = &sw->shards[s].ports[i];
+
+			port_stats.rx_pkts += sp->stats.rx_pkts;
+			port_stats.rx_dropped += sp->stats.rx_dropped;
+			port_stats.tx_pkts += sp->stats.tx_pkts;
+			port_inflights += sp->inflights;
+		}
 		fprintf(f, "\trx   %"PRIu64"\tdrop %"PRIu64"\ttx   %"PRIu64
-			"\t%sinflight %d%s\n", sw->ports[i].stats.rx_pkts,
-			sw->ports[i].stats.rx_dropped,
-			sw->ports[i].stats.tx_pkts,
-			(p->inflights == p->inflight_max) ?
+			"\t%sinflight %d%s\n", port_stats.rx_pkts,
+			port_stats.rx_dropped,
+			port_stats.tx_pkts,
+			(port_inflights == p->inflight_max) ?
 				COL_RED : COL_RESET,
-			sw->ports[i].inflights, COL_RESET);
+			port_inflights, COL_RESET);
 
 		fprintf(f, "\tMax New: %u"
 			"\tAvg cycles PP: %"PRIu64"\tCredits: %u\n",
@@ -801,12 +994,16 @@ sw_start(struct rte_eventdev *dev)
 	 * "If two members compare as equal, their order in the sorted
 	 * array is undefined."
 	 */
-	uint32_t qidx = 0;
+	for (i = 0; i < sw->shard_count; i++)
+		sw->shards[i].qid_count = 0;
 	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
 		for (i = 0; i < sw->qid_count; i++) {
 			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
+				struct sw_shard *sh =
+					&sw->shards[sw->qid_shard[i]];
+				sh->qids_prioritized[sh->qid_count] =
+					&sw->qids[i];
+				sh->qid_count++;
 			}
 		}
 	}
@@ -866,11 +1063,19 @@ sw_close(struct rte_eventdev *dev)
 		sw_port_release(&sw->ports[i]);
 	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (i = 0; i < sw->shard_count; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		memset(&sh->stats, 0, sizeof(sh->stats));
+		sh->sched_called = 0;
+		sh->sched_no_iq_enqueues = 0;
+		sh->sched_no_cq_enqueues = 0;
+		sh->sched_cq_qid_called = 0;
+		sh->sched_xfer_pkts = 0;
+
+		rte_event_ring_free(sh->xfer_ring);
+		sh->xfer_ring = NULL;
+	}
 
 	return 0;
 }
@@ -935,6 +1140,37 @@ set_refill_once(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_shards(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *shards = opaque;
+	*shards = atoi(value);
+	if (*shards < 1 || *shards > SW_SCHED_SHARDS_MAX)
+		return -1;
+	return 0;
+}
+
+static void
+sw_shards_init(struct sw_evdev *sw, uint32_t shard_count)
+{
+	uint32_t i;
+
+	sw->shard_count = shard_count;
+	for (i = 0; i < RTE_EVENT_MAX_QUEUES_PER_DEV; i++)
+		sw->qid_shard[i] = i % shard_count;
+
+	for (i = 0; i < shard_count; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		sh->sw = sw;
+		sh->id = i;
+		rte_spinlock_init(&sh->lock);
+		/* port shadows of the other shards trail the device */
+		sh->ports = (i == 0) ? sw->ports :
+				&sw->shard_ports[(i - 1) * SW_PORTS_MAX];
+	}
+}
+
 static int32_t sw_sched_service_func(void *args)
 {
 	struct rte_eventdev *dev = args;
@@ -984,6 +1220,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		MIN_BURST_SIZE_ARG,
 		DEQ_BURST_SIZE_ARG,
 		REFIL_ONCE_ARG,
+		SCHED_SHARDS_ARG,
 		NULL
 	};
 	const char *name;
@@ -996,6 +1233,7 @@ sw_probe(struct rte_vdev_device *vdev)
 	int min_burst_size = 1;
 	int deq_burst_size = SCHED_DEQUEUE_DEFAULT_BURST_SIZE;
 	int refill_once = 0;
+	int sched_shards = 1;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1067,6 +1305,16 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_SHARDS_ARG,
+					set_sched_shards, &sched_shards);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing scheduler shards parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
@@ -1074,12 +1322,15 @@ sw_probe(struct rte_vdev_device *vdev)
 	SW_LOG_INFO(
 			"Creating eventdev sw device %s, numa_node=%d, "
 			"sched_quanta=%d, credit_quanta=%d "
-			"min_burst=%d, deq_burst=%d, refill_once=%d\n",
+			"min_burst=%d, deq_burst=%d, refill_once=%d, "
+			"sched_shards=%d\n",
 			name, socket_id, sched_quanta, credit_quanta,
-			min_burst_size, deq_burst_size, refill_once);
+			min_burst_size, deq_burst_size, refill_once,
+			sched_shards);
 
-	dev = rte_event_pmd_vdev_init(name,
-			sizeof(struct sw_evdev), socket_id);
+	dev = rte_event_pmd_vdev_init(name, sizeof(struct sw_evdev) +
+			sizeof(struct sw_port) * SW_PORTS_MAX *
+			(sched_shards - 1), socket_id);
 	if (dev == NULL) {
 		SW_LOG_ERR("eventdev vdev init() failed");
 		return -EFAULT;
@@ -1091,6 +1342,14 @@ sw_probe(struct rte_vdev_device *vdev)
 	dev->enqueue_forward_burst = sw_event_enqueue_burst;
 	dev->dequeue = sw_event_dequeue;
 	dev->dequeue_burst = sw_event_dequeue_burst;
+	if (sched_shards > 1) {
+		dev->enqueue = sw_event_enqueue_sharded;
+		dev->enqueue_burst = sw_event_enqueue_burst_sharded;
+		dev->enqueue_new_burst = sw_event_enqueue_burst_sharded;
+		dev->enqueue_forward_burst = sw_event_enqueue_burst_sharded;
+		dev->dequeue = sw_event_dequeue_sharded;
+		dev->dequeue_burst = sw_event_dequeue_burst_sharded;
+	}
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
 		return 0;
@@ -1105,6 +1364,8 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->sched_deq_burst_size = deq_burst_size;
 	sw->refill_once_per_iter = refill_once;
 
+	sw_shards_init(sw, sched_shards);
+
 	/* register service with EAL */
 	struct rte_service_spec service;
 	memset(&service, 0, sizeof(struct rte_service_spec));
@@ -1114,6 +1375,9 @@ sw_probe(struct rte_vdev_device *vdev)
 	service.socket_id = socket_id;
 	service.callback = sw_sched_service_func;
 	service.callback_userdata = (void *)dev;
+	/* the shards can be scheduled by as many service cores */
+	if (sched_shards > 1)
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
 
 	int32_t ret = rte_service_component_register(&service, &sw->service_id);
 	if (ret) {
@@ -1150,5 +1414,5 @@ RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
 		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
 		MIN_BURST_SIZE_ARG "=<int>" DEQ_BURST_SIZE_ARG "=<int>"
-		REFIL_ONCE_ARG "=<int>");
+		REFIL_ONCE_ARG "=<int>" SCHED_SHARDS_ARG "=<int>");
 RTE_LOG_REGISTER(eventdev_sw_log_level, pmd.event.sw, NOTICE);
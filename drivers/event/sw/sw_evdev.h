@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <rte_eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_spinlock.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,8 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+/* max number of scheduler shards, each owning a subset of the QIDs */
+#define SW_SCHED_SHARDS_MAX 8
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -35,10 +38,14 @@
 
 /* Flush the pipeline after this many no enq to cq */
 #define SCHED_NO_ENQ_CYCLE_FLUSH 256
+/* events buffered by a shard before forwarding them to another shard */
+#define SCHED_XFER_BURST_SIZE 32
 
 
 #define SW_PORT_HIST_LIST (MAX_SW_PROD_Q_DEPTH) /* size of our history list */
 #define NUM_SAMPLES 64 /* how many data points use for average stats */
+/* size of the per port list of shards which scheduled unreleased events */
+#define SW_PORT_REL_SHARDS (SW_PORT_HIST_LIST * SW_SCHED_SHARDS_MAX)
 
 #define EVENTDEV_NAME_SW_PMD event_sw
 #define SW_PMD_NAME RTE_STR(event_sw)
@@ -181,6 +188,14 @@ struct sw_port {
 	uint16_t inflight_max; /* app requested max inflights for this port */
 	uint16_t inflight_credits; /* num credits this port has right now */
 	uint8_t implicit_release; /* release events before dequeueing */
+	uint8_t deq_shard; /* shard to dequeue from first, when sharded */
+
+	/* Shard which scheduled each event dequeued and not yet released,
+	 * in dequeue order. Only used when the scheduler is sharded.
+	 */
+	uint8_t *rel_shards;
+	uint16_t rel_head;
+	uint16_t rel_tail;
 
 	uint16_t last_dequeue_burst_sz; /* how big the burst was */
 	uint64_t last_dequeue_ticks; /* used to track burst processing time */
@@ -209,6 +224,51 @@ struct sw_port {
 	uint8_t num_qids_mapped;
 };
 
+/*
+ * A scheduler shard owns a subset of the QIDs, with their IQs and the chunks
+ * backing them, and a shadow of every port: the rings to and from the worker,
+ * the history list and the CQ credits. The shards schedule independently, and
+ * hand events for a QID owned by another shard over through its xfer ring,
+ * once the atomic or ordered context of the source QID has been completed.
+ */
+struct sw_shard {
+	struct sw_evdev *sw;
+	/* Port shadows of this shard, shard 0 uses the device ports */
+	struct sw_port *ports;
+	/* Taken by the service core scheduling this shard */
+	rte_spinlock_t lock;
+	uint8_t id;
+	/* Number of QIDs owned by this shard */
+	uint32_t qid_count;
+	/* Events forwarded to the QIDs of this shard by other shards */
+	struct rte_event_ring *xfer_ring;
+
+	/* Current values */
+	uint32_t sched_flush_count;
+	uint32_t sched_min_burst;
+
+	struct sw_queue_chunk *chunk_list_head;
+	struct sw_queue_chunk *chunks;
+
+	/* Events waiting to be forwarded to each shard */
+	uint16_t xfer_count[SW_SCHED_SHARDS_MAX];
+	struct rte_event xfer_buf[SW_SCHED_SHARDS_MAX][SCHED_XFER_BURST_SIZE];
+
+	/* Cache how many packets are in each cq */
+	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
+
+	/* Array of pointers to the owned QIDs sorted by priority level */
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* Stats */
+	struct sw_point_stats stats __rte_cache_aligned;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+	uint64_t sched_xfer_pkts;
+} __rte_cache_aligned;
+
 struct sw_evdev {
 	struct rte_eventdev_data *data;
 
@@ -226,9 +286,10 @@ struct sw_evdev {
 	uint32_t sched_deq_burst_size;
 	/* Refill pp buffers only once per scheduler call*/
 	uint32_t refill_once_per_iter;
-	/* Current values */
-	uint32_t sched_flush_count;
-	uint32_t sched_min_burst;
+	/* Number of scheduler shards */
+	uint32_t shard_count;
+	/* Shard owning each QID */
+	uint8_t qid_shard[RTE_EVENT_MAX_QUEUES_PER_DEV];
 
 	/* Contains all ports - load balanced and directed */
 	struct sw_port ports[SW_PORTS_MAX] __rte_cache_aligned;
@@ -243,22 +304,11 @@ struct sw_evdev {
 
 	/* Internal queues - one per logical queue */
 	struct sw_qid qids[RTE_EVENT_MAX_QUEUES_PER_DEV] __rte_cache_aligned;
-	struct sw_queue_chunk *chunk_list_head;
-	struct sw_queue_chunk *chunks;
-
-	/* Cache how many packets are in each cq */
-	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
 
-	/* Array of pointers to load-balanced QIDs sorted by priority level */
-	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+	/* Scheduler shards, with their QIDs and port shadows */
+	struct sw_shard shards[SW_SCHED_SHARDS_MAX];
 
-	/* Stats */
-	struct sw_point_stats stats __rte_cache_aligned;
-	uint64_t sched_called;
 	int32_t sched_quanta;
-	uint64_t sched_no_iq_enqueues;
-	uint64_t sched_no_cq_enqueues;
-	uint64_t sched_cq_qid_called;
 
 	uint8_t started;
 	uint32_t credit_update_quanta;
@@ -272,6 +322,9 @@ struct sw_evdev {
 
 	uint32_t service_id;
 	char service_name[SW_PMD_NAME_MAX];
+
+	/* Port shadows of the shards after the first one */
+	struct sw_port shard_ports[] __rte_cache_aligned;
 };
 
 static inline struct sw_evdev *
@@ -293,6 +346,13 @@ uint16_t sw_event_enqueue_burst(void *port, const struct rte_event ev[],
 uint16_t sw_event_dequeue(void *port, struct rte_event *ev, uint64_t wait);
 uint16_t sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 			uint64_t wait);
+uint16_t sw_event_enqueue_sharded(void *port, const struct rte_event *ev);
+uint16_t sw_event_enqueue_burst_sharded(void *port, const struct rte_event ev[],
+		uint16_t num);
+uint16_t sw_event_dequeue_sharded(void *port, struct rte_event *ev,
+		uint64_t wait);
+uint16_t sw_event_dequeue_burst_sharded(void *port, struct rte_event *ev,
+		uint16_t num, uint64_t wait);
 void sw_event_schedule(struct rte_eventdev *dev);
 int sw_xstats_init(struct sw_evdev *dev);
 int sw_xstats_uninit(struct sw_evdev *dev);
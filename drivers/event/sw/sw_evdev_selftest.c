@@ -164,9 +164,11 @@ init(struct test *t, int nb_queues, int nb_ports)
 	int ret;
 
 	void *temp = t->mbuf_pool; /* save and restore mbuf pool */
+	uint32_t service_id = t->service_id; /* and the scheduler service */
 
 	memset(t, 0, sizeof(*t));
 	t->mbuf_pool = temp;
+	t->service_id = service_id;
 
 	ret = rte_event_dev_configure(evdev, &config);
 	if (ret < 0)
@@ -3177,6 +3179,73 @@ worker_loopback(struct test *t, uint8_t disable_implicit_release)
 	return 0;
 }
 
+/*
+ * Re-run the scheduling tests on an instance with its scheduler split in two
+ * shards, so that the queues used by the tests are owned by different shards
+ * and the events hop between them.
+ */
+static int
+test_sw_sharded(struct test *t)
+{
+	const char *eventdev_name = "event_sw_sharded";
+	int main_evdev = evdev;
+	uint32_t main_service_id = t->service_id;
+	int ret = -1;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "sched_shards=2") < 0) {
+			printf("Error creating sharded eventdev\n");
+			goto out;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+		if (evdev < 0) {
+			printf("Error finding newly created eventdev\n");
+			goto out;
+		}
+	}
+
+	if (rte_event_dev_service_id_get(evdev, &t->service_id) < 0) {
+		printf("Failed to get service ID for sharded event dev\n");
+		goto out;
+	}
+	rte_service_runstate_set(t->service_id, 1);
+	rte_service_set_runstate_mapped_check(t->service_id, 0);
+
+	printf("*** Running Sharded Single Load Balanced Packet test...\n");
+	if (single_packet(t) != 0) {
+		printf("ERROR - Sharded Single Packet test FAILED.\n");
+		goto out;
+	}
+	printf("*** Running Sharded Unordered Basic test...\n");
+	if (unordered_basic(t) != 0) {
+		printf("ERROR - Sharded Unordered Basic test FAILED.\n");
+		goto out;
+	}
+	printf("*** Running Sharded Ordered Basic test...\n");
+	if (ordered_basic(t) != 0) {
+		printf("ERROR - Sharded Ordered Basic test FAILED.\n");
+		goto out;
+	}
+	printf("*** Running Sharded Load Balancing test...\n");
+	if (load_balancing(t) != 0) {
+		printf("ERROR - Sharded Load Balancing test FAILED.\n");
+		goto out;
+	}
+	if (rte_lcore_count() >= 3) {
+		printf("*** Running Sharded Worker loopback test...\n");
+		if (worker_loopback(t, 0) != 0) {
+			printf("ERROR - Sharded Worker loopback test FAILED.\n");
+			goto out;
+		}
+	}
+	ret = 0;
+out:
+	evdev = main_evdev;
+	t->service_id = main_service_id;
+	return ret;
+}
+
 static struct rte_mempool *eventdev_func_mempool;
 
 int
@@ -3407,6 +3476,9 @@ test_sw_eventdev(void)
 		printf("### Not enough cores for worker loopback tests.\n");
 		printf("### Need at least 3 cores for the tests.\n");
 	}
+	ret = test_sw_sharded(t);
+	if (ret != 0)
+		goto test_fail;
 
 	/*
 	 * Free test instance, leaving mempool initialized, and a pointer to it
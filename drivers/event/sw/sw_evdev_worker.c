@@ -23,8 +23,16 @@ sw_event_release(struct sw_port *p, uint8_t index)
 	struct rte_event ev;
 	ev.op = sw_qe_flag_map[RTE_EVENT_OP_RELEASE];
 
+	/* when sharded, the release goes to the shard of the event */
+	struct rte_event_ring *ring = p->rx_worker_ring;
+	if (p->rel_shards != NULL) {
+		uint8_t s = p->rel_shards[p->rel_tail++ &
+				(SW_PORT_REL_SHARDS - 1)];
+		ring = p->sw->shards[s].ports[p->id].rx_worker_ring;
+	}
+
 	uint16_t free_count;
-	rte_event_ring_enqueue_burst(p->rx_worker_ring, &ev, 1, &free_count);
+	rte_event_ring_enqueue_burst(ring, &ev, 1, &free_count);
 
 	/* each release returns one credit */
 	p->outstanding_releases--;
@@ -49,30 +57,29 @@ enqueue_burst_with_ops(struct rte_event_ring *r, const struct rte_event *events,
 	return rte_event_ring_enqueue_burst(r, tmp_evs, n, NULL);
 }
 
-uint16_t
-sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
+/*
+ * Takes the credits for the new events of the burst, returning the number of
+ * events which can be enqueued, or -1 if the port is over its threshold.
+ */
+static __rte_always_inline int32_t
+sw_port_credits_take(struct sw_port *p, struct sw_evdev *sw,
+		const struct rte_event ev[], uint16_t num)
 {
-	int32_t i;
-	uint8_t new_ops[PORT_ENQUEUE_MAX_BURST_SIZE];
-	struct sw_port *p = port;
-	struct sw_evdev *sw = (void *)p->sw;
 	uint32_t sw_inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credit_update_quanta = sw->credit_update_quanta;
 	int new = 0;
-
-	if (num > PORT_ENQUEUE_MAX_BURST_SIZE)
-		num = PORT_ENQUEUE_MAX_BURST_SIZE;
+	int32_t i;
 
 	for (i = 0; i < num; i++)
 		new += (ev[i].op == RTE_EVENT_OP_NEW);
 
 	if (unlikely(new > 0 && p->inflight_max < sw_inflights))
-		return 0;
+		return -1;
 
 	if (p->inflight_credits < new) {
 		/* check if event enqueue brings port over max threshold */
 		if (sw_inflights + credit_update_quanta > sw->nb_events_limit)
-			return 0;
+			return -1;
 
 		rte_atomic32_add(&sw->inflights, credit_update_quanta);
 		p->inflight_credits += (credit_update_quanta);
@@ -83,6 +90,22 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 		num = (p->inflight_credits < new) ? p->inflight_credits : new;
 	}
 
+	return num;
+}
+
+/*
+ * Computes the scheduler ops of the events. When sharded, also computes the
+ * shard each event goes to: the shard of the event being completed, which
+ * forwards the event once the atomic or ordered context is released, or the
+ * shard of the destination QID for new events.
+ */
+static __rte_always_inline void
+sw_port_event_ops(struct sw_port *p, struct sw_evdev *sw,
+		const struct rte_event ev[], uint16_t num, uint8_t *new_ops,
+		uint8_t *shards)
+{
+	int32_t i;
+
 	for (i = 0; i < num; i++) {
 		int op = ev[i].op;
 		int outstanding = p->outstanding_releases > 0;
@@ -99,8 +122,19 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 		 * correct usage of the API), providing very high correct
 		 * prediction rate.
 		 */
-		if ((new_ops[i] & QE_FLAG_COMPLETE) && outstanding)
+		if ((new_ops[i] & QE_FLAG_COMPLETE) && outstanding) {
 			p->outstanding_releases--;
+			if (shards != NULL)
+				shards[i] = p->rel_shards[p->rel_tail++ &
+						(SW_PORT_REL_SHARDS - 1)];
+		} else if (shards != NULL) {
+			/* no shard holds an event to complete, events to an
+			 * invalid QID go to shard 0 which drops them
+			 */
+			new_ops[i] &= ~QE_FLAG_COMPLETE;
+			shards[i] = invalid_qid ? 0 :
+					sw->qid_shard[ev[i].queue_id];
+		}
 
 		/* error case: branch to avoid touching p->stats */
 		if (unlikely(invalid_qid && op != RTE_EVENT_OP_RELEASE)) {
@@ -108,10 +142,13 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 			p->inflight_credits++;
 		}
 	}
+}
+
+static __rte_always_inline void
+sw_port_enqueue_done(struct sw_port *p, struct sw_evdev *sw)
+{
+	uint32_t credit_update_quanta = sw->credit_update_quanta;
 
-	/* returns number of events actually enqueued */
-	uint32_t enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i,
-					     new_ops);
 	if (p->outstanding_releases == 0 && p->last_dequeue_burst_sz != 0) {
 		uint64_t burst_ticks = rte_get_timer_cycles() -
 				p->last_dequeue_ticks;
@@ -127,10 +164,84 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 		rte_atomic32_sub(&sw->inflights, credit_update_quanta);
 		p->inflight_credits -= credit_update_quanta;
 	}
+}
+
+uint16_t
+sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
+{
+	uint8_t new_ops[PORT_ENQUEUE_MAX_BURST_SIZE];
+	struct sw_port *p = port;
+	struct sw_evdev *sw = (void *)p->sw;
+
+	if (num > PORT_ENQUEUE_MAX_BURST_SIZE)
+		num = PORT_ENQUEUE_MAX_BURST_SIZE;
+
+	int32_t allowed = sw_port_credits_take(p, sw, ev, num);
+	if (allowed < 0)
+		return 0;
+	num = allowed;
+
+	sw_port_event_ops(p, sw, ev, num, new_ops, NULL);
+
+	/* returns number of events actually enqueued */
+	uint32_t enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, num,
+					     new_ops);
+	sw_port_enqueue_done(p, sw);
 
 	return enq;
 }
 
+uint16_t
+sw_event_enqueue_burst_sharded(void *port, const struct rte_event ev[],
+		uint16_t num)
+{
+	struct rte_event evs[SW_SCHED_SHARDS_MAX][PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint16_t nb_evs[SW_SCHED_SHARDS_MAX] = {0};
+	uint8_t new_ops[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint8_t shards[PORT_ENQUEUE_MAX_BURST_SIZE];
+	struct sw_port *p = port;
+	struct sw_evdev *sw = (void *)p->sw;
+	uint32_t s;
+	uint16_t i;
+
+	if (num > PORT_ENQUEUE_MAX_BURST_SIZE)
+		num = PORT_ENQUEUE_MAX_BURST_SIZE;
+
+	/* The burst is spread over the shards once the credits are taken and
+	 * the releases accounted, so it is all or nothing.
+	 */
+	for (s = 0; s < sw->shard_count; s++) {
+		struct sw_port *sp = &sw->shards[s].ports[p->id];
+
+		if (rte_event_ring_free_count(sp->rx_worker_ring) < num)
+			return 0;
+	}
+
+	int32_t allowed = sw_port_credits_take(p, sw, ev, num);
+	if (allowed < 0)
+		return 0;
+	num = allowed;
+
+	sw_port_event_ops(p, sw, ev, num, new_ops, shards);
+
+	for (i = 0; i < num; i++) {
+		struct rte_event *e = &evs[shards[i]][nb_evs[shards[i]]++];
+
+		*e = ev[i];
+		e->op = new_ops[i];
+	}
+
+	for (s = 0; s < sw->shard_count; s++)
+		if (nb_evs[s])
+			rte_event_ring_enqueue_burst(
+				sw->shards[s].ports[p->id].rx_worker_ring,
+				evs[s], nb_evs[s], NULL);
+
+	sw_port_enqueue_done(p, sw);
+
+	return num;
+}
+
 uint16_t
 sw_event_enqueue(void *port, const struct rte_event *ev)
 {
@@ -138,35 +249,35 @@ sw_event_enqueue(void *port, const struct rte_event *ev)
 }
 
 uint16_t
-sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
-		uint64_t wait)
+sw_event_enqueue_sharded(void *port, const struct rte_event *ev)
 {
-	RTE_SET_USED(wait);
-	struct sw_port *p = (void *)port;
-	struct rte_event_ring *ring = p->cq_worker_ring;
+	return sw_event_enqueue_burst_sharded(port, ev, 1);
+}
 
-	/* check that all previous dequeues have been released */
-	if (p->implicit_release) {
-		struct sw_evdev *sw = (void *)p->sw;
-		uint32_t credit_update_quanta = sw->credit_update_quanta;
-		uint16_t out_rels = p->outstanding_releases;
-		uint16_t i;
-		for (i = 0; i < out_rels; i++)
-			sw_event_release(p, i);
-
-		/* Replenish credits if enough releases are performed */
-		if (p->inflight_credits >= credit_update_quanta * 2) {
-			rte_atomic32_sub(&sw->inflights, credit_update_quanta);
-			p->inflight_credits -= credit_update_quanta;
-		}
+static __rte_always_inline void
+sw_port_implicit_release(struct sw_port *p)
+{
+	struct sw_evdev *sw = (void *)p->sw;
+	uint32_t credit_update_quanta = sw->credit_update_quanta;
+	uint16_t out_rels = p->outstanding_releases;
+	uint16_t i;
+	for (i = 0; i < out_rels; i++)
+		sw_event_release(p, i);
+
+	/* Replenish credits if enough releases are performed */
+	if (p->inflight_credits >= credit_update_quanta * 2) {
+		rte_atomic32_sub(&sw->inflights, credit_update_quanta);
+		p->inflight_credits -= credit_update_quanta;
 	}
+}
 
-	/* returns number of events actually dequeued */
-	uint16_t ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+static __rte_always_inline uint16_t
+sw_port_dequeue_done(struct sw_port *p, uint16_t ndeq)
+{
 	if (unlikely(ndeq == 0)) {
 		p->zero_polls++;
 		p->total_polls++;
-		goto end;
+		return 0;
 	}
 
 	p->outstanding_releases += ndeq;
@@ -175,12 +286,77 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 	p->poll_buckets[(ndeq - 1) >> SW_DEQ_STAT_BUCKET_SHIFT]++;
 	p->total_polls++;
 
-end:
 	return ndeq;
 }
 
+uint16_t
+sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
+		uint64_t wait)
+{
+	RTE_SET_USED(wait);
+	struct sw_port *p = (void *)port;
+	struct rte_event_ring *ring = p->cq_worker_ring;
+
+	/* check that all previous dequeues have been released */
+	if (p->implicit_release)
+		sw_port_implicit_release(p);
+
+	/* returns number of events actually dequeued */
+	uint16_t ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+
+	return sw_port_dequeue_done(p, ndeq);
+}
+
+uint16_t
+sw_event_dequeue_burst_sharded(void *port, struct rte_event *ev, uint16_t num,
+		uint64_t wait)
+{
+	RTE_SET_USED(wait);
+	struct sw_port *p = (void *)port;
+	struct sw_evdev *sw = (void *)p->sw;
+	uint32_t s = p->deq_shard;
+	uint16_t ndeq = 0;
+	uint32_t i;
+
+	/* check that all previous dequeues have been released */
+	if (p->implicit_release)
+		sw_port_implicit_release(p);
+
+	/* a burst can't be bigger than a CQ of the unsharded device */
+	if (num > MAX_SW_CONS_Q_DEPTH)
+		num = MAX_SW_CONS_Q_DEPTH;
+
+	/* poll the CQ of each shard, starting with a different one each call,
+	 * and record which shard each event is to be released to
+	 */
+	for (i = 0; i < sw->shard_count && ndeq < num; i++) {
+		struct rte_event_ring *ring =
+				sw->shards[s].ports[p->id].cq_worker_ring;
+		uint16_t n = rte_event_ring_dequeue_burst(ring, &ev[ndeq],
+				num - ndeq, NULL);
+
+		for (; n > 0; n--, ndeq++)
+			p->rel_shards[p->rel_head++ &
+					(SW_PORT_REL_SHARDS - 1)] = s;
+
+		if (++s == sw->shard_count)
+			s = 0;
+	}
+
+	if (++p->deq_shard == sw->shard_count)
+		p->deq_shard = 0;
+
+	return sw_port_dequeue_done(p, ndeq);
+}
+
 uint16_t
 sw_event_dequeue(void *port, struct rte_event *ev, uint64_t wait)
 {
 	return sw_event_dequeue_burst(port, ev, 1, wait);
 }
+
+uint16_t
+sw_event_dequeue_sharded(void *port, struct rte_event *ev, uint64_t wait)
+{
+	return sw_event_dequeue_burst_sharded(port, ev, 1, wait);
+}
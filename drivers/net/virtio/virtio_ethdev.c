@@ -909,6 +909,47 @@ virtio_dev_rx_queue_intr_disable(struct rte_eth_dev *dev, uint16_t queue_id)
 	return 0;
 }
 
+static int
+virtio_dev_recycle_rxq_info_get(struct rte_eth_dev *dev, uint16_t queue_id,
+				struct rte_eth_recycle_rxq_info *info)
+{
+	struct virtio_hw *hw = dev->data->dev_private;
+	struct virtnet_rx *rxvq = dev->data->rx_queues[queue_id];
+	struct virtqueue *vq = rxvq->vq;
+
+	/* vectorized Rx paths refill the ring by fixed size batches */
+	if (hw->use_vec_rx)
+		return -ENOTSUP;
+
+	info->mp = rxvq->mpool;
+	info->refill_requirement = RTE_MIN(VIRTIO_RECYCLE_REFILL_MIN,
+					   vq->vq_nentries / 2);
+
+	return 0;
+}
+
+static int
+virtio_dev_recycle_rxq_set(struct rte_eth_dev *dev, uint16_t queue_id,
+			   int on)
+{
+	struct virtio_hw *hw = dev->data->dev_private;
+	struct virtnet_rx *rxvq = dev->data->rx_queues[queue_id];
+	struct virtqueue *vq = rxvq->vq;
+
+	if (!on) {
+		rxvq->recycle_thresh = 0;
+		return 0;
+	}
+
+	if (hw->use_vec_rx)
+		return -ENOTSUP;
+
+	/* refill from the mempool only when half of the ring is empty */
+	rxvq->recycle_thresh = vq->vq_nentries / 2;
+
+	return 0;
+}
+
 /*
  * dev_ops for virtio, bare necessities for basic operation
  */
@@ -942,6 +983,8 @@ static const struct eth_dev_ops virtio_eth_dev_ops = {
 	.mac_addr_add            = virtio_mac_addr_add,
 	.mac_addr_remove         = virtio_mac_addr_remove,
 	.mac_addr_set            = virtio_mac_addr_set,
+	.recycle_rxq_info_get    = virtio_dev_recycle_rxq_info_get,
+	.recycle_rxq_set         = virtio_dev_recycle_rxq_set,
 };
 
 /*
@@ -1528,6 +1571,16 @@ set_rxtx_funcs(struct rte_eth_dev *eth_dev)
 	struct virtio_hw *hw = eth_dev->data->dev_private;
 
 	eth_dev->tx_pkt_prepare = virtio_xmit_pkts_prepare;
+	eth_dev->recycle_tx_mbufs_reuse = virtio_recycle_tx_mbufs_reuse;
+	if (!hw->use_vec_rx) {
+		eth_dev->recycle_rx_descriptors_room =
+			virtio_recycle_rx_descriptors_room;
+		eth_dev->recycle_rx_descriptors_refill =
+			virtio_recycle_rx_descriptors_refill;
+	} else {
+		eth_dev->recycle_rx_descriptors_room = NULL;
+		eth_dev->recycle_rx_descriptors_refill = NULL;
+	}
 	if (vtpci_packed_queue(hw)) {
 		PMD_INIT_LOG(INFO,
 			"virtio: using packed ring %s Tx path on port %u",
@@ -111,6 +111,12 @@ uint16_t virtio_recv_pkts_packed_vec(void *rx_queue, struct rte_mbuf **rx_pkts,
 uint16_t virtio_xmit_pkts_packed_vec(void *tx_queue, struct rte_mbuf **tx_pkts,
 		uint16_t nb_pkts);
 
+uint16_t virtio_recycle_rx_descriptors_room(void *rx_queue);
+uint16_t virtio_recycle_tx_mbufs_reuse(void *tx_queue, struct rte_mbuf **mbufs,
+		uint16_t nb_mbufs, struct rte_mempool *mp);
+void virtio_recycle_rx_descriptors_refill(void *rx_queue,
+		struct rte_mbuf **mbufs, uint16_t nb_mbufs);
+
 int eth_virtio_dev_init(struct rte_eth_dev *eth_dev);
 
 void virtio_interrupt_handler(void *param);
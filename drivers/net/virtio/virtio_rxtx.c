@@ -676,6 +676,7 @@ virtio_dev_rx_queue_setup(struct rte_eth_dev *dev,
 	rxvq = &vq->rxq;
 	rxvq->queue_id = queue_idx;
 	rxvq->mpool = mp;
+	rxvq->recycle_thresh = 0;
 	dev->data->rx_queues[queue_idx] = rxvq;
 
 	return 0;
@@ -949,6 +950,21 @@ virtio_rx_offload(struct rte_mbuf *m, struct virtio_net_hdr *hdr)
 	return 0;
 }
 
+/*
+ * Check whether the Rx ring must be refilled from the mempool. When mbufs
+ * are recycled, leave room for the ones coming from Tx queues and only
+ * refill when too many descriptors are empty.
+ */
+static inline bool
+virtio_rx_need_refill(struct virtnet_rx *rxvq)
+{
+	struct virtqueue *vq = rxvq->vq;
+
+	if (rxvq->recycle_thresh != 0)
+		return vq->vq_free_cnt >= rxvq->recycle_thresh;
+	return !virtqueue_full(vq);
+}
+
 #define DESC_PER_CACHELINE (RTE_CACHE_LINE_SIZE / sizeof(struct vring_desc))
 uint16_t
 virtio_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
@@ -1024,7 +1040,7 @@ virtio_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
 	rxvq->stats.packets += nb_rx;
 
 	/* Allocate new mbuf for the used descriptor */
-	if (likely(!virtqueue_full(vq))) {
+	if (likely(virtio_rx_need_refill(rxvq))) {
 		uint16_t free_cnt = vq->vq_free_cnt;
 		struct rte_mbuf *new_pkts[free_cnt];
 
@@ -1127,7 +1143,7 @@ virtio_recv_pkts_packed(void *rx_queue, struct rte_mbuf **rx_pkts,
 	rxvq->stats.packets += nb_rx;
 
 	/* Allocate new mbuf for the used descriptor */
-	if (likely(!virtqueue_full(vq))) {
+	if (likely(virtio_rx_need_refill(rxvq))) {
 		uint16_t free_cnt = vq->vq_free_cnt;
 		struct rte_mbuf *new_pkts[free_cnt];
 
@@ -1310,7 +1326,7 @@ virtio_recv_pkts_inorder(void *rx_queue,
 
 	/* Allocate new mbuf for the used descriptor */
 
-	if (likely(!virtqueue_full(vq))) {
+	if (likely(virtio_rx_need_refill(rxvq))) {
 		/* free_cnt may include mrg descs */
 		uint16_t free_cnt = vq->vq_free_cnt;
 		struct rte_mbuf *new_pkts[free_cnt];
@@ -1488,7 +1504,7 @@ virtio_recv_mergeable_pkts(void *rx_queue,
 	rxvq->stats.packets += nb_rx;
 
 	/* Allocate new mbuf for the used descriptor */
-	if (likely(!virtqueue_full(vq))) {
+	if (likely(virtio_rx_need_refill(rxvq))) {
 		/* free_cnt may include mrg descs */
 		uint16_t free_cnt = vq->vq_free_cnt;
 		struct rte_mbuf *new_pkts[free_cnt];
@@ -1657,7 +1673,7 @@ virtio_recv_mergeable_pkts_packed(void *rx_queue,
 	rxvq->stats.packets += nb_rx;
 
 	/* Allocate new mbuf for the used descriptor */
-	if (likely(!virtqueue_full(vq))) {
+	if (likely(virtio_rx_need_refill(rxvq))) {
 		/* free_cnt may include mrg descs */
 		uint16_t free_cnt = vq->vq_free_cnt;
 		struct rte_mbuf *new_pkts[free_cnt];
@@ -2042,3 +2058,86 @@ virtio_xmit_pkts_packed_vec(void *tx_queue __rte_unused,
 	return 0;
 }
 #endif /* ifndef CC_AVX512_SUPPORT */
+
+uint16_t
+virtio_recycle_rx_descriptors_room(void *rx_queue)
+{
+	struct virtnet_rx *rxvq = rx_queue;
+
+	return rxvq->vq->vq_free_cnt;
+}
+
+uint16_t
+virtio_recycle_tx_mbufs_reuse(void *tx_queue, struct rte_mbuf **mbufs,
+			      uint16_t nb_mbufs, struct rte_mempool *mp)
+{
+	struct virtnet_tx *txvq = tx_queue;
+	struct virtqueue *vq = txvq->vq;
+	struct virtio_hw *hw = vq->hw;
+	struct virtio_tx_recycle recycle = {
+		.mbufs = mbufs,
+		.mp = mp,
+		.nb_mbufs = 0,
+		.max_mbufs = nb_mbufs,
+	};
+	uint16_t nb_used;
+
+	/* the cleanup functions store the mbufs in the recycle array */
+	txvq->recycle = &recycle;
+	if (vtpci_packed_queue(hw)) {
+		virtio_xmit_cleanup_packed(vq, nb_mbufs,
+				vtpci_with_feature(hw, VIRTIO_F_IN_ORDER));
+	} else {
+		nb_used = RTE_MIN(virtqueue_nused(vq), nb_mbufs);
+		if (hw->use_inorder_tx)
+			virtio_xmit_cleanup_inorder(vq, nb_used);
+		else
+			virtio_xmit_cleanup(vq, nb_used);
+	}
+	txvq->recycle = NULL;
+
+	return recycle.nb_mbufs;
+}
+
+void
+virtio_recycle_rx_descriptors_refill(void *rx_queue, struct rte_mbuf **mbufs,
+				     uint16_t nb_mbufs)
+{
+	struct virtnet_rx *rxvq = rx_queue;
+	struct virtqueue *vq = rxvq->vq;
+	struct virtio_hw *hw = vq->hw;
+	uint16_t i;
+	int error;
+
+	/* same state as mbufs from rte_pktmbuf_alloc_bulk() */
+	for (i = 0; i < nb_mbufs; i++)
+		rte_pktmbuf_reset(mbufs[i]);
+
+	if (vtpci_packed_queue(hw))
+		error = virtqueue_enqueue_recv_refill_packed(vq, mbufs,
+				nb_mbufs);
+	else if (hw->use_inorder_rx)
+		error = virtqueue_enqueue_refill_inorder(vq, mbufs, nb_mbufs);
+	else
+		error = virtqueue_enqueue_recv_refill(vq, mbufs, nb_mbufs);
+
+	if (unlikely(error)) {
+		for (i = 0; i < nb_mbufs; i++)
+			rte_pktmbuf_free(mbufs[i]);
+		return;
+	}
+
+	if (vtpci_packed_queue(hw)) {
+		if (unlikely(virtqueue_kick_prepare_packed(vq))) {
+			virtqueue_notify(vq);
+			PMD_RX_LOG(DEBUG, "Notified");
+		}
+	} else {
+		vq_update_avail_idx(vq);
+
+		if (unlikely(virtqueue_kick_prepare(vq))) {
+			virtqueue_notify(vq);
+			PMD_RX_LOG(DEBUG, "Notified");
+		}
+	}
+}
@@ -7,6 +7,9 @@
 
 #define RTE_PMD_VIRTIO_RX_MAX_BURST 64
 
+/* Free Rx descriptors needed before refilling them with recycled mbufs. */
+#define VIRTIO_RECYCLE_REFILL_MIN 8
+
 struct virtnet_stats {
 	uint64_t	packets;
 	uint64_t	bytes;
@@ -26,6 +29,8 @@ struct virtnet_rx {
 
 	uint16_t queue_id;   /**< DPDK queue index. */
 	uint16_t port_id;     /**< Device port identifier. */
+	/**< Free descriptors before refilling from mpool, 0 without recycling */
+	uint16_t recycle_thresh;
 
 	/* Statistics */
 	struct virtnet_stats stats;
@@ -33,6 +38,14 @@ struct virtnet_rx {
 	const struct rte_memzone *mz; /**< mem zone to populate RX ring. */
 };
 
+/* Destination of the mbufs released by Tx cleanup while recycling. */
+struct virtio_tx_recycle {
+	struct rte_mbuf **mbufs; /**< recycled mbufs. */
+	struct rte_mempool *mp;  /**< mempool of the Rx queue to refill. */
+	uint16_t nb_mbufs;       /**< number of recycled mbufs. */
+	uint16_t max_mbufs;      /**< size of the mbufs array. */
+};
+
 struct virtnet_tx {
 	struct virtqueue *vq;
 	/**< memzone to populate hdr. */
@@ -42,6 +55,9 @@ struct virtnet_tx {
 	uint16_t    queue_id;            /**< DPDK queue index. */
 	uint16_t    port_id;             /**< Device port identifier. */
 
+	/**< Set while completed mbufs are being recycled. */
+	struct virtio_tx_recycle *recycle;
+
 	/* Statistics */
 	struct virtnet_stats stats;
 
@@ -810,6 +810,36 @@ virtqueue_enqueue_xmit_packed(struct virtnet_tx *txvq, struct rte_mbuf *cookie,
 				     vq->hw->weak_barriers);
 }
 
+/*
+ * Free the mbuf of a completed Tx descriptor. While mbufs are recycled, the
+ * segments belonging to the mempool of the Rx queue to refill are kept in
+ * the recycle array instead, as long as it has room.
+ */
+static inline void
+virtio_xmit_free_mbuf(struct virtqueue *vq, struct rte_mbuf *m)
+{
+	struct virtio_tx_recycle *recycle = vq->txq.recycle;
+	struct rte_mbuf *next;
+
+	if (likely(recycle == NULL)) {
+		rte_pktmbuf_free(m);
+		return;
+	}
+
+	while (m != NULL) {
+		next = m->next;
+		m = rte_pktmbuf_prefree_seg(m);
+		if (m != NULL) {
+			if (m->pool == recycle->mp &&
+					recycle->nb_mbufs < recycle->max_mbufs)
+				recycle->mbufs[recycle->nb_mbufs++] = m;
+			else
+				rte_mbuf_raw_free(m);
+		}
+		m = next;
+	}
+}
+
 static void
 vq_ring_free_id_packed(struct virtqueue *vq, uint16_t id)
 {
@@ -852,7 +882,7 @@ virtio_xmit_cleanup_inorder_packed(struct virtqueue *vq, int num)
 				vq->vq_packed.used_wrap_counter ^= 1;
 			}
 			if (dxp->cookie != NULL) {
-				rte_pktmbuf_free(dxp->cookie);
+				virtio_xmit_free_mbuf(vq, dxp->cookie);
 				dxp->cookie = NULL;
 			}
 		} while (curr_id != id);
@@ -883,7 +913,7 @@ virtio_xmit_cleanup_normal_packed(struct virtqueue *vq, int num)
 		}
 		vq_ring_free_id_packed(vq, id);
 		if (dxp->cookie != NULL) {
-			rte_pktmbuf_free(dxp->cookie);
+			virtio_xmit_free_mbuf(vq, dxp->cookie);
 			dxp->cookie = NULL;
 		}
 		used_idx = vq->vq_used_cons_idx;
@@ -918,7 +948,7 @@ virtio_xmit_cleanup(struct virtqueue *vq, uint16_t num)
 		vq_ring_free_chain(vq, desc_idx);
 
 		if (dxp->cookie != NULL) {
-			rte_pktmbuf_free(dxp->cookie);
+			virtio_xmit_free_mbuf(vq, dxp->cookie);
 			dxp->cookie = NULL;
 		}
 	}
@@ -939,7 +969,7 @@ virtio_xmit_cleanup_inorder(struct virtqueue *vq, uint16_t num)
 		dxp = &vq->vq_descx[idx++ & (vq->vq_nentries - 1)];
 		free_cnt += dxp->ndescs;
 		if (dxp->cookie != NULL) {
-			rte_pktmbuf_free(dxp->cookie);
+			virtio_xmit_free_mbuf(vq, dxp->cookie);
 			dxp->cookie = NULL;
 		}
 	}
@@ -174,9 +174,22 @@ struct rte_acl_ctx {
 	uint32_t            max_rules;
 	uint32_t            rule_sz;
 	uint32_t            num_rules;
+	/* incremental updates state, see acl_incr.c. */
+	struct rte_acl_ctx *rt;        /* RT used by classify, NULL - this one. */
+	struct rte_acl_ctx *base;      /* RT built from the main rules. */
+	uint32_t            num_main;  /* number of main rules. */
+	uint32_t            num_del;   /* number of deleted main rules. */
+	void               *del_rules; /* copies of deleted main rules. */
+	/* RCU config. */
+	struct rte_rcu_qsbr *v;               /* RCU QSBR variable. */
+	enum rte_acl_qsbr_mode rcu_mode;      /* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq *dq;           /* RCU QSBR defer queue. */
+	uint32_t            num_workers;      /* number of build threads. */
+	/* RT related fields, reset by the build. */
 	uint32_t            num_categories;
 	uint32_t            num_tries;
 	uint32_t            match_index;
+	uint32_t            num_match;
 	uint64_t            no_match;
 	uint64_t            idle;
 	uint64_t           *trans_table;
@@ -185,11 +198,17 @@ struct rte_acl_ctx {
 	void               *mem;
 	size_t              mem_sz;
 	struct rte_acl_config config; /* copy of build config. */
+	struct rte_acl_build_stats stats; /* stats of the last build. */
 };
 
 int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
-	uint32_t num_categories, uint32_t data_index_sz, size_t max_size);
+	uint32_t num_categories, uint32_t data_index_sz, size_t max_size,
+	uint32_t num_workers);
+
+void acl_incr_reset(struct rte_acl_ctx *ctx);
+
+void acl_incr_free(struct rte_acl_ctx *ctx);
 
 typedef int (*rte_acl_classify_t)
 (const struct rte_acl_ctx *, const uint8_t **, uint32_t *, uint32_t, uint32_t);
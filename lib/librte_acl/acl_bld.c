@@ -3,6 +3,8 @@
  */
 
 #include <rte_acl.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
 #include "tb_mem.h"
 #include "acl.h"
 
@@ -85,6 +87,26 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* rebuilds of the split tries running on the other threads */
+	uint32_t                  num_workers;
+	uint32_t                  num_active;
+	uint32_t                  next_join;
+	struct acl_build_worker   *workers[RTE_ACL_MAX_TRIES];
+};
+
+/*
+ * Rebuild of one trie with the reduced rule-set on a separate thread.
+ * Has its own build context, so the node memory is not shared
+ * with the calling thread, that continues with the remaining rules.
+ */
+struct acl_build_worker {
+	struct acl_build_context  bcx;
+	struct rte_acl_build_rule *rules;
+	uint32_t                  trie;
+	int32_t                   rc;
+	int32_t                   joined;
+	pthread_t                 tid;
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -1335,8 +1357,137 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+static void *
+acl_build_worker_main(void *arg)
+{
+	int32_t rc;
+	struct acl_build_worker *w;
+	struct rte_acl_build_rule *last;
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+
+	w = arg;
+
+	rc = sigsetjmp(w->bcx.pool.fail, 0);
+
+	/* rebuild runs out of memory. */
+	if (rc != 0) {
+		w->rc = rc;
+		return NULL;
+	}
+
+	rule_sets[w->trie] = w->rules;
+	last = build_one_trie(&w->bcx, rule_sets, w->trie, INT32_MAX);
+	w->rc = (w->bcx.bld_tries[w->trie].trie == NULL || last != NULL) ?
+		-ENOMEM : 0;
+	return NULL;
+}
+
+/*
+ * Wait for the rebuild of the given trie and take its results.
+ */
 static int
-acl_build_tries(struct acl_build_context *context,
+acl_build_join(struct acl_build_context *context, uint32_t n)
+{
+	struct acl_build_worker *w;
+
+	w = context->workers[n];
+	if (w == NULL)
+		return 0;
+
+	if (w->joined == 0) {
+		pthread_join(w->tid, NULL);
+		w->joined = 1;
+		context->num_active--;
+
+		if (w->rc != 0) {
+			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
+			return w->rc;
+		}
+
+		context->tries[n] = w->bcx.tries[n];
+		memcpy(context->data_indexes[n], w->bcx.data_indexes[n],
+			sizeof(context->data_indexes[n]));
+		context->tries[n].data_index = context->data_indexes[n];
+		context->bld_tries[n] = w->bcx.bld_tries[n];
+		context->num_nodes += w->bcx.num_nodes;
+	}
+
+	return w->rc;
+}
+
+/*
+ * Wait for all the rebuilds that are still running.
+ */
+static int
+acl_build_join_all(struct acl_build_context *context)
+{
+	int32_t rc, rc2;
+
+	rc = 0;
+	for (; context->next_join != RTE_DIM(context->workers);
+			context->next_join++) {
+		rc2 = acl_build_join(context, context->next_join);
+		if (rc == 0)
+			rc = rc2;
+	}
+	return rc;
+}
+
+/*
+ * Start the rebuild of the n-th trie on a separate thread.
+ * Returns non-zero if that is not possible, then the caller has to
+ * rebuild the trie by itself.
+ */
+static int
+acl_build_start(struct acl_build_context *context,
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES], uint32_t n)
+{
+	int32_t rc;
+	struct acl_build_worker *w;
+	char name[RTE_MAX_THREAD_NAME_LEN];
+
+	if (context->num_workers <= 1)
+		return -ENOTSUP;
+
+	/* all threads are busy, wait for the oldest one. */
+	while (context->num_active + 1 >= context->num_workers) {
+		rc = acl_build_join(context, context->next_join++);
+		if (rc != 0)
+			return rc;
+	}
+
+	w = calloc(1, sizeof(*w));
+	if (w == NULL)
+		return -ENOMEM;
+
+	w->bcx.acx = context->acx;
+	w->bcx.pool.alignment = ACL_POOL_ALIGN;
+	w->bcx.pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	/*
+	 * Only number of categories is used by the trie build,
+	 * other fields of cfg can be updated by acl_rule_stats() meanwhile.
+	 */
+	w->bcx.cfg.num_categories = context->cfg.num_categories;
+	w->bcx.category_mask = context->category_mask;
+	w->bcx.node_max = context->node_max;
+	w->rules = rule_sets[n];
+	w->trie = n;
+
+	snprintf(name, sizeof(name), "acl-bld-%u", n);
+	rc = rte_ctrl_thread_create(&w->tid, name, NULL,
+		acl_build_worker_main, w);
+	if (rc != 0) {
+		free(w);
+		return rc;
+	}
+
+	context->workers[n] = w;
+	context->num_active++;
+	return 0;
+}
+
+static int
+acl_build_split(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
 {
 	uint32_t n, num_tries;
@@ -1384,6 +1535,7 @@ acl_build_tries(struct acl_build_context *context,
 		rule_sets[num_tries] = last->next;
 		last->next = NULL;
 		acl_free_node(context, context->bld_tries[n].trie);
+		context->bld_tries[n].trie = NULL;
 
 		/* Create a new copy of config for remaining rules. */
 		config = acl_build_alloc(context, 1, sizeof(*config));
@@ -1397,7 +1549,12 @@ acl_build_tries(struct acl_build_context *context,
 		/*
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
+		 * Where possible, do it on another thread, while this one
+		 * proceeds with the remaining rules.
 		 */
+		if (acl_build_start(context, rule_sets, n) == 0)
+			continue;
+
 		last = build_one_trie(context, rule_sets, n, INT32_MAX);
 		if (context->bld_tries[n].trie == NULL || last != NULL) {
 			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
@@ -1410,6 +1567,54 @@ acl_build_tries(struct acl_build_context *context,
 	return 0;
 }
 
+static int
+acl_build_tries(struct acl_build_context *context,
+	struct rte_acl_build_rule *head)
+{
+	int32_t rc, rc2;
+
+	rc = acl_build_split(context, head);
+	rc2 = acl_build_join_all(context);
+	return (rc != 0) ? rc : rc2;
+}
+
+/*
+ * Release memory of the build context and of the rebuild threads.
+ */
+static void
+acl_build_free_ctx(struct acl_build_context *context)
+{
+	uint32_t n;
+
+	for (n = 0; n != RTE_DIM(context->workers); n++) {
+		if (context->workers[n] != NULL) {
+			tb_free_pool(&context->workers[n]->bcx.pool);
+			free(context->workers[n]);
+			context->workers[n] = NULL;
+		}
+	}
+
+	tb_free_pool(&context->pool);
+}
+
+/*
+ * Memory consumed by the build phase.
+ */
+static size_t
+acl_build_mem(const struct acl_build_context *context)
+{
+	uint32_t n;
+	size_t sz;
+
+	sz = context->pool.alloc;
+	for (n = 0; n != RTE_DIM(context->workers); n++) {
+		if (context->workers[n] != NULL)
+			sz += context->workers[n]->bcx.pool.alloc;
+	}
+
+	return sz;
+}
+
 static void
 acl_build_log(const struct acl_build_context *ctx)
 {
@@ -1417,12 +1622,14 @@ acl_build_log(const struct acl_build_context *ctx)
 
 	RTE_LOG(DEBUG, ACL, "Build phase for ACL \"%s\":\n"
 		"node limit for tree split: %u\n"
+		"build threads: %u\n"
 		"nodes created: %u\n"
 		"memory consumed: %zu\n",
 		ctx->acx->name,
 		ctx->node_max,
+		ctx->num_workers,
 		ctx->num_nodes,
-		ctx->pool.alloc);
+		acl_build_mem(ctx));
 
 	for (n = 0; n < RTE_DIM(ctx->tries); n++) {
 		if (ctx->tries[n].count != 0)
@@ -1491,6 +1698,16 @@ acl_set_data_indexes(struct rte_acl_ctx *ctx)
 	}
 }
 
+/*
+ * Number of threads to use, there is no point to have more than tries.
+ */
+static uint32_t
+acl_build_num_workers(const struct rte_acl_ctx *ctx)
+{
+	return RTE_MAX(RTE_MIN(ctx->num_workers, (uint32_t)RTE_ACL_MAX_TRIES),
+		1U);
+}
+
 /*
  * Internal routine, performs 'build' phase of trie generation:
  * - setups build context.
@@ -1512,11 +1729,13 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
 		typeof(bcx->category_mask));
 	bcx->node_max = node_max;
+	bcx->num_workers = acl_build_num_workers(ctx);
 
 	rc = sigsetjmp(bcx->pool.fail, 0);
 
 	/* build phase runs out of memory. */
 	if (rc != 0) {
+		acl_build_join_all(bcx);
 		RTE_LOG(ERR, ACL,
 			"ACL context: %s, %s() failed with error code: %d\n",
 			bcx->acx->name, __func__, rc);
@@ -1617,13 +1836,16 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 {
 	int32_t rc;
 	uint32_t n;
-	size_t max_size;
+	size_t max_size, mem;
+	uint64_t hz, tm;
 	struct acl_build_context bcx;
+	struct rte_acl_build_stats stats;
 
 	rc = acl_check_bld_param(ctx, cfg);
 	if (rc != 0)
 		return rc;
 
+	acl_incr_reset(ctx);
 	acl_build_reset(ctx);
 
 	if (cfg->max_size == 0) {
@@ -1634,17 +1856,29 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		max_size = cfg->max_size;
 	}
 
+	memset(&stats, 0, sizeof(stats));
+	stats.num_workers = acl_build_num_workers(ctx);
+	hz = rte_get_timer_hz();
+
 	for (rc = -ERANGE; n >= NODE_MIN && rc == -ERANGE; n /= 2) {
 
+		stats.num_passes++;
+
 		/* perform build phase. */
+		tm = rte_get_timer_cycles();
 		rc = acl_bld(&bcx, ctx, cfg, n);
+		stats.build_time += rte_get_timer_cycles() - tm;
+		mem = acl_build_mem(&bcx);
 
 		if (rc == 0) {
 			/* allocate and fill run-time  structures. */
+			tm = rte_get_timer_cycles();
 			rc = rte_acl_gen(ctx, bcx.tries, bcx.bld_tries,
 				bcx.num_tries, bcx.cfg.num_categories,
 				RTE_ACL_MAX_FIELDS * RTE_DIM(bcx.tries) *
-				sizeof(ctx->data_indexes[0]), max_size);
+				sizeof(ctx->data_indexes[0]), max_size,
+				stats.num_workers);
+			stats.gen_time += rte_get_timer_cycles() - tm;
 			if (rc == 0) {
 				/* set data indexes. */
 				acl_set_data_indexes(ctx);
@@ -1654,14 +1888,25 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 
 				/* copy in build config. */
 				ctx->config = *cfg;
+
+				mem += ctx->mem_sz;
+				stats.rt_mem = ctx->mem_sz;
+				stats.num_tries = bcx.num_tries;
+				stats.num_nodes = bcx.num_nodes;
 			}
 		}
 
+		stats.peak_mem = RTE_MAX(stats.peak_mem, mem);
+
 		acl_build_log(&bcx);
 
 		/* cleanup after build. */
-		tb_free_pool(&bcx.pool);
+		acl_build_free_ctx(&bcx);
 	}
 
+	stats.build_time = stats.build_time * US_PER_S / hz;
+	stats.gen_time = stats.gen_time * US_PER_S / hz;
+	ctx->stats = stats;
+
 	return rc;
 }
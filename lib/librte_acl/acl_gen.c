@@ -3,6 +3,7 @@
  */
 
 #include <rte_acl.h>
+#include <rte_lcore.h>
 #include "acl.h"
 
 #define	QRANGE_MIN	((uint8_t)INT8_MIN)
@@ -30,6 +31,32 @@ struct rte_acl_indices {
 	int32_t match_start;
 };
 
+/*
+ * Tries don't share nodes, so each of them can be counted and generated
+ * independently, given its own range of indices in the runtime arrays.
+ */
+struct acl_gen_trie {
+	struct rte_acl_node      *root;
+	struct acl_node_counters counts;
+	struct rte_acl_indices   indices;
+};
+
+struct acl_gen_param {
+	struct acl_gen_trie *tries;
+	uint32_t            num_tries;
+	uint32_t            num_threads;
+	uint64_t            *node_array;
+	uint64_t            no_match;
+	int                 num_categories;
+	void (*fn)(const struct acl_gen_param *prm, struct acl_gen_trie *t);
+};
+
+struct acl_gen_worker {
+	const struct acl_gen_param *prm;
+	uint32_t                   first;
+	pthread_t                  tid;
+};
+
 static void
 acl_gen_log_stats(const struct rte_acl_ctx *ctx,
 	const struct acl_node_counters *counts,
@@ -414,21 +441,96 @@ acl_gen_node(struct rte_acl_node *node, uint64_t *node_array,
 	}
 }
 
+static void
+acl_gen_count_trie(const struct acl_gen_param *prm, struct acl_gen_trie *t)
+{
+	acl_count_trie_types(&t->counts, t->root, prm->no_match, 1);
+}
+
+static void
+acl_gen_fill_trie(const struct acl_gen_param *prm, struct acl_gen_trie *t)
+{
+	acl_gen_node(t->root, prm->node_array, prm->no_match, &t->indices,
+		prm->num_categories);
+}
+
+/*
+ * Each thread handles every num_threads-th trie, starting from the given one.
+ */
+static void *
+acl_gen_worker_main(void *arg)
+{
+	uint32_t n;
+	const struct acl_gen_worker *w;
+
+	w = arg;
+	for (n = w->first; n < w->prm->num_tries; n += w->prm->num_threads)
+		w->prm->fn(w->prm, w->prm->tries + n);
+
+	return NULL;
+}
+
+/*
+ * Run the given function for all the tries, using up to num_threads threads.
+ * The calling thread does its share of the work too.
+ */
+static void
+acl_gen_run(struct acl_gen_param *prm,
+	void (*fn)(const struct acl_gen_param *, struct acl_gen_trie *))
+{
+	int32_t rc;
+	uint32_t i, started[RTE_ACL_MAX_TRIES];
+	struct acl_gen_worker w[RTE_ACL_MAX_TRIES];
+	char name[RTE_MAX_THREAD_NAME_LEN];
+
+	prm->fn = fn;
+
+	for (i = 0; i != prm->num_threads; i++) {
+		w[i].prm = prm;
+		w[i].first = i;
+		started[i] = 0;
+	}
+
+	for (i = 1; i < prm->num_threads; i++) {
+		snprintf(name, sizeof(name), "acl-gen-%u", i);
+		rc = rte_ctrl_thread_create(&w[i].tid, name, NULL,
+			acl_gen_worker_main, w + i);
+		started[i] = (rc == 0);
+	}
+
+	/* do the work of the threads that failed to start. */
+	for (i = 0; i != prm->num_threads; i++) {
+		if (started[i] == 0)
+			acl_gen_worker_main(w + i);
+	}
+
+	for (i = 1; i < prm->num_threads; i++) {
+		if (started[i] != 0)
+			pthread_join(w[i].tid, NULL);
+	}
+}
+
 static void
 acl_calc_counts_indices(struct acl_node_counters *counts,
-	struct rte_acl_indices *indices,
-	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
-	uint64_t no_match)
+	struct rte_acl_indices *indices, struct acl_gen_param *prm)
 {
 	uint32_t n;
+	struct acl_gen_trie *t;
 
 	memset(indices, 0, sizeof(*indices));
 	memset(counts, 0, sizeof(*counts));
 
 	/* Get stats on nodes */
-	for (n = 0; n < num_tries; n++) {
-		acl_count_trie_types(counts, node_bld_trie[n].trie,
-			no_match, 1);
+	acl_gen_run(prm, acl_gen_count_trie);
+
+	for (n = 0; n < prm->num_tries; n++) {
+		t = prm->tries + n;
+		counts->match += t->counts.match;
+		counts->single += t->counts.single;
+		counts->quad += t->counts.quad;
+		counts->quad_vectors += t->counts.quad_vectors;
+		counts->dfa += t->counts.dfa;
+		counts->dfa_gr64 += t->counts.dfa_gr64;
 	}
 
 	indices->dfa_index = RTE_ACL_DFA_SIZE + 1;
@@ -439,6 +541,19 @@ acl_calc_counts_indices(struct acl_node_counters *counts,
 	indices->match_start = RTE_ALIGN(indices->match_start,
 		(XMM_SIZE / sizeof(uint64_t)));
 	indices->match_index = 1;
+
+	/*
+	 * Split the indices between the tries, in the same order
+	 * as they would be allocated by generating tries one by one.
+	 */
+	for (n = 0; n < prm->num_tries; n++) {
+		t = prm->tries + n;
+		t->indices = *indices;
+		indices->dfa_index += t->counts.dfa_gr64 * RTE_ACL_DFA_GR64_SIZE;
+		indices->quad_index += t->counts.quad_vectors;
+		indices->single_index += t->counts.single;
+		indices->match_index += t->counts.match;
+	}
 }
 
 /*
@@ -447,7 +562,8 @@ acl_calc_counts_indices(struct acl_node_counters *counts,
 int
 rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
-	uint32_t num_categories, uint32_t data_index_sz, size_t max_size)
+	uint32_t num_categories, uint32_t data_index_sz, size_t max_size,
+	uint32_t num_workers)
 {
 	void *mem;
 	size_t total_size;
@@ -456,12 +572,24 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_match_results *match;
 	struct acl_node_counters counts;
 	struct rte_acl_indices indices;
+	struct acl_gen_trie tries[RTE_ACL_MAX_TRIES];
+	struct acl_gen_param prm;
 
 	no_match = RTE_ACL_NODE_MATCH;
 
+	memset(tries, 0, sizeof(tries));
+	for (n = 0; n < num_tries; n++)
+		tries[n].root = node_bld_trie[n].trie;
+
+	prm.tries = tries;
+	prm.num_tries = num_tries;
+	prm.num_threads = RTE_MAX(RTE_MIN(num_workers, num_tries), 1U);
+	prm.node_array = NULL;
+	prm.no_match = no_match;
+	prm.num_categories = num_categories;
+
 	/* Fill counts and indices arrays from the nodes. */
-	acl_calc_counts_indices(&counts, &indices,
-		node_bld_trie, num_tries, no_match);
+	acl_calc_counts_indices(&counts, &indices, &prm);
 
 	/* Allocate runtime memory (align to cache boundary) */
 	total_size = RTE_ALIGN(data_index_sz, RTE_CACHE_LINE_SIZE) +
@@ -505,11 +633,10 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	match = ((struct rte_acl_match_results *)(node_array + match_index));
 	memset(match, 0, sizeof(*match));
 
-	for (n = 0; n < num_tries; n++) {
-
-		acl_gen_node(node_bld_trie[n].trie, node_array, no_match,
-			&indices, num_categories);
+	prm.node_array = node_array;
+	acl_gen_run(&prm, acl_gen_fill_trie);
 
+	for (n = 0; n < num_tries; n++) {
 		if (node_bld_trie[n].trie->node_index == no_match)
 			trie[n].root_index = 0;
 		else
@@ -522,6 +649,7 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	ctx->num_tries = num_tries;
 	ctx->num_categories = num_categories;
 	ctx->match_index = match_index;
+	ctx->num_match = indices.match_index;
 	ctx->no_match = no_match;
 	ctx->idle = node_array[RTE_ACL_DFA_SIZE];
 	ctx->trans_table = node_array;
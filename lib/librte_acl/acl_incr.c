@@ -0,0 +1,862 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#include <rte_string_fns.h>
+#include <rte_acl.h>
+#include "acl.h"
+
+/*
+ * Incremental updates of the ACL run-time structures.
+ * Rules present at the last full build are the *main* rules,
+ * their run-time (base RT) stays intact until the next full build.
+ * The memory of the base RT taken over from the context stays owned by
+ * the context, as the classify methods called directly keep using it.
+ * The RT used by classify is a copy of the base RT with:
+ * - results of the deleted main rules removed from the match entries,
+ * - tries built from the *delta* rules appended after the base tries.
+ * Delta rules are the rules added since the last full build, plus
+ * the remaining main rules that overlap with the removed results
+ * (they could be hidden by the removed rule in the base RT).
+ * Classify resolves results between all tries by priority, so the
+ * combined RT gives the same results as a full build.
+ */
+
+/* match results with the same userdata and priority as some deleted rule. */
+struct acl_incr_del {
+	uint32_t userdata;
+	int32_t priority;
+	uint32_t category_mask;
+};
+
+static uint64_t
+acl_field_get(const union rte_acl_field_types *v, uint32_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return v->u8;
+	case sizeof(uint16_t):
+		return v->u16;
+	case sizeof(uint32_t):
+		return v->u32;
+	default:
+		return v->u64;
+	}
+}
+
+static void
+acl_field_range(const struct rte_acl_field_def *def,
+	const struct rte_acl_field *fld, uint64_t *lo, uint64_t *hi)
+{
+	uint32_t bits, len;
+	uint64_t full, msk;
+
+	bits = def->size * CHAR_BIT;
+	full = RTE_LEN2MASK(bits, uint64_t);
+
+	if (def->type == RTE_ACL_FIELD_TYPE_RANGE) {
+		*lo = acl_field_get(&fld->value, def->size);
+		*hi = acl_field_get(&fld->mask_range, def->size);
+	} else {
+		len = acl_field_get(&fld->mask_range, def->size);
+		len = RTE_MIN(len, bits);
+		msk = (len == 0) ? 0 : (full << (bits - len)) & full;
+		*lo = acl_field_get(&fld->value, def->size) & msk;
+		*hi = *lo | (full & ~msk);
+	}
+}
+
+/*
+ * Check can some input match both rules.
+ */
+static int
+acl_rule_overlap(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *r1, const struct rte_acl_rule *r2)
+{
+	uint32_t i;
+	uint64_t lo1, lo2, hi1, hi2, m1, m2, v1, v2;
+	const struct rte_acl_field_def *def;
+	const struct rte_acl_field *f1, *f2;
+
+	if ((r1->data.category_mask & r2->data.category_mask &
+			RTE_LEN2MASK(cfg->num_categories, uint32_t)) == 0)
+		return 0;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		def = cfg->defs + i;
+		f1 = r1->field + def->field_index;
+		f2 = r2->field + def->field_index;
+
+		if (def->type == RTE_ACL_FIELD_TYPE_BITMASK) {
+			v1 = acl_field_get(&f1->value, def->size);
+			v2 = acl_field_get(&f2->value, def->size);
+			m1 = acl_field_get(&f1->mask_range, def->size);
+			m2 = acl_field_get(&f2->mask_range, def->size);
+			if (((v1 ^ v2) & m1 & m2) != 0)
+				return 0;
+		} else {
+			acl_field_range(def, f1, &lo1, &hi1);
+			acl_field_range(def, f2, &lo2, &hi2);
+			if (lo1 > hi2 || lo2 > hi1)
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int
+acl_rule_equal(const struct rte_acl_config *cfg,
+	const struct rte_acl_rule *r1, const struct rte_acl_rule *r2)
+{
+	uint32_t i;
+	const struct rte_acl_field_def *def;
+	const struct rte_acl_field *f1, *f2;
+
+	if (r1->data.category_mask != r2->data.category_mask ||
+			r1->data.priority != r2->data.priority ||
+			r1->data.userdata != r2->data.userdata)
+		return 0;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		def = cfg->defs + i;
+		f1 = r1->field + def->field_index;
+		f2 = r2->field + def->field_index;
+		if (acl_field_get(&f1->value, def->size) !=
+				acl_field_get(&f2->value, def->size) ||
+				acl_field_get(&f1->mask_range, def->size) !=
+				acl_field_get(&f2->mask_range, def->size))
+			return 0;
+	}
+
+	return 1;
+}
+
+static inline const struct rte_acl_rule *
+acl_rule_get(const void *rules, uint32_t rule_sz, uint32_t idx)
+{
+	return (const struct rte_acl_rule *)((uintptr_t)rules + idx * rule_sz);
+}
+
+static int
+acl_incr_del_cmp(const void *a, const void *b)
+{
+	const struct acl_incr_del *d1 = a;
+	const struct acl_incr_del *d2 = b;
+
+	if (d1->userdata != d2->userdata)
+		return (d1->userdata < d2->userdata) ? -1 : 1;
+	if (d1->priority != d2->priority)
+		return (d1->priority < d2->priority) ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Collect sorted userdata/priority pairs of the deleted rules,
+ * category masks of the rules with the same pair are merged.
+ */
+static struct acl_incr_del *
+acl_incr_del_pairs(const struct rte_acl_ctx *ctx, uint32_t *num)
+{
+	uint32_t i, n;
+	struct acl_incr_del *del;
+	const struct rte_acl_rule *r;
+
+	del = rte_malloc(NULL, (ctx->num_del + 1) * sizeof(del[0]), 0);
+	if (del == NULL)
+		return NULL;
+
+	for (i = 0; i != ctx->num_del; i++) {
+		r = acl_rule_get(ctx->del_rules, ctx->rule_sz, i);
+		del[i].userdata = r->data.userdata;
+		del[i].priority = r->data.priority;
+		del[i].category_mask = r->data.category_mask;
+	}
+
+	qsort(del, ctx->num_del, sizeof(del[0]), acl_incr_del_cmp);
+
+	n = 0;
+	for (i = 0; i != ctx->num_del; i++) {
+		if (n != 0 && acl_incr_del_cmp(del + n - 1, del + i) == 0)
+			del[n - 1].category_mask |= del[i].category_mask;
+		else
+			del[n++] = del[i];
+	}
+
+	*num = n;
+	return del;
+}
+
+static uint32_t
+acl_incr_del_mask(const struct acl_incr_del *del, uint32_t num,
+	uint32_t userdata, int32_t priority)
+{
+	const struct acl_incr_del *d;
+	struct acl_incr_del key = {
+		.userdata = userdata,
+		.priority = priority,
+	};
+
+	d = bsearch(&key, del, num, sizeof(del[0]), acl_incr_del_cmp);
+	return (d == NULL) ? 0 : d->category_mask;
+}
+
+/*
+ * Check does the main rule overlap with any deleted rule
+ * or with any hidden main rule.
+ */
+static int
+acl_incr_overlap(const struct rte_acl_ctx *ctx, const struct rte_acl_rule *r,
+	const uint32_t *hidden, uint32_t num_hidden)
+{
+	uint32_t i;
+
+	for (i = 0; i != ctx->num_del; i++) {
+		if (acl_rule_overlap(&ctx->config, r,
+				acl_rule_get(ctx->del_rules, ctx->rule_sz, i)))
+			return 1;
+	}
+
+	for (i = 0; i != num_hidden; i++) {
+		if (acl_rule_overlap(&ctx->config, r,
+				acl_rule_get(ctx->rules, ctx->rule_sz,
+				hidden[i])))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Fill the delta rules: the rules added since the last full build,
+ * and the main rules that overlap with any deleted rule or with
+ * a main rule which results are removed together with the deleted ones
+ * (hidden rules).
+ */
+static int
+acl_incr_delta_rules(const struct rte_acl_ctx *ctx,
+	const struct acl_incr_del *del, uint32_t num_del, void **rules)
+{
+	uint32_t i, n, num_hidden;
+	uint8_t *buf;
+	uint32_t *hidden;
+	const struct rte_acl_rule *r;
+
+	buf = rte_malloc(NULL, (ctx->num_rules + 1) * ctx->rule_sz, 0);
+	hidden = rte_malloc(NULL, (ctx->num_main + 1) * sizeof(hidden[0]), 0);
+	if (buf == NULL || hidden == NULL) {
+		rte_free(buf);
+		rte_free(hidden);
+		return -ENOMEM;
+	}
+
+	n = ctx->num_rules - ctx->num_main;
+	memcpy(buf, acl_rule_get(ctx->rules, ctx->rule_sz, ctx->num_main),
+		n * ctx->rule_sz);
+
+	num_hidden = 0;
+	for (i = 0; i != ctx->num_main && num_del != 0; i++) {
+		r = acl_rule_get(ctx->rules, ctx->rule_sz, i);
+		if ((acl_incr_del_mask(del, num_del, r->data.userdata,
+				r->data.priority) &
+				r->data.category_mask) != 0)
+			hidden[num_hidden++] = i;
+	}
+
+	/* hidden rules overlap with themselves, so they are included too. */
+	for (i = 0; i != ctx->num_main && num_del != 0; i++) {
+		r = acl_rule_get(ctx->rules, ctx->rule_sz, i);
+		if (acl_incr_overlap(ctx, r, hidden, num_hidden)) {
+			memcpy(buf + n * ctx->rule_sz, r, ctx->rule_sz);
+			n++;
+		}
+	}
+
+	rte_free(hidden);
+	*rules = buf;
+	return n;
+}
+
+static struct rte_acl_ctx *
+acl_rt_alloc(const struct rte_acl_ctx *ctx)
+{
+	struct rte_acl_ctx *rt;
+
+	rt = rte_zmalloc_socket(ctx->name, sizeof(*rt), RTE_CACHE_LINE_SIZE,
+		ctx->socket_id);
+	if (rt == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			sizeof(*rt), ctx->socket_id, ctx->name);
+		return NULL;
+	}
+
+	strlcpy(rt->name, ctx->name, sizeof(rt->name));
+	rt->socket_id = ctx->socket_id;
+	rt->alg = ctx->alg;
+	rt->num_workers = ctx->num_workers;
+	return rt;
+}
+
+static void
+acl_rt_free(struct rte_acl_ctx *rt)
+{
+	if (rt != NULL) {
+		rte_free(rt->mem);
+		rte_free(rt);
+	}
+}
+
+static void
+acl_rcu_free_rt(void *p, void *data, unsigned int n)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(n);
+	acl_rt_free(*(struct rte_acl_ctx **)data);
+}
+
+/*
+ * Release RT that could still be used by concurrent classify.
+ */
+static void
+acl_rt_retire(struct rte_acl_ctx *ctx, struct rte_acl_ctx *rt)
+{
+	if (rt == NULL)
+		return;
+
+	if (ctx->v == NULL) {
+		acl_rt_free(rt);
+	} else if (ctx->rcu_mode == RTE_ACL_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(ctx->v, RTE_QSBR_THRID_INVALID);
+		acl_rt_free(rt);
+	} else if (ctx->rcu_mode == RTE_ACL_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(ctx->dq, (void *)&rt) != 0) {
+			RTE_LOG(ERR, ACL, "Failed to push QSBR FIFO\n");
+			/* Fall back to blocking reclaim instead of leaking */
+			rte_rcu_qsbr_synchronize(ctx->v,
+				RTE_QSBR_THRID_INVALID);
+			acl_rt_free(rt);
+		}
+	}
+}
+
+/*
+ * Replace RT used by classify.
+ */
+static void
+acl_rt_publish(struct rte_acl_ctx *ctx, struct rte_acl_ctx *rt,
+	struct rte_acl_ctx *base)
+{
+	struct rte_acl_ctx *old_rt, *old_base;
+
+	old_rt = ctx->rt;
+	old_base = ctx->base;
+
+	__atomic_store_n(&ctx->rt, rt, __ATOMIC_RELEASE);
+	ctx->base = base;
+
+	if (old_rt != old_base)
+		acl_rt_retire(ctx, old_rt);
+	if (old_base != base)
+		acl_rt_retire(ctx, old_base);
+}
+
+/*
+ * Relocate transition of the delta RT into the combined RT.
+ */
+static inline uint64_t
+acl_trans_reloc(uint64_t trans, uint32_t node_ofs, uint32_t match_ofs)
+{
+	uint32_t addr;
+
+	addr = trans & RTE_ACL_MAX_INDEX;
+	if ((trans & RTE_ACL_NODE_TYPE) == RTE_ACL_NODE_MATCH) {
+		if (addr != 0)
+			trans += match_ofs;
+	} else if (addr > RTE_ACL_DFA_SIZE)
+		trans += node_ofs;
+	return trans;
+}
+
+/*
+ * Create RT that contains all tries of the base RT followed by
+ * all tries of the delta RT.
+ */
+static struct rte_acl_ctx *
+acl_rt_join(const struct rte_acl_ctx *ctx, const struct rte_acl_ctx *base,
+	const struct rte_acl_ctx *dlt)
+{
+	uint32_t i, n, match_start, node_ofs, match_ofs, num_match, num_node;
+	size_t dsz, total_size;
+	uint64_t *node_array;
+	struct rte_acl_ctx *rt;
+	struct rte_acl_match_results *match;
+	const struct rte_acl_match_results *dmatch;
+
+	dsz = (uintptr_t)base->trans_table - (uintptr_t)base->data_indexes;
+
+	num_node = 0;
+	num_match = base->num_match;
+	if (dlt != NULL) {
+		num_node = dlt->match_index - (RTE_ACL_DFA_SIZE + 1);
+		num_match += dlt->num_match - 1;
+	}
+
+	match_start = RTE_ALIGN(base->match_index + num_node,
+		(XMM_SIZE / sizeof(uint64_t)));
+	if (match_start > RTE_ACL_MAX_INDEX || num_match > RTE_ACL_MAX_INDEX) {
+		rte_errno = ERANGE;
+		return NULL;
+	}
+
+	total_size = dsz + match_start * sizeof(uint64_t) +
+		num_match * sizeof(struct rte_acl_match_results) + XMM_SIZE;
+
+	rt = acl_rt_alloc(ctx);
+	if (rt == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	rt->mem = rte_zmalloc_socket(ctx->name, total_size,
+		RTE_CACHE_LINE_SIZE, ctx->socket_id);
+	if (rt->mem == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			total_size, ctx->socket_id, ctx->name);
+		rte_free(rt);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	node_array = (uint64_t *)((uintptr_t)rt->mem + dsz);
+	match = (struct rte_acl_match_results *)(node_array + match_start);
+
+	/* base RT nodes and matches are copied as is. */
+	memcpy(node_array, base->trans_table,
+		base->match_index * sizeof(uint64_t));
+	memcpy(match, base->trans_table + base->match_index,
+		base->num_match * sizeof(*match));
+
+	rt->num_tries = base->num_tries;
+	for (i = 0; i != base->num_tries; i++)
+		rt->trie[i] = base->trie[i];
+
+	memcpy(rt->mem, base->data_indexes, base->num_tries *
+		RTE_ACL_MAX_FIELDS * sizeof(base->data_indexes[0]));
+
+	/* delta RT nodes and matches are appended. */
+	if (dlt != NULL) {
+		node_ofs = base->match_index - (RTE_ACL_DFA_SIZE + 1);
+		match_ofs = base->num_match - 1;
+
+		for (i = 0; i != num_node; i++)
+			node_array[base->match_index + i] = acl_trans_reloc(
+				dlt->trans_table[RTE_ACL_DFA_SIZE + 1 + i],
+				node_ofs, match_ofs);
+
+		dmatch = (const struct rte_acl_match_results *)
+			(dlt->trans_table + dlt->match_index);
+		memcpy(match + base->num_match, dmatch + 1,
+			(dlt->num_match - 1) * sizeof(*match));
+
+		for (i = 0; i != dlt->num_tries; i++) {
+			n = rt->num_tries++;
+			rt->trie[n] = dlt->trie[i];
+			if (rt->trie[n].root_index != 0)
+				rt->trie[n].root_index = acl_trans_reloc(
+					rt->trie[n].root_index, node_ofs, 0);
+		}
+
+		memcpy((uint32_t *)rt->mem + base->num_tries *
+			RTE_ACL_MAX_FIELDS, dlt->data_indexes,
+			dlt->num_tries * RTE_ACL_MAX_FIELDS *
+			sizeof(dlt->data_indexes[0]));
+	}
+
+	rt->mem_sz = total_size;
+	rt->data_indexes = rt->mem;
+	for (i = 0; i != rt->num_tries; i++)
+		rt->trie[i].data_index = rt->data_indexes +
+			i * RTE_ACL_MAX_FIELDS;
+
+	rt->first_load_sz = base->first_load_sz;
+	rt->num_categories = base->num_categories;
+	rt->match_index = match_start;
+	rt->num_match = num_match;
+	rt->no_match = base->no_match;
+	rt->idle = base->idle;
+	rt->trans_table = node_array;
+	rt->config = base->config;
+
+	return rt;
+}
+
+/*
+ * Remove results of the deleted rules from the base RT part.
+ */
+static void
+acl_rt_suppress(struct rte_acl_ctx *rt, uint32_t num_match,
+	const struct acl_incr_del *del, uint32_t num_del)
+{
+	uint32_t i, j, msk;
+	struct rte_acl_match_results *match;
+
+	if (num_del == 0)
+		return;
+
+	match = (struct rte_acl_match_results *)
+		(rt->trans_table + rt->match_index);
+
+	for (i = 1; i != num_match; i++) {
+		for (j = 0; j != rt->num_categories; j++) {
+			if (match[i].results[j] == 0 &&
+					match[i].priority[j] == 0)
+				continue;
+			msk = acl_incr_del_mask(del, num_del,
+				match[i].results[j], match[i].priority[j]);
+			if ((msk & (1U << j)) != 0) {
+				match[i].results[j] = 0;
+				match[i].priority[j] = 0;
+			}
+		}
+	}
+}
+
+/*
+ * Take over RT of the last full build as the base RT.
+ */
+static int
+acl_incr_init(struct rte_acl_ctx *ctx)
+{
+	struct rte_acl_ctx *base;
+
+	if (ctx->base != NULL)
+		return 0;
+
+	if (ctx->trans_table == NULL || ctx->num_main > ctx->num_rules)
+		return -EINVAL;
+
+	base = acl_rt_alloc(ctx);
+	if (base == NULL)
+		return -ENOMEM;
+
+	memcpy(&base->num_categories, &ctx->num_categories,
+		sizeof(*ctx) - offsetof(struct rte_acl_ctx, num_categories));
+	ctx->base = base;
+
+	/*
+	 * Context keeps the memory until the next full build,
+	 * readers still use it via ctx, even after a merge.
+	 */
+	base->mem = NULL;
+	base->mem_sz = 0;
+	return 0;
+}
+
+int
+rte_acl_incr_merge(struct rte_acl_ctx *ctx)
+{
+	int32_t rc;
+	struct rte_acl_ctx *rt;
+
+	if (ctx == NULL)
+		return -EINVAL;
+
+	rc = acl_incr_init(ctx);
+	if (rc != 0)
+		return rc;
+
+	/* nothing to build, all main rules are already removed. */
+	if (ctx->num_rules == 0)
+		return 0;
+
+	rt = acl_rt_alloc(ctx);
+	if (rt == NULL)
+		return -ENOMEM;
+
+	rt->rules = ctx->rules;
+	rt->max_rules = ctx->num_rules;
+	rt->num_rules = ctx->num_rules;
+	rt->rule_sz = ctx->rule_sz;
+
+	rc = rte_acl_build(rt, &ctx->config);
+
+	rt->rules = NULL;
+	rt->max_rules = 0;
+	rt->num_rules = 0;
+
+	if (rc != 0) {
+		acl_rt_free(rt);
+		return rc;
+	}
+
+	acl_rt_publish(ctx, rt, rt);
+	ctx->num_main = ctx->num_rules;
+	ctx->num_del = 0;
+	return 0;
+}
+
+/*
+ * Rebuild delta tries and publish new RT.
+ */
+static int
+acl_incr_update(struct rte_acl_ctx *ctx)
+{
+	int32_t n, rc;
+	uint32_t num_del;
+	void *rules;
+	struct rte_acl_ctx *dlt, *rt;
+	struct acl_incr_del *del;
+
+	rc = acl_incr_init(ctx);
+	if (rc != 0)
+		return rc;
+
+	del = acl_incr_del_pairs(ctx, &num_del);
+	if (del == NULL)
+		return -ENOMEM;
+
+	n = acl_incr_delta_rules(ctx, del, num_del, &rules);
+	if (n < 0) {
+		rte_free(del);
+		return n;
+	}
+
+	dlt = NULL;
+	rc = 0;
+	if (n != 0) {
+		dlt = acl_rt_alloc(ctx);
+		if (dlt == NULL) {
+			rc = -ENOMEM;
+		} else {
+			dlt->rules = rules;
+			dlt->max_rules = n;
+			dlt->num_rules = n;
+			dlt->rule_sz = ctx->rule_sz;
+			rc = rte_acl_build(dlt, &ctx->config);
+		}
+	}
+	rte_free(rules);
+
+	/* delta tries don't fit, do the full rebuild. */
+	if (rc == 0 && dlt != NULL &&
+			ctx->base->num_tries + dlt->num_tries >
+			RTE_ACL_MAX_TRIES)
+		rc = -ERANGE;
+
+	rt = NULL;
+	if (rc == 0) {
+		rt = acl_rt_join(ctx, ctx->base, dlt);
+		if (rt == NULL)
+			rc = -rte_errno;
+	}
+	acl_rt_free(dlt);
+
+	if (rc == -ERANGE) {
+		RTE_LOG(DEBUG, ACL,
+			"ACL context: %s, delta doesn't fit, full rebuild\n",
+			ctx->name);
+		rte_free(del);
+		return rte_acl_incr_merge(ctx);
+	} else if (rc != 0) {
+		rte_free(del);
+		return rc;
+	}
+
+	acl_rt_suppress(rt, ctx->base->num_match, del, num_del);
+	rte_free(del);
+
+	acl_rt_publish(ctx, rt, ctx->base);
+	return 0;
+}
+
+int
+rte_acl_incr_add(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num)
+{
+	int32_t rc;
+
+	if (ctx == NULL || rules == NULL || ctx->num_main > ctx->num_rules ||
+			(ctx->base == NULL && ctx->trans_table == NULL))
+		return -EINVAL;
+
+	rc = rte_acl_add_rules(ctx, rules, num);
+	if (rc != 0)
+		return rc;
+
+	rc = acl_incr_update(ctx);
+	if (rc != 0)
+		ctx->num_rules -= num;
+	return rc;
+}
+
+/*
+ * Remove idx-th rule, deleted main rules are kept aside,
+ * order of the rules is not preserved.
+ */
+static void
+acl_incr_del_rule(struct rte_acl_ctx *ctx, uint32_t idx)
+{
+	uint8_t *rules;
+	uint32_t sz;
+
+	rules = ctx->rules;
+	sz = ctx->rule_sz;
+
+	if (idx < ctx->num_main) {
+		memcpy((uint8_t *)ctx->del_rules + ctx->num_del * sz,
+			rules + idx * sz, sz);
+		ctx->num_del++;
+		ctx->num_main--;
+		memcpy(rules + idx * sz, rules + ctx->num_main * sz, sz);
+		idx = ctx->num_main;
+	}
+
+	ctx->num_rules--;
+	if (idx != ctx->num_rules)
+		memcpy(rules + idx * sz, rules + ctx->num_rules * sz, sz);
+}
+
+static int
+acl_idx_cmp(const void *a, const void *b)
+{
+	uint32_t i1 = *(const uint32_t *)a;
+	uint32_t i2 = *(const uint32_t *)b;
+
+	return (i1 > i2) ? -1 : (i1 < i2);
+}
+
+int
+rte_acl_incr_del(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num)
+{
+	uint32_t i, j, k, *idx;
+	const struct rte_acl_rule *rv;
+
+	if (ctx == NULL || rules == NULL || ctx->num_main > ctx->num_rules ||
+			(ctx->base == NULL && ctx->trans_table == NULL))
+		return -EINVAL;
+
+	if (num == 0)
+		return 0;
+
+	if (ctx->del_rules == NULL) {
+		ctx->del_rules = rte_malloc_socket(ctx->name,
+			ctx->max_rules * ctx->rule_sz, 0, ctx->socket_id);
+		if (ctx->del_rules == NULL)
+			return -ENOMEM;
+	}
+
+	idx = rte_malloc(NULL, num * sizeof(idx[0]), 0);
+	if (idx == NULL)
+		return -ENOMEM;
+
+	/* find all the rules first, each rule can be deleted only once. */
+	for (i = 0; i != num; i++) {
+		rv = acl_rule_get(rules, ctx->rule_sz, i);
+		for (j = 0; j != ctx->num_rules; j++) {
+			if (!acl_rule_equal(&ctx->config, rv,
+					acl_rule_get(ctx->rules,
+					ctx->rule_sz, j)))
+				continue;
+			for (k = 0; k != i && idx[k] != j; k++)
+				;
+			if (k == i)
+				break;
+		}
+		if (j == ctx->num_rules) {
+			RTE_LOG(ERR, ACL, "%s(%s): rule #%u is not found\n",
+				__func__, ctx->name, i + 1);
+			rte_free(idx);
+			return -ENOENT;
+		}
+		idx[i] = j;
+	}
+
+	/* remove from the last one, so indexes to remove stay valid. */
+	qsort(idx, num, sizeof(idx[0]), acl_idx_cmp);
+	for (i = 0; i != num; i++)
+		acl_incr_del_rule(ctx, idx[i]);
+
+	rte_free(idx);
+	return acl_incr_update(ctx);
+}
+
+int
+rte_acl_rcu_qsbr_add(struct rte_acl_ctx *ctx, struct rte_acl_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (ctx == NULL || cfg == NULL)
+		return -EINVAL;
+
+	if (ctx->v != NULL)
+		return -EEXIST;
+
+	if (cfg->mode == RTE_ACL_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_ACL_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"ACL_RCU_%s", ctx->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = RTE_ACL_RCU_DQ_SIZE;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_ACL_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(struct rte_acl_ctx *);
+		params.free_fn = acl_rcu_free_rt;
+		params.p = ctx;
+		params.v = cfg->v;
+		ctx->dq = rte_rcu_qsbr_dq_create(&params);
+		if (ctx->dq == NULL) {
+			RTE_LOG(ERR, ACL, "ACL defer queue creation failed\n");
+			return -ENOMEM;
+		}
+	} else {
+		return -EINVAL;
+	}
+	ctx->rcu_mode = cfg->mode;
+	ctx->v = cfg->v;
+
+	return 0;
+}
+
+/*
+ * Drop incremental updates state, called by the full build.
+ */
+void
+acl_incr_reset(struct rte_acl_ctx *ctx)
+{
+	struct rte_acl_ctx *rt, *base;
+
+	rt = ctx->rt;
+	base = ctx->base;
+
+	__atomic_store_n(&ctx->rt, NULL, __ATOMIC_RELEASE);
+	ctx->base = NULL;
+	ctx->num_main = ctx->num_rules;
+	ctx->num_del = 0;
+
+	if (rt != base)
+		acl_rt_retire(ctx, rt);
+	acl_rt_retire(ctx, base);
+}
+
+void
+acl_incr_free(struct rte_acl_ctx *ctx)
+{
+	if (ctx->dq != NULL)
+		rte_rcu_qsbr_dq_delete(ctx->dq);
+	if (ctx->rt != ctx->base)
+		acl_rt_free(ctx->rt);
+	acl_rt_free(ctx->base);
+	rte_free(ctx->del_rules);
+}
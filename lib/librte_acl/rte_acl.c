@@ -292,10 +292,17 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories,
 	enum rte_acl_classify_alg alg)
 {
+	const struct rte_acl_ctx *rt;
+
 	if (categories != 1 &&
 			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0)
 		return -EINVAL;
 
+	/* use RT published by the incremental updates, if any. */
+	rt = __atomic_load_n(&ctx->rt, __ATOMIC_ACQUIRE);
+	if (rt != NULL)
+		ctx = rt;
+
 	return classify_fns[alg](ctx, data, results, num, categories);
 }
 
@@ -358,6 +365,7 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_mcfg_tailq_write_unlock();
 
+	acl_incr_free(ctx);
 	rte_free(ctx->mem);
 	rte_free(ctx);
 	rte_free(te);
@@ -507,6 +515,27 @@ rte_acl_reset(struct rte_acl_ctx *ctx)
 	}
 }
 
+int
+rte_acl_set_build_workers(struct rte_acl_ctx *ctx, uint32_t num_workers)
+{
+	if (ctx == NULL)
+		return -EINVAL;
+
+	ctx->num_workers = num_workers;
+	return 0;
+}
+
+int
+rte_acl_get_build_stats(const struct rte_acl_ctx *ctx,
+	struct rte_acl_build_stats *stats)
+{
+	if (ctx == NULL || stats == NULL)
+		return -EINVAL;
+
+	*stats = ctx->stats;
+	return 0;
+}
+
 /*
  * Dump ACL context to the stdout.
  */
@@ -12,6 +12,7 @@
  */
 
 #include <rte_acl_osdep.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,6 +70,20 @@ struct rte_acl_config {
 	/**< max memory limit for internal run-time structures. */
 };
 
+/**
+ * Statistics of the last build of an ACL context.
+ */
+struct rte_acl_build_stats {
+	uint64_t build_time; /**< Time spent building the tries (us). */
+	uint64_t gen_time;   /**< Time spent generating RT structures (us). */
+	size_t peak_mem;     /**< Peak memory used by the build (bytes). */
+	size_t rt_mem;       /**< Size of the run-time structures (bytes). */
+	uint32_t num_nodes;  /**< Number of trie nodes created. */
+	uint32_t num_tries;  /**< Number of tries built. */
+	uint32_t num_workers; /**< Number of threads used by the build. */
+	uint32_t num_passes; /**< Number of build passes to fit max_size. */
+};
+
 /**
  * Defines the value of a field for a rule.
  */
@@ -206,6 +221,11 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx);
 /**
  * Analyze set of rules and build required internal run-time structures.
  * This function is not multi-thread safe.
+ * If rte_acl_set_build_workers() set more than one worker for the context,
+ * the function spawns extra control threads to build and generate the tries in parallel,
+ * and waits for them before returning.
+ * Run-time structures published by rte_acl_incr_add(), rte_acl_incr_del()
+ * and rte_acl_incr_merge() are released.
  *
  * @param ctx
  *   ACL context to build.
@@ -339,6 +359,198 @@ extern int
 rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx,
 	enum rte_acl_classify_alg alg);
 
+/** @internal Default RCU defer queue size. */
+#define RTE_ACL_RCU_DQ_SIZE		64
+
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_ACL_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_acl_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_ACL_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_ACL_QSBR_MODE_SYNC
+};
+
+/** ACL RCU QSBR configuration structure. */
+struct rte_acl_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_ACL_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_acl_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: RTE_ACL_RCU_DQ_SIZE.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_ACL_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add rules to an ACL context that was already built and update its
+ * internal run-time structures without a full rebuild.
+ * The new rules are built into a separate small trie, that is searched
+ * together with the tries of the last full build.
+ * The updated run-time structures are published atomically, so
+ * rte_acl_classify() and rte_acl_classify_alg() can run concurrently
+ * with this function. Old run-time structures are released once
+ * the readers have reported a quiescent state, see rte_acl_rcu_qsbr_add().
+ * Note that the classify methods called directly
+ * (i.e. rte_acl_classify_scalar()) always use the run-time structures
+ * of the last rte_acl_build(), rte_acl_incr_merge() doesn't change them.
+ * If the extra trie doesn't fit into the context, a full rebuild
+ * is performed as with rte_acl_incr_merge().
+ * This function is not multi-thread safe with other functions
+ * that modify the context.
+ *
+ * @param ctx
+ *   ACL context built with rte_acl_build().
+ * @param rules
+ *   Array of rules to add to the ACL context, see rte_acl_add_rules().
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOMEM if there is no space in the ACL context for these rules
+ *     or couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid or context was not built.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_add(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete rules from an ACL context that was already built and update its
+ * internal run-time structures without a full rebuild.
+ * Each rule has to be equal to a rule in the context: same category mask,
+ * priority, userdata and field values.
+ * Results of the deleted rules are removed from the tries of the last
+ * full build, the remaining rules that overlap with them are
+ * added to the separate trie, see rte_acl_incr_add().
+ * This function is not multi-thread safe with other functions
+ * that modify the context.
+ *
+ * @param ctx
+ *   ACL context built with rte_acl_build().
+ * @param rules
+ *   Array of rules to delete from the ACL context.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOENT if some rule is not found, no rules are deleted then.
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid or context was not built.
+ *   - Negative error code if operation failed, rules are deleted
+ *     but run-time structures are not updated.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_del(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
+	uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Rebuild the internal run-time structures from all the rules of the context
+ * and publish them the same way as rte_acl_incr_add() does.
+ * Intended to be called periodically (i.e. from a background thread)
+ * to merge the changes made by rte_acl_incr_add() and rte_acl_incr_del().
+ * Unlike rte_acl_build() this function can run concurrently with
+ * rte_acl_classify().
+ * This function is not multi-thread safe with other functions
+ * that modify the context.
+ *
+ * @param ctx
+ *   ACL context built with rte_acl_build().
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid or context was not built.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_incr_merge(struct rte_acl_ctx *ctx);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with an ACL context.
+ * Run-time structures replaced by rte_acl_incr_add(), rte_acl_incr_del()
+ * and rte_acl_incr_merge() are not freed until all the readers registered
+ * with the QSBR variable have reported a quiescent state.
+ * Without it they are freed immediately, so the caller has to make sure
+ * that no classify is in progress.
+ *
+ * @param ctx
+ *   ACL context to add RCU QSBR to.
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EEXIST if already added QSBR.
+ *   - -ENOMEM if defer queue creation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_rcu_qsbr_add(struct rte_acl_ctx *ctx, struct rte_acl_rcu_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the number of threads rte_acl_build() uses for an ACL context.
+ * The value is kept across builds until changed.
+ *
+ * @param ctx
+ *   ACL context.
+ * @param num_workers
+ *   Number of threads to build with, including the calling one.
+ *   Zero or one means that the build runs on the calling thread only.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_set_build_workers(struct rte_acl_ctx *ctx, uint32_t num_workers);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve statistics of the last rte_acl_build() for an ACL context.
+ * When the build has to be repeated to fit into max_size, the times of
+ * all the passes are summed up and the peak memory is the largest of them.
+ *
+ * @param ctx
+ *   ACL context.
+ * @param stats
+ *   Pointer to the structure to fill.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_get_build_stats(const struct rte_acl_ctx *ctx,
+	struct rte_acl_build_stats *stats);
+
 /**
  * Dump an ACL context structure to the console.
  *
@@ -30,27 +30,11 @@ static inline const struct rte_memzone *
 memzone_lookup_thread_unsafe(const char *name)
 {
 	struct rte_mem_config *mcfg;
-	struct rte_fbarray *arr;
-	const struct rte_memzone *mz;
-	int i = 0;
 
 	/* get pointer to global configuration */
 	mcfg = rte_eal_get_configuration()->mem_config;
-	arr = &mcfg->memzones;
 
-	/*
-	 * the algorithm is not optimal (linear), but there are few
-	 * zones and this function should be called at init only
-	 */
-	i = rte_fbarray_find_next_used(arr, 0);
-	while (i >= 0) {
-		mz = rte_fbarray_get(arr, i);
-		if (mz->addr != NULL &&
-				!strncmp(name, mz->name, RTE_MEMZONE_NAMESIZE))
-			return mz;
-		i = rte_fbarray_find_next_used(arr, i + 1);
-	}
-	return NULL;
+	return eal_name_index_lookup(&mcfg->memzone_index, name);
 }
 
 static const struct rte_memzone *
@@ -175,11 +159,22 @@ memzone_reserve_aligned_thread_unsafe(const char *name, size_t len,
 	}
 
 	strlcpy(mz->name, name, sizeof(mz->name));
+	if (eal_name_index_add(&mcfg->memzone_index, mz->name, mz) < 0) {
+		RTE_LOG(ERR, EAL, "%s(): Cannot index memzone\n", __func__);
+		memset(mz, 0, sizeof(*mz));
+		rte_fbarray_set_free(arr, mz_idx);
+		malloc_heap_free(elem);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
 	mz->iova = rte_malloc_virt2iova(mz_addr);
 	mz->addr = mz_addr;
 	mz->len = requested_len == 0 ?
 			elem->size - elem->pad - MALLOC_ELEM_OVERHEAD :
 			requested_len;
+
+	/* memzones are expected to be zeroed, clear memory freed lazily */
+	malloc_elem_zero_dirty(elem, mz_addr, mz->len);
 	mz->hugepage_sz = elem->msl->page_sz;
 	mz->socket_id = elem->msl->socket_id;
 	mz->flags = 0;
@@ -277,6 +272,7 @@ rte_memzone_free(const struct rte_memzone *mz)
 		ret = -EINVAL;
 	} else {
 		addr = found_mz->addr;
+		eal_name_index_del(&mcfg->memzone_index, found_mz->name);
 		memset(found_mz, 0, sizeof(*found_mz));
 		rte_fbarray_set_free(arr, idx);
 	}
@@ -0,0 +1,153 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+
+#include "eal_name_index.h"
+
+/* Initial number of slots, the index is kept at most half full. */
+#define NAME_INDEX_MIN_SIZE 64
+
+/* 32-bit FNV-1a hash */
+static uint32_t
+name_hash(const char *name, size_t len)
+{
+	uint32_t hash = 2166136261u;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= (uint8_t)name[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* return the slot holding name, or the empty slot ending its probe chain */
+static uint32_t
+find_slot(const struct eal_name_index_slot *slots, uint32_t size,
+		const char *name, uint32_t hash)
+{
+	const uint32_t mask = size - 1;
+	uint32_t i;
+
+	for (i = hash & mask; slots[i].obj != NULL; i = (i + 1) & mask) {
+		if (slots[i].hash == hash &&
+				strcmp(slots[i].name, name) == 0)
+			break;
+	}
+	return i;
+}
+
+static int
+index_grow(struct eal_name_index *idx)
+{
+	struct eal_name_index_slot *slots;
+	uint32_t size, i, j;
+
+	size = idx->size == 0 ? NAME_INDEX_MIN_SIZE : idx->size * 2;
+	slots = rte_zmalloc("EAL_NAME_INDEX", size * sizeof(*slots), 0);
+	if (slots == NULL)
+		return -1;
+
+	for (i = 0; i < idx->size; i++) {
+		if (idx->slots[i].obj == NULL)
+			continue;
+		j = find_slot(slots, size, idx->slots[i].name,
+				idx->slots[i].hash);
+		slots[j] = idx->slots[i];
+	}
+
+	rte_free(idx->slots);
+	idx->slots = slots;
+	idx->size = size;
+	return 0;
+}
+
+int
+eal_name_index_add(struct eal_name_index *idx, const char *name, void *obj)
+{
+	size_t len = strnlen(name, EAL_NAME_INDEX_NAMESIZE);
+	uint32_t hash, i;
+
+	if (len == EAL_NAME_INDEX_NAMESIZE) {
+		rte_errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	/* keep the load factor under 1/2, but use the last free slots if
+	 * there is no memory to grow the index.
+	 */
+	if ((idx->count + 1) * 2 > idx->size && index_grow(idx) < 0 &&
+			idx->count + 1 >= idx->size) {
+		RTE_LOG(ERR, EAL, "Cannot grow name index\n");
+		rte_errno = ENOMEM;
+		return -1;
+	}
+
+	hash = name_hash(name, len);
+	i = find_slot(idx->slots, idx->size, name, hash);
+	if (idx->slots[i].obj != NULL) {
+		rte_errno = EEXIST;
+		return -1;
+	}
+
+	idx->slots[i].hash = hash;
+	memcpy(idx->slots[i].name, name, len + 1);
+	idx->slots[i].obj = obj;
+	idx->count++;
+	return 0;
+}
+
+void *
+eal_name_index_lookup(const struct eal_name_index *idx, const char *name)
+{
+	size_t len = strnlen(name, EAL_NAME_INDEX_NAMESIZE);
+	uint32_t i;
+
+	if (idx->size == 0 || len == EAL_NAME_INDEX_NAMESIZE)
+		return NULL;
+
+	i = find_slot(idx->slots, idx->size, name, name_hash(name, len));
+	return idx->slots[i].obj;
+}
+
+void *
+eal_name_index_del(struct eal_name_index *idx, const char *name)
+{
+	size_t len = strnlen(name, EAL_NAME_INDEX_NAMESIZE);
+	struct eal_name_index_slot *slots = idx->slots;
+	const uint32_t mask = idx->size - 1;
+	uint32_t i, j, home;
+	void *obj;
+
+	if (idx->size == 0 || len == EAL_NAME_INDEX_NAMESIZE)
+		return NULL;
+
+	i = find_slot(slots, idx->size, name, name_hash(name, len));
+	obj = slots[i].obj;
+	if (obj == NULL)
+		return NULL;
+
+	/* shift back the following entries of the probe chain, so that no
+	 * tombstone is needed.
+	 */
+	for (j = (i + 1) & mask; slots[j].obj != NULL; j = (j + 1) & mask) {
+		home = slots[j].hash & mask;
+		/* entry can stay if its home slot is cyclically in (i, j] */
+		if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+			continue;
+		slots[i] = slots[j];
+		i = j;
+	}
+	memset(&slots[i], 0, sizeof(slots[i]));
+	idx->count--;
+
+	return obj;
+}
@@ -103,6 +103,7 @@ eal_long_options[] = {
 	{OPT_LEGACY_MEM,        0, NULL, OPT_LEGACY_MEM_NUM       },
 	{OPT_SINGLE_FILE_SEGMENTS, 0, NULL, OPT_SINGLE_FILE_SEGMENTS_NUM},
 	{OPT_MATCH_ALLOCATIONS, 0, NULL, OPT_MATCH_ALLOCATIONS_NUM},
+	{OPT_MEM_INIT_THREADS,  1, NULL, OPT_MEM_INIT_THREADS_NUM },
 	{OPT_TELEMETRY,         0, NULL, OPT_TELEMETRY_NUM        },
 	{OPT_NO_TELEMETRY,      0, NULL, OPT_NO_TELEMETRY_NUM     },
 	{OPT_FORCE_MAX_SIMD_BITWIDTH, 1, NULL, OPT_FORCE_MAX_SIMD_BITWIDTH_NUM},
@@ -352,6 +353,7 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 	internal_cfg->user_mbuf_pool_ops_name = NULL;
 	CPU_ZERO(&internal_cfg->ctrl_cpuset);
 	internal_cfg->init_complete = 0;
+	internal_cfg->mem_init_threads = 1;
 	internal_cfg->max_simd_bitwidth.bitwidth = RTE_VECT_DEFAULT_SIMD_BITWIDTH;
 	internal_cfg->max_simd_bitwidth.forced = 0;
 }
@@ -1990,6 +1992,17 @@ eal_check_common_options(struct internal_config *internal_cfg)
 				"with --"OPT_MATCH_ALLOCATIONS"\n");
 		return -1;
 	}
+	if (internal_cfg->mem_init_threads > 1 && internal_cfg->legacy_mem) {
+		RTE_LOG(ERR, EAL, "Option --"OPT_MEM_INIT_THREADS" is not "
+				"compatible with --"OPT_LEGACY_MEM"\n");
+		return -1;
+	}
+	if (internal_cfg->mem_init_threads > 1 &&
+			internal_cfg->single_file_segments) {
+		RTE_LOG(ERR, EAL, "Option --"OPT_MEM_INIT_THREADS" is not "
+				"compatible with --"OPT_SINGLE_FILE_SEGMENTS"\n");
+		return -1;
+	}
 	if (internal_cfg->legacy_mem && internal_cfg->memory == 0) {
 		RTE_LOG(NOTICE, EAL, "Static memory layout is selected, "
 			"amount of reserved memory can be adjusted with "
@@ -21,7 +21,9 @@
 #include <rte_log.h>
 #include <rte_string_fns.h>
 #include <rte_debug.h>
+#include <rte_errno.h>
 
+#include "eal_name_index.h"
 #include "eal_private.h"
 #include "eal_memcfg.h"
 
@@ -51,6 +53,55 @@ rte_eal_tailq_lookup(const char *name)
 	return NULL;
 }
 
+/* get the name index of a tailq head, NULL if head is not a valid tailq */
+static struct eal_name_index *
+tailq_name_index(struct rte_tailq_head *head)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+
+	if (head < &mcfg->tailq_head[0] ||
+			head >= &mcfg->tailq_head[RTE_MAX_TAILQ])
+		return NULL;
+
+	return &mcfg->tailq_index[head - &mcfg->tailq_head[0]];
+}
+
+int
+rte_eal_tailq_index_add(struct rte_tailq_head *head, const char *name,
+		struct rte_tailq_entry *te)
+{
+	struct eal_name_index *idx = tailq_name_index(head);
+
+	if (idx == NULL || name == NULL || te == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	return eal_name_index_add(idx, name, te);
+}
+
+struct rte_tailq_entry *
+rte_eal_tailq_index_del(struct rte_tailq_head *head, const char *name)
+{
+	struct eal_name_index *idx = tailq_name_index(head);
+
+	if (idx == NULL || name == NULL)
+		return NULL;
+
+	return eal_name_index_del(idx, name);
+}
+
+struct rte_tailq_entry *
+rte_eal_tailq_index_lookup(struct rte_tailq_head *head, const char *name)
+{
+	struct eal_name_index *idx = tailq_name_index(head);
+
+	if (idx == NULL || name == NULL)
+		return NULL;
+
+	return eal_name_index_lookup(idx, name);
+}
+
 void
 rte_dump_tailq(FILE *f)
 {
@@ -71,6 +71,8 @@ struct internal_config {
 	 */
 	volatile unsigned match_allocations;
 	/**< true to free hugepages exactly as allocated */
+	unsigned int mem_init_threads;
+	/**< number of threads per NUMA node allocating hugepages at init */
 	volatile unsigned single_file_segments;
 	/**< true if storing all pages within single files (per-page-size,
 	 * per-node) non-legacy mode only.
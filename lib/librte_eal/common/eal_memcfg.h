@@ -12,6 +12,7 @@
 #include <rte_rwlock.h>
 #include <rte_tailq.h>
 
+#include "eal_name_index.h"
 #include "malloc_heap.h"
 
 /**
@@ -45,6 +46,7 @@ struct rte_mem_config {
 
 	/* memory segments and zones */
 	struct rte_fbarray memzones; /**< Memzone descriptors. */
+	struct eal_name_index memzone_index; /**< Memzones by name. */
 
 	struct rte_memseg_list memsegs[RTE_MAX_MEMSEG_LISTS];
 	/**< List of dynamic arrays holding memsegs */
@@ -52,6 +54,9 @@ struct rte_mem_config {
 	struct rte_tailq_head tailq_head[RTE_MAX_TAILQ];
 	/**< Tailqs for objects */
 
+	struct eal_name_index tailq_index[RTE_MAX_TAILQ];
+	/**< Objects of each tailq by name */
+
 	struct malloc_heap malloc_heaps[RTE_MAX_HEAPS];
 	/**< DPDK malloc heaps */
 
@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#ifndef EAL_NAME_INDEX_H
+#define EAL_NAME_INDEX_H
+
+#include <stdint.h>
+
+/* Longest name (including the terminating NUL) that can be indexed. */
+#define EAL_NAME_INDEX_NAMESIZE 64
+
+struct eal_name_index_slot {
+	void *obj;     /**< Indexed object, NULL if the slot is empty. */
+	uint32_t hash; /**< Hash of the name. */
+	char name[EAL_NAME_INDEX_NAMESIZE];
+};
+
+/**
+ * Open addressing hash table mapping names to objects. It lives in shared
+ * memory, and its slots are allocated from the malloc heaps, so that it can
+ * be used by all processes. The caller is responsible for locking.
+ */
+struct eal_name_index {
+	uint32_t size;  /**< Number of slots, zero or a power of two. */
+	uint32_t count; /**< Number of used slots. */
+	struct eal_name_index_slot *slots;
+};
+
+/*
+ * Add an object to the index. The slot array is grown as needed.
+ * Returns 0 on success, -1 on error with rte_errno set to EEXIST if the name
+ * is already indexed, ENAMETOOLONG if it is too long or ENOMEM.
+ */
+int
+eal_name_index_add(struct eal_name_index *idx, const char *name, void *obj);
+
+/*
+ * Remove a name from the index. Returns the object it was mapped to, or NULL
+ * if it was not indexed.
+ */
+void *
+eal_name_index_del(struct eal_name_index *idx, const char *name);
+
+/*
+ * Return the object mapped to a name, or NULL if it is not indexed.
+ */
+void *
+eal_name_index_lookup(const struct eal_name_index *idx, const char *name);
+
+#endif /* EAL_NAME_INDEX_H */
@@ -87,6 +87,8 @@ enum {
 	OPT_IOVA_MODE_NUM,
 #define OPT_MATCH_ALLOCATIONS  "match-allocations"
 	OPT_MATCH_ALLOCATIONS_NUM,
+#define OPT_MEM_INIT_THREADS  "mem-init-threads"
+	OPT_MEM_INIT_THREADS_NUM,
 #define OPT_TELEMETRY         "telemetry"
 	OPT_TELEMETRY_NUM,
 #define OPT_NO_TELEMETRY      "no-telemetry"
@@ -0,0 +1,354 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/queue.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+#include <rte_memory.h>
+#include <rte_spinlock.h>
+
+#include "malloc_elem.h"
+#include "malloc_heap.h"
+#include "malloc_cache.h"
+
+/*
+ * Per-lcore object cache. Only ever accessed by the thread owning the lcore,
+ * so no locking is needed. All cached objects belong to the heap of socket_id.
+ */
+struct malloc_lcore_cache {
+	unsigned int socket_id;
+	unsigned int len[MALLOC_CACHE_NUM_CLASSES];
+	void *objs[MALLOC_CACHE_NUM_CLASSES][MALLOC_CACHE_LCORE_SIZE];
+} __rte_cache_aligned;
+
+/*
+ * Per-socket object cache, shared by all threads of the process. Used to
+ * exchange objects between lcore caches, and as the cache of threads that
+ * do not have a lcore id.
+ */
+struct malloc_socket_cache {
+	rte_spinlock_t lock;
+	unsigned int len[MALLOC_CACHE_NUM_CLASSES];
+	void *objs[MALLOC_CACHE_NUM_CLASSES][MALLOC_CACHE_SOCKET_SIZE];
+} __rte_cache_aligned;
+
+static struct malloc_lcore_cache lcore_caches[RTE_MAX_LCORE];
+static struct malloc_socket_cache socket_caches[RTE_MAX_NUMA_NODES];
+
+static volatile bool cache_enabled;
+static void *cache_lcore_cb;
+static rte_spinlock_t cache_cfg_lock = RTE_SPINLOCK_INITIALIZER;
+
+static inline unsigned int
+size_to_class(size_t size)
+{
+	if (size <= (1 << MALLOC_CACHE_MIN_SIZE_LOG2))
+		return 0;
+	return rte_log2_u32((uint32_t)size) - MALLOC_CACHE_MIN_SIZE_LOG2;
+}
+
+static inline size_t
+class_to_size(unsigned int cls)
+{
+	return (size_t)1 << (cls + MALLOC_CACHE_MIN_SIZE_LOG2);
+}
+
+static void
+release_obj(void *obj)
+{
+	struct malloc_elem *elem = malloc_elem_from_data(obj);
+
+	elem->in_cache = 0;
+	if (malloc_heap_free(elem) < 0)
+		RTE_LOG(ERR, EAL, "Error: Invalid memory in malloc cache\n");
+}
+
+/* hand a cached object back to the application */
+static inline void *
+cache_obj_take(void *obj)
+{
+	struct malloc_elem *elem;
+
+	if (obj != NULL) {
+		elem = RTE_PTR_SUB(obj, MALLOC_ELEM_HEADER_LEN);
+		elem->in_cache = 0;
+	}
+	return obj;
+}
+
+/* get an object from a socket cache, returns NULL if it is empty */
+static void *
+socket_cache_get(unsigned int socket_id, unsigned int cls)
+{
+	struct malloc_socket_cache *sc = &socket_caches[socket_id];
+	void *obj = NULL;
+
+	rte_spinlock_lock(&sc->lock);
+	if (sc->len[cls] != 0)
+		obj = sc->objs[cls][--sc->len[cls]];
+	rte_spinlock_unlock(&sc->lock);
+
+	return obj;
+}
+
+/* put an object in a socket cache, returns -1 if it is full */
+static int
+socket_cache_put(unsigned int socket_id, unsigned int cls, void *obj)
+{
+	struct malloc_socket_cache *sc = &socket_caches[socket_id];
+	int ret = -1;
+
+	rte_spinlock_lock(&sc->lock);
+	if (sc->len[cls] != MALLOC_CACHE_SOCKET_SIZE) {
+		sc->objs[cls][sc->len[cls]++] = obj;
+		ret = 0;
+	}
+	rte_spinlock_unlock(&sc->lock);
+
+	return ret;
+}
+
+/* move up to MALLOC_CACHE_BATCH objects from the socket cache */
+static unsigned int
+lcore_cache_refill(struct malloc_lcore_cache *lc, unsigned int cls)
+{
+	struct malloc_socket_cache *sc = &socket_caches[lc->socket_id];
+	unsigned int n;
+
+	rte_spinlock_lock(&sc->lock);
+	n = RTE_MIN(sc->len[cls], (unsigned int)MALLOC_CACHE_BATCH);
+	sc->len[cls] -= n;
+	memcpy(&lc->objs[cls][lc->len[cls]], &sc->objs[cls][sc->len[cls]],
+			n * sizeof(void *));
+	rte_spinlock_unlock(&sc->lock);
+
+	lc->len[cls] += n;
+	return n;
+}
+
+/* move MALLOC_CACHE_BATCH objects to the socket cache, or to the heap */
+static void
+lcore_cache_spill(struct malloc_lcore_cache *lc, unsigned int cls)
+{
+	struct malloc_socket_cache *sc = &socket_caches[lc->socket_id];
+	unsigned int n, i;
+
+	rte_spinlock_lock(&sc->lock);
+	n = RTE_MIN(MALLOC_CACHE_SOCKET_SIZE - sc->len[cls],
+			(unsigned int)MALLOC_CACHE_BATCH);
+	lc->len[cls] -= n;
+	memcpy(&sc->objs[cls][sc->len[cls]], &lc->objs[cls][lc->len[cls]],
+			n * sizeof(void *));
+	sc->len[cls] += n;
+	rte_spinlock_unlock(&sc->lock);
+
+	/* socket cache is full, give the objects back to the heap */
+	for (i = n; i < MALLOC_CACHE_BATCH; i++)
+		release_obj(lc->objs[cls][--lc->len[cls]]);
+}
+
+static unsigned int
+lcore_cache_flush(struct malloc_lcore_cache *lc)
+{
+	unsigned int cls, n = 0;
+
+	for (cls = 0; cls < MALLOC_CACHE_NUM_CLASSES; cls++) {
+		n += lc->len[cls];
+		while (lc->len[cls] != 0)
+			release_obj(lc->objs[cls][--lc->len[cls]]);
+	}
+	return n;
+}
+
+static unsigned int
+socket_cache_flush(struct malloc_socket_cache *sc)
+{
+	unsigned int cls, n = 0;
+
+	rte_spinlock_lock(&sc->lock);
+	for (cls = 0; cls < MALLOC_CACHE_NUM_CLASSES; cls++) {
+		n += sc->len[cls];
+		while (sc->len[cls] != 0)
+			release_obj(sc->objs[cls][--sc->len[cls]]);
+	}
+	rte_spinlock_unlock(&sc->lock);
+	return n;
+}
+
+/* allocate a new object of a given class and mark it as cacheable */
+static void *
+class_alloc(const char *type, unsigned int cls, unsigned int socket_id)
+{
+	struct malloc_elem *elem;
+	void *obj;
+
+	obj = malloc_heap_alloc(type, class_to_size(cls), socket_id, 0,
+			RTE_CACHE_LINE_SIZE, 0, false);
+	if (obj == NULL)
+		return NULL;
+
+	elem = malloc_elem_from_data(obj);
+	elem->cache_class = cls + 1;
+	return obj;
+}
+
+void *
+malloc_cache_alloc(const char *type, size_t size, unsigned int align,
+		int socket_arg)
+{
+	struct malloc_lcore_cache *lc;
+	unsigned int lcore_id, socket_id, cls;
+	void *obj;
+
+	if (!cache_enabled || size > MALLOC_CACHE_MAX_SIZE ||
+			align > RTE_CACHE_LINE_SIZE)
+		return NULL;
+
+	socket_id = malloc_get_numa_socket();
+	if (socket_arg != SOCKET_ID_ANY && (unsigned int)socket_arg != socket_id)
+		return NULL;
+
+	cls = size_to_class(size);
+	lcore_id = rte_lcore_id();
+	if (lcore_id == LCORE_ID_ANY) {
+		obj = cache_obj_take(socket_cache_get(socket_id, cls));
+		if (obj == NULL)
+			obj = class_alloc(type, cls, socket_id);
+		return obj;
+	}
+
+	lc = &lcore_caches[lcore_id];
+	if (unlikely(lc->socket_id != socket_id)) {
+		/* thread was moved to another socket, drop remote objects */
+		lcore_cache_flush(lc);
+		lc->socket_id = socket_id;
+	}
+
+	if (lc->len[cls] == 0 && lcore_cache_refill(lc, cls) == 0)
+		return class_alloc(type, cls, socket_id);
+
+	return cache_obj_take(lc->objs[cls][--lc->len[cls]]);
+}
+
+int
+malloc_cache_free(struct malloc_elem *elem)
+{
+	struct malloc_lcore_cache *lc;
+	unsigned int lcore_id, socket_id, cls;
+	void *obj;
+
+	if (elem->cache_class == 0 || !cache_enabled)
+		return -1;
+
+	cls = elem->cache_class - 1;
+	socket_id = elem->heap->socket_id;
+	obj = RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN);
+
+	/* mark it before it becomes visible to other threads */
+	elem->in_cache = 1;
+
+	lcore_id = rte_lcore_id();
+	if (lcore_id == LCORE_ID_ANY ||
+			lcore_caches[lcore_id].socket_id != socket_id) {
+		if (socket_cache_put(socket_id, cls, obj) == 0)
+			return 0;
+		elem->in_cache = 0;
+		return -1;
+	}
+
+	lc = &lcore_caches[lcore_id];
+	if (lc->len[cls] == MALLOC_CACHE_LCORE_SIZE)
+		lcore_cache_spill(lc, cls);
+
+	lc->objs[cls][lc->len[cls]++] = obj;
+	return 0;
+}
+
+unsigned int
+malloc_cache_reclaim(void)
+{
+	unsigned int lcore_id, socket_id, n = 0;
+
+	lcore_id = rte_lcore_id();
+	if (lcore_id != LCORE_ID_ANY)
+		n += lcore_cache_flush(&lcore_caches[lcore_id]);
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++)
+		n += socket_cache_flush(&socket_caches[socket_id]);
+
+	return n;
+}
+
+void
+malloc_cache_flush(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (lcore_id != LCORE_ID_ANY)
+		lcore_cache_flush(&lcore_caches[lcore_id]);
+}
+
+static int
+cache_lcore_init(unsigned int lcore_id, void *arg __rte_unused)
+{
+	lcore_caches[lcore_id].socket_id = (unsigned int)SOCKET_ID_ANY;
+	return 0;
+}
+
+static void
+cache_lcore_uninit(unsigned int lcore_id, void *arg __rte_unused)
+{
+	lcore_cache_flush(&lcore_caches[lcore_id]);
+}
+
+int
+malloc_cache_enable(void)
+{
+	int ret = 0;
+
+	rte_spinlock_lock(&cache_cfg_lock);
+	if (cache_enabled)
+		goto unlock;
+
+	cache_lcore_cb = rte_lcore_callback_register("malloc_cache",
+			cache_lcore_init, cache_lcore_uninit, NULL);
+	if (cache_lcore_cb == NULL) {
+		RTE_LOG(ERR, EAL, "Cannot register malloc cache lcore callback\n");
+		rte_errno = ENOMEM;
+		ret = -1;
+		goto unlock;
+	}
+	cache_enabled = true;
+unlock:
+	rte_spinlock_unlock(&cache_cfg_lock);
+	return ret;
+}
+
+int
+malloc_cache_disable(void)
+{
+	unsigned int socket_id;
+
+	rte_spinlock_lock(&cache_cfg_lock);
+	if (!cache_enabled)
+		goto unlock;
+
+	cache_enabled = false;
+	/* uninit callback flushes the cache of every lcore */
+	rte_lcore_callback_unregister(cache_lcore_cb);
+	cache_lcore_cb = NULL;
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++)
+		socket_cache_flush(&socket_caches[socket_id]);
+unlock:
+	rte_spinlock_unlock(&cache_cfg_lock);
+	return 0;
+}
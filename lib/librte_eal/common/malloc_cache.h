@@ -0,0 +1,63 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#ifndef MALLOC_CACHE_H_
+#define MALLOC_CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Size classes are powers of two, from one cache line up to
+ * MALLOC_CACHE_MAX_SIZE bytes.
+ */
+#define MALLOC_CACHE_MIN_SIZE_LOG2 6
+#define MALLOC_CACHE_MAX_SIZE_LOG2 12
+#define MALLOC_CACHE_MAX_SIZE (1 << MALLOC_CACHE_MAX_SIZE_LOG2)
+#define MALLOC_CACHE_NUM_CLASSES \
+	(MALLOC_CACHE_MAX_SIZE_LOG2 - MALLOC_CACHE_MIN_SIZE_LOG2 + 1)
+
+/* Max number of objects kept per size class in a lcore cache. */
+#define MALLOC_CACHE_LCORE_SIZE 32
+/* Number of objects moved at once between a lcore cache and a socket cache. */
+#define MALLOC_CACHE_BATCH (MALLOC_CACHE_LCORE_SIZE / 2)
+/* Max number of objects kept per size class in a socket cache. */
+#define MALLOC_CACHE_SOCKET_SIZE 128
+
+struct malloc_elem;
+
+/*
+ * Try to serve an allocation from the object cache. Returns NULL if the
+ * cache is disabled, the request is not cacheable or no memory could be
+ * obtained from the heap for the matching size class.
+ */
+void *
+malloc_cache_alloc(const char *type, size_t size, unsigned int align,
+		int socket_arg);
+
+/*
+ * Try to return an element to the object cache. Returns 0 if the element was
+ * cached, -1 if it must be freed to the heap by the caller. The element must
+ * have been checked to be a valid allocated element by the caller.
+ */
+int
+malloc_cache_free(struct malloc_elem *elem);
+
+/*
+ * Release the objects cached by the calling thread and by the socket caches
+ * back to the heaps. Returns the number of released objects.
+ */
+unsigned int
+malloc_cache_reclaim(void);
+
+int
+malloc_cache_enable(void);
+
+int
+malloc_cache_disable(void);
+
+void
+malloc_cache_flush(void);
+
+#endif /* MALLOC_CACHE_H_ */
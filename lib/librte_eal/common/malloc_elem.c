@@ -27,7 +27,7 @@
 /*
  * If debugging is enabled, freed memory is set to poison value
  * to catch buggy programs. Otherwise, freed memory is set to zero
- * to avoid having to zero in zmalloc
+ * to avoid having to zero in zmalloc, unless lazy zeroing is enabled.
  */
 #ifdef RTE_MALLOC_DEBUG
 #define MALLOC_POISON	       0x6b
@@ -35,6 +35,13 @@
 #define MALLOC_POISON	       0
 #endif
 
+/*
+ * With lazy zeroing, freed memory is not cleared but recorded as the dirty
+ * range of the free element. Dirty ranges are cleared on allocation by the
+ * callers needing zeroed memory, or in the background by the heap scrubber.
+ */
+static volatile bool lazy_zero;
+
 size_t
 malloc_elem_find_max_iova_contig(struct malloc_elem *elem, size_t align)
 {
@@ -141,6 +148,10 @@ malloc_elem_init(struct malloc_elem *elem, struct malloc_heap *heap,
 	elem->pad = 0;
 	elem->orig_elem = orig_elem;
 	elem->orig_size = orig_size;
+	elem->cache_class = 0;
+	elem->in_cache = 0;
+	elem->dirty_start = NULL;
+	elem->dirty_end = NULL;
 	set_header(elem);
 	set_trailer(elem);
 }
@@ -288,6 +299,97 @@ malloc_elem_can_hold(struct malloc_elem *elem, size_t size,	unsigned align,
 	return elem_start_pt(elem, size, align, bound, contig) != NULL;
 }
 
+void
+malloc_elem_set_lazy_zero(bool enable)
+{
+	lazy_zero = enable;
+}
+
+static inline bool
+elem_is_dirty(const struct malloc_elem *elem)
+{
+	return elem->dirty_start != elem->dirty_end;
+}
+
+static inline void
+elem_set_clean(struct malloc_elem *elem)
+{
+	elem->dirty_start = NULL;
+	elem->dirty_end = NULL;
+}
+
+/*
+ * restrict the dirty range of an element to its data area, this is needed
+ * after the element was split.
+ */
+static void
+elem_clamp_dirty(struct malloc_elem *elem)
+{
+	uintptr_t data_start = (uintptr_t)elem + MALLOC_ELEM_HEADER_LEN;
+	uintptr_t data_end = (uintptr_t)elem + elem->size -
+			MALLOC_ELEM_TRAILER_LEN;
+	uintptr_t start = RTE_MAX((uintptr_t)elem->dirty_start, data_start);
+	uintptr_t end = RTE_MIN((uintptr_t)elem->dirty_end, data_end);
+
+	if (!elem_is_dirty(elem) || start >= end) {
+		elem_set_clean(elem);
+		return;
+	}
+	elem->dirty_start = (void *)start;
+	elem->dirty_end = (void *)end;
+}
+
+/*
+ * extend the dirty range of dst to also cover the dirty range of src. The
+ * clean memory between both ranges is considered dirty from now on.
+ */
+static void
+elem_merge_dirty(struct malloc_elem *dst, const struct malloc_elem *src)
+{
+	if (!elem_is_dirty(src))
+		return;
+	if (!elem_is_dirty(dst)) {
+		dst->dirty_start = src->dirty_start;
+		dst->dirty_end = src->dirty_end;
+		return;
+	}
+	dst->dirty_start = (void *)RTE_MIN((uintptr_t)dst->dirty_start,
+			(uintptr_t)src->dirty_start);
+	dst->dirty_end = (void *)RTE_MAX((uintptr_t)dst->dirty_end,
+			(uintptr_t)src->dirty_end);
+}
+
+void
+malloc_elem_zero_dirty(struct malloc_elem *elem, void *data, size_t len)
+{
+	uintptr_t start = RTE_MAX((uintptr_t)elem->dirty_start,
+			(uintptr_t)data);
+	uintptr_t end = RTE_MIN((uintptr_t)elem->dirty_end,
+			(uintptr_t)data + len);
+
+	if (elem_is_dirty(elem) && start < end)
+		memset((void *)start, 0, end - start);
+	elem_set_clean(elem);
+}
+
+size_t
+malloc_elem_scrub(struct malloc_elem *elem, size_t max_bytes)
+{
+	size_t len = RTE_PTR_DIFF(elem->dirty_end, elem->dirty_start);
+
+	if (len == 0)
+		return 0;
+
+	/* clear from the end, so the remaining range stays contiguous */
+	len = RTE_MIN(len, max_bytes);
+	elem->dirty_end = RTE_PTR_SUB(elem->dirty_end, len);
+	memset(elem->dirty_end, 0, len);
+	if (!elem_is_dirty(elem))
+		elem_set_clean(elem);
+
+	return len;
+}
+
 /*
  * split an existing element into two smaller elements at the given
  * split_pt parameter.
@@ -301,6 +403,8 @@ split_elem(struct malloc_elem *elem, struct malloc_elem *split_pt)
 
 	malloc_elem_init(split_pt, elem->heap, elem->msl, new_elem_size,
 			 elem->orig_elem, elem->orig_size);
+	elem_merge_dirty(split_pt, elem);
+	elem_clamp_dirty(split_pt);
 	split_pt->prev = elem;
 	split_pt->next = next_elem;
 	if (next_elem)
@@ -309,6 +413,7 @@ split_elem(struct malloc_elem *elem, struct malloc_elem *split_pt)
 		elem->heap->last = split_pt;
 	elem->next = split_pt;
 	elem->size = old_elem_size;
+	elem_clamp_dirty(elem);
 	set_trailer(elem);
 	if (elem->pad) {
 		/* Update inner padding inner element size. */
@@ -490,6 +595,7 @@ static inline void
 join_elem(struct malloc_elem *elem1, struct malloc_elem *elem2)
 {
 	struct malloc_elem *next = elem2->next;
+	elem_merge_dirty(elem1, elem2);
 	elem1->size += elem2->size;
 	if (next)
 		next->prev = elem1;
@@ -563,11 +669,21 @@ malloc_elem_join_adjacent_free(struct malloc_elem *elem)
 struct malloc_elem *
 malloc_elem_free(struct malloc_elem *elem)
 {
+	const bool lazy = lazy_zero;
 	void *ptr;
 	size_t data_len;
 
 	ptr = RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN);
 	data_len = elem->size - MALLOC_ELEM_OVERHEAD;
+	elem->cache_class = 0;
+
+	if (lazy) {
+		/* leave the data as is, it will be cleared when needed */
+		elem->dirty_start = ptr;
+		elem->dirty_end = RTE_PTR_ADD(ptr, data_len);
+	} else {
+		elem_set_clean(elem);
+	}
 
 	elem = malloc_elem_join_adjacent_free(elem);
 
@@ -579,7 +695,8 @@ malloc_elem_free(struct malloc_elem *elem)
 	elem->heap->alloc_count--;
 
 	/* poison memory */
-	memset(ptr, MALLOC_POISON, data_len);
+	if (!lazy)
+		memset(ptr, MALLOC_POISON, data_len);
 
 	return elem;
 }
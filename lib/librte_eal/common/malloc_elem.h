@@ -32,6 +32,14 @@ struct malloc_elem {
 	size_t size;
 	struct malloc_elem *orig_elem;
 	size_t orig_size;
+	uint32_t cache_class;
+	/**< size class + 1 if elem can be kept in malloc cache, 0 otherwise */
+	uint32_t in_cache;
+	/**< set while the elem has been freed to the malloc cache */
+	void *dirty_start;
+	/**< start of the data of a free elem that may not be zeroed */
+	void *dirty_end;
+	/**< end of the dirty data, equal to dirty_start if elem is all zero */
 #ifdef RTE_MALLOC_DEBUG
 	uint64_t header_cookie;         /* Cookie marking start of data */
 	                                /* trailer cookie at start + size */
@@ -123,6 +131,27 @@ malloc_elem_init(struct malloc_elem *elem,
 void
 malloc_elem_insert(struct malloc_elem *elem);
 
+/*
+ * enable or disable lazy zeroing: when enabled, freed elements are only
+ * marked as dirty instead of being cleared.
+ */
+void
+malloc_elem_set_lazy_zero(bool enable);
+
+/*
+ * zero the part of [data, data + len) that overlaps the dirty range of a
+ * newly allocated element, and forget about the dirty range.
+ */
+void
+malloc_elem_zero_dirty(struct malloc_elem *elem, void *data, size_t len);
+
+/*
+ * zero up to max_bytes of the dirty range of a free element. The heap lock
+ * must be held. Returns the number of bytes that were cleared.
+ */
+size_t
+malloc_elem_scrub(struct malloc_elem *elem, size_t max_bytes);
+
 /*
  * return true if the current malloc_elem can hold a block of data
  * of the requested size and with the requested alignment
@@ -1021,6 +1021,29 @@ malloc_heap_resize(struct malloc_elem *elem, size_t size)
 	return ret;
 }
 
+size_t
+malloc_heap_scrub(struct malloc_heap *heap, size_t max_bytes)
+{
+	struct malloc_elem *elem;
+	size_t done = 0;
+	int idx;
+
+	rte_spinlock_lock(&heap->lock);
+
+	/* start with the largest elements, which are likely the dirtiest */
+	for (idx = RTE_HEAP_NUM_FREELISTS - 1; idx >= 0; idx--) {
+		LIST_FOREACH(elem, &heap->free_head[idx], free_list) {
+			done += malloc_elem_scrub(elem, max_bytes - done);
+			if (done == max_bytes)
+				goto unlock;
+		}
+	}
+unlock:
+	rte_spinlock_unlock(&heap->lock);
+
+	return done;
+}
+
 /*
  * Function to retrieve data for a given heap
  */
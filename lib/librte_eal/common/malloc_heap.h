@@ -87,6 +87,14 @@ malloc_heap_free(struct malloc_elem *elem);
 int
 malloc_heap_resize(struct malloc_elem *elem, size_t size);
 
+/*
+ * Clear up to max_bytes of dirty free memory in the heap. The heap lock is
+ * held while clearing, so max_bytes bounds the latency added to concurrent
+ * allocations. Returns the number of bytes that were cleared.
+ */
+size_t
+malloc_heap_scrub(struct malloc_heap *heap, size_t max_bytes);
+
 int
 malloc_heap_get_stats(struct malloc_heap *heap,
 		struct rte_malloc_socket_stats *socket_stats);
@@ -24,6 +24,7 @@
 #include <rte_eal_trace.h>
 
 #include <rte_malloc.h>
+#include "malloc_cache.h"
 #include "malloc_elem.h"
 #include "malloc_heap.h"
 #include "eal_memalloc.h"
@@ -35,11 +36,22 @@
 static void
 mem_free(void *addr, const bool trace_ena)
 {
+	struct malloc_elem *elem;
+
 	if (trace_ena)
 		rte_eal_trace_mem_free(addr);
 
 	if (addr == NULL) return;
-	if (malloc_heap_free(malloc_elem_from_data(addr)) < 0)
+	elem = malloc_elem_from_data(addr);
+	/* check the element before it can be kept in the malloc cache */
+	if (!malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY ||
+			elem->in_cache) {
+		RTE_LOG(ERR, EAL, "Error: Invalid memory\n");
+		return;
+	}
+	if (malloc_cache_free(elem) == 0)
+		return;
+	if (malloc_heap_free(elem) < 0)
 		RTE_LOG(ERR, EAL, "Error: Invalid memory\n");
 }
 
@@ -57,7 +69,7 @@ eal_free_no_trace(void *addr)
 
 static void *
 malloc_socket(const char *type, size_t size, unsigned int align,
-		int socket_arg, const bool trace_ena)
+		int socket_arg, const bool trace_ena, const bool zero)
 {
 	void *ptr;
 
@@ -74,9 +86,28 @@ malloc_socket(const char *type, size_t size, unsigned int align,
 				!rte_eal_has_hugepages())
 		socket_arg = SOCKET_ID_ANY;
 
+	/* small requests are served by the per-lcore cache, if enabled.
+	 * cached objects are not cleared on free, so zero them here.
+	 */
+	ptr = malloc_cache_alloc(type, size, align, socket_arg);
+	if (ptr != NULL) {
+		if (zero)
+			memset(ptr, 0, size);
+		goto out;
+	}
+
 	ptr = malloc_heap_alloc(type, size, socket_arg, 0,
 			align == 0 ? 1 : align, 0, false);
 
+	/* memory may be held by the object cache, release it and retry */
+	if (ptr == NULL && malloc_cache_reclaim() != 0)
+		ptr = malloc_heap_alloc(type, size, socket_arg, 0,
+				align == 0 ? 1 : align, 0, false);
+
+	/* memory freed with lazy zeroing enabled may not be cleared yet */
+	if (ptr != NULL && zero)
+		malloc_elem_zero_dirty(malloc_elem_from_data(ptr), ptr, size);
+out:
 	if (trace_ena)
 		rte_eal_trace_mem_malloc(type, size, align, socket_arg, ptr);
 	return ptr;
@@ -89,13 +120,13 @@ void *
 rte_malloc_socket(const char *type, size_t size, unsigned int align,
 		int socket_arg)
 {
-	return malloc_socket(type, size, align, socket_arg, true);
+	return malloc_socket(type, size, align, socket_arg, true, false);
 }
 
 void *
 eal_malloc_no_trace(const char *type, size_t size, unsigned int align)
 {
-	return malloc_socket(type, size, align, SOCKET_ID_ANY, false);
+	return malloc_socket(type, size, align, SOCKET_ID_ANY, false, false);
 }
 
 /*
@@ -113,13 +144,14 @@ rte_malloc(const char *type, size_t size, unsigned align)
 void *
 rte_zmalloc_socket(const char *type, size_t size, unsigned align, int socket)
 {
-	void *ptr = rte_malloc_socket(type, size, align, socket);
+	void *ptr = malloc_socket(type, size, align, socket, true, true);
 
 #ifdef RTE_MALLOC_DEBUG
 	/*
 	 * If DEBUG is enabled, then freed memory is marked with poison
 	 * value and set to zero on allocation.
-	 * If DEBUG is not enabled then  memory is already zeroed.
+	 * If DEBUG is not enabled then memory is already zeroed, or its dirty
+	 * part was cleared by malloc_socket().
 	 */
 	if (ptr != NULL)
 		memset(ptr, 0, size);
@@ -180,6 +212,8 @@ rte_realloc_socket(void *ptr, size_t size, unsigned int align, int socket)
 	     (unsigned int)socket == elem->heap->socket_id) &&
 			RTE_PTR_ALIGN(ptr, align) == ptr &&
 			malloc_heap_resize(elem, size) == 0) {
+		/* element no longer matches its cache size class */
+		elem->cache_class = 0;
 		rte_eal_trace_mem_realloc(size, align, socket, ptr);
 		return ptr;
 	}
@@ -209,6 +243,67 @@ rte_realloc(void *ptr, size_t size, unsigned int align)
 	return rte_realloc_socket(ptr, size, align, SOCKET_ID_ANY);
 }
 
+int
+rte_malloc_cache_enable(void)
+{
+	return malloc_cache_enable();
+}
+
+int
+rte_malloc_cache_disable(void)
+{
+	return malloc_cache_disable();
+}
+
+void
+rte_malloc_cache_flush(void)
+{
+	malloc_cache_flush();
+}
+
+int
+rte_malloc_lazy_zero_enable(void)
+{
+#ifdef RTE_MALLOC_DEBUG
+	/* freed memory must always be poisoned in debug mode */
+	rte_errno = ENOTSUP;
+	return -1;
+#else
+	malloc_elem_set_lazy_zero(true);
+	return 0;
+#endif
+}
+
+int
+rte_malloc_lazy_zero_disable(void)
+{
+	malloc_elem_set_lazy_zero(false);
+	return 0;
+}
+
+size_t
+rte_malloc_heap_scrub(int socket, size_t max_bytes)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	unsigned int idx;
+	size_t done = 0;
+	int heap_idx;
+
+	if (socket != SOCKET_ID_ANY) {
+		heap_idx = malloc_socket_to_heap_id(socket);
+		if (heap_idx < 0)
+			return 0;
+		return malloc_heap_scrub(&mcfg->malloc_heaps[heap_idx],
+				max_bytes);
+	}
+
+	for (idx = 0; idx < RTE_MAX_HEAPS && done < max_bytes; idx++)
+		done += malloc_heap_scrub(&mcfg->malloc_heaps[idx],
+				max_bytes - done);
+
+	return done;
+}
+
 int
 rte_malloc_validate(const void *ptr, size_t *size)
 {
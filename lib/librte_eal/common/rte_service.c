@@ -7,6 +7,8 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
 
 #include <rte_compat.h>
 #include <rte_service.h>
@@ -21,10 +23,17 @@
 #include <rte_memory.h>
 #include <rte_malloc.h>
 #include <rte_spinlock.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <rte_telemetry.h>
+#endif
 
 #include "eal_private.h"
 
-#define RTE_SERVICE_NUM_MAX 64
+/* number of 64-bit words of a bitmap of services */
+#define SERVICE_MASK_WORDS ((RTE_SERVICE_NUM_MAX + 63) / 64)
+
+/* log2 buckets of the histograms, the last one counting the larger values */
+#define SERVICE_HIST_BUCKETS 32
 
 #define SERVICE_F_REGISTERED    (1 << 0)
 #define SERVICE_F_STATS_ENABLED (1 << 1)
@@ -58,18 +67,31 @@ struct rte_service_spec_impl {
 	uint32_t num_mapped_cores;
 	uint64_t calls;
 	uint64_t cycles_spent;
+	uint64_t idle_calls;
+
+	/* scheduling parameters */
+	uint32_t weight; /* max calls per round of a service core */
+	uint32_t idle_skip_max; /* max rounds skipped while idle, 0 disables */
+	uint64_t cycle_budget; /* max cycles per round, 0 for no limit */
+
+	/* log2 histograms of the cycles per call and calls per round */
+	uint64_t cycles_hist[SERVICE_HIST_BUCKETS];
+	uint64_t calls_hist[SERVICE_HIST_BUCKETS];
 } __rte_cache_aligned;
 
 /* the internal values of a service core */
 struct core_state {
 	/* map of services IDs are run on this core */
-	uint64_t service_mask;
+	uint64_t service_mask[SERVICE_MASK_WORDS];
 	uint8_t runstate; /* running or stopped */
 	uint8_t thread_active; /* indicates when thread is in service_run() */
 	uint8_t is_service_core; /* set if core is currently a service core */
 	uint8_t service_active_on_lcore[RTE_SERVICE_NUM_MAX];
 	uint64_t loops;
 	uint64_t calls_per_service[RTE_SERVICE_NUM_MAX];
+	/* rounds left to skip and current backoff of idle services */
+	uint16_t idle_skip[RTE_SERVICE_NUM_MAX];
+	uint16_t idle_backoff[RTE_SERVICE_NUM_MAX];
 } __rte_cache_aligned;
 
 static uint32_t rte_service_count;
@@ -137,6 +159,27 @@ rte_service_finalize(void)
 	rte_service_library_initialized = 0;
 }
 
+static inline int
+service_mask_test(const uint64_t *mask, uint32_t id)
+{
+	return !!(__atomic_load_n(&mask[id / 64], __ATOMIC_RELAXED) &
+		  (UINT64_C(1) << (id % 64)));
+}
+
+static inline void
+service_mask_set(uint64_t *mask, uint32_t id)
+{
+	__atomic_fetch_or(&mask[id / 64], UINT64_C(1) << (id % 64),
+			  __ATOMIC_RELAXED);
+}
+
+static inline void
+service_mask_clear(uint64_t *mask, uint32_t id)
+{
+	__atomic_fetch_and(&mask[id / 64], ~(UINT64_C(1) << (id % 64)),
+			   __ATOMIC_RELAXED);
+}
+
 /* returns 1 if service is registered and has not been unregistered
  * Returns 0 if service never registered, or has been unregistered
  */
@@ -264,6 +307,7 @@ rte_service_component_register(const struct rte_service_spec *spec,
 
 	struct rte_service_spec_impl *s = &rte_services[free_slot];
 	s->spec = *spec;
+	s->weight = 1;
 	s->internal_flags |= SERVICE_F_REGISTERED | SERVICE_F_START_CHECK;
 
 	rte_service_count++;
@@ -285,9 +329,12 @@ rte_service_component_unregister(uint32_t id)
 
 	s->internal_flags &= ~(SERVICE_F_REGISTERED);
 
-	/* clear the run-bit in all cores */
-	for (i = 0; i < RTE_MAX_LCORE; i++)
-		lcore_states[i].service_mask &= ~(UINT64_C(1) << id);
+	/* clear the run-bit and the idle state in all cores */
+	for (i = 0; i < RTE_MAX_LCORE; i++) {
+		service_mask_clear(lcore_states[i].service_mask, id);
+		lcore_states[i].idle_skip[id] = 0;
+		lcore_states[i].idle_backoff[id] = 0;
+	}
 
 	memset(&rte_services[id], 0, sizeof(struct rte_service_spec_impl));
 
@@ -359,28 +406,76 @@ rte_service_runstate_get(uint32_t id)
 
 }
 
+/* histogram bucket of a value: 0 for 0, n for [2^(n-1), 2^n) */
+static inline uint32_t
+service_hist_bucket(uint64_t v)
+{
+	return RTE_MIN(rte_fls_u64(v), SERVICE_HIST_BUCKETS - 1);
+}
+
+/* Call the service up to max_calls times, stopping when it reports it has
+ * no work to do (-EAGAIN) or when the round exceeds its cycle budget.
+ */
 static inline void
 service_runner_do_callback(struct rte_service_spec_impl *s,
-			   struct core_state *cs, uint32_t service_idx)
+			   struct core_state *cs, uint32_t service_idx,
+			   uint32_t max_calls)
 {
 	void *userdata = s->spec.callback_userdata;
+	const uint64_t budget = s->cycle_budget;
+	uint32_t calls = 0;
+	int32_t ret;
 
-	if (service_stats_enabled(s)) {
+	if (service_stats_enabled(s) || budget != 0) {
+		const int stats = service_stats_enabled(s);
 		uint64_t start = rte_rdtsc();
-		s->spec.callback(userdata);
-		uint64_t end = rte_rdtsc();
-		s->cycles_spent += end - start;
-		cs->calls_per_service[service_idx]++;
-		s->calls++;
+		uint64_t prev = start, now;
+
+		do {
+			ret = s->spec.callback(userdata);
+			now = rte_rdtsc();
+			calls++;
+			if (stats) {
+				s->cycles_hist[service_hist_bucket(now -
+								   prev)]++;
+				s->idle_calls += (ret == -EAGAIN);
+			}
+			prev = now;
+		} while (ret != -EAGAIN && calls < max_calls &&
+			 (budget == 0 || now - start < budget));
+
+		if (stats) {
+			s->cycles_spent += now - start;
+			cs->calls_per_service[service_idx] += calls;
+			s->calls += calls;
+			s->calls_hist[service_hist_bucket(calls)]++;
+		}
+	} else {
+		do {
+			ret = s->spec.callback(userdata);
+		} while (ret != -EAGAIN && ++calls < max_calls);
+	}
+
+	/* back off exponentially while the service has no work at all */
+	if (unlikely(ret == -EAGAIN && calls == 1 && s->idle_skip_max != 0)) {
+		uint32_t backoff = cs->idle_backoff[service_idx] * 2;
+
+		if (backoff == 0)
+			backoff = 1;
+		if (backoff > s->idle_skip_max)
+			backoff = s->idle_skip_max;
+		cs->idle_backoff[service_idx] = backoff;
+		cs->idle_skip[service_idx] = backoff;
 	} else
-		s->spec.callback(userdata);
+		cs->idle_backoff[service_idx] = 0;
 }
 
 
 /* Expects the service 's' is valid. */
 static int32_t
-service_run(uint32_t i, struct core_state *cs, uint64_t service_mask,
-	    struct rte_service_spec_impl *s, uint32_t serialize_mt_unsafe)
+service_run(uint32_t i, struct core_state *cs, int mapped,
+	    struct rte_service_spec_impl *s, uint32_t serialize_mt_unsafe,
+	    uint32_t max_calls)
 {
 	if (!s)
 		return -EINVAL;
@@ -393,21 +488,27 @@ service_run(uint32_t i, struct core_state *cs, uint64_t service_mask,
 			RUNSTATE_RUNNING ||
 	    __atomic_load_n(&s->app_runstate, __ATOMIC_ACQUIRE) !=
 			RUNSTATE_RUNNING ||
-	    !(service_mask & (UINT64_C(1) << i))) {
+	    !mapped) {
 		cs->service_active_on_lcore[i] = 0;
 		return -ENOEXEC;
 	}
 
 	cs->service_active_on_lcore[i] = 1;
 
+	/* the service reported it had no work, skip it for a few rounds */
+	if (unlikely(cs->idle_skip[i] != 0)) {
+		cs->idle_skip[i]--;
+		return 0;
+	}
+
 	if ((service_mt_safe(s) == 0) && (serialize_mt_unsafe == 1)) {
 		if (!rte_spinlock_trylock(&s->execute_lock))
 			return -EBUSY;
 
-		service_runner_do_callback(s, cs, i);
+		service_runner_do_callback(s, cs, i, max_calls);
 		rte_spinlock_unlock(&s->execute_lock);
 	} else
-		service_runner_do_callback(s, cs, i);
+		service_runner_do_callback(s, cs, i, max_calls);
 
 	return 0;
 }
@@ -443,7 +544,7 @@ rte_service_run_iter_on_app_lcore(uint32_t id, uint32_t serialize_mt_unsafe)
 	 */
 	__atomic_add_fetch(&s->num_mapped_cores, 1, __ATOMIC_RELAXED);
 
-	int ret = service_run(id, cs, UINT64_MAX, s, serialize_mt_unsafe);
+	int ret = service_run(id, cs, 1, s, serialize_mt_unsafe, 1);
 
 	__atomic_sub_fetch(&s->num_mapped_cores, 1, __ATOMIC_RELAXED);
 
@@ -454,9 +555,17 @@ static int32_t
 service_runner_func(void *arg)
 {
 	RTE_SET_USED(arg);
-	uint32_t i;
+	uint32_t i, w;
+	uint64_t mask, unmapped;
 	const int lcore = rte_lcore_id();
 	struct core_state *cs = &lcore_states[lcore];
+	struct rte_service_spec_impl *s;
+	/* services mapped in the previous round, all at start so that the
+	 * services not mapped anymore are marked as not active
+	 */
+	uint64_t prev_mask[SERVICE_MASK_WORDS];
+
+	memset(prev_mask, 0xff, sizeof(prev_mask));
 
 	__atomic_store_n(&cs->thread_active, 1, __ATOMIC_SEQ_CST);
 
@@ -466,13 +575,29 @@ service_runner_func(void *arg)
 	 */
 	while (__atomic_load_n(&cs->runstate, __ATOMIC_ACQUIRE) ==
 			RUNSTATE_RUNNING) {
-		const uint64_t service_mask = cs->service_mask;
-
-		for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
-			if (!service_valid(i))
-				continue;
-			/* return value ignored as no change to code flow */
-			service_run(i, cs, service_mask, service_get(i), 1);
+		for (w = 0; w < SERVICE_MASK_WORDS; w++) {
+			mask = __atomic_load_n(&cs->service_mask[w],
+					       __ATOMIC_RELAXED);
+
+			for (unmapped = prev_mask[w] & ~mask; unmapped != 0;
+			     unmapped &= unmapped - 1) {
+				i = w * 64 + __builtin_ctzll(unmapped);
+				if (i < RTE_SERVICE_NUM_MAX)
+					cs->service_active_on_lcore[i] = 0;
+			}
+			prev_mask[w] = mask;
+
+			/* only walk the services mapped to this core */
+			for (; mask != 0; mask &= mask - 1) {
+				i = w * 64 + __builtin_ctzll(mask);
+				if (!service_valid(i))
+					continue;
+				s = service_get(i);
+				/* return value ignored as no change to
+				 * code flow
+				 */
+				service_run(i, cs, 1, s, 1, s->weight);
+			}
 		}
 
 		cs->loops++;
@@ -542,7 +667,12 @@ rte_service_lcore_count_services(uint32_t lcore)
 	if (!cs->is_service_core)
 		return -ENOTSUP;
 
-	return __builtin_popcountll(cs->service_mask);
+	uint32_t w;
+	int32_t count = 0;
+	for (w = 0; w < SERVICE_MASK_WORDS; w++)
+		count += __builtin_popcountll(cs->service_mask[w]);
+
+	return count;
 }
 
 int32_t
@@ -595,25 +725,24 @@ service_update(uint32_t sid, uint32_t lcore, uint32_t *set, uint32_t *enabled)
 	    lcore >= RTE_MAX_LCORE || !lcore_states[lcore].is_service_core)
 		return -EINVAL;
 
-	uint64_t sid_mask = UINT64_C(1) << sid;
+	uint64_t *service_mask = lcore_states[lcore].service_mask;
 	if (set) {
-		uint64_t lcore_mapped = lcore_states[lcore].service_mask &
-			sid_mask;
+		int lcore_mapped = service_mask_test(service_mask, sid);
 
 		if (*set && !lcore_mapped) {
-			lcore_states[lcore].service_mask |= sid_mask;
+			service_mask_set(service_mask, sid);
 			__atomic_add_fetch(&rte_services[sid].num_mapped_cores,
 				1, __ATOMIC_RELAXED);
 		}
 		if (!*set && lcore_mapped) {
-			lcore_states[lcore].service_mask &= ~(sid_mask);
+			service_mask_clear(service_mask, sid);
 			__atomic_sub_fetch(&rte_services[sid].num_mapped_cores,
 				1, __ATOMIC_RELAXED);
 		}
 	}
 
 	if (enabled)
-		*enabled = !!(lcore_states[lcore].service_mask & (sid_mask));
+		*enabled = service_mask_test(service_mask, sid);
 
 	return 0;
 }
@@ -656,7 +785,8 @@ rte_service_lcore_reset_all(void)
 	uint32_t i;
 	for (i = 0; i < RTE_MAX_LCORE; i++) {
 		if (lcore_states[i].is_service_core) {
-			lcore_states[i].service_mask = 0;
+			memset(lcore_states[i].service_mask, 0,
+			       sizeof(lcore_states[i].service_mask));
 			set_lcore_state(i, ROLE_RTE);
 			/* runstate act as guard variable Use
 			 * store-release memory order here to synchronize
@@ -684,7 +814,8 @@ rte_service_lcore_add(uint32_t lcore)
 	set_lcore_state(lcore, ROLE_SERVICE);
 
 	/* ensure that after adding a core the mask and state are defaults */
-	lcore_states[lcore].service_mask = 0;
+	memset(lcore_states[lcore].service_mask, 0,
+	       sizeof(lcore_states[lcore].service_mask));
 	/* Use store-release memory order here to synchronize with
 	 * load-acquire in runstate read functions.
 	 */
@@ -764,9 +895,9 @@ rte_service_lcore_stop(uint32_t lcore)
 		return -EALREADY;
 
 	uint32_t i;
-	uint64_t service_mask = lcore_states[lcore].service_mask;
+	const uint64_t *service_mask = lcore_states[lcore].service_mask;
 	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
-		int32_t enabled = service_mask & (UINT64_C(1) << i);
+		int32_t enabled = service_mask_test(service_mask, i);
 		int32_t service_running = rte_service_runstate_get(i);
 		int32_t only_core = (1 ==
 			__atomic_load_n(&rte_services[i].num_mapped_cores,
@@ -805,6 +936,9 @@ rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 	case RTE_SERVICE_ATTR_CALL_COUNT:
 		*attr_value = s->calls;
 		return 0;
+	case RTE_SERVICE_ATTR_IDLE_CALL_COUNT:
+		*attr_value = s->idle_calls;
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -840,6 +974,45 @@ rte_service_attr_reset_all(uint32_t id)
 
 	s->cycles_spent = 0;
 	s->calls = 0;
+	s->idle_calls = 0;
+	memset(s->cycles_hist, 0, sizeof(s->cycles_hist));
+	memset(s->calls_hist, 0, sizeof(s->calls_hist));
+	return 0;
+}
+
+int32_t
+rte_service_set_weight(uint32_t id, uint32_t weight)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (weight == 0)
+		return -EINVAL;
+
+	s->weight = weight;
+	return 0;
+}
+
+int32_t
+rte_service_set_cycle_budget(uint32_t id, uint64_t cycles)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	s->cycle_budget = cycles;
+	return 0;
+}
+
+int32_t
+rte_service_set_idle_skip_max(uint32_t id, uint32_t rounds)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (rounds > UINT16_MAX)
+		return -EINVAL;
+
+	s->idle_skip_max = rounds;
 	return 0;
 }
 
@@ -922,3 +1095,89 @@ rte_service_dump(FILE *f, uint32_t id)
 
 	return 0;
 }
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+static int
+service_handle_list(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	uint32_t i;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	if (!rte_service_library_initialized)
+		return 0;
+
+	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++)
+		if (service_valid(i))
+			rte_tel_data_add_array_int(d, i);
+	return 0;
+}
+
+static struct rte_tel_data *
+service_tel_hist(const uint64_t *hist)
+{
+	struct rte_tel_data *h = rte_tel_data_alloc();
+	uint32_t i;
+
+	if (h == NULL)
+		return NULL;
+
+	rte_tel_data_start_array(h, RTE_TEL_U64_VAL);
+	for (i = 0; i < SERVICE_HIST_BUCKETS; i++)
+		rte_tel_data_add_array_u64(h, hist[i]);
+	return h;
+}
+
+static int
+service_handle_stats(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_service_spec_impl *s;
+	struct rte_tel_data *cycles_hist, *calls_hist;
+	unsigned long id;
+	char *end_param;
+
+	if (!rte_service_library_initialized || params == NULL ||
+	    !isdigit(*params))
+		return -1;
+
+	id = strtoul(params, &end_param, 0);
+	if (*end_param != '\0')
+		RTE_LOG(NOTICE, EAL,
+			"Extra parameters passed to service telemetry command, ignoring\n");
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -1);
+
+	cycles_hist = service_tel_hist(s->cycles_hist);
+	calls_hist = service_tel_hist(s->calls_hist);
+	if (cycles_hist == NULL || calls_hist == NULL) {
+		rte_tel_data_free(cycles_hist);
+		rte_tel_data_free(calls_hist);
+		return -1;
+	}
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", s->spec.name);
+	rte_tel_data_add_dict_int(d, "stats_enabled", service_stats_enabled(s));
+	rte_tel_data_add_dict_u64(d, "weight", s->weight);
+	rte_tel_data_add_dict_u64(d, "cycle_budget", s->cycle_budget);
+	rte_tel_data_add_dict_u64(d, "idle_skip_max", s->idle_skip_max);
+	rte_tel_data_add_dict_u64(d, "calls", s->calls);
+	rte_tel_data_add_dict_u64(d, "idle_calls", s->idle_calls);
+	rte_tel_data_add_dict_u64(d, "cycles", s->cycles_spent);
+	rte_tel_data_add_dict_container(d, "cycles_per_call_log2_hist",
+			cycles_hist, 0);
+	rte_tel_data_add_dict_container(d, "calls_per_round_log2_hist",
+			calls_hist, 0);
+	return 0;
+}
+
+RTE_INIT(service_init_telemetry)
+{
+	rte_telemetry_register_cmd("/eal/service_list", service_handle_list,
+			"Returns list of registered service IDs. Takes no parameters");
+	rte_telemetry_register_cmd("/eal/service_stats", service_handle_stats,
+			"Returns the stats and histograms of a service. Parameters: int service_id");
+}
+#endif
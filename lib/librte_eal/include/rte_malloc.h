@@ -262,6 +262,118 @@ rte_calloc_socket(const char *type, size_t num, size_t size, unsigned align, int
 void
 rte_free(void *ptr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable the per-lcore object cache of the malloc heaps.
+ *
+ * While the cache is enabled, rte_malloc(), rte_zmalloc() and rte_calloc()
+ * requests of up to 4 KB with an alignment of at most one cache line, made
+ * on the socket of the calling lcore, are rounded up to a power of two and
+ * served from a per-lcore cache without taking the heap lock. Freed objects
+ * are kept in the cache of the freeing lcore, overflowing into a per-socket
+ * cache which is also used by threads without a lcore id.
+ *
+ * Cached objects are accounted as allocated in the heap statistics. The
+ * cache of a lcore is flushed to the heap when the lcore is released.
+ *
+ * The cache is local to the calling process.
+ *
+ * @return
+ *   0 on success, -1 on error with rte_errno set.
+ */
+__rte_experimental
+int
+rte_malloc_cache_enable(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Disable the per-lcore object cache and return all cached objects to the
+ * malloc heaps.
+ *
+ * This function is not thread-safe with regard to allocations made on other
+ * lcores: it must be called while no other lcore uses the malloc API.
+ *
+ * @return
+ *   0 on success.
+ */
+__rte_experimental
+int
+rte_malloc_cache_disable(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Return the objects held in the object cache of the calling lcore to the
+ * malloc heaps.
+ */
+__rte_experimental
+void
+rte_malloc_cache_flush(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable lazy zeroing of freed memory.
+ *
+ * By default, memory is cleared when it is freed, so that rte_zmalloc() and
+ * rte_memzone_reserve() do not have to clear it again. This makes freeing
+ * large blocks as slow as writing them. With lazy zeroing, rte_free() only
+ * records the freed range as dirty in the heap metadata, and the dirty part
+ * of a block is cleared when it is allocated again through rte_zmalloc(),
+ * rte_calloc() or rte_memzone_reserve(). Dirty memory can also be cleared in
+ * the background with rte_malloc_heap_scrub().
+ *
+ * The setting is local to the calling process.
+ *
+ * @return
+ *   0 on success, -1 on error with rte_errno set to ENOTSUP if malloc debug
+ *   is enabled.
+ */
+__rte_experimental
+int
+rte_malloc_lazy_zero_enable(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Disable lazy zeroing of freed memory. Memory freed before this call stays
+ * dirty until it is allocated again or scrubbed.
+ *
+ * @return
+ *   0 on success.
+ */
+__rte_experimental
+int
+rte_malloc_lazy_zero_disable(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Clear free memory left dirty by lazy zeroing.
+ *
+ * This function is meant to be called periodically from a service core or
+ * from a background lcore. The heap lock is held while memory is cleared,
+ * so max_bytes bounds the latency added to concurrent allocations.
+ *
+ * @param socket
+ *   Socket of the heap to scrub, or SOCKET_ID_ANY to scrub all heaps.
+ * @param max_bytes
+ *   Maximum number of bytes to clear.
+ * @return
+ *   Number of bytes cleared, 0 if there is no dirty free memory left.
+ */
+__rte_experimental
+size_t
+rte_malloc_heap_scrub(int socket, size_t max_bytes);
+
 /**
  * If malloc debug is enabled, check a memory block for header
  * and trailer markers to indicate that all is well with the block.
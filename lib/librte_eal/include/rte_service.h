@@ -387,6 +387,12 @@ int32_t rte_service_dump(FILE *f, uint32_t id);
  */
 #define RTE_SERVICE_ATTR_CALL_COUNT 1
 
+/**
+ * Returns the count of invocations of this service function which reported
+ * there was no work to do, by returning -EAGAIN
+ */
+#define RTE_SERVICE_ATTR_IDLE_CALL_COUNT 2
+
 /**
  * Get an attribute from a service.
  *
@@ -405,6 +411,57 @@ int32_t rte_service_attr_get(uint32_t id, uint32_t attr_id,
  */
 int32_t rte_service_attr_reset_all(uint32_t id);
 
+/**
+ * Set the weight of a service.
+ *
+ * In each round of a service core over its mapped services, the service is
+ * called up to *weight* times in a row, so that the busiest services get more
+ * cycles than the others. The calls stop earlier if the service returns
+ * -EAGAIN, or if the round exceeded the cycle budget of the service. The
+ * default weight is 1.
+ *
+ * @param id The service to set the weight of
+ * @param weight The maximum number of calls per round, at least 1
+ * @retval 0 Success
+ *         -EINVAL Invalid service id or weight
+ */
+__rte_experimental
+int32_t rte_service_set_weight(uint32_t id, uint32_t weight);
+
+/**
+ * Set the cycle budget of a service.
+ *
+ * A service core stops calling the service in a round once the calls of this
+ * round consumed *cycles* TSC cycles, even if the service weight allows more
+ * calls. The last call is not interrupted, so the budget can be exceeded by
+ * the duration of one call.
+ *
+ * @param id The service to set the cycle budget of
+ * @param cycles The number of cycles per round, 0 for no limit (default)
+ * @retval 0 Success
+ *         -EINVAL Invalid service id
+ */
+__rte_experimental
+int32_t rte_service_set_cycle_budget(uint32_t id, uint64_t cycles);
+
+/**
+ * Set the maximum number of rounds a service is skipped while idle.
+ *
+ * When the first call of a round returns -EAGAIN, meaning the service had no
+ * work to do, a service core skips the service in its next round. The number
+ * of rounds skipped doubles each time the service is found idle again, up to
+ * *rounds*, and is reset once the service does some work. Each service core
+ * tracks this separately.
+ *
+ * @param id The service to set the maximum number of skipped rounds of
+ * @param rounds The maximum number of rounds skipped, up to UINT16_MAX. 0
+ *        disables skipping (default).
+ * @retval 0 Success
+ *         -EINVAL Invalid service id or number of rounds
+ */
+__rte_experimental
+int32_t rte_service_set_idle_skip_max(uint32_t id, uint32_t rounds);
+
 /**
  * Returns the number of times the service runner has looped.
  */
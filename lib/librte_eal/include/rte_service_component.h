@@ -19,6 +19,9 @@ extern "C" {
 
 /**
  * Signature of callback function to run a service.
+ *
+ * The callback returns -EAGAIN if the service had no work to do, which lets
+ * the service cores skip it while idle, see rte_service_set_idle_skip_max().
  */
 typedef int32_t (*rte_service_func)(void *args);
 
@@ -17,6 +17,7 @@ extern "C" {
 
 #include <sys/queue.h>
 #include <stdio.h>
+#include <rte_compat.h>
 #include <rte_debug.h>
 
 /** dummy structure type used by the rte_tailq APIs */
@@ -118,6 +119,71 @@ struct rte_tailq_head *rte_eal_tailq_lookup(const char *name);
  */
 int rte_eal_tailq_register(struct rte_tailq_elem *t);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add an entry of a tail queue to the name index of the tail queue.
+ *
+ * Each tail queue has a hash index in shared memory, mapping object names to
+ * tail queue entries, so that objects can be looked up by name in constant
+ * time from any process. Libraries keeping named objects in a tail queue
+ * should add them to the index when inserting them in the tail queue.
+ * The caller must hold the tailq write lock.
+ *
+ * @param head
+ *   The tail queue head, as set in the registered tailq element.
+ * @param name
+ *   The name of the object, shorter than 64 bytes.
+ * @param te
+ *   The tail queue entry of the object.
+ * @return
+ *   0 on success, -1 on error with rte_errno set:
+ *    - EINVAL - invalid tail queue head
+ *    - EEXIST - the name is already indexed
+ *    - ENAMETOOLONG - the name is too long
+ *    - ENOMEM - no memory to grow the index
+ */
+__rte_experimental
+int rte_eal_tailq_index_add(struct rte_tailq_head *head, const char *name,
+		struct rte_tailq_entry *te);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Remove an object from the name index of a tail queue.
+ * The caller must hold the tailq write lock.
+ *
+ * @param head
+ *   The tail queue head, as set in the registered tailq element.
+ * @param name
+ *   The name of the object.
+ * @return
+ *   The tail queue entry the name was mapped to, NULL if it was not indexed.
+ */
+__rte_experimental
+struct rte_tailq_entry *rte_eal_tailq_index_del(struct rte_tailq_head *head,
+		const char *name);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Look up an object by name in the name index of a tail queue.
+ * The caller must hold the tailq read lock.
+ *
+ * @param head
+ *   The tail queue head, as set in the registered tailq element.
+ * @param name
+ *   The name of the object.
+ * @return
+ *   The tail queue entry of the object, NULL if not found.
+ */
+__rte_experimental
+struct rte_tailq_entry *rte_eal_tailq_index_lookup(struct rte_tailq_head *head,
+		const char *name);
+
 #define EAL_REGISTER_TAILQ(t) \
 RTE_INIT(tailqinitfn_ ##t) \
 { \
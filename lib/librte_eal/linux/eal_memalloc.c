@@ -22,6 +22,8 @@
 #include <sys/time.h>
 #include <signal.h>
 #include <setjmp.h>
+#include <time.h>
+#include <pthread.h>
 #ifdef F_ADD_SEALS /* if file sealing is supported, so is memfd */
 #include <linux/memfd.h>
 #define MEMFD_SUPPORTED
@@ -38,7 +40,9 @@
 #include <rte_eal.h>
 #include <rte_errno.h>
 #include <rte_memory.h>
+#include <rte_per_lcore.h>
 #include <rte_spinlock.h>
+#include <rte_time.h>
 
 #include "eal_filesystem.h"
 #include "eal_internal_cfg.h"
@@ -105,11 +109,12 @@ static struct {
 /** local copy of a memory map, used to synchronize memory hotplug in MP */
 static struct rte_memseg_list local_memsegs[RTE_MAX_MEMSEG_LISTS];
 
-static sigjmp_buf huge_jmpenv;
+/* per-thread, as pages may be allocated by several threads at init */
+static RTE_DEFINE_PER_LCORE(sigjmp_buf, huge_jmpenv);
 
 static void __rte_unused huge_sigbus_handler(int signo __rte_unused)
 {
-	siglongjmp(huge_jmpenv, 1);
+	siglongjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 /* Put setjmp into a wrap method to avoid compiling error. Any non-volatile,
@@ -118,7 +123,7 @@ static void __rte_unused huge_sigbus_handler(int signo __rte_unused)
  */
 static int __rte_unused huge_wrap_sigsetjmp(void)
 {
-	return sigsetjmp(huge_jmpenv, 1);
+	return sigsetjmp(RTE_PER_LCORE(huge_jmpenv), 1);
 }
 
 static struct sigaction huge_action_old;
@@ -195,6 +200,37 @@ restore_numa(int *oldpolicy, struct bitmask *oldmask)
 }
 #endif
 
+/*
+ * time spent in each phase of segment allocation, reported at init.
+ */
+struct alloc_seg_stats {
+	uint64_t fd_ns; /**< getting the page file and sizing it */
+	uint64_t map_ns; /**< mapping and populating the page */
+	uint64_t fault_ns; /**< faulting in the page */
+	uint64_t iova_ns; /**< looking up the page IOVA */
+};
+
+#define NSEC_PER_MSEC (NSEC_PER_SEC / 1000)
+
+static inline uint64_t
+get_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return rte_timespec_to_ns(&ts);
+}
+
+/* add time elapsed since *ts to *acc, and restart the measurement */
+static inline void
+stats_add(uint64_t *acc, uint64_t *ts)
+{
+	uint64_t now = get_time_ns();
+
+	*acc += now - *ts;
+	*ts = now;
+}
+
 /*
  * uses fstat to report the size of a file on disk
  */
@@ -494,12 +530,12 @@ resize_hugefile(int fd, uint64_t fa_offset, uint64_t page_sz, bool grow)
 static int
 alloc_seg(struct rte_memseg *ms, void *addr, int socket_id,
 		struct hugepage_info *hi, unsigned int list_idx,
-		unsigned int seg_idx)
+		unsigned int seg_idx, struct alloc_seg_stats *stats)
 {
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
 	int cur_socket_id = 0;
 #endif
-	uint64_t map_offset;
+	uint64_t map_offset, ts;
 	rte_iova_t iova;
 	void *va;
 	char path[PATH_MAX];
@@ -512,6 +548,7 @@ alloc_seg(struct rte_memseg *ms, void *addr, int socket_id,
 		eal_get_internal_configuration();
 
 	alloc_sz = hi->hugepage_sz;
+	ts = get_time_ns();
 
 	/* these are checked at init, but code analyzers don't know that */
 	if (internal_conf->in_memory && !anonymous_hugepages_supported) {
@@ -575,6 +612,7 @@ alloc_seg(struct rte_memseg *ms, void *addr, int socket_id,
 		}
 		mmap_flags = MAP_SHARED | MAP_POPULATE | MAP_FIXED;
 	}
+	stats_add(&stats->fd_ns, &ts);
 
 	/*
 	 * map the segment, and populate page tables, the kernel fills
@@ -596,6 +634,7 @@ alloc_seg(struct rte_memseg *ms, void *addr, int socket_id,
 		munmap(va, alloc_sz);
 		goto resized;
 	}
+	stats_add(&stats->map_ns, &ts);
 
 	/* In linux, hugetlb limitations, like cgroup, are
 	 * enforced at fault time instead of mmap(), even
@@ -616,6 +655,7 @@ alloc_seg(struct rte_memseg *ms, void *addr, int socket_id,
 	 * kernel populates the page with zeroes initially.
 	 */
 	*(volatile int *)addr = *(volatile int *)addr;
+	stats_add(&stats->fault_ns, &ts);
 
 	iova = rte_mem_virt2iova(addr);
 	if (iova == RTE_BAD_PHYS_ADDR) {
@@ -623,6 +663,7 @@ alloc_seg(struct rte_memseg *ms, void *addr, int socket_id,
 			__func__);
 		goto mapped;
 	}
+	stats_add(&stats->iova_ns, &ts);
 
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
 	/*
@@ -777,7 +818,117 @@ struct alloc_walk_param {
 	unsigned int n_segs;
 	int socket;
 	bool exact;
+	struct alloc_seg_stats stats;
+};
+
+/* a range of segments of one memseg list allocated by a thread */
+struct alloc_thread_param {
+	pthread_t tid;
+	struct alloc_walk_param *wa;
+	struct rte_memseg_list *msl;
+	unsigned int msl_idx;
+	unsigned int start_idx; /**< first segment of the whole request */
+	unsigned int first; /**< first segment of this thread */
+	unsigned int last; /**< last segment of this thread, excluded */
+	int *seg_ret; /**< alloc_seg() results, indexed from start_idx */
+	struct alloc_seg_stats stats;
 };
+
+static void *
+alloc_seg_thread(void *arg)
+{
+	struct alloc_thread_param *p = arg;
+	struct alloc_walk_param *wa = p->wa;
+	size_t page_sz = (size_t)p->msl->page_sz;
+	unsigned int idx;
+
+#ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
+	/* memory policy and affinity are per-thread, so set them up again */
+	if (check_numa()) {
+		if (numa_run_on_node(wa->socket) < 0)
+			RTE_LOG(DEBUG, EAL, "%s(): cannot run on node %d: %s\n",
+				__func__, wa->socket, strerror(errno));
+		numa_set_preferred(wa->socket);
+	}
+#endif
+
+	for (idx = p->first; idx < p->last; idx++) {
+		struct rte_memseg *cur;
+		void *map_addr;
+
+		cur = rte_fbarray_get(&p->msl->memseg_arr, idx);
+		map_addr = RTE_PTR_ADD(p->msl->base_va, idx * page_sz);
+
+		p->seg_ret[idx - p->start_idx] = alloc_seg(cur, map_addr,
+				wa->socket, wa->hi, p->msl_idx, idx, &p->stats);
+	}
+	return NULL;
+}
+
+/*
+ * Allocate need segments starting at start_idx using several threads, each
+ * one taking care of a contiguous range. Results are stored in seg_ret.
+ * Returns -1 if threads could not be started, in which case no segment was
+ * allocated.
+ */
+static int
+alloc_seg_threaded(struct alloc_walk_param *wa, struct rte_memseg_list *msl,
+		unsigned int msl_idx, unsigned int start_idx, unsigned int need,
+		unsigned int n_threads, int *seg_ret)
+{
+	struct alloc_thread_param *params;
+	unsigned int i, chunk, started;
+	int ret = 0;
+
+	params = calloc(n_threads, sizeof(*params));
+	if (params == NULL)
+		return -1;
+
+	chunk = (need + n_threads - 1) / n_threads;
+	for (started = 0; started < n_threads; started++) {
+		struct alloc_thread_param *p = &params[started];
+
+		p->wa = wa;
+		p->msl = msl;
+		p->msl_idx = msl_idx;
+		p->start_idx = start_idx;
+		p->first = start_idx + started * chunk;
+		p->last = RTE_MIN(p->first + chunk, start_idx + need);
+		p->seg_ret = seg_ret;
+		if (p->first >= p->last)
+			break;
+		if (pthread_create(&p->tid, NULL, alloc_seg_thread, p) != 0) {
+			RTE_LOG(ERR, EAL, "%s(): cannot create thread\n",
+				__func__);
+			ret = -1;
+			break;
+		}
+	}
+
+	for (i = 0; i < started; i++) {
+		pthread_join(params[i].tid, NULL);
+		wa->stats.fd_ns += params[i].stats.fd_ns;
+		wa->stats.map_ns += params[i].stats.map_ns;
+		wa->stats.fault_ns += params[i].stats.fault_ns;
+		wa->stats.iova_ns += params[i].stats.iova_ns;
+	}
+
+	if (ret < 0) {
+		/* roll back whatever the started threads have allocated */
+		for (i = 0; i < params[started].first - start_idx; i++) {
+			struct rte_memseg *tmp;
+
+			if (seg_ret[i] != 0)
+				continue;
+			tmp = rte_fbarray_get(&msl->memseg_arr, start_idx + i);
+			if (free_seg(tmp, wa->hi, msl_idx, start_idx + i))
+				RTE_LOG(DEBUG, EAL, "Cannot free page\n");
+		}
+	}
+
+	free(params);
+	return ret;
+}
 static int
 alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 {
@@ -786,7 +937,8 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 	struct rte_memseg_list *cur_msl;
 	size_t page_sz;
 	int cur_idx, start_idx, j, dir_fd = -1;
-	unsigned int msl_idx, need, i;
+	unsigned int msl_idx, need, i, n_threads;
+	int *seg_ret = NULL;
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
@@ -854,19 +1006,54 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		}
 	}
 
+	/* at init, pages may be allocated and faulted in by several threads.
+	 * this is only possible with one file per page, as single file
+	 * segments share the file and its reference count.
+	 */
+	n_threads = RTE_MIN(internal_conf->mem_init_threads, need);
+	if (n_threads > 1 && !internal_conf->init_complete &&
+			!internal_conf->single_file_segments) {
+		seg_ret = malloc(need * sizeof(*seg_ret));
+		if (seg_ret != NULL && alloc_seg_threaded(wa, cur_msl, msl_idx,
+				start_idx, need, n_threads, seg_ret) < 0) {
+			free(seg_ret);
+			seg_ret = NULL;
+		}
+	}
+
 	for (i = 0; i < need; i++, cur_idx++) {
 		struct rte_memseg *cur;
 		void *map_addr;
+		int ret;
 
 		cur = rte_fbarray_get(&cur_msl->memseg_arr, cur_idx);
 		map_addr = RTE_PTR_ADD(cur_msl->base_va,
 				cur_idx * page_sz);
 
-		if (alloc_seg(cur, map_addr, wa->socket, wa->hi,
-				msl_idx, cur_idx)) {
+		if (seg_ret != NULL)
+			ret = seg_ret[i];
+		else
+			ret = alloc_seg(cur, map_addr, wa->socket, wa->hi,
+					msl_idx, cur_idx, &wa->stats);
+		if (ret) {
 			RTE_LOG(DEBUG, EAL, "attempted to allocate %i segments, but only %i were allocated\n",
 				need, i);
 
+			/* segments after this one may have been allocated by
+			 * other threads, release them.
+			 */
+			for (j = i + 1; seg_ret != NULL && j < (int)need; j++) {
+				struct rte_memseg *tmp;
+
+				if (seg_ret[j] != 0)
+					continue;
+				tmp = rte_fbarray_get(&cur_msl->memseg_arr,
+						start_idx + j);
+				if (free_seg(tmp, wa->hi, msl_idx,
+						start_idx + j))
+					RTE_LOG(DEBUG, EAL, "Cannot free page\n");
+			}
+
 			/* if exact number wasn't requested, stop */
 			if (!wa->exact)
 				goto out;
@@ -892,6 +1079,7 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 
 			if (dir_fd >= 0)
 				close(dir_fd);
+			free(seg_ret);
 			return -1;
 		}
 		if (wa->ms)
@@ -905,6 +1093,7 @@ alloc_seg_walk(const struct rte_memseg_list *msl, void *arg)
 		cur_msl->version++;
 	if (dir_fd >= 0)
 		close(dir_fd);
+	free(seg_ret);
 	/* if we didn't allocate any segments, move on to the next list */
 	return i > 0;
 }
@@ -987,6 +1176,7 @@ eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
 	struct bitmask *oldmask;
 #endif
 	struct alloc_walk_param wa;
+	uint64_t start_ns;
 	struct hugepage_info *hi = NULL;
 	struct internal_config *internal_conf =
 		eal_get_internal_configuration();
@@ -1026,6 +1216,8 @@ eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
 	wa.socket = socket;
 	wa.segs_allocated = 0;
 
+	start_ns = get_time_ns();
+
 	/* memalloc is locked, so it's safe to use thread-unsafe version */
 	ret = rte_memseg_list_walk_thread_unsafe(alloc_seg_walk, &wa);
 	if (ret == 0) {
@@ -1036,6 +1228,18 @@ eal_memalloc_alloc_seg_bulk(struct rte_memseg **ms, int n_segs, size_t page_sz,
 		ret = (int)wa.segs_allocated;
 	}
 
+	/* phase times are summed over all threads */
+	if (!internal_conf->init_complete && ret > 0)
+		RTE_LOG(DEBUG, EAL, "Allocated %d pages of size %zuM on socket %d in %"
+			PRIu64 " ms (fd/fallocate: %" PRIu64 " ms, mmap/populate: %"
+			PRIu64 " ms, fault-in: %" PRIu64 " ms, IOVA lookup: %"
+			PRIu64 " ms)\n",
+			ret, page_sz >> 20, socket,
+			(get_time_ns() - start_ns) / NSEC_PER_MSEC,
+			wa.stats.fd_ns / NSEC_PER_MSEC, wa.stats.map_ns / NSEC_PER_MSEC,
+			wa.stats.fault_ns / NSEC_PER_MSEC,
+			wa.stats.iova_ns / NSEC_PER_MSEC);
+
 #ifdef RTE_EAL_NUMA_AWARE_HUGEPAGES
 	if (have_numa)
 		restore_numa(&oldpolicy, oldmask);
@@ -1179,9 +1383,11 @@ sync_chunk(struct rte_memseg_list *primary_msl,
 			return -1;
 
 		if (used) {
+			struct alloc_seg_stats stats = { 0 };
+
 			ret = alloc_seg(l_ms, p_ms->addr,
 					p_ms->socket_id, hi,
-					msl_idx, seg_idx);
+					msl_idx, seg_idx, &stats);
 			if (ret < 0)
 				return -1;
 			rte_fbarray_set_used(l_arr, seg_idx);
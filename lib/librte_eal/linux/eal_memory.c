@@ -24,6 +24,7 @@
 #include <sys/time.h>
 #include <signal.h>
 #include <setjmp.h>
+#include <time.h>
 #ifdef F_ADD_SEALS /* if file sealing is supported, so is memfd */
 #include <linux/memfd.h>
 #define MEMFD_SUPPORTED
@@ -42,6 +43,7 @@
 #include <rte_lcore.h>
 #include <rte_common.h>
 #include <rte_string_fns.h>
+#include <rte_time.h>
 
 #include "eal_private.h"
 #include "eal_memalloc.h"
@@ -1869,7 +1871,17 @@ memseg_primary_init_32(void)
 static int __rte_unused
 memseg_primary_init(void)
 {
-	return eal_dynmem_memseg_lists_init();
+	struct timespec start, end;
+	int ret;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	ret = eal_dynmem_memseg_lists_init();
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	RTE_LOG(DEBUG, EAL, "Reserved VA space for memseg lists in %" PRIu64
+		" ms\n", (rte_timespec_to_ns(&end) -
+			rte_timespec_to_ns(&start)) / (NSEC_PER_SEC / 1000));
+	return ret;
 }
 
 static int
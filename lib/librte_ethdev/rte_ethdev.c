@@ -574,6 +574,9 @@ rte_eth_dev_release_port(struct rte_eth_dev *eth_dev)
 	eth_dev->rx_descriptor_done = NULL;
 	eth_dev->rx_descriptor_status = NULL;
 	eth_dev->tx_descriptor_status = NULL;
+	eth_dev->recycle_rx_descriptors_room = NULL;
+	eth_dev->recycle_tx_mbufs_reuse = NULL;
+	eth_dev->recycle_rx_descriptors_refill = NULL;
 	eth_dev->dev_ops = NULL;
 
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
@@ -5047,6 +5050,78 @@ rte_eth_rx_queue_info_get(uint16_t port_id, uint16_t queue_id,
 	return 0;
 }
 
+/* Check that a Rx queue is set up and can take recycled mbufs. */
+static int
+eth_recycle_rxq_check(struct rte_eth_dev *dev, uint16_t port_id,
+	uint16_t queue_id)
+{
+	if (queue_id >= dev->data->nb_rx_queues) {
+		RTE_ETHDEV_LOG(ERR, "Invalid RX queue_id=%u\n", queue_id);
+		return -EINVAL;
+	}
+
+	if (dev->data->rx_queues == NULL ||
+			dev->data->rx_queues[queue_id] == NULL) {
+		RTE_ETHDEV_LOG(ERR,
+			       "Rx queue %"PRIu16" of device with port_id=%"
+			       PRIu16" has not been setup\n",
+			       queue_id, port_id);
+		return -EINVAL;
+	}
+
+	if (rte_eth_dev_is_rx_hairpin_queue(dev, queue_id)) {
+		RTE_ETHDEV_LOG(INFO,
+			"Can't recycle mbufs to hairpin Rx queue %"PRIu16" of device with port_id=%"PRIu16"\n",
+			queue_id, port_id);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int
+rte_eth_recycle_rx_queue_info_get(uint16_t port_id, uint16_t queue_id,
+	struct rte_eth_recycle_rxq_info *info)
+{
+	struct rte_eth_dev *dev;
+	int ret;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+
+	if (info == NULL)
+		return -EINVAL;
+
+	dev = &rte_eth_devices[port_id];
+	ret = eth_recycle_rxq_check(dev, port_id, queue_id);
+	if (ret != 0)
+		return ret;
+
+	RTE_FUNC_PTR_OR_ERR_RET(*dev->dev_ops->recycle_rxq_info_get, -ENOTSUP);
+
+	memset(info, 0, sizeof(*info));
+	return eth_err(port_id,
+		dev->dev_ops->recycle_rxq_info_get(dev, queue_id, info));
+}
+
+int
+rte_eth_recycle_rx_queue_set(uint16_t port_id, uint16_t queue_id, int on)
+{
+	struct rte_eth_dev *dev;
+	int ret;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+
+	dev = &rte_eth_devices[port_id];
+	ret = eth_recycle_rxq_check(dev, port_id, queue_id);
+	if (ret != 0)
+		return ret;
+
+	RTE_FUNC_PTR_OR_ERR_RET(*dev->dev_ops->recycle_rxq_set, -ENOTSUP);
+
+	return eth_err(port_id,
+		dev->dev_ops->recycle_rxq_set(dev, queue_id, on != 0));
+}
+
 int
 rte_eth_tx_queue_info_get(uint16_t port_id, uint16_t queue_id,
 	struct rte_eth_txq_info *qinfo)
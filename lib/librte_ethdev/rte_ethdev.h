@@ -1573,6 +1573,19 @@ struct rte_eth_rxq_info {
 	uint16_t rx_buf_size;       /**< hardware receive buffer size. */
 } __rte_cache_min_aligned;
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change without prior notice.
+ *
+ * Ethernet device Rx queue information used to recycle Tx mbufs into it.
+ * Filled by rte_eth_recycle_rx_queue_info_get().
+ */
+struct rte_eth_recycle_rxq_info {
+	struct rte_mempool *mp; /**< mempool of the mbufs of the queue. */
+	uint16_t refill_requirement;
+	/**< Minimum number of mbufs worth a refill of the queue. */
+};
+
 /**
  * Ethernet device TX queue information structure.
  * Used to retrieve information about configured queue.
@@ -4290,6 +4303,65 @@ int rte_eth_rx_queue_info_get(uint16_t port_id, uint16_t queue_id,
 int rte_eth_tx_queue_info_get(uint16_t port_id, uint16_t queue_id,
 	struct rte_eth_txq_info *qinfo);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Retrieve the information needed to recycle mbufs into a Rx queue.
+ * Recycling is then enabled with rte_eth_recycle_rx_queue_set().
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The Rx queue on the Ethernet device for which information
+ *   will be retrieved.
+ * @param info
+ *   A pointer to a structure of type *rte_eth_recycle_rxq_info* to be filled.
+ *
+ * @return
+ *   - 0: Success
+ *   - -ENODEV:  If *port_id* is invalid.
+ *   - -ENOTSUP: mbuf recycling is not supported by the device PMD, or in
+ *               the current Rx path.
+ *   - -EINVAL:  The queue_id is out of range, or the queue
+ *               is hairpin queue.
+ */
+__rte_experimental
+int rte_eth_recycle_rx_queue_info_get(uint16_t port_id, uint16_t queue_id,
+	struct rte_eth_recycle_rxq_info *info);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Enable or disable mbuf recycling on a Rx queue.
+ *
+ * Once recycling is enabled, the PMD may defer refilling the queue from its
+ * mempool, to leave room for the mbufs given by rte_eth_recycle_mbufs().
+ * The application must then call rte_eth_recycle_mbufs() regularly for
+ * this queue, the PMD still refills from the mempool when too many
+ * descriptors are empty. Recycling must be disabled when the application
+ * stops calling rte_eth_recycle_mbufs(), it is also disabled when the
+ * queue is set up again.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The index of the Rx queue.
+ * @param on
+ *   If 1, enable mbuf recycling, if 0, disable it.
+ *
+ * @return
+ *   - 0: Success
+ *   - -ENODEV:  If *port_id* is invalid.
+ *   - -ENOTSUP: mbuf recycling is not supported by the device PMD, or in
+ *               the current Rx path.
+ *   - -EINVAL:  The queue_id is out of range, or the queue
+ *               is hairpin queue.
+ */
+__rte_experimental
+int rte_eth_recycle_rx_queue_set(uint16_t port_id, uint16_t queue_id, int on);
+
 /**
  * Retrieve information about the Rx packet burst mode.
  *
@@ -5263,6 +5335,90 @@ rte_eth_tx_prepare(__rte_unused uint16_t port_id,
 
 #endif
 
+/** Maximum number of mbufs moved by one call to rte_eth_recycle_mbufs(). */
+#define RTE_ETH_RECYCLE_MAX_BURST 64
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Recycle the mbufs of completed transmissions into a receive queue.
+ *
+ * The mbufs of packets sent by the Tx queue *tx_queue_id* of *tx_port_id*
+ * and whose transmission is complete are released, and the ones belonging
+ * to the mempool of the Rx queue *rx_queue_id* of *rx_port_id* are directly
+ * used to refill its descriptors, instead of going through the mempool.
+ * Other mbufs are freed to their mempool.
+ *
+ * It is meant for run-to-completion forwarding, with the Rx and Tx queues
+ * polled by the same lcore, and is typically called before
+ * rte_eth_rx_burst(). Both queues may belong to different ports, but their
+ * PMDs must support mbuf recycling.
+ *
+ * @param rx_port_id
+ *   The port identifier of the Ethernet device receiving the mbufs.
+ * @param rx_queue_id
+ *   The index of the receive queue to refill. Mbuf recycling must have been
+ *   enabled on it with rte_eth_recycle_rx_queue_set().
+ * @param tx_port_id
+ *   The port identifier of the Ethernet device transmitting the mbufs.
+ * @param tx_queue_id
+ *   The index of the transmit queue to take completed mbufs from.
+ * @param recycle_rxq_info
+ *   The information returned by rte_eth_recycle_rx_queue_info_get() for the
+ *   receive queue.
+ * @return
+ *   The number of mbufs recycled into the receive queue.
+ */
+__rte_experimental
+static inline uint16_t
+rte_eth_recycle_mbufs(uint16_t rx_port_id, uint16_t rx_queue_id,
+		uint16_t tx_port_id, uint16_t tx_queue_id,
+		const struct rte_eth_recycle_rxq_info *recycle_rxq_info)
+{
+	struct rte_eth_dev *rx_dev = &rte_eth_devices[rx_port_id];
+	struct rte_eth_dev *tx_dev = &rte_eth_devices[tx_port_id];
+	struct rte_mbuf *mbufs[RTE_ETH_RECYCLE_MAX_BURST];
+	void *rxq, *txq;
+	uint16_t room, nb_mbufs;
+
+#ifdef RTE_LIBRTE_ETHDEV_DEBUG
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(rx_port_id, 0);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(tx_port_id, 0);
+	RTE_FUNC_PTR_OR_ERR_RET(*rx_dev->recycle_rx_descriptors_room, 0);
+	RTE_FUNC_PTR_OR_ERR_RET(*rx_dev->recycle_rx_descriptors_refill, 0);
+
+	if (rx_queue_id >= rx_dev->data->nb_rx_queues) {
+		RTE_ETHDEV_LOG(ERR, "Invalid RX queue_id=%u\n", rx_queue_id);
+		return 0;
+	}
+	if (tx_queue_id >= tx_dev->data->nb_tx_queues) {
+		RTE_ETHDEV_LOG(ERR, "Invalid TX queue_id=%u\n", tx_queue_id);
+		return 0;
+	}
+#endif
+
+	/* the Tx PMD may not support recycling */
+	if (unlikely(tx_dev->recycle_tx_mbufs_reuse == NULL))
+		return 0;
+
+	rxq = rx_dev->data->rx_queues[rx_queue_id];
+	txq = tx_dev->data->tx_queues[tx_queue_id];
+
+	room = (*rx_dev->recycle_rx_descriptors_room)(rxq);
+	if (room == 0 || room < recycle_rxq_info->refill_requirement)
+		return 0;
+
+	nb_mbufs = (*tx_dev->recycle_tx_mbufs_reuse)(txq, mbufs,
+			RTE_MIN(room, (uint16_t)RTE_ETH_RECYCLE_MAX_BURST),
+			recycle_rxq_info->mp);
+	if (nb_mbufs == 0)
+		return 0;
+
+	(*rx_dev->recycle_rx_descriptors_refill)(rxq, mbufs, nb_mbufs);
+	return nb_mbufs;
+}
+
 /**
  * Send any packets queued up for transmission on a port and HW queue
  *
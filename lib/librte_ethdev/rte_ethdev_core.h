@@ -55,6 +55,20 @@ typedef int (*eth_rx_descriptor_status_t)(void *rxq, uint16_t offset);
 typedef int (*eth_tx_descriptor_status_t)(void *txq, uint16_t offset);
 /**< @internal Check the status of a Tx descriptor */
 
+typedef uint16_t (*eth_recycle_rx_descriptors_room_t)(void *rxq);
+/**< @internal Get number of Rx descriptors waiting for a new mbuf */
+
+typedef uint16_t (*eth_recycle_tx_mbufs_reuse_t)(void *txq,
+					       struct rte_mbuf **mbufs,
+					       uint16_t nb_mbufs,
+					       struct rte_mempool *mp);
+/**< @internal Take back completed Tx mbufs of a mempool for recycling */
+
+typedef void (*eth_recycle_rx_descriptors_refill_t)(void *rxq,
+						    struct rte_mbuf **mbufs,
+						    uint16_t nb_mbufs);
+/**< @internal Refill Rx descriptors with recycled mbufs */
+
 
 /**
  * @internal
@@ -116,7 +130,17 @@ struct rte_eth_dev {
 	void *security_ctx; /**< Context for security ops */
 
 	uint64_t reserved_64s[4]; /**< Reserved for future fields */
-	void *reserved_ptrs[4];   /**< Reserved for future fields */
+	/*
+	 * The mbuf recycling functions take the place of reserved pointers,
+	 * to keep the layout of the structure.
+	 */
+	eth_recycle_rx_descriptors_room_t recycle_rx_descriptors_room;
+	/**< Get the number of Rx descriptors which can take recycled mbufs. */
+	eth_recycle_tx_mbufs_reuse_t recycle_tx_mbufs_reuse;
+	/**< Take back completed Tx mbufs for recycling. */
+	eth_recycle_rx_descriptors_refill_t recycle_rx_descriptors_refill;
+	/**< Refill Rx descriptors with recycled mbufs. */
+	void *reserved_ptrs[1];   /**< Reserved for future fields */
 } __rte_cache_aligned;
 
 struct rte_eth_dev_sriov;
@@ -298,6 +298,14 @@ typedef void (*eth_rxq_info_get_t)(struct rte_eth_dev *dev,
 typedef void (*eth_txq_info_get_t)(struct rte_eth_dev *dev,
 	uint16_t tx_queue_id, struct rte_eth_txq_info *qinfo);
 
+typedef int (*eth_recycle_rxq_info_get_t)(struct rte_eth_dev *dev,
+	uint16_t rx_queue_id, struct rte_eth_recycle_rxq_info *info);
+/**< @internal Get mbuf recycling information of a Rx queue. */
+
+typedef int (*eth_recycle_rxq_set_t)(struct rte_eth_dev *dev,
+	uint16_t rx_queue_id, int on);
+/**< @internal Enable or disable mbuf recycling on a Rx queue. */
+
 typedef int (*eth_burst_mode_get_t)(struct rte_eth_dev *dev,
 	uint16_t queue_id, struct rte_eth_burst_mode *mode);
 
@@ -917,6 +925,11 @@ struct eth_dev_ops {
 	/**< Set up the connection between the pair of hairpin queues. */
 	eth_hairpin_queue_peer_unbind_t hairpin_queue_peer_unbind;
 	/**< Disconnect the hairpin queues of a pair from each other. */
+
+	eth_recycle_rxq_info_get_t recycle_rxq_info_get;
+	/**< Get mbuf recycling information of a Rx queue. */
+	eth_recycle_rxq_set_t recycle_rxq_set;
+	/**< Enable or disable mbuf recycling on a Rx queue. */
 };
 
 /**
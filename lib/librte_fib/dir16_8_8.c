@@ -0,0 +1,872 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_debug.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_memory.h>
+#include <rte_vect.h>
+
+#include <rte_rib.h>
+#include <rte_fib.h>
+#include "dir16_8_8.h"
+
+#ifdef CC_DIR16_8_8_AVX512_SUPPORT
+
+#include "dir16_8_8_avx512.h"
+
+#endif /* CC_DIR16_8_8_AVX512_SUPPORT */
+
+#define DIR16_8_8_NAMESIZE	64
+
+/* Vector lookup reads leaves 32 bits at a time, keep it inside the block */
+#define DIR16_8_8_BLK_PAD	sizeof(uint32_t)
+
+static inline rte_fib_lookup_fn_t
+get_scalar_fn(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return dir16_8_8_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return dir16_8_8_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return dir16_8_8_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return dir16_8_8_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+}
+
+static inline rte_fib_lookup_fn_t
+get_vector_fn(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+#ifdef CC_DIR16_8_8_AVX512_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0) ||
+			(rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) <= 0) ||
+			(rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_512))
+		return NULL;
+
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return rte_dir16_8_8_vec_lookup_bulk_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return rte_dir16_8_8_vec_lookup_bulk_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return rte_dir16_8_8_vec_lookup_bulk_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return rte_dir16_8_8_vec_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(nh_sz);
+#endif
+	return NULL;
+}
+
+rte_fib_lookup_fn_t
+dir16_8_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type)
+{
+	enum rte_fib_dir24_8_nh_sz nh_sz;
+	rte_fib_lookup_fn_t ret_fn;
+	struct dir16_8_8_tbl *dp = p;
+
+	if (dp == NULL)
+		return NULL;
+
+	nh_sz = dp->nh_sz;
+
+	switch (type) {
+	case RTE_FIB_LOOKUP_DIR16_8_8_SCALAR:
+		return get_scalar_fn(nh_sz);
+	case RTE_FIB_LOOKUP_DIR16_8_8_VECTOR_AVX512:
+		return get_vector_fn(nh_sz);
+	case RTE_FIB_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn(nh_sz);
+		return (ret_fn != NULL) ? ret_fn : get_scalar_fn(nh_sz);
+	default:
+		return NULL;
+	}
+
+	return NULL;
+}
+
+static inline void
+write_leaf(uint8_t *ptr, uint64_t val, enum rte_fib_dir24_8_nh_sz size)
+{
+	switch (size) {
+	case RTE_FIB_DIR24_8_1B:
+		*ptr = (uint8_t)val;
+		break;
+	case RTE_FIB_DIR24_8_2B:
+		*(uint16_t *)ptr = (uint16_t)val;
+		break;
+	case RTE_FIB_DIR24_8_4B:
+		*(uint32_t *)ptr = (uint32_t)val;
+		break;
+	case RTE_FIB_DIR24_8_8B:
+		*(uint64_t *)ptr = val;
+		break;
+	}
+}
+
+static inline uint64_t
+read_leaf(const uint8_t *ptr, enum rte_fib_dir24_8_nh_sz size)
+{
+	switch (size) {
+	case RTE_FIB_DIR24_8_1B:
+		return *ptr;
+	case RTE_FIB_DIR24_8_2B:
+		return *(const uint16_t *)ptr;
+	case RTE_FIB_DIR24_8_4B:
+		return *(const uint32_t *)ptr;
+	default:
+		return *(const uint64_t *)ptr;
+	}
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(n);
+	rte_free(*(void **)data);
+}
+
+/*
+ * Release a block which is no longer referenced from tbl16.
+ * Readers may still be walking it, so with RCU configured
+ * it is only freed once they have all gone quiescent.
+ */
+static void
+blk_free(struct dir16_8_8_tbl *dp, void *blk)
+{
+	if (dp->v == NULL) {
+		rte_free(blk);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		rte_free(blk);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(dp->dq, (void *)&blk) != 0) {
+			RTE_LOG(ERR, LPM, "Failed to push QSBR FIFO\n");
+			/* Fall back to blocking reclaim instead of leaking */
+			rte_rcu_qsbr_synchronize(dp->v,
+				RTE_QSBR_THRID_INVALID);
+			rte_free(blk);
+		}
+	}
+}
+
+static void *
+blk_alloc(struct dir16_8_8_tbl *dp, size_t sz)
+{
+	void *blk;
+
+	blk = rte_malloc_socket("DIR16_8_8_BLK", sz, RTE_CACHE_LINE_SIZE,
+		dp->socket_id);
+	if ((blk == NULL) && (dp->dq != NULL)) {
+		/* Blocks waiting for the readers may free enough memory. */
+		rte_rcu_qsbr_dq_reclaim(dp->dq, UINT32_MAX, NULL, NULL, NULL);
+		blk = rte_malloc_socket("DIR16_8_8_BLK", sz,
+			RTE_CACHE_LINE_SIZE, dp->socket_id);
+	}
+	return blk;
+}
+
+/* Most specific route covering ip with a prefix not longer than depth */
+static struct rte_rib_node *
+get_cover(struct rte_rib *rib, uint32_t ip, uint8_t depth)
+{
+	struct rte_rib_node *node;
+	uint8_t node_depth;
+
+	node = rte_rib_lookup(rib, ip);
+	while (node != NULL) {
+		rte_rib_get_depth(node, &node_depth);
+		if (node_depth <= depth)
+			break;
+		node = rte_rib_lookup_parent(node);
+	}
+	return node;
+}
+
+static uint64_t
+get_cover_nh(struct dir16_8_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+	uint8_t depth)
+{
+	struct rte_rib_node *node;
+	uint64_t nh = dp->def_nh;
+
+	node = get_cover(rib, ip, depth);
+	if (node != NULL)
+		rte_rib_get_nh(node, &nh);
+	return nh;
+}
+
+/*
+ * Set entries [first, first + num) to nh unless a more specific route
+ * has already been written there. rte_rib_get_nxt() returns routes
+ * after all their more specific routes, so the first write wins.
+ */
+static inline void
+paint(uint64_t *vals, uint64_t *painted, uint32_t first, uint32_t num,
+	uint64_t nh)
+{
+	uint32_t i;
+
+	for (i = first; i < first + num; i++) {
+		if (painted[i / DIR16_8_8_CHUNK_NUM_ENT] &
+				(1ULL << (i % DIR16_8_8_CHUNK_NUM_ENT)))
+			continue;
+		painted[i / DIR16_8_8_CHUNK_NUM_ENT] |=
+			1ULL << (i % DIR16_8_8_CHUNK_NUM_ENT);
+		vals[i] = nh;
+	}
+}
+
+/*
+ * Compute from the RIB the /24 entries covered by ip/depth,
+ * 16 <= depth <= 24. The /24s with longer routes are marked in childmap,
+ * their entry holds the next hop of the /24 itself.
+ */
+static void
+paint_l1(struct dir16_8_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+	uint8_t depth, uint64_t *vals, uint64_t *childmap)
+{
+	uint64_t painted[DIR16_8_8_CHUNK_NUM] = {0};
+	struct rte_rib_node *node = NULL;
+	uint32_t i, first, num, rt_ip;
+	uint64_t nh;
+	uint8_t rt_depth;
+
+	first = (uint8_t)(ip >> 8);
+	num = 1 << (24 - depth);
+	nh = get_cover_nh(dp, rib, ip, depth);
+	for (i = first; i < first + num; i++) {
+		vals[i] = nh;
+		childmap[i / DIR16_8_8_CHUNK_NUM_ENT] &=
+			~(1ULL << (i % DIR16_8_8_CHUNK_NUM_ENT));
+	}
+
+	while ((node = rte_rib_get_nxt(rib, ip, depth, node,
+			RTE_RIB_GET_NXT_ALL)) != NULL) {
+		rte_rib_get_ip(node, &rt_ip);
+		rte_rib_get_depth(node, &rt_depth);
+		i = (uint8_t)(rt_ip >> 8);
+		if (rt_depth > 24) {
+			childmap[i / DIR16_8_8_CHUNK_NUM_ENT] |=
+				1ULL << (i % DIR16_8_8_CHUNK_NUM_ENT);
+			continue;
+		}
+		rte_rib_get_nh(node, &nh);
+		paint(vals, painted, i, 1 << (24 - rt_depth), nh);
+	}
+}
+
+/* Compute from the RIB the entries of the /24 ip, nh is the /24 next hop */
+static void
+paint_l2(struct rte_rib *rib, uint32_t ip, uint64_t nh, uint64_t *vals)
+{
+	uint64_t painted[DIR16_8_8_CHUNK_NUM] = {0};
+	struct rte_rib_node *node = NULL;
+	uint32_t i, rt_ip;
+	uint8_t rt_depth;
+
+	for (i = 0; i < DIR16_8_8_GRP_NUM_ENT; i++)
+		vals[i] = nh;
+
+	while ((node = rte_rib_get_nxt(rib, ip, 24, node,
+			RTE_RIB_GET_NXT_ALL)) != NULL) {
+		rte_rib_get_ip(node, &rt_ip);
+		rte_rib_get_depth(node, &rt_depth);
+		rte_rib_get_nh(node, &nh);
+		paint(vals, painted, (uint8_t)rt_ip, 1 << (32 - rt_depth), nh);
+	}
+}
+
+/* Expand the leaves of a node, entries pointing to child nodes are skipped */
+static void
+expand_node(const uint8_t *blk, const struct dir16_8_8_node *node,
+	uint64_t *vals, enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	const struct dir16_8_8_chunk *c;
+	uint32_t i, j, runs;
+
+	for (i = 0; i < DIR16_8_8_CHUNK_NUM; i++) {
+		c = &node->chunk[i];
+		for (j = 0, runs = 0; j < DIR16_8_8_CHUNK_NUM_ENT; j++) {
+			if (c->nodemap & (1ULL << j))
+				continue;
+			if (c->leafmap & (1ULL << j))
+				runs++;
+			vals[i * DIR16_8_8_CHUNK_NUM_ENT + j] =
+				read_leaf(blk + c->leaf_off + (runs << nh_sz),
+				nh_sz);
+		}
+	}
+}
+
+/* Child node of entry idx of the root node of a block */
+static inline const struct dir16_8_8_node *
+get_child(const uint8_t *blk, uint32_t idx)
+{
+	const struct dir16_8_8_chunk *c;
+	uint64_t bit;
+
+	c = &((const struct dir16_8_8_node *)blk)->chunk[idx /
+		DIR16_8_8_CHUNK_NUM_ENT];
+	bit = 1ULL << (idx % DIR16_8_8_CHUNK_NUM_ENT);
+	return (const struct dir16_8_8_node *)(blk + c->node_off) +
+		__builtin_popcountll(c->nodemap & (bit - 1));
+}
+
+/* Number of leaves of a node without children */
+static inline uint32_t
+node_leaves(const struct dir16_8_8_node *node)
+{
+	uint32_t i, n = 0;
+
+	for (i = 0; i < DIR16_8_8_CHUNK_NUM; i++)
+		n += __builtin_popcountll(node->chunk[i].leafmap);
+	return n;
+}
+
+/*
+ * Copy a node without children and its leaves from the old block,
+ * the leaves are appended at *leaf_off.
+ */
+static void
+copy_node(uint8_t *blk, struct dir16_8_8_node *node, const uint8_t *old_blk,
+	const struct dir16_8_8_node *old, uint32_t *leaf_off,
+	enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	uint32_t i, first, len;
+
+	/* The first entry always starts a run */
+	first = old->chunk[0].leaf_off + (1 << nh_sz);
+	len = node_leaves(old) << nh_sz;
+	*node = *old;
+	for (i = 0; i < DIR16_8_8_CHUNK_NUM; i++)
+		node->chunk[i].leaf_off += *leaf_off - first;
+	memcpy(blk + *leaf_off, old_blk + first, len);
+	*leaf_off += len;
+}
+
+static inline int
+is_child(const uint64_t *childmap, uint32_t i)
+{
+	return (childmap != NULL) && (childmap[i / DIR16_8_8_CHUNK_NUM_ENT] &
+		(1ULL << (i % DIR16_8_8_CHUNK_NUM_ENT)));
+}
+
+/* Number of leaves compress_node() writes for the entries */
+static uint32_t
+count_leaves(const uint64_t *vals, const uint64_t *childmap)
+{
+	uint32_t i, runs = 0;
+	uint64_t prev = 0;
+
+	for (i = 0; i < DIR16_8_8_GRP_NUM_ENT; i++) {
+		if (is_child(childmap, i))
+			continue;
+		if ((runs != 0) && (vals[i] == prev))
+			continue;
+		prev = vals[i];
+		runs++;
+	}
+	return runs;
+}
+
+/*
+ * Fill node from the entry values. Entries set in childmap point to
+ * the child nodes found at node_off, leaves are appended at *leaf_off.
+ */
+static void
+compress_node(uint8_t *blk, struct dir16_8_8_node *node, const uint64_t *vals,
+	const uint64_t *childmap, uint32_t node_off, uint32_t *leaf_off,
+	enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	struct dir16_8_8_chunk *c;
+	uint32_t i, j, idx, runs = 0;
+	uint32_t off = *leaf_off;
+	uint64_t prev = 0;
+
+	for (i = 0; i < DIR16_8_8_CHUNK_NUM; i++) {
+		c = &node->chunk[i];
+		c->leafmap = 0;
+		c->nodemap = 0;
+		c->leaf_off = off - (1 << nh_sz);
+		c->node_off = node_off;
+		c->rsvd = 0;
+		for (j = 0; j < DIR16_8_8_CHUNK_NUM_ENT; j++) {
+			idx = i * DIR16_8_8_CHUNK_NUM_ENT + j;
+			if (is_child(childmap, idx)) {
+				c->nodemap |= 1ULL << j;
+				node_off += sizeof(struct dir16_8_8_node);
+				continue;
+			}
+			if ((runs != 0) && (vals[idx] == prev))
+				continue;
+			c->leafmap |= 1ULL << j;
+			write_leaf(blk + off, vals[idx], nh_sz);
+			off += 1 << nh_sz;
+			prev = vals[idx];
+			runs++;
+		}
+	}
+	*leaf_off = off;
+}
+
+/*
+ * Replace the block of the /16 containing ip. The /24 entries covered
+ * by ip/depth (depth is clamped to 16..24) are computed from the RIB,
+ * the rest is copied from the old block. Readers keep using the old
+ * block until tbl16 points to the new one.
+ */
+static int
+rebuild_tbl16(struct dir16_8_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+	uint8_t depth)
+{
+	uint64_t l1[DIR16_8_8_GRP_NUM_ENT];
+	uint64_t l2_buf[DIR16_8_8_GRP_NUM_ENT];
+	uint64_t childmap[DIR16_8_8_CHUNK_NUM] = {0};
+	uint64_t *l2 = l2_buf;
+	const uint8_t *old_blk = NULL;
+	struct dir16_8_8_node *node;
+	uint64_t old_ent, ent;
+	uint32_t i, k, first, last, nb_nodes = 0, nb_dirty = 0;
+	uint32_t nb_leaves, leaf_off;
+	uint8_t *blk = NULL;
+
+	depth = RTE_MIN(RTE_MAX(depth, 16), 24);
+	ip &= rte_rib_depth_to_mask(depth);
+	first = (uint8_t)(ip >> 8);
+	last = first + (1 << (24 - depth));
+
+	old_ent = dp->tbl16[ip >> 16];
+	if (old_ent & DIR16_8_8_EXT_ENT) {
+		old_blk = (const uint8_t *)(uintptr_t)(old_ent &
+			~(uint64_t)DIR16_8_8_EXT_ENT);
+		node = (struct dir16_8_8_node *)(uintptr_t)old_blk;
+		expand_node(old_blk, node, l1, dp->nh_sz);
+		for (i = 0; i < DIR16_8_8_CHUNK_NUM; i++)
+			childmap[i] = node->chunk[i].nodemap;
+	} else {
+		for (i = 0; i < DIR16_8_8_GRP_NUM_ENT; i++)
+			l1[i] = old_ent >> 1;
+	}
+	paint_l1(dp, rib, ip, depth, l1, childmap);
+
+	for (i = first; i < last; i++)
+		nb_dirty += is_child(childmap, i);
+	if (nb_dirty > 1) {
+		l2 = rte_malloc(NULL, nb_dirty * sizeof(l2_buf), 0);
+		if (l2 == NULL)
+			return -ENOMEM;
+	}
+
+	/* Children outside of the dirty range are kept as they are */
+	nb_leaves = count_leaves(l1, childmap);
+	for (i = 0, k = 0; i < DIR16_8_8_GRP_NUM_ENT; i++) {
+		if (!is_child(childmap, i))
+			continue;
+		if ((i >= first) && (i < last)) {
+			paint_l2(rib, (ip & 0xffff0000) | (i << 8), l1[i],
+				&l2[k * DIR16_8_8_GRP_NUM_ENT]);
+			nb_leaves += count_leaves(&l2[k * DIR16_8_8_GRP_NUM_ENT],
+				NULL);
+			k++;
+		} else
+			nb_leaves += node_leaves(get_child(old_blk, i));
+		nb_nodes++;
+	}
+
+	if ((nb_nodes == 0) && (nb_leaves == 1))
+		ent = l1[0] << 1;
+	else {
+		leaf_off = (nb_nodes + 1) * sizeof(struct dir16_8_8_node);
+		blk = blk_alloc(dp, leaf_off + (nb_leaves << dp->nh_sz) +
+			DIR16_8_8_BLK_PAD);
+		if (blk == NULL) {
+			if (l2 != l2_buf)
+				rte_free(l2);
+			return -ENOMEM;
+		}
+
+		node = (struct dir16_8_8_node *)blk;
+		compress_node(blk, node++, l1, childmap,
+			sizeof(struct dir16_8_8_node), &leaf_off, dp->nh_sz);
+		for (i = 0, k = 0; i < DIR16_8_8_GRP_NUM_ENT; i++) {
+			if (!is_child(childmap, i))
+				continue;
+			if ((i >= first) && (i < last))
+				compress_node(blk, node++,
+					&l2[k++ * DIR16_8_8_GRP_NUM_ENT], NULL,
+					0, &leaf_off, dp->nh_sz);
+			else
+				copy_node(blk, node++, old_blk,
+					get_child(old_blk, i), &leaf_off,
+					dp->nh_sz);
+		}
+		ent = (uintptr_t)blk | DIR16_8_8_EXT_ENT;
+	}
+	if (l2 != l2_buf)
+		rte_free(l2);
+
+	/* The block has to be complete before readers can reach it */
+	__atomic_store_n(&dp->tbl16[ip >> 16], ent, __ATOMIC_RELEASE);
+	if (old_blk != NULL)
+		blk_free(dp, (void *)(uintptr_t)old_blk);
+
+	return 0;
+}
+
+/* Rebuild every /16 whose entries depend on the route ip/depth */
+static int
+update_range(struct dir16_8_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+	uint8_t depth)
+{
+	struct rte_rib_node *node;
+	uint32_t i, first, num;
+	uint8_t node_depth;
+	int ret;
+
+	if (depth > 16)
+		return rebuild_tbl16(dp, rib, ip, depth);
+
+	first = ip >> 16;
+	num = 1 << (16 - depth);
+	for (i = first; i < first + num; i++) {
+		/* Skip the /16s under a more specific route */
+		node = get_cover(rib, i << 16, 16);
+		if (node != NULL) {
+			rte_rib_get_depth(node, &node_depth);
+			if (node_depth > depth)
+				continue;
+		}
+		ret = rebuild_tbl16(dp, rib, i << 16, 16);
+		if (ret != 0)
+			return ret;
+	}
+	return 0;
+}
+
+int
+dir16_8_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, int op)
+{
+	struct dir16_8_8_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *node;
+	uint64_t node_nh;
+	int ret;
+
+	if ((fib == NULL) || (depth > RTE_FIB_MAXDEPTH))
+		return -EINVAL;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	if (next_hop > dir16_8_8_get_max_nh(dp->nh_sz))
+		return -EINVAL;
+
+	ip &= rte_rib_depth_to_mask(depth);
+
+	/*
+	 * The dataplane is computed from the RIB, so the RIB is changed
+	 * first and restored if the new blocks can not be allocated.
+	 */
+	node = rte_rib_lookup_exact(rib, ip, depth);
+	switch (op) {
+	case RTE_FIB_ADD:
+		if (node != NULL) {
+			rte_rib_get_nh(node, &node_nh);
+			if (node_nh == next_hop)
+				return 0;
+			rte_rib_set_nh(node, next_hop);
+			ret = update_range(dp, rib, ip, depth);
+			if (ret != 0) {
+				rte_rib_set_nh(node, node_nh);
+				update_range(dp, rib, ip, depth);
+			}
+			return ret;
+		}
+		node = rte_rib_insert(rib, ip, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib_set_nh(node, next_hop);
+		ret = update_range(dp, rib, ip, depth);
+		if (ret != 0) {
+			rte_rib_remove(rib, ip, depth);
+			update_range(dp, rib, ip, depth);
+		}
+		return ret;
+	case RTE_FIB_DEL:
+		if (node == NULL)
+			return -ENOENT;
+		rte_rib_get_nh(node, &node_nh);
+		rte_rib_remove(rib, ip, depth);
+		ret = update_range(dp, rib, ip, depth);
+		if (ret != 0) {
+			node = rte_rib_insert(rib, ip, depth);
+			if (node != NULL) {
+				rte_rib_set_nh(node, node_nh);
+				update_range(dp, rib, ip, depth);
+			}
+		}
+		return ret;
+	default:
+		break;
+	}
+	return -EINVAL;
+}
+
+/* State of a route during dir16_8_8_add_bulk() */
+#define BULK_RT_UNCHANGED	0
+#define BULK_RT_UPDATED		1
+#define BULK_RT_NEW		2
+
+static inline void
+mark_tbl16(uint64_t *dirty, uint32_t ip, uint8_t depth)
+{
+	uint32_t i, first, num;
+
+	first = ip >> 16;
+	num = (depth < 16) ? 1 << (16 - depth) : 1;
+	for (i = first; i < first + num; i++)
+		dirty[i / 64] |= 1ULL << (i % 64);
+}
+
+static int
+rebuild_marked(struct dir16_8_8_tbl *dp, struct rte_rib *rib,
+	const uint64_t *dirty)
+{
+	uint64_t slab;
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < DIR16_8_8_TBL16_NUM_ENT / 64; i++) {
+		for (slab = dirty[i]; slab != 0; slab &= slab - 1) {
+			ret = rebuild_tbl16(dp, rib,
+				(i * 64 + __builtin_ctzll(slab)) << 16, 16);
+			if (ret != 0)
+				return ret;
+		}
+	}
+	return 0;
+}
+
+int
+dir16_8_8_add_bulk(struct rte_fib *fib, const struct rte_fib_route *routes,
+	unsigned int n)
+{
+	struct dir16_8_8_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *node;
+	uint64_t *dirty, *old_nh;
+	uint8_t *state;
+	unsigned int i, nb;
+	int ret = 0, err;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	for (i = 0; i < n; i++) {
+		if (routes[i].next_hop > dir16_8_8_get_max_nh(dp->nh_sz))
+			return -EINVAL;
+	}
+
+	dirty = rte_zmalloc(NULL, DIR16_8_8_TBL16_NUM_ENT / 8 +
+		(uint64_t)n * (sizeof(*old_nh) + sizeof(*state)), 0);
+	if (dirty == NULL)
+		return -ENOMEM;
+	old_nh = dirty + DIR16_8_8_TBL16_NUM_ENT / 64;
+	state = (uint8_t *)(old_nh + n);
+
+	/*
+	 * Put all the routes into the RIB first, then build every /16
+	 * they touch only once.
+	 */
+	for (nb = 0; nb < n; nb++) {
+		node = rte_rib_lookup_exact(rib, routes[nb].ip,
+			routes[nb].depth);
+		if (node != NULL) {
+			rte_rib_get_nh(node, &old_nh[nb]);
+			if (old_nh[nb] == routes[nb].next_hop) {
+				state[nb] = BULK_RT_UNCHANGED;
+				continue;
+			}
+			state[nb] = BULK_RT_UPDATED;
+		} else {
+			node = rte_rib_insert(rib, routes[nb].ip,
+				routes[nb].depth);
+			if (node == NULL) {
+				ret = -rte_errno;
+				break;
+			}
+			state[nb] = BULK_RT_NEW;
+		}
+		rte_rib_set_nh(node, routes[nb].next_hop);
+		mark_tbl16(dirty, routes[nb].ip, routes[nb].depth);
+	}
+
+	err = rebuild_marked(dp, rib, dirty);
+	if (err != 0) {
+		/* Out of memory, put the RIB back the way it was */
+		ret = err;
+		while (nb-- > 0) {
+			if (state[nb] == BULK_RT_NEW)
+				rte_rib_remove(rib, routes[nb].ip,
+					routes[nb].depth);
+			else if (state[nb] == BULK_RT_UPDATED)
+				rte_rib_set_nh(rte_rib_lookup_exact(rib,
+					routes[nb].ip, routes[nb].depth),
+					old_nh[nb]);
+		}
+		rebuild_marked(dp, rib, dirty);
+	}
+
+	rte_free(dirty);
+	return ret;
+}
+
+int
+dir16_8_8_rebuild(struct rte_fib *fib)
+{
+	struct dir16_8_8_tbl *dp;
+	struct rte_rib *rib;
+	uint32_t i;
+	int ret;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	for (i = 0; i < DIR16_8_8_TBL16_NUM_ENT; i++) {
+		ret = rebuild_tbl16(dp, rib, i << 16, 16);
+		if (ret != 0)
+			return ret;
+	}
+	return 0;
+}
+
+void *
+dir16_8_8_create(const char *name, int socket_id,
+	struct rte_fib_conf *fib_conf)
+{
+	char mem_name[DIR16_8_8_NAMESIZE];
+	struct dir16_8_8_tbl *dp;
+	uint64_t	def_nh;
+	enum rte_fib_dir24_8_nh_sz	nh_sz;
+	uint32_t	i;
+
+	if ((name == NULL) || (fib_conf == NULL) ||
+			(fib_conf->dir16_8_8.nh_sz < RTE_FIB_DIR24_8_1B) ||
+			(fib_conf->dir16_8_8.nh_sz > RTE_FIB_DIR24_8_8B) ||
+			(fib_conf->default_nh >
+			dir16_8_8_get_max_nh(fib_conf->dir16_8_8.nh_sz))) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	def_nh = fib_conf->default_nh;
+	nh_sz = fib_conf->dir16_8_8.nh_sz;
+
+	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
+	dp = rte_zmalloc_socket(mem_name, sizeof(struct dir16_8_8_tbl) +
+		DIR16_8_8_TBL16_NUM_ENT * sizeof(uint64_t), RTE_CACHE_LINE_SIZE,
+		socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	/* Init table with default value */
+	for (i = 0; i < DIR16_8_8_TBL16_NUM_ENT; i++)
+		dp->tbl16[i] = def_nh << 1;
+
+	dp->def_nh = def_nh;
+	dp->nh_sz = nh_sz;
+	dp->socket_id = socket_id;
+
+	return dp;
+}
+
+void
+dir16_8_8_free(void *p)
+{
+	struct dir16_8_8_tbl *dp = (struct dir16_8_8_tbl *)p;
+	uint32_t i;
+
+	if (dp->dq != NULL)
+		rte_rcu_qsbr_dq_delete(dp->dq);
+	for (i = 0; i < DIR16_8_8_TBL16_NUM_ENT; i++) {
+		if (dp->tbl16[i] & DIR16_8_8_EXT_ENT)
+			rte_free((void *)(uintptr_t)(dp->tbl16[i] &
+				~(uint64_t)DIR16_8_8_EXT_ENT));
+	}
+	rte_free(dp);
+}
+
+int
+dir16_8_8_rcu_qsbr_add(struct dir16_8_8_tbl *dp,
+	struct rte_fib_rcu_config *cfg, const char *name)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (dp == NULL || cfg == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (dp->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_FIB_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"FIB_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = DIR16_8_8_TBL16_NUM_ENT;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(void *);	/* block pointer */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			RTE_LOG(ERR, LPM, "FIB defer queue creation failed\n");
+			return 1;
+		}
+	} else {
+		rte_errno = EINVAL;
+		return 1;
+	}
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
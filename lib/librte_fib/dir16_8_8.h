@@ -0,0 +1,157 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#ifndef _DIR16_8_8_H_
+#define _DIR16_8_8_H_
+
+#include <rte_prefetch.h>
+#include <rte_branch_prediction.h>
+
+/**
+ * @file
+ * DIR16_8_8 algorithm with bitmap compressed levels
+ *
+ * tbl16 holds either a next hop or a pointer to a block describing
+ * the whole /16. A block starts with the node for bits 15..8 of
+ * the address, followed by the nodes for bits 7..0 of the /24s
+ * that have more specific routes, followed by the leaves.
+ * Every node splits its 256 entries into four chunks of 64, with
+ * one bit per entry in nodemap when the entry points to a child node
+ * and one bit in leafmap when the entry starts a new run of leaves.
+ * Child nodes and leaves of a chunk are stored contiguously, so the
+ * popcount of the bitmaps below an entry gives its position.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DIR16_8_8_TBL16_NUM_ENT		(1 << 16)
+#define DIR16_8_8_GRP_NUM_ENT		256U
+#define DIR16_8_8_CHUNK_NUM_ENT		64U
+#define DIR16_8_8_CHUNK_NUM		\
+	(DIR16_8_8_GRP_NUM_ENT / DIR16_8_8_CHUNK_NUM_ENT)
+#define DIR16_8_8_EXT_ENT		1
+
+struct dir16_8_8_chunk {
+	uint64_t	leafmap;	/**< Entries starting a run of leaves */
+	uint64_t	nodemap;	/**< Entries pointing to a child node */
+	/** Offset in the block of the leaf preceding the chunk runs */
+	uint32_t	leaf_off;
+	/** Offset in the block of the first child node of the chunk */
+	uint32_t	node_off;
+	uint64_t	rsvd;
+};
+
+struct dir16_8_8_node {
+	struct dir16_8_8_chunk	chunk[DIR16_8_8_CHUNK_NUM];
+};
+
+struct dir16_8_8_tbl {
+	uint64_t	def_nh;		/**< Default next hop */
+	enum rte_fib_dir24_8_nh_sz	nh_sz;	/**< Size of nexthop entry */
+	int		socket_id;	/**< Socket to allocate blocks on */
+	/* RCU config. */
+	struct rte_rcu_qsbr	*v;		/* RCU QSBR variable. */
+	enum rte_fib_qsbr_mode	rcu_mode;	/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq	*dq;		/* RCU QSBR defer queue. */
+	/* tbl16 table. */
+	__extension__ uint64_t	tbl16[0] __rte_cache_aligned;
+};
+
+static inline uint64_t
+dir16_8_8_get_max_nh(uint8_t nh_sz)
+{
+	return ((1ULL << ((8 << nh_sz) - 1)) - 1);
+}
+
+static inline const void *
+dir16_8_8_get_leaf(uint64_t ent, uint32_t ip, uint8_t nh_sz)
+{
+	const uint8_t *blk = (const uint8_t *)(uintptr_t)(ent &
+		~(uint64_t)DIR16_8_8_EXT_ENT);
+	const struct dir16_8_8_node *node;
+	const struct dir16_8_8_chunk *c;
+	uint32_t idx = (uint8_t)(ip >> 8);
+	uint64_t bit;
+
+	node = (const struct dir16_8_8_node *)blk;
+	c = &node->chunk[idx / DIR16_8_8_CHUNK_NUM_ENT];
+	bit = 1ULL << (idx % DIR16_8_8_CHUNK_NUM_ENT);
+	if (c->nodemap & bit) {
+		node = (const struct dir16_8_8_node *)(blk + c->node_off) +
+			__builtin_popcountll(c->nodemap & (bit - 1));
+		idx = (uint8_t)ip;
+		c = &node->chunk[idx / DIR16_8_8_CHUNK_NUM_ENT];
+		bit = 1ULL << (idx % DIR16_8_8_CHUNK_NUM_ENT);
+	}
+	return blk + c->leaf_off +
+		((uint32_t)__builtin_popcountll(c->leafmap &
+		((bit << 1) - 1)) << nh_sz);
+}
+
+#define DIR16_8_8_LOOKUP_FUNC(suffix, type, nh_sz)			\
+static inline void dir16_8_8_lookup_bulk_##suffix(void *p,		\
+	const uint32_t *ips, uint64_t *next_hops, const unsigned int n)	\
+{									\
+	struct dir16_8_8_tbl *dp = (struct dir16_8_8_tbl *)p;		\
+	uint64_t tmp;							\
+	uint32_t i;							\
+	uint32_t prefetch_offset = RTE_MIN(15U, n);			\
+									\
+	for (i = 0; i < prefetch_offset; i++)				\
+		rte_prefetch0(&dp->tbl16[ips[i] >> 16]);		\
+	for (i = 0; i < (n - prefetch_offset); i++) {			\
+		rte_prefetch0(&dp->tbl16[ips[i + prefetch_offset] >> 16]); \
+		tmp = dp->tbl16[ips[i] >> 16];				\
+		if (unlikely(tmp & DIR16_8_8_EXT_ENT))			\
+			next_hops[i] = *(const type *)			\
+				dir16_8_8_get_leaf(tmp, ips[i], nh_sz);	\
+		else							\
+			next_hops[i] = tmp >> 1;			\
+	}								\
+	for (; i < n; i++) {						\
+		tmp = dp->tbl16[ips[i] >> 16];				\
+		if (unlikely(tmp & DIR16_8_8_EXT_ENT))			\
+			next_hops[i] = *(const type *)			\
+				dir16_8_8_get_leaf(tmp, ips[i], nh_sz);	\
+		else							\
+			next_hops[i] = tmp >> 1;			\
+	}								\
+}									\
+
+DIR16_8_8_LOOKUP_FUNC(1b, uint8_t, 0)
+DIR16_8_8_LOOKUP_FUNC(2b, uint16_t, 1)
+DIR16_8_8_LOOKUP_FUNC(4b, uint32_t, 2)
+DIR16_8_8_LOOKUP_FUNC(8b, uint64_t, 3)
+
+void *
+dir16_8_8_create(const char *name, int socket_id, struct rte_fib_conf *conf);
+
+void
+dir16_8_8_free(void *p);
+
+rte_fib_lookup_fn_t
+dir16_8_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type);
+
+int
+dir16_8_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, int op);
+
+int
+dir16_8_8_add_bulk(struct rte_fib *fib, const struct rte_fib_route *routes,
+	unsigned int n);
+
+int
+dir16_8_8_rebuild(struct rte_fib *fib);
+
+int
+dir16_8_8_rcu_qsbr_add(struct dir16_8_8_tbl *dp,
+	struct rte_fib_rcu_config *cfg, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DIR16_8_8_H_ */
@@ -0,0 +1,185 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#include <stddef.h>
+
+#include <rte_vect.h>
+#include <rte_fib.h>
+
+#include "dir16_8_8.h"
+#include "dir16_8_8_avx512.h"
+
+/* Chunk fields are gathered with absolute addresses and these offsets */
+#define CHUNK_LEAFMAP	offsetof(struct dir16_8_8_chunk, leafmap)
+#define CHUNK_NODEMAP	offsetof(struct dir16_8_8_chunk, nodemap)
+/* leaf_off in the low and node_off in the high 32 bits */
+#define CHUNK_OFFS	offsetof(struct dir16_8_8_chunk, leaf_off)
+
+/*
+ * Number of set bits in every 64 bit lane.
+ * AVX512 VPOPCNTDQ is not required, count nibbles with a lookup table.
+ */
+static __rte_always_inline __m512i
+popcnt64(__m512i v)
+{
+	const __m512i lut = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 1, 2,
+		1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+	const __m512i nibble_msk = _mm512_set1_epi8(0x0f);
+	__m512i lo, hi;
+
+	lo = _mm512_shuffle_epi8(lut, _mm512_and_si512(v, nibble_msk));
+	hi = _mm512_shuffle_epi8(lut,
+		_mm512_and_si512(_mm512_srli_epi16(v, 4), nibble_msk));
+	return _mm512_sad_epu8(_mm512_add_epi8(lo, hi),
+		_mm512_setzero_si512());
+}
+
+/* Address of the chunk holding entry idx of a node and the entry bit */
+static __rte_always_inline __m512i
+get_chunk(__m512i node, __m512i idx, __m512i *bit)
+{
+	const __m512i one = _mm512_set1_epi64(1);
+	const __m512i chunk_ent_msk =
+		_mm512_set1_epi64(DIR16_8_8_CHUNK_NUM_ENT - 1);
+
+	*bit = _mm512_sllv_epi64(one, _mm512_and_si512(idx, chunk_ent_msk));
+	return _mm512_add_epi64(node, _mm512_slli_epi64(
+		_mm512_srli_epi64(idx, 6), 5));
+}
+
+static __rte_always_inline void
+dir16_8_8_vec_lookup_x8(void *p, const uint32_t *ips,
+	uint64_t *next_hops, int size)
+{
+	struct dir16_8_8_tbl *dp = (struct dir16_8_8_tbl *)p;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i one = _mm512_set1_epi64(1);
+	const __m512i lsbyte_msk = _mm512_set1_epi64(0xff);
+	const __m512i lsdword_msk = _mm512_set1_epi64(UINT32_MAX);
+	__m512i ip_vec, res, blk, chunk, child, bit, child_bit, map, offs;
+	__m512i leafmap, leaf, res_msk;
+	__m256i ip256;
+	__mmask8 msk_ext, msk_node;
+
+	/* used to mask gather values if size is 1/2 (8/16 bit next hops) */
+	if (size == sizeof(uint8_t))
+		res_msk = _mm512_set1_epi64(UINT8_MAX);
+	else if (size == sizeof(uint16_t))
+		res_msk = _mm512_set1_epi64(UINT16_MAX);
+	else
+		res_msk = lsdword_msk;
+
+	ip256 = _mm256_loadu_si256((const void *)ips);
+	ip_vec = _mm512_cvtepu32_epi64(ip256);
+
+	/* lookup in tbl16 */
+	res = _mm512_i32gather_epi64(_mm256_srli_epi32(ip256, 16),
+		(const void *)dp->tbl16, 8);
+
+	/* get extended entries */
+	msk_ext = _mm512_test_epi64_mask(res, one);
+	res = _mm512_srli_epi64(res, 1);
+	if (msk_ext == 0) {
+		_mm512_storeu_si512(next_hops, res);
+		return;
+	}
+
+	/* chunk of the root node for bits 15..8 */
+	blk = _mm512_slli_epi64(res, 1);
+	chunk = get_chunk(blk, _mm512_and_si512(_mm512_srli_epi64(ip_vec, 8),
+		lsbyte_msk), &bit);
+	map = _mm512_mask_i64gather_epi64(zero, msk_ext, chunk,
+		(const void *)CHUNK_NODEMAP, 1);
+	leafmap = _mm512_mask_i64gather_epi64(zero, msk_ext, chunk,
+		(const void *)CHUNK_LEAFMAP, 1);
+	offs = _mm512_mask_i64gather_epi64(zero, msk_ext, chunk,
+		(const void *)CHUNK_OFFS, 1);
+	msk_node = _mm512_mask_test_epi64_mask(msk_ext, map, bit);
+
+	/* switch to the chunk of the child node for bits 7..0 */
+	if (msk_node != 0) {
+		child = _mm512_add_epi64(blk, _mm512_srli_epi64(offs, 32));
+		child = _mm512_add_epi64(child, _mm512_slli_epi64(popcnt64(
+			_mm512_and_si512(map, _mm512_sub_epi64(bit, one))), 7));
+		child = get_chunk(child, _mm512_and_si512(ip_vec, lsbyte_msk),
+			&child_bit);
+		bit = _mm512_mask_mov_epi64(bit, msk_node, child_bit);
+		leafmap = _mm512_mask_i64gather_epi64(leafmap, msk_node, child,
+			(const void *)CHUNK_LEAFMAP, 1);
+		offs = _mm512_mask_i64gather_epi64(offs, msk_node, child,
+			(const void *)CHUNK_OFFS, 1);
+	}
+
+	/* position of the leaf is the number of runs up to the entry */
+	leaf = _mm512_add_epi64(blk, _mm512_and_si512(offs, lsdword_msk));
+	leafmap = _mm512_and_si512(leafmap,
+		_mm512_sub_epi64(_mm512_slli_epi64(bit, 1), one));
+	leaf = _mm512_add_epi64(leaf, _mm512_slli_epi64(popcnt64(leafmap),
+		__builtin_ctz(size)));
+
+	/* Put it inside branch to make compiler happy with -O0 */
+	if (size == sizeof(uint64_t))
+		leaf = _mm512_mask_i64gather_epi64(zero, msk_ext, leaf,
+			NULL, 1);
+	else {
+		leaf = _mm512_cvtepu32_epi64(_mm512_mask_i64gather_epi32(
+			_mm256_setzero_si256(), msk_ext, leaf, NULL, 1));
+		leaf = _mm512_and_si512(leaf, res_msk);
+	}
+
+	res = _mm512_mask_blend_epi64(msk_ext, res, leaf);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+void
+rte_dir16_8_8_vec_lookup_bulk_1b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++)
+		dir16_8_8_vec_lookup_x8(p, ips + i * 8, next_hops + i * 8,
+			sizeof(uint8_t));
+
+	dir16_8_8_lookup_bulk_1b(p, ips + i * 8, next_hops + i * 8,
+		n - i * 8);
+}
+
+void
+rte_dir16_8_8_vec_lookup_bulk_2b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++)
+		dir16_8_8_vec_lookup_x8(p, ips + i * 8, next_hops + i * 8,
+			sizeof(uint16_t));
+
+	dir16_8_8_lookup_bulk_2b(p, ips + i * 8, next_hops + i * 8,
+		n - i * 8);
+}
+
+void
+rte_dir16_8_8_vec_lookup_bulk_4b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++)
+		dir16_8_8_vec_lookup_x8(p, ips + i * 8, next_hops + i * 8,
+			sizeof(uint32_t));
+
+	dir16_8_8_lookup_bulk_4b(p, ips + i * 8, next_hops + i * 8,
+		n - i * 8);
+}
+
+void
+rte_dir16_8_8_vec_lookup_bulk_8b(void *p, const uint32_t *ips,
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++)
+		dir16_8_8_vec_lookup_x8(p, ips + i * 8, next_hops + i * 8,
+			sizeof(uint64_t));
+
+	dir16_8_8_lookup_bulk_8b(p, ips + i * 8, next_hops + i * 8,
+		n - i * 8);
+}
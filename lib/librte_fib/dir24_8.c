@@ -150,7 +150,7 @@ write_to_fib(void *ptr, uint64_t val, enum rte_fib_dir24_8_nh_sz size, int n)
 }
 
 static int
-tbl8_get_idx(struct dir24_8_tbl *dp)
+_tbl8_get_idx(struct dir24_8_tbl *dp)
 {
 	uint32_t i;
 	int bit_idx;
@@ -166,6 +166,20 @@ tbl8_get_idx(struct dir24_8_tbl *dp)
 	return -ENOSPC;
 }
 
+static int
+tbl8_get_idx(struct dir24_8_tbl *dp)
+{
+	int tbl8_idx;
+
+	tbl8_idx = _tbl8_get_idx(dp);
+	if ((tbl8_idx == -ENOSPC) && (dp->dq != NULL)) {
+		/* If there are no tbl8 groups try to reclaim one. */
+		if (rte_rcu_qsbr_dq_reclaim(dp->dq, 1, NULL, NULL, NULL) == 0)
+			tbl8_idx = _tbl8_get_idx(dp);
+	}
+	return tbl8_idx;
+}
+
 static inline void
 tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
 {
@@ -173,6 +187,55 @@ tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
 		~(1ULL << (idx & BITMAP_SLAB_BITMASK));
 }
 
+static void
+tbl8_cleanup_and_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
+{
+	uint8_t *ptr = (uint8_t *)dp->tbl8 +
+		((tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT) << dp->nh_sz);
+
+	memset(ptr, 0, DIR24_8_TBL8_GRP_NUM_ENT << dp->nh_sz);
+	tbl8_free_idx(dp, tbl8_idx);
+	dp->cur_tbl8s--;
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct dir24_8_tbl *dp = p;
+	uint64_t tbl8_idx = *(uint32_t *)data;
+
+	RTE_SET_USED(n);
+	tbl8_cleanup_and_free(dp, tbl8_idx);
+}
+
+/*
+ * Release a tbl8 group which is no longer referenced from tbl24.
+ * Readers may still be walking it, so with RCU configured
+ * the group is only recycled once they have all gone quiescent.
+ */
+static void
+tbl8_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
+{
+	uint32_t idx = tbl8_idx;
+
+	if (dp->v == NULL) {
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(dp->dq, (void *)&idx) != 0) {
+			RTE_LOG(ERR, LPM, "Failed to push QSBR FIFO\n");
+			/* Fall back to blocking reclaim instead of leaking */
+			rte_rcu_qsbr_synchronize(dp->v,
+				RTE_QSBR_THRID_INVALID);
+			tbl8_cleanup_and_free(dp, tbl8_idx);
+		}
+	}
+}
+
 static int
 tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 {
@@ -214,8 +277,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint8_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr8[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_2B:
 		ptr16 = &((uint16_t *)dp->tbl8)[tbl8_idx *
@@ -227,8 +288,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint16_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr16[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_4B:
 		ptr32 = &((uint32_t *)dp->tbl8)[tbl8_idx *
@@ -240,8 +299,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint32_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr32[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_8B:
 		ptr64 = &((uint64_t *)dp->tbl8)[tbl8_idx *
@@ -253,12 +310,9 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint64_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr64[i] = 0;
 		break;
 	}
-	tbl8_free_idx(dp, tbl8_idx);
-	dp->cur_tbl8s--;
+	tbl8_free(dp, tbl8_idx);
 }
 
 static int
@@ -496,6 +550,103 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	return -EINVAL;
 }
 
+/* State of a route during dir24_8_add_bulk() */
+#define BULK_RT_UNCHANGED	0
+#define BULK_RT_UPDATED		1
+#define BULK_RT_NEW		2
+
+int
+dir24_8_add_bulk(struct rte_fib *fib, const struct rte_fib_route *routes,
+	unsigned int n)
+{
+	struct dir24_8_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *tmp;
+	struct rte_rib_node *node;
+	uint64_t node_nh;
+	uint8_t *state;
+	uint32_t ip;
+	uint8_t depth;
+	unsigned int i, nb;
+	int ret = 0, err;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	for (i = 0; i < n; i++) {
+		if (routes[i].next_hop > get_max_nh(dp->nh_sz))
+			return -EINVAL;
+	}
+
+	state = rte_malloc(NULL, n, 0);
+	if (state == NULL)
+		return -ENOMEM;
+
+	/*
+	 * Put all the routes into the RIB first, reserving tbl8s the same
+	 * way dir24_8_modify() does. modify_fib() then skips the ranges
+	 * of more specific routes, so every tbl24/tbl8 entry is written
+	 * only for its longest matching prefix.
+	 */
+	for (nb = 0; nb < n; nb++) {
+		ip = routes[nb].ip;
+		depth = routes[nb].depth;
+		node = rte_rib_lookup_exact(rib, ip, depth);
+		if (node != NULL) {
+			rte_rib_get_nh(node, &node_nh);
+			state[nb] = (node_nh == routes[nb].next_hop) ?
+				BULK_RT_UNCHANGED : BULK_RT_UPDATED;
+			rte_rib_set_nh(node, routes[nb].next_hop);
+			continue;
+		}
+		tmp = NULL;
+		if (depth > 24) {
+			tmp = rte_rib_get_nxt(rib, ip, 24, NULL,
+				RTE_RIB_GET_NXT_COVER);
+			if ((tmp == NULL) &&
+					(dp->rsvd_tbl8s >= dp->number_tbl8s)) {
+				ret = -ENOSPC;
+				break;
+			}
+		}
+		node = rte_rib_insert(rib, ip, depth);
+		if (node == NULL) {
+			ret = -rte_errno;
+			break;
+		}
+		rte_rib_set_nh(node, routes[nb].next_hop);
+		if ((depth > 24) && (tmp == NULL))
+			dp->rsvd_tbl8s++;
+		state[nb] = BULK_RT_NEW;
+	}
+
+	/* Routes are sorted, so less specific ones are installed first */
+	for (i = 0; i < nb; i++) {
+		if (state[i] == BULK_RT_UNCHANGED)
+			continue;
+		ip = routes[i].ip;
+		depth = routes[i].depth;
+		err = modify_fib(dp, rib, ip, depth, routes[i].next_hop);
+		if (err == 0)
+			continue;
+		if (ret == 0)
+			ret = err;
+		if (state[i] != BULK_RT_NEW)
+			continue;
+		rte_rib_remove(rib, ip, depth);
+		if (depth > 24) {
+			tmp = rte_rib_get_nxt(rib, ip, 24, NULL,
+				RTE_RIB_GET_NXT_COVER);
+			if (tmp == NULL)
+				dp->rsvd_tbl8s--;
+		}
+	}
+
+	rte_free(state);
+	return ret;
+}
+
 void *
 dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
 {
@@ -567,7 +718,141 @@ dir24_8_free(void *p)
 {
 	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
 
+	if (dp->dq != NULL)
+		rte_rcu_qsbr_dq_delete(dp->dq);
 	rte_free(dp->tbl8_idxes);
 	rte_free(dp->tbl8);
 	rte_free(dp);
 }
+
+int
+dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (dp == NULL || cfg == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (dp->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_FIB_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"FIB_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = dp->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 group index */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			RTE_LOG(ERR, LPM, "FIB defer queue creation failed\n");
+			return 1;
+		}
+	} else {
+		rte_errno = EINVAL;
+		return 1;
+	}
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
+
+/*
+ * The dataplane snapshot starts at a page aligned file offset with
+ * struct dir24_8_snapshot padded to DIR24_8_SNAPSHOT_ALIGN, followed by
+ * tbl24 and tbl8 exactly as they are laid out in memory, so both tables
+ * start page aligned as well.
+ */
+#define DIR24_8_SNAPSHOT_ALIGN	4096
+
+struct dir24_8_snapshot {
+	uint32_t	number_tbl8s;
+	uint32_t	rsvd_tbl8s;
+	uint32_t	nh_sz;
+};
+
+static inline uint64_t
+get_tbl8_sz(struct dir24_8_tbl *dp)
+{
+	return ((uint64_t)DIR24_8_TBL8_GRP_NUM_ENT * (dp->number_tbl8s + 1)) <<
+		dp->nh_sz;
+}
+
+int
+dir24_8_save(struct dir24_8_tbl *dp, FILE *f)
+{
+	struct dir24_8_snapshot snap = {0};
+
+	snap.number_tbl8s = dp->number_tbl8s;
+	snap.rsvd_tbl8s = dp->rsvd_tbl8s;
+	snap.nh_sz = dp->nh_sz;
+
+	if ((fwrite(&snap, sizeof(snap), 1, f) != 1) ||
+			(fseek(f, DIR24_8_SNAPSHOT_ALIGN - sizeof(snap),
+			SEEK_CUR) != 0) ||
+			(fwrite(dp->tbl24, (uint64_t)DIR24_8_TBL24_NUM_ENT <<
+			dp->nh_sz, 1, f) != 1) ||
+			(fwrite(dp->tbl8, get_tbl8_sz(dp), 1, f) != 1))
+		return -EIO;
+
+	return 0;
+}
+
+int
+dir24_8_restore(struct dir24_8_tbl *dp, FILE *f)
+{
+	struct dir24_8_snapshot snap;
+	uint64_t ent;
+	uint32_t i, tbl8_idx;
+
+	if (fread(&snap, sizeof(snap), 1, f) != 1)
+		return -EIO;
+	if ((snap.number_tbl8s != dp->number_tbl8s) ||
+			(snap.nh_sz != dp->nh_sz) ||
+			(snap.rsvd_tbl8s > dp->number_tbl8s))
+		return -EINVAL;
+
+	if ((fseek(f, DIR24_8_SNAPSHOT_ALIGN - sizeof(snap),
+			SEEK_CUR) != 0) ||
+			(fread(dp->tbl24, (uint64_t)DIR24_8_TBL24_NUM_ENT <<
+			dp->nh_sz, 1, f) != 1) ||
+			(fread(dp->tbl8, get_tbl8_sz(dp), 1, f) != 1))
+		return -EIO;
+
+	/*
+	 * Rebuild the tbl8 bitmap from tbl24, groups that were waiting
+	 * for RCU reclamation when the snapshot was taken become free.
+	 */
+	dp->rsvd_tbl8s = snap.rsvd_tbl8s;
+	for (i = 0; i < DIR24_8_TBL24_NUM_ENT; i++) {
+		ent = get_tbl24(dp, i << 8, dp->nh_sz);
+		if (!is_entry_extended(ent))
+			continue;
+		tbl8_idx = ent >> 1;
+		if (tbl8_idx >= dp->number_tbl8s)
+			return -EINVAL;
+		dp->tbl8_idxes[tbl8_idx >> BITMAP_SLAB_BIT_SIZE_LOG2] |=
+			1ULL << (tbl8_idx & BITMAP_SLAB_BITMASK);
+		dp->cur_tbl8s++;
+	}
+
+	return 0;
+}
@@ -4,7 +4,10 @@
  */
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 
 #include <rte_eal.h>
 #include <rte_eal_memconfig.h>
@@ -18,6 +21,7 @@
 #include <rte_fib.h>
 
 #include "dir24_8.h"
+#include "dir16_8_8.h"
 
 TAILQ_HEAD(rte_fib_list, rte_tailq_entry);
 static struct rte_tailq_elem rte_fib_tailq = {
@@ -28,6 +32,11 @@ EAL_REGISTER_TAILQ(rte_fib_tailq)
 /* Maximum length of a FIB name. */
 #define RTE_FIB_NAMESIZE	64
 
+#define FIB_SNAPSHOT_MAGIC	0x34424946	/* "FIB4" */
+#define FIB_SNAPSHOT_VERSION	1
+/* Alignment of the dataplane part of a snapshot file */
+#define FIB_SNAPSHOT_ALIGN	4096
+
 #if defined(RTE_LIBRTE_FIB_DEBUG)
 #define FIB_RETURN_IF_TRUE(cond, retval) do {		\
 	if (cond)					\
@@ -45,6 +54,20 @@ struct rte_fib {
 	rte_fib_lookup_fn_t	lookup;	/**< fib lookup function */
 	rte_fib_modify_fn_t	modify; /**< modify fib datastruct */
 	uint64_t		def_nh;
+	struct rte_fib_conf	conf;	/**< creation parameters */
+};
+
+/* Header of a file written by rte_fib_save() */
+struct fib_snapshot_hdr {
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	type;
+	int32_t		max_routes;
+	uint64_t	def_nh;
+	uint32_t	nh_sz;
+	uint32_t	num_tbl8;
+	uint64_t	nb_routes;	/**< Routes following the header */
+	uint64_t	dp_offset;	/**< Offset of the dataplane part */
 };
 
 static void
@@ -111,6 +134,14 @@ init_dataplane(struct rte_fib *fib, __rte_unused int socket_id,
 			RTE_FIB_LOOKUP_DEFAULT);
 		fib->modify = dir24_8_modify;
 		return 0;
+	case RTE_FIB_DIR16_8_8:
+		fib->dp = dir16_8_8_create(dp_name, socket_id, conf);
+		if (fib->dp == NULL)
+			return -rte_errno;
+		fib->lookup = dir16_8_8_get_lookup_fn(fib->dp,
+			RTE_FIB_LOOKUP_DEFAULT);
+		fib->modify = dir16_8_8_modify;
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -135,6 +166,57 @@ rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth)
 	return fib->modify(fib, ip, depth, 0, RTE_FIB_DEL);
 }
 
+static int
+route_cmp(const void *a, const void *b)
+{
+	const struct rte_fib_route *r1 = a;
+	const struct rte_fib_route *r2 = b;
+
+	if (r1->ip != r2->ip)
+		return (r1->ip < r2->ip) ? -1 : 1;
+	return (int)r1->depth - (int)r2->depth;
+}
+
+int
+rte_fib_add_bulk(struct rte_fib *fib, struct rte_fib_route *routes,
+	unsigned int n)
+{
+	unsigned int i;
+	int ret;
+
+	if ((fib == NULL) || (fib->modify == NULL) ||
+			((routes == NULL) && (n != 0)))
+		return -EINVAL;
+
+	for (i = 0; i < n; i++) {
+		if (routes[i].depth > RTE_FIB_MAXDEPTH)
+			return -EINVAL;
+		routes[i].ip &= rte_rib_depth_to_mask(routes[i].depth);
+	}
+
+	/* Prefixes are followed by their more specific routes */
+	qsort(routes, n, sizeof(*routes), route_cmp);
+	for (i = 1; i < n; i++) {
+		if (route_cmp(&routes[i - 1], &routes[i]) == 0)
+			return -EINVAL;
+	}
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_add_bulk(fib, routes, n);
+	case RTE_FIB_DIR16_8_8:
+		return dir16_8_8_add_bulk(fib, routes, n);
+	default:
+		for (i = 0; i < n; i++) {
+			ret = fib->modify(fib, routes[i].ip, routes[i].depth,
+				routes[i].next_hop, RTE_FIB_ADD);
+			if (ret != 0)
+				return ret;
+		}
+		return 0;
+	}
+}
+
 int
 rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
 	uint64_t *next_hops, int n)
@@ -159,7 +241,7 @@ rte_fib_create(const char *name, int socket_id, struct rte_fib_conf *conf)
 
 	/* Check user arguments. */
 	if ((name == NULL) || (conf == NULL) ||	(conf->max_routes < 0) ||
-			(conf->type > RTE_FIB_DIR24_8)) {
+			(conf->type > RTE_FIB_DIR16_8_8)) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
@@ -213,6 +295,7 @@ rte_fib_create(const char *name, int socket_id, struct rte_fib_conf *conf)
 	fib->rib = rib;
 	fib->type = conf->type;
 	fib->def_nh = conf->default_nh;
+	fib->conf = *conf;
 	ret = init_dataplane(fib, socket_id, conf);
 	if (ret < 0) {
 		RTE_LOG(ERR, LPM,
@@ -273,6 +356,10 @@ free_dataplane(struct rte_fib *fib)
 		return;
 	case RTE_FIB_DIR24_8:
 		dir24_8_free(fib->dp);
+		return;
+	case RTE_FIB_DIR16_8_8:
+		dir16_8_8_free(fib->dp);
+		return;
 	default:
 		return;
 	}
@@ -332,7 +419,221 @@ rte_fib_select_lookup(struct rte_fib *fib,
 			return -EINVAL;
 		fib->lookup = fn;
 		return 0;
+	case RTE_FIB_DIR16_8_8:
+		fn = dir16_8_8_get_lookup_fn(fib->dp, type);
+		if (fn == NULL)
+			return -EINVAL;
+		fib->lookup = fn;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg)
+{
+	struct rte_rib_rcu_config rib_cfg = {0};
+
+	if ((fib == NULL) || (cfg == NULL)) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	case RTE_FIB_DIR16_8_8:
+		return dir16_8_8_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	case RTE_FIB_DUMMY:
+		/* Lookups walk the RIB, so its nodes need protection */
+		if (cfg->mode == RTE_FIB_QSBR_MODE_DQ)
+			rib_cfg.mode = RTE_RIB_QSBR_MODE_DQ;
+		else if (cfg->mode == RTE_FIB_QSBR_MODE_SYNC)
+			rib_cfg.mode = RTE_RIB_QSBR_MODE_SYNC;
+		else {
+			rte_errno = EINVAL;
+			return 1;
+		}
+		rib_cfg.v = cfg->v;
+		rib_cfg.dq_size = cfg->dq_size;
+		rib_cfg.reclaim_thd = cfg->reclaim_thd;
+		rib_cfg.reclaim_max = cfg->reclaim_max;
+		return rte_rib_rcu_qsbr_add(fib->rib, &rib_cfg);
 	default:
+		rte_errno = EINVAL;
+		return 1;
+	}
+}
+
+static int
+save_route(FILE *f, struct rte_rib_node *node)
+{
+	struct rte_fib_route rt = {0};
+
+	rte_rib_get_ip(node, &rt.ip);
+	rte_rib_get_depth(node, &rt.depth);
+	rte_rib_get_nh(node, &rt.next_hop);
+	return (fwrite(&rt, sizeof(rt), 1, f) == 1) ? 0 : -EIO;
+}
+
+int
+rte_fib_save(struct rte_fib *fib, const char *path)
+{
+	struct fib_snapshot_hdr hdr = {0};
+	struct rte_rib_node *node;
+	FILE *f;
+	long off;
+	int ret = 0;
+
+	if ((fib == NULL) || (path == NULL))
 		return -EINVAL;
+
+	f = fopen(path, "w");
+	if (f == NULL)
+		return -errno;
+
+	hdr.magic = FIB_SNAPSHOT_MAGIC;
+	hdr.version = FIB_SNAPSHOT_VERSION;
+	hdr.type = fib->type;
+	hdr.max_routes = fib->conf.max_routes;
+	hdr.def_nh = fib->def_nh;
+	if (fib->type == RTE_FIB_DIR24_8) {
+		hdr.nh_sz = fib->conf.dir24_8.nh_sz;
+		hdr.num_tbl8 = fib->conf.dir24_8.num_tbl8;
+	} else if (fib->type == RTE_FIB_DIR16_8_8)
+		hdr.nh_sz = fib->conf.dir16_8_8.nh_sz;
+
+	/* Written again once the number of routes is known */
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1) {
+		ret = -EIO;
+		goto exit;
+	}
+
+	/* get_nxt() only returns more specific routes than 0/0 */
+	node = rte_rib_lookup_exact(fib->rib, 0, 0);
+	if (node != NULL) {
+		ret = save_route(f, node);
+		hdr.nb_routes++;
+	}
+	node = NULL;
+	while ((ret == 0) && ((node = rte_rib_get_nxt(fib->rib, 0, 0,
+			node, RTE_RIB_GET_NXT_ALL)) != NULL)) {
+		ret = save_route(f, node);
+		hdr.nb_routes++;
+	}
+	if (ret != 0)
+		goto exit;
+
+	if (fib->type == RTE_FIB_DIR24_8) {
+		off = ftell(f);
+		if (off < 0) {
+			ret = -EIO;
+			goto exit;
+		}
+		hdr.dp_offset = RTE_ALIGN_CEIL((uint64_t)off,
+			FIB_SNAPSHOT_ALIGN);
+		if (fseek(f, hdr.dp_offset, SEEK_SET) != 0) {
+			ret = -EIO;
+			goto exit;
+		}
+		ret = dir24_8_save(fib->dp, f);
+		if (ret != 0)
+			goto exit;
+	}
+
+	if ((fseek(f, 0, SEEK_SET) != 0) ||
+			(fwrite(&hdr, sizeof(hdr), 1, f) != 1))
+		ret = -EIO;
+exit:
+	if ((fclose(f) != 0) && (ret == 0))
+		ret = -EIO;
+	if (ret != 0)
+		remove(path);
+	return ret;
+}
+
+struct rte_fib *
+rte_fib_restore(const char *name, int socket_id, const char *path)
+{
+	struct fib_snapshot_hdr hdr;
+	struct rte_fib_conf conf = {0};
+	struct rte_fib_route rt;
+	struct rte_rib_node *node;
+	struct rte_fib *fib = NULL;
+	uint64_t i;
+	FILE *f;
+	int ret = 0;
+
+	if ((name == NULL) || (path == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	f = fopen(path, "r");
+	if (f == NULL) {
+		rte_errno = errno;
+		return NULL;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1) {
+		ret = -EIO;
+		goto exit;
+	}
+	if ((hdr.magic != FIB_SNAPSHOT_MAGIC) ||
+			(hdr.version != FIB_SNAPSHOT_VERSION)) {
+		RTE_LOG(ERR, LPM, "%s is not a FIB snapshot\n", path);
+		ret = -EINVAL;
+		goto exit;
 	}
+
+	conf.type = hdr.type;
+	conf.default_nh = hdr.def_nh;
+	conf.max_routes = hdr.max_routes;
+	if (conf.type == RTE_FIB_DIR24_8) {
+		conf.dir24_8.nh_sz = hdr.nh_sz;
+		conf.dir24_8.num_tbl8 = hdr.num_tbl8;
+	} else if (conf.type == RTE_FIB_DIR16_8_8)
+		conf.dir16_8_8.nh_sz = hdr.nh_sz;
+
+	fib = rte_fib_create(name, socket_id, &conf);
+	if (fib == NULL) {
+		ret = -rte_errno;
+		goto exit;
+	}
+
+	/* Only the RIB is rebuilt, the dataplane is read back below */
+	for (i = 0; i < hdr.nb_routes; i++) {
+		if (fread(&rt, sizeof(rt), 1, f) != 1) {
+			ret = -EIO;
+			goto exit;
+		}
+		if (rt.depth > RTE_FIB_MAXDEPTH) {
+			ret = -EINVAL;
+			goto exit;
+		}
+		node = rte_rib_insert(fib->rib, rt.ip, rt.depth);
+		if (node == NULL) {
+			ret = -rte_errno;
+			goto exit;
+		}
+		rte_rib_set_nh(node, rt.next_hop);
+	}
+
+	if (fib->type == RTE_FIB_DIR24_8) {
+		if (fseek(f, hdr.dp_offset, SEEK_SET) != 0) {
+			ret = -EIO;
+			goto exit;
+		}
+		ret = dir24_8_restore(fib->dp, f);
+	} else if (fib->type == RTE_FIB_DIR16_8_8)
+		ret = dir16_8_8_rebuild(fib);
+exit:
+	fclose(f);
+	if (ret != 0) {
+		rte_fib_free(fib);
+		rte_errno = -ret;
+		return NULL;
+	}
+	return fib;
 }
@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,7 +37,8 @@ struct rte_rib;
 /** Type of FIB struct */
 enum rte_fib_type {
 	RTE_FIB_DUMMY,		/**< RIB tree based FIB */
-	RTE_FIB_DIR24_8		/**< DIR24_8 based FIB */
+	RTE_FIB_DIR24_8,	/**< DIR24_8 based FIB */
+	RTE_FIB_DIR16_8_8	/**< DIR16_8_8 FIB with compressed levels */
 };
 
 /** Modify FIB function */
@@ -51,7 +53,7 @@ enum rte_fib_op {
 	RTE_FIB_DEL,
 };
 
-/** Size of nexthop (1 << nh_sz) bits for DIR24_8 based FIB */
+/** Size of nexthop (1 << nh_sz) bits for DIR24_8 and DIR16_8_8 FIB */
 enum rte_fib_dir24_8_nh_sz {
 	RTE_FIB_DIR24_8_1B,
 	RTE_FIB_DIR24_8_2B,
@@ -74,8 +76,12 @@ enum rte_fib_lookup_type {
 	/**<
 	 * Unified lookup function for all next hop sizes
 	 */
-	RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512
+	RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512,
 	/**< Vector implementation using AVX512 */
+	RTE_FIB_LOOKUP_DIR16_8_8_SCALAR,
+	/**< Scalar DIR16_8_8 lookup function */
+	RTE_FIB_LOOKUP_DIR16_8_8_VECTOR_AVX512
+	/**< DIR16_8_8 vector implementation using AVX512 */
 };
 
 /** FIB configuration structure */
@@ -89,9 +95,46 @@ struct rte_fib_conf {
 			enum rte_fib_dir24_8_nh_sz nh_sz;
 			uint32_t	num_tbl8;
 		} dir24_8;
+		struct {
+			enum rte_fib_dir24_8_nh_sz nh_sz;
+		} dir16_8_8;
 	};
 };
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_FIB_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_fib_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_FIB_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_FIB_QSBR_MODE_SYNC
+};
+
+/** FIB RCU QSBR configuration structure. */
+struct rte_fib_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_FIB_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_fib_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: number of tbl8 groups.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_FIB_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
+/** Route description used by rte_fib_add_bulk() */
+struct rte_fib_route {
+	uint32_t	ip;		/**< IPv4 prefix address */
+	uint8_t		depth;		/**< Prefix length */
+	uint64_t	next_hop;	/**< Next hop */
+};
+
 /**
  * Create FIB
  *
@@ -169,6 +212,31 @@ __rte_experimental
 int
 rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth);
 
+/**
+ * Add a list of routes to the FIB.
+ *
+ * The result is the same as calling rte_fib_add() for every route, but
+ * the routes are sorted and put into the RIB first, so the dataplane
+ * structures are built in a single pass instead of rewriting the ranges
+ * of overlapping prefixes once per route.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param routes
+ *   Array of routes. It is sorted in place and the addresses are masked
+ *   with their prefix length.
+ * @param n
+ *   Number of routes in the array
+ * @return
+ *   0 on success, negative value otherwise. The same prefix given twice
+ *   is rejected with -EINVAL before anything is added, on other errors
+ *   part of the routes may have been added.
+ */
+__rte_experimental
+int
+rte_fib_add_bulk(struct rte_fib *fib, struct rte_fib_route *routes,
+	unsigned int n);
+
 /**
  * Lookup multiple IP addresses in the FIB.
  *
@@ -232,6 +300,74 @@ __rte_experimental
 int
 rte_fib_select_lookup(struct rte_fib *fib, enum rte_fib_lookup_type type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a FIB object.
+ *
+ * For a DIR24_8 FIB the released tbl8 groups are not reused until all the
+ * readers registered with the QSBR variable have reported a quiescent
+ * state, the same applies to the per /16 blocks of a DIR16_8_8 FIB.
+ * For a RIB based (dummy) FIB the variable is passed down to the
+ * underlying RIB, which defers the release of the tree nodes.
+ *
+ * @param fib
+ *   the fib object to add RCU QSBR
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   On success - 0
+ *   On error - 1 with error code set in rte_errno.
+ *   Possible rte_errno codes are:
+ *   - EINVAL - invalid pointer
+ *   - EEXIST - already added QSBR
+ *   - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg);
+
+/**
+ * Save the FIB into a file.
+ *
+ * The file holds the FIB configuration, the routes of the RIB and,
+ * for a DIR24_8 FIB, the tbl24 and tbl8 tables at page aligned offsets.
+ * A DIR16_8_8 FIB is rebuilt from the routes on restore.
+ * It can only be restored by the same DPDK version on the same
+ * architecture. Must not be called concurrently with FIB updates.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param path
+ *   Path to the file, it is created or truncated
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_fib_save(struct rte_fib *fib, const char *path);
+
+/**
+ * Create a FIB from a file written by rte_fib_save().
+ *
+ * The dataplane tables are read back as they are, only the RIB is
+ * rebuilt, which is much faster than adding the routes again.
+ *
+ * @param name
+ *  FIB name
+ * @param socket_id
+ *  NUMA socket ID for FIB table memory allocation
+ * @param path
+ *  Path to the file
+ * @return
+ *  Handle to the FIB object on success
+ *  NULL otherwise with rte_errno set to an appropriate values.
+ */
+__rte_experimental
+struct rte_fib *
+rte_fib_restore(const char *name, int socket_id, const char *path);
+
 #ifdef __cplusplus
 }
 #endif
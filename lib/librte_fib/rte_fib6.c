@@ -4,7 +4,10 @@
  */
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 
 #include <rte_eal.h>
 #include <rte_eal_memconfig.h>
@@ -28,6 +31,11 @@ EAL_REGISTER_TAILQ(rte_fib6_tailq)
 /* Maximum length of a FIB name. */
 #define FIB6_NAMESIZE	64
 
+#define FIB6_SNAPSHOT_MAGIC	0x36424946	/* "FIB6" */
+#define FIB6_SNAPSHOT_VERSION	1
+/* Alignment of the dataplane part of a snapshot file */
+#define FIB6_SNAPSHOT_ALIGN	4096
+
 #if defined(RTE_LIBRTE_FIB_DEBUG)
 #define FIB6_RETURN_IF_TRUE(cond, retval) do {		\
 	if (cond)					\
@@ -45,6 +53,20 @@ struct rte_fib6 {
 	rte_fib6_lookup_fn_t	lookup;	/**< fib lookup function */
 	rte_fib6_modify_fn_t	modify; /**< modify fib datastruct */
 	uint64_t		def_nh;
+	struct rte_fib6_conf	conf;	/**< creation parameters */
+};
+
+/* Header of a file written by rte_fib6_save() */
+struct fib6_snapshot_hdr {
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	type;
+	int32_t		max_routes;
+	uint64_t	def_nh;
+	uint32_t	nh_sz;
+	uint32_t	num_tbl8;
+	uint64_t	nb_routes;	/**< Routes following the header */
+	uint64_t	dp_offset;	/**< Offset of the dataplane part */
 };
 
 static void
@@ -136,6 +158,58 @@ rte_fib6_delete(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	return fib->modify(fib, ip, depth, 0, RTE_FIB6_DEL);
 }
 
+static int
+route_cmp(const void *a, const void *b)
+{
+	const struct rte_fib6_route *r1 = a;
+	const struct rte_fib6_route *r2 = b;
+	int ret;
+
+	ret = memcmp(r1->ip, r2->ip, RTE_FIB6_IPV6_ADDR_SIZE);
+	if (ret != 0)
+		return ret;
+	return (int)r1->depth - (int)r2->depth;
+}
+
+int
+rte_fib6_add_bulk(struct rte_fib6 *fib, struct rte_fib6_route *routes,
+	unsigned int n)
+{
+	unsigned int i;
+	int j, ret;
+
+	if ((fib == NULL) || (fib->modify == NULL) ||
+			((routes == NULL) && (n != 0)))
+		return -EINVAL;
+
+	for (i = 0; i < n; i++) {
+		if (routes[i].depth > RTE_FIB6_MAXDEPTH)
+			return -EINVAL;
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			routes[i].ip[j] &= get_msk_part(routes[i].depth, j);
+	}
+
+	/* Prefixes are followed by their more specific routes */
+	qsort(routes, n, sizeof(*routes), route_cmp);
+	for (i = 1; i < n; i++) {
+		if (route_cmp(&routes[i - 1], &routes[i]) == 0)
+			return -EINVAL;
+	}
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		return trie_add_bulk(fib, routes, n);
+	default:
+		for (i = 0; i < n; i++) {
+			ret = fib->modify(fib, routes[i].ip, routes[i].depth,
+				routes[i].next_hop, RTE_FIB6_ADD);
+			if (ret != 0)
+				return ret;
+		}
+		return 0;
+	}
+}
+
 int
 rte_fib6_lookup_bulk(struct rte_fib6 *fib,
 	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
@@ -214,6 +288,7 @@ rte_fib6_create(const char *name, int socket_id, struct rte_fib6_conf *conf)
 	fib->rib = rib;
 	fib->type = conf->type;
 	fib->def_nh = conf->default_nh;
+	fib->conf = *conf;
 	ret = init_dataplane(fib, socket_id, conf);
 	if (ret < 0) {
 		RTE_LOG(ERR, LPM,
@@ -337,3 +412,207 @@ rte_fib6_select_lookup(struct rte_fib6 *fib,
 		return -EINVAL;
 	}
 }
+
+int
+rte_fib6_rcu_qsbr_add(struct rte_fib6 *fib, struct rte_fib6_rcu_config *cfg)
+{
+	struct rte_rib6_rcu_config rib_cfg = {0};
+
+	if ((fib == NULL) || (cfg == NULL)) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	switch (fib->type) {
+	case RTE_FIB6_TRIE:
+		return trie_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	case RTE_FIB6_DUMMY:
+		/* Lookups walk the RIB, so its nodes need protection */
+		if (cfg->mode == RTE_FIB6_QSBR_MODE_DQ)
+			rib_cfg.mode = RTE_RIB6_QSBR_MODE_DQ;
+		else if (cfg->mode == RTE_FIB6_QSBR_MODE_SYNC)
+			rib_cfg.mode = RTE_RIB6_QSBR_MODE_SYNC;
+		else {
+			rte_errno = EINVAL;
+			return 1;
+		}
+		rib_cfg.v = cfg->v;
+		rib_cfg.dq_size = cfg->dq_size;
+		rib_cfg.reclaim_thd = cfg->reclaim_thd;
+		rib_cfg.reclaim_max = cfg->reclaim_max;
+		return rte_rib6_rcu_qsbr_add(fib->rib, &rib_cfg);
+	default:
+		rte_errno = EINVAL;
+		return 1;
+	}
+}
+
+static int
+save_route(FILE *f, struct rte_rib6_node *node)
+{
+	struct rte_fib6_route rt = {0};
+
+	rte_rib6_get_ip(node, rt.ip);
+	rte_rib6_get_depth(node, &rt.depth);
+	rte_rib6_get_nh(node, &rt.next_hop);
+	return (fwrite(&rt, sizeof(rt), 1, f) == 1) ? 0 : -EIO;
+}
+
+int
+rte_fib6_save(struct rte_fib6 *fib, const char *path)
+{
+	struct fib6_snapshot_hdr hdr = {0};
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	struct rte_rib6_node *node;
+	FILE *f;
+	long off;
+	int ret = 0;
+
+	if ((fib == NULL) || (path == NULL))
+		return -EINVAL;
+
+	f = fopen(path, "w");
+	if (f == NULL)
+		return -errno;
+
+	hdr.magic = FIB6_SNAPSHOT_MAGIC;
+	hdr.version = FIB6_SNAPSHOT_VERSION;
+	hdr.type = fib->type;
+	hdr.max_routes = fib->conf.max_routes;
+	hdr.def_nh = fib->def_nh;
+	if (fib->type == RTE_FIB6_TRIE) {
+		hdr.nh_sz = fib->conf.trie.nh_sz;
+		hdr.num_tbl8 = fib->conf.trie.num_tbl8;
+	}
+
+	/* Written again once the number of routes is known */
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1) {
+		ret = -EIO;
+		goto exit;
+	}
+
+	/* get_nxt() only returns more specific routes than ::/0 */
+	node = rte_rib6_lookup_exact(fib->rib, ip, 0);
+	if (node != NULL) {
+		ret = save_route(f, node);
+		hdr.nb_routes++;
+	}
+	node = NULL;
+	while ((ret == 0) && ((node = rte_rib6_get_nxt(fib->rib, ip, 0,
+			node, RTE_RIB6_GET_NXT_ALL)) != NULL)) {
+		ret = save_route(f, node);
+		hdr.nb_routes++;
+	}
+	if (ret != 0)
+		goto exit;
+
+	if (fib->type == RTE_FIB6_TRIE) {
+		off = ftell(f);
+		if (off < 0) {
+			ret = -EIO;
+			goto exit;
+		}
+		hdr.dp_offset = RTE_ALIGN_CEIL((uint64_t)off,
+			FIB6_SNAPSHOT_ALIGN);
+		if (fseek(f, hdr.dp_offset, SEEK_SET) != 0) {
+			ret = -EIO;
+			goto exit;
+		}
+		ret = trie_save(fib->dp, f);
+		if (ret != 0)
+			goto exit;
+	}
+
+	if ((fseek(f, 0, SEEK_SET) != 0) ||
+			(fwrite(&hdr, sizeof(hdr), 1, f) != 1))
+		ret = -EIO;
+exit:
+	if ((fclose(f) != 0) && (ret == 0))
+		ret = -EIO;
+	if (ret != 0)
+		remove(path);
+	return ret;
+}
+
+struct rte_fib6 *
+rte_fib6_restore(const char *name, int socket_id, const char *path)
+{
+	struct fib6_snapshot_hdr hdr;
+	struct rte_fib6_conf conf = {0};
+	struct rte_fib6_route rt;
+	struct rte_rib6_node *node;
+	struct rte_fib6 *fib = NULL;
+	uint64_t i;
+	FILE *f;
+	int ret = 0;
+
+	if ((name == NULL) || (path == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	f = fopen(path, "r");
+	if (f == NULL) {
+		rte_errno = errno;
+		return NULL;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1) {
+		ret = -EIO;
+		goto exit;
+	}
+	if ((hdr.magic != FIB6_SNAPSHOT_MAGIC) ||
+			(hdr.version != FIB6_SNAPSHOT_VERSION)) {
+		RTE_LOG(ERR, LPM, "%s is not a FIB6 snapshot\n", path);
+		ret = -EINVAL;
+		goto exit;
+	}
+
+	conf.type = hdr.type;
+	conf.default_nh = hdr.def_nh;
+	conf.max_routes = hdr.max_routes;
+	if (conf.type == RTE_FIB6_TRIE) {
+		conf.trie.nh_sz = hdr.nh_sz;
+		conf.trie.num_tbl8 = hdr.num_tbl8;
+	}
+
+	fib = rte_fib6_create(name, socket_id, &conf);
+	if (fib == NULL) {
+		ret = -rte_errno;
+		goto exit;
+	}
+
+	/* Only the RIB is rebuilt, the dataplane is read back below */
+	for (i = 0; i < hdr.nb_routes; i++) {
+		if (fread(&rt, sizeof(rt), 1, f) != 1) {
+			ret = -EIO;
+			goto exit;
+		}
+		if (rt.depth > RTE_FIB6_MAXDEPTH) {
+			ret = -EINVAL;
+			goto exit;
+		}
+		node = rte_rib6_insert(fib->rib, rt.ip, rt.depth);
+		if (node == NULL) {
+			ret = -rte_errno;
+			goto exit;
+		}
+		rte_rib6_set_nh(node, rt.next_hop);
+	}
+
+	if (fib->type == RTE_FIB6_TRIE) {
+		if (fseek(f, hdr.dp_offset, SEEK_SET) != 0) {
+			ret = -EIO;
+			goto exit;
+		}
+		ret = trie_restore(fib->dp, f);
+	}
+exit:
+	fclose(f);
+	if (ret != 0) {
+		rte_fib6_free(fib);
+		rte_errno = -ret;
+		return NULL;
+	}
+	return fib;
+}
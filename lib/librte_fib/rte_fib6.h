@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -83,6 +84,40 @@ struct rte_fib6_conf {
 	};
 };
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_FIB6_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_fib6_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_FIB6_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_FIB6_QSBR_MODE_SYNC
+};
+
+/** FIB RCU QSBR configuration structure. */
+struct rte_fib6_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_FIB6_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_fib6_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: number of tbl8 groups.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_FIB6_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
+/** Route description used by rte_fib6_add_bulk() */
+struct rte_fib6_route {
+	uint8_t		ip[RTE_FIB6_IPV6_ADDR_SIZE];	/**< Prefix address */
+	uint8_t		depth;		/**< Prefix length */
+	uint64_t	next_hop;	/**< Next hop */
+};
+
 /**
  * Create FIB
  *
@@ -162,6 +197,31 @@ int
 rte_fib6_delete(struct rte_fib6 *fib,
 	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth);
 
+/**
+ * Add a list of routes to the FIB.
+ *
+ * The result is the same as calling rte_fib6_add() for every route, but
+ * the routes are sorted and put into the RIB first, so the dataplane
+ * structures are built in a single pass instead of rewriting the ranges
+ * of overlapping prefixes once per route.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param routes
+ *   Array of routes. It is sorted in place and the addresses are masked
+ *   with their prefix length.
+ * @param n
+ *   Number of routes in the array
+ * @return
+ *   0 on success, negative value otherwise. The same prefix given twice
+ *   is rejected with -EINVAL before anything is added, on other errors
+ *   part of the routes may have been added.
+ */
+__rte_experimental
+int
+rte_fib6_add_bulk(struct rte_fib6 *fib, struct rte_fib6_route *routes,
+	unsigned int n);
+
 /**
  * Lookup multiple IP addresses in the FIB.
  *
@@ -227,6 +287,72 @@ __rte_experimental
 int
 rte_fib6_select_lookup(struct rte_fib6 *fib, enum rte_fib6_lookup_type type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a FIB object.
+ *
+ * For a TRIE FIB the released tbl8 groups are not reused until all the
+ * readers registered with the QSBR variable have reported a quiescent
+ * state. For a RIB based (dummy) FIB the variable is passed down to
+ * the underlying RIB, which defers the release of the tree nodes.
+ *
+ * @param fib
+ *   the fib object to add RCU QSBR
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   On success - 0
+ *   On error - 1 with error code set in rte_errno.
+ *   Possible rte_errno codes are:
+ *   - EINVAL - invalid pointer
+ *   - EEXIST - already added QSBR
+ *   - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int
+rte_fib6_rcu_qsbr_add(struct rte_fib6 *fib, struct rte_fib6_rcu_config *cfg);
+
+/**
+ * Save the FIB into a file.
+ *
+ * The file holds the FIB configuration, the routes of the RIB and,
+ * for a TRIE FIB, the tbl24 and tbl8 tables at page aligned offsets.
+ * It can only be restored by the same DPDK version on the same
+ * architecture. Must not be called concurrently with FIB updates.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param path
+ *   Path to the file, it is created or truncated
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_fib6_save(struct rte_fib6 *fib, const char *path);
+
+/**
+ * Create a FIB from a file written by rte_fib6_save().
+ *
+ * The dataplane tables are read back as they are, only the RIB is
+ * rebuilt, which is much faster than adding the routes again.
+ *
+ * @param name
+ *  FIB name
+ * @param socket_id
+ *  NUMA socket ID for FIB table memory allocation
+ * @param path
+ *  Path to the file
+ * @return
+ *  Handle to the FIB object on success
+ *  NULL otherwise with rte_errno set to an appropriate values.
+ */
+__rte_experimental
+struct rte_fib6 *
+rte_fib6_restore(const char *name, int socket_id, const char *path);
+
 #ifdef __cplusplus
 }
 #endif
@@ -136,7 +136,7 @@ tbl8_pool_init(struct rte_trie_tbl *dp)
  * Get an index of a free tbl8 from the pool
  */
 static inline int32_t
-tbl8_get(struct rte_trie_tbl *dp)
+_tbl8_get(struct rte_trie_tbl *dp)
 {
 	if (dp->tbl8_pool_pos == dp->number_tbl8s)
 		/* no more free tbl8 */
@@ -146,6 +146,20 @@ tbl8_get(struct rte_trie_tbl *dp)
 	return dp->tbl8_pool[dp->tbl8_pool_pos++];
 }
 
+static inline int32_t
+tbl8_get(struct rte_trie_tbl *dp)
+{
+	int32_t tbl8_idx;
+
+	tbl8_idx = _tbl8_get(dp);
+	if ((tbl8_idx == -ENOSPC) && (dp->dq != NULL)) {
+		/* If there are no tbl8 groups try to reclaim one. */
+		if (rte_rcu_qsbr_dq_reclaim(dp->dq, 1, NULL, NULL, NULL) == 0)
+			tbl8_idx = _tbl8_get(dp);
+	}
+	return tbl8_idx;
+}
+
 /*
  * Put an index of a free tbl8 back to the pool
  */
@@ -155,6 +169,54 @@ tbl8_put(struct rte_trie_tbl *dp, uint32_t tbl8_ind)
 	dp->tbl8_pool[--dp->tbl8_pool_pos] = tbl8_ind;
 }
 
+static void
+tbl8_cleanup_and_free(struct rte_trie_tbl *dp, uint64_t tbl8_idx)
+{
+	uint8_t *ptr = (uint8_t *)dp->tbl8 +
+		((tbl8_idx * TRIE_TBL8_GRP_NUM_ENT) << dp->nh_sz);
+
+	memset(ptr, 0, TRIE_TBL8_GRP_NUM_ENT << dp->nh_sz);
+	tbl8_put(dp, tbl8_idx);
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct rte_trie_tbl *dp = p;
+	uint64_t tbl8_idx = *(uint32_t *)data;
+
+	RTE_SET_USED(n);
+	tbl8_cleanup_and_free(dp, tbl8_idx);
+}
+
+/*
+ * Release a tbl8 group once its parent entry no longer points to it.
+ * Readers may still be walking it, so with RCU configured
+ * the group is only recycled once they have all gone quiescent.
+ */
+static void
+tbl8_free(struct rte_trie_tbl *dp, uint64_t tbl8_idx)
+{
+	uint32_t idx = tbl8_idx;
+
+	if (dp->v == NULL) {
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB6_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB6_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(dp->dq, (void *)&idx) != 0) {
+			RTE_LOG(ERR, LPM, "Failed to push QSBR FIFO\n");
+			/* Fall back to blocking reclaim instead of leaking */
+			rte_rcu_qsbr_synchronize(dp->v,
+				RTE_QSBR_THRID_INVALID);
+			tbl8_cleanup_and_free(dp, tbl8_idx);
+		}
+	}
+}
+
 static int
 tbl8_alloc(struct rte_trie_tbl *dp, uint64_t nh)
 {
@@ -172,7 +234,13 @@ tbl8_alloc(struct rte_trie_tbl *dp, uint64_t nh)
 	return tbl8_idx;
 }
 
-static void
+/*
+ * Collapse a tbl8 group into its parent entry if all its entries are
+ * the same. Returns 1 if the group became unused, the caller is then
+ * responsible for releasing it with tbl8_free() once the parent entry
+ * has been updated.
+ */
+static int
 tbl8_recycle(struct rte_trie_tbl *dp, void *par, uint64_t tbl8_idx)
 {
 	uint32_t i;
@@ -187,45 +255,39 @@ tbl8_recycle(struct rte_trie_tbl *dp, void *par, uint64_t tbl8_idx)
 				TRIE_TBL8_GRP_NUM_ENT];
 		nh = *ptr16;
 		if (nh & TRIE_EXT_ENT)
-			return;
+			return 0;
 		for (i = 1; i < TRIE_TBL8_GRP_NUM_ENT; i++) {
 			if (nh != ptr16[i])
-				return;
+				return 0;
 		}
 		write_to_dp(par, nh, dp->nh_sz, 1);
-		for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++)
-			ptr16[i] = 0;
 		break;
 	case RTE_FIB6_TRIE_4B:
 		ptr32 = &((uint32_t *)dp->tbl8)[tbl8_idx *
 				TRIE_TBL8_GRP_NUM_ENT];
 		nh = *ptr32;
 		if (nh & TRIE_EXT_ENT)
-			return;
+			return 0;
 		for (i = 1; i < TRIE_TBL8_GRP_NUM_ENT; i++) {
 			if (nh != ptr32[i])
-				return;
+				return 0;
 		}
 		write_to_dp(par, nh, dp->nh_sz, 1);
-		for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++)
-			ptr32[i] = 0;
 		break;
 	case RTE_FIB6_TRIE_8B:
 		ptr64 = &((uint64_t *)dp->tbl8)[tbl8_idx *
 				TRIE_TBL8_GRP_NUM_ENT];
 		nh = *ptr64;
 		if (nh & TRIE_EXT_ENT)
-			return;
+			return 0;
 		for (i = 1; i < TRIE_TBL8_GRP_NUM_ENT; i++) {
 			if (nh != ptr64[i])
-				return;
+				return 0;
 		}
 		write_to_dp(par, nh, dp->nh_sz, 1);
-		for (i = 0; i < TRIE_TBL8_GRP_NUM_ENT; i++)
-			ptr64[i] = 0;
 		break;
 	}
-	tbl8_put(dp, tbl8_idx);
+	return 1;
 }
 
 #define BYTE_SIZE	8
@@ -281,7 +343,8 @@ recycle_root_path(struct rte_trie_tbl *dp, const uint8_t *ip_part,
 			TRIE_TBL8_GRP_NUM_ENT + *ip_part, dp->nh_sz);
 		recycle_root_path(dp, ip_part + 1, common_tbl8 - 1, p);
 	}
-	tbl8_recycle(dp, prev, val >> 1);
+	if (tbl8_recycle(dp, prev, val >> 1))
+		tbl8_free(dp, val >> 1);
 }
 
 static inline int
@@ -321,7 +384,9 @@ write_edge(struct rte_trie_tbl *dp, const uint8_t *ip_part, uint64_t next_hop,
 	int len, enum edge edge, void *ent)
 {
 	uint64_t val = next_hop << 1;
-	int tbl8_idx;
+	int tbl8_idx = 0;
+	int recycled = 0;
+	int fresh = 0;
 	int ret = 0;
 	void *p;
 
@@ -334,6 +399,7 @@ write_edge(struct rte_trie_tbl *dp, const uint8_t *ip_part, uint64_t next_hop,
 			if (tbl8_idx < 0)
 				return tbl8_idx;
 			val = (tbl8_idx << 1)|TRIE_EXT_ENT;
+			fresh = 1;
 		}
 		p = get_tbl_p_by_idx(dp->tbl8, (tbl8_idx *
 			TRIE_TBL8_GRP_NUM_ENT) + *ip_part, dp->nh_sz);
@@ -348,10 +414,15 @@ write_edge(struct rte_trie_tbl *dp, const uint8_t *ip_part, uint64_t next_hop,
 				TRIE_TBL8_GRP_NUM_ENT, dp->nh_sz),
 				next_hop << 1, dp->nh_sz, *ip_part);
 		}
-		tbl8_recycle(dp, &val, tbl8_idx);
+		recycled = tbl8_recycle(dp, &val, tbl8_idx);
 	}
 
 	write_to_dp(ent, val, dp->nh_sz, 1);
+	/* a group allocated above was never visible to readers */
+	if (recycled && fresh)
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	else if (recycled)
+		tbl8_free(dp, tbl8_idx);
 	return ret;
 }
 
@@ -504,19 +575,46 @@ modify_dp(struct rte_trie_tbl *dp, struct rte_rib6 *rib,
 	return 0;
 }
 
+/*
+ * Number of tbl8 groups a route with a prefix longer than /24 needs
+ * on top of the ones already reserved by the routes covering it.
+ */
+static uint8_t
+get_depth_diff(struct rte_rib6 *rib,
+	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	struct rte_rib6_node *tmp;
+	uint8_t tmp_depth, parent_depth = 24;
+
+	if (depth <= 24)
+		return 0;
+
+	tmp = rte_rib6_get_nxt(rib, ip, RTE_ALIGN_FLOOR(depth, 8), NULL,
+		RTE_RIB6_GET_NXT_COVER);
+	if (tmp != NULL)
+		return 0;
+
+	tmp = rte_rib6_lookup(rib, ip);
+	if (tmp != NULL) {
+		rte_rib6_get_depth(tmp, &tmp_depth);
+		parent_depth = RTE_MAX(tmp_depth, 24);
+	}
+	return (RTE_ALIGN_CEIL(depth, 8) -
+		RTE_ALIGN_CEIL(parent_depth, 8)) >> 3;
+}
+
 int
 trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	uint8_t depth, uint64_t next_hop, int op)
 {
 	struct rte_trie_tbl *dp;
 	struct rte_rib6 *rib;
-	struct rte_rib6_node *tmp = NULL;
 	struct rte_rib6_node *node;
 	struct rte_rib6_node *parent;
 	uint8_t	ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
 	int i, ret = 0;
 	uint64_t par_nh, node_nh;
-	uint8_t tmp_depth, depth_diff = 0, parent_depth = 24;
+	uint8_t depth_diff;
 
 	if ((fib == NULL) || (ip == NULL) || (depth > RTE_FIB6_MAXDEPTH))
 		return -EINVAL;
@@ -529,21 +627,7 @@ trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++)
 		ip_masked[i] = ip[i] & get_msk_part(depth, i);
 
-	if (depth > 24) {
-		tmp = rte_rib6_get_nxt(rib, ip_masked,
-			RTE_ALIGN_FLOOR(depth, 8), NULL,
-			RTE_RIB6_GET_NXT_COVER);
-		if (tmp == NULL) {
-			tmp = rte_rib6_lookup(rib, ip);
-			if (tmp != NULL) {
-				rte_rib6_get_depth(tmp, &tmp_depth);
-				parent_depth = RTE_MAX(tmp_depth, 24);
-			}
-			depth_diff = RTE_ALIGN_CEIL(depth, 8) -
-				RTE_ALIGN_CEIL(parent_depth, 8);
-			depth_diff = depth_diff >> 3;
-		}
-	}
+	depth_diff = get_depth_diff(rib, ip_masked, depth);
 	node = rte_rib6_lookup_exact(rib, ip_masked, depth);
 	switch (op) {
 	case RTE_FIB6_ADD:
@@ -605,6 +689,95 @@ trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	return -EINVAL;
 }
 
+/* State of a route during trie_add_bulk(), depth_diff is kept on top */
+#define BULK_RT_UNCHANGED	0
+#define BULK_RT_UPDATED		1
+#define BULK_RT_NEW		2
+#define BULK_RT_STATE_MASK	3
+#define BULK_RT_DIFF_SHIFT	2
+
+int
+trie_add_bulk(struct rte_fib6 *fib, const struct rte_fib6_route *routes,
+	unsigned int n)
+{
+	struct rte_trie_tbl *dp;
+	struct rte_rib6 *rib;
+	struct rte_rib6_node *node;
+	uint64_t node_nh;
+	uint8_t *state;
+	const uint8_t *ip;
+	uint8_t depth, depth_diff;
+	unsigned int i, nb;
+	int ret = 0, err;
+
+	dp = rte_fib6_get_dp(fib);
+	RTE_ASSERT(dp);
+	rib = rte_fib6_get_rib(fib);
+	RTE_ASSERT(rib);
+
+	for (i = 0; i < n; i++) {
+		if (routes[i].next_hop > get_max_nh(dp->nh_sz))
+			return -EINVAL;
+	}
+
+	state = rte_malloc(NULL, n, 0);
+	if (state == NULL)
+		return -ENOMEM;
+
+	/*
+	 * Put all the routes into the RIB first, reserving tbl8s the same
+	 * way trie_modify() does. modify_dp() then skips the ranges
+	 * of more specific routes, so every tbl24/tbl8 entry is written
+	 * only for its longest matching prefix.
+	 */
+	for (nb = 0; nb < n; nb++) {
+		ip = routes[nb].ip;
+		depth = routes[nb].depth;
+		depth_diff = get_depth_diff(rib, ip, depth);
+		node = rte_rib6_lookup_exact(rib, ip, depth);
+		if (node != NULL) {
+			rte_rib6_get_nh(node, &node_nh);
+			state[nb] = (node_nh == routes[nb].next_hop) ?
+				BULK_RT_UNCHANGED : BULK_RT_UPDATED;
+			rte_rib6_set_nh(node, routes[nb].next_hop);
+			continue;
+		}
+		if ((depth > 24) && (dp->rsvd_tbl8s >=
+				dp->number_tbl8s - depth_diff)) {
+			ret = -ENOSPC;
+			break;
+		}
+		node = rte_rib6_insert(rib, ip, depth);
+		if (node == NULL) {
+			ret = -rte_errno;
+			break;
+		}
+		rte_rib6_set_nh(node, routes[nb].next_hop);
+		dp->rsvd_tbl8s += depth_diff;
+		state[nb] = BULK_RT_NEW | (depth_diff << BULK_RT_DIFF_SHIFT);
+	}
+
+	/* Routes are sorted, so less specific ones are installed first */
+	for (i = 0; i < nb; i++) {
+		if (state[i] == BULK_RT_UNCHANGED)
+			continue;
+		ip = routes[i].ip;
+		depth = routes[i].depth;
+		err = modify_dp(dp, rib, ip, depth, routes[i].next_hop);
+		if (err == 0)
+			continue;
+		if (ret == 0)
+			ret = err;
+		if ((state[i] & BULK_RT_STATE_MASK) != BULK_RT_NEW)
+			continue;
+		rte_rib6_remove(rib, ip, depth);
+		dp->rsvd_tbl8s -= state[i] >> BULK_RT_DIFF_SHIFT;
+	}
+
+	rte_free(state);
+	return ret;
+}
+
 void *
 trie_create(const char *name, int socket_id,
 	struct rte_fib6_conf *conf)
@@ -677,7 +850,172 @@ trie_free(void *p)
 {
 	struct rte_trie_tbl *dp = (struct rte_trie_tbl *)p;
 
+	if (dp->dq != NULL)
+		rte_rcu_qsbr_dq_delete(dp->dq);
 	rte_free(dp->tbl8_pool);
 	rte_free(dp->tbl8);
 	rte_free(dp);
 }
+
+int
+trie_rcu_qsbr_add(struct rte_trie_tbl *dp, struct rte_fib6_rcu_config *cfg,
+	const char *name)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (dp == NULL || cfg == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (dp->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_FIB6_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_FIB6_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"FIB6_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = dp->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB6_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 group index */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			RTE_LOG(ERR, LPM, "FIB6 defer queue creation failed\n");
+			return 1;
+		}
+	} else {
+		rte_errno = EINVAL;
+		return 1;
+	}
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
+
+/*
+ * The dataplane snapshot starts at a page aligned file offset with
+ * struct trie_snapshot padded to TRIE_SNAPSHOT_ALIGN, followed by
+ * tbl24 and tbl8 exactly as they are laid out in memory, so both tables
+ * start page aligned as well.
+ */
+#define TRIE_SNAPSHOT_ALIGN	4096
+
+struct trie_snapshot {
+	uint32_t	number_tbl8s;
+	uint32_t	rsvd_tbl8s;
+	uint32_t	nh_sz;
+};
+
+static inline uint64_t
+get_tbl8_sz(struct rte_trie_tbl *dp)
+{
+	return (TRIE_TBL8_GRP_NUM_ENT * (dp->number_tbl8s + 1)) << dp->nh_sz;
+}
+
+int
+trie_save(struct rte_trie_tbl *dp, FILE *f)
+{
+	struct trie_snapshot snap = {0};
+
+	snap.number_tbl8s = dp->number_tbl8s;
+	snap.rsvd_tbl8s = dp->rsvd_tbl8s;
+	snap.nh_sz = dp->nh_sz;
+
+	if ((fwrite(&snap, sizeof(snap), 1, f) != 1) ||
+			(fseek(f, TRIE_SNAPSHOT_ALIGN - sizeof(snap),
+			SEEK_CUR) != 0) ||
+			(fwrite(dp->tbl24, (uint64_t)TRIE_TBL24_NUM_ENT <<
+			dp->nh_sz, 1, f) != 1) ||
+			(fwrite(dp->tbl8, get_tbl8_sz(dp), 1, f) != 1))
+		return -EIO;
+
+	return 0;
+}
+
+/*
+ * Take the tbl8 group referenced by an extended entry out of the pool.
+ * A group referenced twice means the snapshot is corrupted.
+ */
+static int
+tbl8_mark_used(struct rte_trie_tbl *dp, uint8_t *used, uint64_t val)
+{
+	uint64_t tbl8_idx;
+
+	if (!is_entry_extended(val))
+		return 0;
+	tbl8_idx = val >> 1;
+	if ((tbl8_idx >= dp->number_tbl8s) || (used[tbl8_idx] != 0))
+		return -EINVAL;
+	used[tbl8_idx] = 1;
+	dp->tbl8_pool[dp->tbl8_pool_pos++] = tbl8_idx;
+	return 0;
+}
+
+int
+trie_restore(struct rte_trie_tbl *dp, FILE *f)
+{
+	struct trie_snapshot snap;
+	uint8_t *used;
+	uint64_t base;
+	uint32_t i, j, k;
+	int ret = 0;
+
+	if (fread(&snap, sizeof(snap), 1, f) != 1)
+		return -EIO;
+	if ((snap.number_tbl8s != dp->number_tbl8s) ||
+			(snap.nh_sz != dp->nh_sz) ||
+			(snap.rsvd_tbl8s > dp->number_tbl8s))
+		return -EINVAL;
+
+	if ((fseek(f, TRIE_SNAPSHOT_ALIGN - sizeof(snap),
+			SEEK_CUR) != 0) ||
+			(fread(dp->tbl24, (uint64_t)TRIE_TBL24_NUM_ENT <<
+			dp->nh_sz, 1, f) != 1) ||
+			(fread(dp->tbl8, get_tbl8_sz(dp), 1, f) != 1))
+		return -EIO;
+
+	used = rte_zmalloc(NULL, dp->number_tbl8s, 0);
+	if (used == NULL)
+		return -ENOMEM;
+
+	/*
+	 * Rebuild the tbl8 pool by walking the trie from tbl24, the groups
+	 * found are appended to the allocated part of the pool and scanned
+	 * in turn. Groups that were waiting for RCU reclamation when the
+	 * snapshot was taken are not referenced and become free.
+	 */
+	dp->rsvd_tbl8s = snap.rsvd_tbl8s;
+	dp->tbl8_pool_pos = 0;
+	for (i = 0; (ret == 0) && (i < TRIE_TBL24_NUM_ENT); i++)
+		ret = tbl8_mark_used(dp, used,
+			get_tbl_val_by_idx(dp->tbl24, i, dp->nh_sz));
+	for (k = 0; (ret == 0) && (k < dp->tbl8_pool_pos); k++) {
+		base = dp->tbl8_pool[k] * TRIE_TBL8_GRP_NUM_ENT;
+		for (j = 0; (ret == 0) && (j < TRIE_TBL8_GRP_NUM_ENT); j++)
+			ret = tbl8_mark_used(dp, used,
+				get_tbl_val_by_idx(dp->tbl8, base + j,
+				dp->nh_sz));
+	}
+	for (i = 0, k = dp->tbl8_pool_pos; i < dp->number_tbl8s; i++) {
+		if (used[i] == 0)
+			dp->tbl8_pool[k++] = i;
+	}
+
+	rte_free(used);
+	return ret;
+}
@@ -10,6 +10,8 @@
  * @file
  * RTE IPv6 Longest Prefix Match (LPM)
  */
+#include <stdio.h>
+
 #include <rte_prefetch.h>
 #include <rte_branch_prediction.h>
 
@@ -41,6 +43,10 @@ struct rte_trie_tbl {
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint32_t	*tbl8_pool;	/**< bitmap containing free tbl8 idxes*/
 	uint32_t	tbl8_pool_pos;
+	/* RCU config. */
+	struct rte_rcu_qsbr	*v;		/* RCU QSBR variable. */
+	enum rte_fib6_qsbr_mode	rcu_mode;	/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq	*dq;		/* RCU QSBR defer queue. */
 	/* tbl24 table. */
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
@@ -145,6 +151,20 @@ int
 trie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
 	uint8_t depth, uint64_t next_hop, int op);
 
+int
+trie_add_bulk(struct rte_fib6 *fib, const struct rte_fib6_route *routes,
+	unsigned int n);
+
+int
+trie_rcu_qsbr_add(struct rte_trie_tbl *dp, struct rte_fib6_rcu_config *cfg,
+	const char *name);
+
+int
+trie_save(struct rte_trie_tbl *dp, FILE *f);
+
+int
+trie_restore(struct rte_trie_tbl *dp, FILE *f);
+
 
 #ifdef __cplusplus
 }
@@ -32,13 +32,19 @@
 #include "rte_hash.h"
 #include "rte_cuckoo_hash.h"
 
+#ifdef CC_HASH_AVX512_SUPPORT
+#include "rte_cuckoo_hash_avx512.h"
+#endif
+
 /* Mask of all flags supported by this version */
 #define RTE_HASH_EXTRA_FLAGS_MASK (RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT | \
 				   RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD | \
 				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY | \
 				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE |	\
 				   RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL | \
-				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF | \
+				   RTE_HASH_EXTRA_FLAGS_RESIZABLE | \
+				   RTE_HASH_EXTRA_FLAGS_AGING)
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -62,16 +68,11 @@ rte_hash_find_existing(const char *name)
 {
 	struct rte_hash *h = NULL;
 	struct rte_tailq_entry *te;
-	struct rte_hash_list *hash_list;
-
-	hash_list = RTE_TAILQ_CAST(rte_hash_tailq.head, rte_hash_list);
 
 	rte_mcfg_tailq_read_lock();
-	TAILQ_FOREACH(te, hash_list, next) {
+	te = rte_eal_tailq_index_lookup(rte_hash_tailq.head, name);
+	if (te != NULL)
 		h = (struct rte_hash *) te->data;
-		if (strncmp(name, h->name, RTE_HASH_NAMESIZE) == 0)
-			break;
-	}
 	rte_mcfg_tailq_read_unlock();
 
 	if (te == NULL) {
@@ -134,6 +135,78 @@ get_alt_bucket_index(const struct rte_hash *h,
 	return (cur_bkt_idx ^ sig) & h->bucket_bitmask;
 }
 
+/*
+ * Get the slot of a key index in the key store. The slots beyond the ones
+ * allocated at creation were added by resizes, each one doubling the
+ * number of slots.
+ */
+static inline struct rte_hash_key *
+get_key_slot(const struct rte_hash *h, uint32_t key_idx)
+{
+	uint32_t seg;
+
+	if (likely(key_idx < h->key_store_slots))
+		return RTE_PTR_ADD(h->key_store,
+				(size_t)key_idx * h->key_entry_size);
+
+	seg = rte_fls_u32(key_idx / h->key_store_slots) - 1;
+	return RTE_PTR_ADD(h->key_store_ext[seg],
+		(size_t)(key_idx - (h->key_store_slots << seg)) *
+		h->key_entry_size);
+}
+
+/* Get the last seen timestamp of a key, 0 if it was not seen yet. */
+static inline uint64_t *
+get_key_ts(const struct rte_hash *h, struct rte_hash_key *k)
+{
+	return RTE_PTR_ADD(k, h->key_ts_offset);
+}
+
+/*
+ * Get the primary and secondary buckets of a hash value in a table
+ * descriptor of a resizable table. An entry of the old bucket i is moved
+ * to the new bucket i or i + number of old buckets, in the same position
+ * (primary or secondary), so the buckets already moved are looked up in
+ * the new table.
+ */
+static inline void
+get_resize_buckets(const struct rte_hash_resize *r, const hash_sig_t hash,
+		uint16_t sig, struct rte_hash_bucket **prim_bkt,
+		struct rte_hash_bucket **sec_bkt)
+{
+	uint32_t pos = __atomic_load_n(&r->pos, __ATOMIC_ACQUIRE);
+	uint32_t old_idx = hash & r->old_bucket_bitmask;
+	uint32_t new_idx = hash & r->bucket_bitmask;
+
+	*prim_bkt = old_idx < pos ? &r->buckets[new_idx] :
+				    &r->old_buckets[old_idx];
+
+	old_idx = (old_idx ^ sig) & r->old_bucket_bitmask;
+	new_idx = (new_idx ^ sig) & r->bucket_bitmask;
+	*sec_bkt = old_idx < pos ? &r->buckets[new_idx] :
+				   &r->old_buckets[old_idx];
+}
+
+/* Get the primary and secondary buckets of a hash value. */
+static inline void
+get_buckets(const struct rte_hash *h, const hash_sig_t hash, uint16_t sig,
+		struct rte_hash_bucket **prim_bkt,
+		struct rte_hash_bucket **sec_bkt)
+{
+	uint32_t prim_bucket_idx;
+
+	if (likely(!h->resizable)) {
+		prim_bucket_idx = get_prim_bucket_index(h, hash);
+		*prim_bkt = &h->buckets[prim_bucket_idx];
+		*sec_bkt = &h->buckets[get_alt_bucket_index(h,
+					prim_bucket_idx, sig)];
+		return;
+	}
+
+	get_resize_buckets(__atomic_load_n(&h->table, __ATOMIC_ACQUIRE),
+			   hash, sig, prim_bkt, sec_bkt);
+}
+
 struct rte_hash *
 rte_hash_create(const struct rte_hash_parameters *params)
 {
@@ -156,8 +229,13 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	unsigned int no_free_on_del = 0;
 	uint32_t *ext_bkt_to_free = NULL;
 	uint32_t *tbl_chng_cnt = NULL;
+	struct rte_hash_resize *table = NULL;
 	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	unsigned int resizable = 0;
+	unsigned int aging = 0;
+	uint32_t key_entry_size, key_ts_offset = 0;
+	uint32_t entries;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -193,6 +271,17 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) &&
+	    (params->extra_flag & (RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD |
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY |
+				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE))) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: resizable table cannot "
+			"have multiple writers, rw concurrency with locks or "
+			"ext table\n");
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -222,6 +311,23 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		no_free_on_del = 1;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_AGING)
+		aging = 1;
+
+	entries = params->entries;
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) {
+		resizable = 1;
+		/* Keep the number of key slots a power of 2, so that it
+		 * matches the number of bucket entries after each doubling.
+		 */
+		entries = rte_align32pow2(entries + 1) - 1;
+		if (entries > RTE_HASH_ENTRIES_MAX) {
+			rte_errno = EINVAL;
+			RTE_LOG(ERR, HASH, "rte_hash_create has invalid parameters\n");
+			return NULL;
+		}
+	}
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
 	if (use_local_cache)
 		/*
@@ -229,10 +335,10 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		 * that can be stored in the lcore caches
 		 * except for the first cache
 		 */
-		num_key_slots = params->entries + (RTE_MAX_LCORE - 1) *
+		num_key_slots = entries + (RTE_MAX_LCORE - 1) *
 					(LCORE_CACHE_SIZE - 1) + 1;
 	else
-		num_key_slots = params->entries + 1;
+		num_key_slots = entries + 1;
 
 	snprintf(ring_name, sizeof(ring_name), "HT_%s", params->name);
 	/* Create ring (Dummy slot index is not enqueued) */
@@ -243,7 +349,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err;
 	}
 
-	const uint32_t num_buckets = rte_align32pow2(params->entries) /
+	const uint32_t num_buckets = rte_align32pow2(entries) /
 						RTE_HASH_BUCKET_ENTRIES;
 
 	/* Create ring for extendable buckets. */
@@ -267,12 +373,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 
 	/* guarantee there's no existing: this is normally already checked
 	 * by ring creation above */
-	TAILQ_FOREACH(te, hash_list, next) {
-		h = (struct rte_hash *) te->data;
-		if (strncmp(params->name, h->name, RTE_HASH_NAMESIZE) == 0)
-			break;
-	}
-	h = NULL;
+	te = rte_eal_tailq_index_lookup(rte_hash_tailq.head, params->name);
 	if (te != NULL) {
 		rte_errno = EEXIST;
 		te = NULL;
@@ -331,9 +432,16 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		}
 	}
 
-	const uint32_t key_entry_size =
-		RTE_ALIGN(sizeof(struct rte_hash_key) + params->key_len,
-			  KEY_ALIGNMENT);
+	if (aging) {
+		/* Store the last seen timestamp after the key */
+		key_ts_offset = sizeof(struct rte_hash_key) +
+			RTE_ALIGN(params->key_len, sizeof(uint64_t));
+		key_entry_size = RTE_ALIGN(key_ts_offset + sizeof(uint64_t),
+					   KEY_ALIGNMENT);
+	} else
+		key_entry_size =
+			RTE_ALIGN(sizeof(struct rte_hash_key) + params->key_len,
+				  KEY_ALIGNMENT);
 	const uint64_t key_tbl_size = (uint64_t) key_entry_size * num_key_slots;
 
 	k = rte_zmalloc_socket(NULL, key_tbl_size,
@@ -352,6 +460,22 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	/* The readers of a resizable table get its buckets from a table
+	 * descriptor. All the buckets of this one are already "moved".
+	 */
+	if (resizable) {
+		table = rte_zmalloc_socket(NULL, sizeof(*table), 0,
+				params->socket_id);
+		if (table == NULL) {
+			RTE_LOG(ERR, HASH, "memory allocation failed\n");
+			goto err_unlock;
+		}
+		table->buckets = buckets;
+		table->old_bucket_bitmask = num_buckets - 1;
+		table->bucket_bitmask = num_buckets - 1;
+		table->pos = num_buckets;
+	}
+
 /*
  * If x86 architecture is used, select appropriate compare function,
  * which may use x86 intrinsics, otherwise use memcmp
@@ -410,19 +534,22 @@ rte_hash_create(const struct rte_hash_parameters *params)
 #endif
 	/* Setup hash context */
 	strlcpy(h->name, params->name, sizeof(h->name));
-	h->entries = params->entries;
+	h->entries = entries;
 	h->key_len = params->key_len;
 	h->key_entry_size = key_entry_size;
+	h->key_ts_offset = key_ts_offset;
 	h->hash_func_init_val = params->hash_func_init_val;
 
 	h->num_buckets = num_buckets;
 	h->bucket_bitmask = h->num_buckets - 1;
 	h->buckets = buckets;
+	h->table = table;
 	h->buckets_ext = buckets_ext;
 	h->free_ext_bkts = r_ext;
 	h->hash_func = (params->hash_func == NULL) ?
 		default_hash_func : params->hash_func;
 	h->key_store = k;
+	h->key_store_slots = num_key_slots;
 	h->free_slots = r;
 	h->ext_bkt_to_free = ext_bkt_to_free;
 	h->tbl_chng_cnt = tbl_chng_cnt;
@@ -435,8 +562,19 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->resizable = resizable;
+	h->aging = aging;
+	h->socket_id = params->socket_id;
 
 #if defined(RTE_ARCH_X86)
+#ifdef CC_HASH_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_BMI2) > 0 &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512)
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+	else
+#endif
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
@@ -465,6 +603,10 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		rte_ring_sp_enqueue_elem(r, &i, sizeof(uint32_t));
 
 	te->data = (void *) h;
+	if (rte_eal_tailq_index_add(rte_hash_tailq.head, h->name, te) < 0) {
+		RTE_LOG(ERR, HASH, "Cannot index hash table\n");
+		goto err_unlock;
+	}
 	TAILQ_INSERT_TAIL(hash_list, te, next);
 	rte_mcfg_tailq_write_unlock();
 
@@ -481,6 +623,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_free(buckets_ext);
 	rte_free(k);
 	rte_free(tbl_chng_cnt);
+	rte_free(table);
 	rte_free(ext_bkt_to_free);
 	return NULL;
 }
@@ -490,6 +633,7 @@ rte_hash_free(struct rte_hash *h)
 {
 	struct rte_tailq_entry *te;
 	struct rte_hash_list *hash_list;
+	unsigned int i;
 
 	if (h == NULL)
 		return;
@@ -499,16 +643,13 @@ rte_hash_free(struct rte_hash *h)
 	rte_mcfg_tailq_write_lock();
 
 	/* find out tailq entry */
-	TAILQ_FOREACH(te, hash_list, next) {
-		if (te->data == (void *) h)
-			break;
-	}
-
-	if (te == NULL) {
+	te = rte_eal_tailq_index_lookup(rte_hash_tailq.head, h->name);
+	if (te == NULL || te->data != (void *) h) {
 		rte_mcfg_tailq_write_unlock();
 		return;
 	}
 
+	rte_eal_tailq_index_del(rte_hash_tailq.head, h->name);
 	TAILQ_REMOVE(hash_list, te, next);
 
 	rte_mcfg_tailq_write_unlock();
@@ -520,9 +661,24 @@ rte_hash_free(struct rte_hash *h)
 		rte_free(h->local_free_slots);
 	if (h->writer_takes_lock)
 		rte_free(h->readwrite_lock);
-	rte_ring_free(h->free_slots);
+	/* The free slots ring is allocated by rte_malloc once resized */
+	if (h->free_slots->memzone == NULL)
+		rte_free(h->free_slots);
+	else
+		rte_ring_free(h->free_slots);
 	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
+	for (i = 0; i < RTE_HASH_RESIZE_MAX; i++)
+		rte_free(h->key_store_ext[i]);
+	/* The table descriptor is the resize in progress, if any */
+	if (h->table != NULL) {
+		if (h->table->old_buckets != h->buckets)
+			rte_free(h->table->old_buckets);
+		if (h->table->buckets != h->buckets)
+			rte_free(h->table->buckets);
+		rte_free(h->table->prev);
+		rte_free(h->table);
+	}
 	rte_free(h->buckets);
 	rte_free(h->buckets_ext);
 	rte_free(h->tbl_chng_cnt);
@@ -617,6 +773,7 @@ __hash_rw_reader_unlock(const struct rte_hash *h)
 void
 rte_hash_reset(struct rte_hash *h)
 {
+	struct rte_hash_resize *r;
 	uint32_t tot_ring_cnt, i;
 	unsigned int pending;
 
@@ -632,9 +789,30 @@ rte_hash_reset(struct rte_hash *h)
 			RTE_LOG(ERR, HASH, "RCU reclaim all resources failed\n");
 	}
 
+	/* Drop the table being moved, the new one is cleared below */
+	r = h->table;
+	if (r != NULL) {
+		if (h->resize != NULL) {
+			h->buckets = r->buckets;
+			h->bucket_bitmask = r->bucket_bitmask;
+			h->num_buckets = r->bucket_bitmask + 1;
+			r->pos = r->old_bucket_bitmask + 1;
+			h->resize = NULL;
+		}
+		rte_free(r->old_buckets);
+		r->old_buckets = NULL;
+		rte_free(r->prev);
+		r->prev = NULL;
+		h->resize_retired = NULL;
+	}
+
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
-	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
+	memset(h->key_store, 0, h->key_entry_size * h->key_store_slots);
+	for (i = 0; i < RTE_HASH_RESIZE_MAX && h->key_store_ext[i]; i++)
+		memset(h->key_store_ext[i], 0, (size_t)h->key_entry_size *
+					(h->key_store_slots << i));
 	*h->tbl_chng_cnt = 0;
+	h->expire_pos = 0;
 
 	/* reset the free ring */
 	rte_ring_reset(h->free_slots);
@@ -697,12 +875,11 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 	struct rte_hash_bucket *bkt, uint16_t sig)
 {
 	int i;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		if (bkt->sig_current[i] == sig) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+			k = get_key_slot(h, bkt->key_idx[i]);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				/* The store to application data at *data
 				 * should not leak after the store to pdata
@@ -1004,6 +1181,229 @@ alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
 	return slot_id;
 }
 
+/*
+ * Free the bucket table replaced by the last resize and its descriptor
+ * once the lock free readers stopped using them, waiting for them if wait
+ * is true.
+ */
+static void
+__rte_hash_resize_reclaim(struct rte_hash *h, bool wait)
+{
+	struct rte_hash_resize *r = h->resize_retired;
+
+	if (r == NULL || rte_rcu_qsbr_check(h->hash_rcu_cfg->v,
+					h->retired_token, wait) != 1)
+		return;
+
+	rte_free(r->old_buckets);
+	r->old_buckets = NULL;
+	rte_free(r->prev);
+	r->prev = NULL;
+	h->resize_retired = NULL;
+}
+
+/*
+ * Start growing the table: allocate twice as many buckets and key slots.
+ * The buckets are then moved to the new table by __rte_hash_resize_move().
+ * If the previous resize is not reclaimed yet, wait for the readers only
+ * if wait is true.
+ */
+static int
+__rte_hash_resize_start(struct rte_hash *h, bool wait)
+{
+	struct rte_hash_resize *r = NULL;
+	struct rte_hash_bucket *buckets = NULL;
+	struct rte_ring *free_slots = NULL;
+	void *k = NULL;
+	uint32_t objs[LCORE_CACHE_SIZE];
+	uint32_t num_slots, seg, i, n;
+	ssize_t ring_size;
+
+	if (h->resize != NULL)
+		return -EBUSY;
+	/* Lock free readers may use the old bucket table until they report
+	 * a quiescent state.
+	 */
+	if (h->readwrite_concur_lf_support && h->hash_rcu_cfg == NULL)
+		return -EPERM;
+	__rte_hash_resize_reclaim(h, wait);
+	if (h->resize_retired != NULL)
+		return -EAGAIN;
+
+	/* The new key slots follow the current ones */
+	num_slots = h->entries + 1;
+	seg = rte_fls_u32(num_slots / h->key_store_slots) - 1;
+	if (seg >= RTE_HASH_RESIZE_MAX ||
+			num_slots * 2 - 1 > RTE_HASH_ENTRIES_MAX)
+		return -ENOSPC;
+
+	ring_size = rte_ring_get_memsize_elem(sizeof(uint32_t),
+				rte_align32pow2(num_slots * 2));
+	if (ring_size < 0)
+		return ring_size;
+
+	r = rte_zmalloc_socket(NULL, sizeof(*r), 0, h->socket_id);
+	buckets = rte_zmalloc_socket(NULL,
+			h->num_buckets * 2 * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	k = rte_zmalloc_socket(NULL, (size_t)h->key_entry_size * num_slots,
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	free_slots = rte_zmalloc_socket(NULL, ring_size,
+			RTE_CACHE_LINE_SIZE, h->socket_id);
+	if (r == NULL || buckets == NULL || k == NULL || free_slots == NULL ||
+			rte_ring_init(free_slots, h->free_slots->name,
+				rte_align32pow2(num_slots * 2), 0) != 0) {
+		rte_free(free_slots);
+		rte_free(k);
+		rte_free(buckets);
+		rte_free(r);
+		return -ENOMEM;
+	}
+
+	/* Move the free key slots to the larger ring and add the new ones */
+	while ((n = rte_ring_sc_dequeue_burst_elem(h->free_slots, objs,
+				sizeof(uint32_t), LCORE_CACHE_SIZE, NULL)) != 0)
+		rte_ring_sp_enqueue_bulk_elem(free_slots, objs,
+				sizeof(uint32_t), n, NULL);
+	for (i = num_slots; i < num_slots * 2; i++)
+		rte_ring_sp_enqueue_elem(free_slots, &i, sizeof(uint32_t));
+
+	if (h->free_slots->memzone == NULL)
+		rte_free(h->free_slots);
+	else
+		rte_ring_free(h->free_slots);
+	h->free_slots = free_slots;
+	h->key_store_ext[seg] = k;
+	h->entries = num_slots * 2 - 1;
+
+	r->old_buckets = h->buckets;
+	r->buckets = buckets;
+	r->old_bucket_bitmask = h->bucket_bitmask;
+	r->bucket_bitmask = h->bucket_bitmask * 2 + 1;
+	r->prev = h->table;
+	h->resize = r;
+	/* Release the new table to the readers */
+	__atomic_store_n(&h->table, r, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/*
+ * Move up to n buckets of the old table to the new one, and switch to the
+ * new table once all of them are moved.
+ * Return the number of buckets left to move.
+ */
+static int32_t
+__rte_hash_resize_move(struct rte_hash *h, uint32_t n)
+{
+	struct rte_hash_resize *r = h->resize;
+	struct rte_hash_bucket *old_bkt, *new_bkt;
+	const struct rte_hash_key *k;
+	uint32_t num_buckets, bkt_idx, hash, key_idx;
+	unsigned int i, j;
+
+	if (r == NULL) {
+		__rte_hash_resize_reclaim(h, false);
+		return 0;
+	}
+
+	num_buckets = r->old_bucket_bitmask + 1;
+	for (; n > 0 && r->pos < num_buckets; n--) {
+		old_bkt = &r->old_buckets[r->pos];
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			key_idx = old_bkt->key_idx[i];
+			if (key_idx == EMPTY_SLOT)
+				continue;
+
+			k = get_key_slot(h, key_idx);
+			hash = rte_hash_hash(h, k->key);
+			bkt_idx = hash & r->bucket_bitmask;
+			/* Keep the entry in its secondary bucket */
+			if ((hash & r->old_bucket_bitmask) != r->pos)
+				bkt_idx = (bkt_idx ^ old_bkt->sig_current[i]) &
+						r->bucket_bitmask;
+
+			/* Only the entries of this old bucket go to the
+			 * new bucket until it is moved, so there is room.
+			 */
+			new_bkt = &r->buckets[bkt_idx];
+			for (j = 0; j < RTE_HASH_BUCKET_ENTRIES; j++)
+				if (new_bkt->key_idx[j] == EMPTY_SLOT)
+					break;
+			if (unlikely(j == RTE_HASH_BUCKET_ENTRIES))
+				return -ENOSPC;
+
+			new_bkt->sig_current[j] = old_bkt->sig_current[i];
+			__atomic_store_n(&new_bkt->key_idx[j], key_idx,
+					 __ATOMIC_RELEASE);
+		}
+		/* Readers look the moved bucket up in the new table */
+		__atomic_store_n(&r->pos, r->pos + 1, __ATOMIC_RELEASE);
+
+		if (h->readwrite_concur_lf_support) {
+			/* Inform the move, so that the readers which
+			 * looked the old bucket up and missed a key
+			 * updated in the new one search again.
+			 * Since there is one writer, load acquires on
+			 * tbl_chng_cnt are not required.
+			 */
+			__atomic_store_n(h->tbl_chng_cnt,
+					 *h->tbl_chng_cnt + 1,
+					 __ATOMIC_RELEASE);
+			/* The stores to the next bucket should not
+			 * move above the store to tbl_chng_cnt.
+			 */
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+		}
+	}
+
+	if (r->pos < num_buckets)
+		return num_buckets - r->pos;
+
+	/* Switch the writer to the new table. The readers already use it
+	 * through the table descriptor, as all the buckets are moved.
+	 */
+	h->buckets = r->buckets;
+	h->num_buckets = num_buckets * 2;
+	h->bucket_bitmask = r->bucket_bitmask;
+	h->resize = NULL;
+
+	if (h->readwrite_concur_lf_support) {
+		h->resize_retired = r;
+		h->retired_token = rte_rcu_qsbr_start(h->hash_rcu_cfg->v);
+	} else {
+		rte_free(r->old_buckets);
+		r->old_buckets = NULL;
+		rte_free(r->prev);
+		r->prev = NULL;
+	}
+
+	return 0;
+}
+
+/*
+ * On a key addition, move a few buckets if the table is growing,
+ * or start growing it if it is getting full.
+ */
+static inline void
+__rte_hash_resize_add(struct rte_hash *h)
+{
+	if (h->resize != NULL)
+		__rte_hash_resize_move(h, RTE_HASH_RESIZE_ADD_BUCKETS);
+	else if ((uint64_t)rte_hash_count(h) * 100 >=
+			(uint64_t)h->entries * RTE_HASH_RESIZE_LOAD_PCT)
+		__rte_hash_resize_start(h, false);
+}
+
+int32_t
+rte_hash_resize_step(struct rte_hash *h, uint32_t n)
+{
+	if (h == NULL || !h->resizable)
+		return -EINVAL;
+
+	return __rte_hash_resize_move(h, n);
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
@@ -1011,7 +1411,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint16_t short_sig;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
-	struct rte_hash_key *new_k, *keys = h->key_store;
+	struct rte_hash_key *new_k;
 	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
@@ -1021,11 +1421,17 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	int32_t ret_val;
 	struct rte_hash_bucket *last;
 
+	if (h->resizable)
+		__rte_hash_resize_add((struct rte_hash *)((uintptr_t)h));
+
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
 	sec_bkt = &h->buckets[sec_bucket_idx];
+	if (h->resize != NULL)
+		get_resize_buckets(h->resize, sig, short_sig,
+				   &prim_bkt, &sec_bkt);
 	rte_prefetch0(prim_bkt);
 	rte_prefetch0(sec_bkt);
 
@@ -1064,11 +1470,16 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 			if (ret == 0)
 				slot_id = alloc_slot(h, cached_free_slots);
 		}
+		/* The resize could not start early enough */
+		if (slot_id == EMPTY_SLOT && h->resizable &&
+				__rte_hash_resize_start((struct rte_hash *)
+					((uintptr_t)h), true) == 0)
+			slot_id = alloc_slot(h, cached_free_slots);
 		if (slot_id == EMPTY_SLOT)
 			return -ENOSPC;
 	}
 
-	new_k = RTE_PTR_ADD(keys, slot_id * h->key_entry_size);
+	new_k = get_key_slot(h, slot_id);
 	/* The store to application data (by the application) at *data should
 	 * not leak after the store of pdata in the key store. i.e. pdata is
 	 * the guard variable. Release the application data to the readers.
@@ -1078,6 +1489,8 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		__ATOMIC_RELEASE);
 	/* Copy key */
 	memcpy(new_k->key, key, h->key_len);
+	if (h->aging)
+		__atomic_store_n(get_key_ts(h, new_k), 0, __ATOMIC_RELAXED);
 
 	/* Find an empty slot and insert */
 	ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt, key, data,
@@ -1089,6 +1502,32 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		return ret_val;
 	}
 
+	/* Entries are not pushed around while the table is growing: try the
+	 * secondary bucket, and complete the resize if it is full too.
+	 */
+	if (h->resize != NULL) {
+		ret = rte_hash_cuckoo_insert_mw(h, sec_bkt, prim_bkt, key, data,
+						short_sig, slot_id, &ret_val);
+		if (ret == 0)
+			return slot_id - 1;
+		else if (ret == 1) {
+			enqueue_slot_back(h, cached_free_slots, slot_id);
+			return ret_val;
+		}
+
+		__rte_hash_resize_move((struct rte_hash *)((uintptr_t)h),
+				       UINT32_MAX);
+		if (h->resize != NULL) {
+			enqueue_slot_back(h, cached_free_slots, slot_id);
+			return -ENOSPC;
+		}
+		prim_bucket_idx = get_prim_bucket_index(h, sig);
+		sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+						      short_sig);
+		prim_bkt = &h->buckets[prim_bucket_idx];
+		sec_bkt = &h->buckets[sec_bucket_idx];
+	}
+
 	/* Primary bucket full, need to make space for new entry */
 	ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
 				short_sig, prim_bucket_idx, slot_id, &ret_val);
@@ -1113,6 +1552,10 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	/* if ext table not enabled, we failed the insertion */
 	if (!h->ext_table_support) {
 		enqueue_slot_back(h, cached_free_slots, slot_id);
+		/* The resize could not start early enough */
+		if (h->resizable && __rte_hash_resize_start((struct rte_hash *)
+					((uintptr_t)h), true) == 0)
+			return __rte_hash_add_key_with_hash(h, key, sig, data);
 		return ret;
 	}
 
@@ -1240,6 +1683,79 @@ rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
 		return ret;
 }
 
+/*
+ * Compute the hash values of a burst of keys and prefetch their buckets,
+ * then the key slots of the entries matching their signatures, so that the
+ * keys are added or removed from cache.
+ */
+static inline void
+__bulk_add_del_prefetch(const struct rte_hash *h, const void **keys,
+			uint32_t num_keys, hash_sig_t *sig)
+{
+	struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i, j, key_idx;
+	uint16_t short_sig;
+
+	for (i = 0; i < num_keys; i++) {
+		sig[i] = rte_hash_hash(h, keys[i]);
+		get_buckets(h, sig[i], get_short_sig(sig[i]),
+			    &primary_bkt[i], &secondary_bkt[i]);
+		rte_prefetch0(primary_bkt[i]);
+		rte_prefetch0(secondary_bkt[i]);
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		short_sig = get_short_sig(sig[i]);
+		for (j = 0; j < RTE_HASH_BUCKET_ENTRIES; j++) {
+			if (primary_bkt[i]->sig_current[j] == short_sig) {
+				key_idx = __atomic_load_n(
+					&primary_bkt[i]->key_idx[j],
+					__ATOMIC_RELAXED);
+				if (key_idx != EMPTY_SLOT)
+					rte_prefetch0(get_key_slot(h, key_idx));
+			}
+			if (secondary_bkt[i]->sig_current[j] == short_sig) {
+				key_idx = __atomic_load_n(
+					&secondary_bkt[i]->key_idx[j],
+					__ATOMIC_RELAXED);
+				if (key_idx != EMPTY_SLOT)
+					rte_prefetch0(get_key_slot(h, key_idx));
+			}
+		}
+	}
+}
+
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+		void **data, uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i, n, burst;
+	int32_t ret;
+	int added = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (data == NULL)),
+			-EINVAL);
+
+	for (n = 0; n < num_keys; n += burst) {
+		burst = RTE_MIN(num_keys - n,
+				(uint32_t)RTE_HASH_LOOKUP_BULK_MAX);
+		__bulk_add_del_prefetch(h, &keys[n], burst, sig);
+
+		for (i = 0; i < burst; i++) {
+			ret = __rte_hash_add_key_with_hash(h, keys[n + i],
+							   sig[i], data[n + i]);
+			if (ret >= 0)
+				added++;
+			if (positions != NULL)
+				positions[n + i] = ret;
+		}
+	}
+
+	return added;
+}
+
 /* Search one bucket to find the match key - uses rw lock */
 static inline int32_t
 search_one_bucket_l(const struct rte_hash *h, const void *key,
@@ -1247,13 +1763,12 @@ search_one_bucket_l(const struct rte_hash *h, const void *key,
 		const struct rte_hash_bucket *bkt)
 {
 	int i;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		if (bkt->sig_current[i] == sig &&
 				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+			k = get_key_slot(h, bkt->key_idx[i]);
 
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				if (data != NULL)
@@ -1276,7 +1791,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 {
 	int i;
 	uint32_t key_idx;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		/* Signature comparison is done before the acquire-load
@@ -1290,8 +1805,7 @@ search_one_bucket_lf(const struct rte_hash *h, const void *key, uint16_t sig,
 			key_idx = __atomic_load_n(&bkt->key_idx[i],
 					  __ATOMIC_ACQUIRE);
 			if (key_idx != EMPTY_SLOT) {
-				k = (struct rte_hash_key *) ((char *)keys +
-						key_idx * h->key_entry_size);
+				k = get_key_slot(h, key_idx);
 
 				if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 					if (data != NULL) {
@@ -1315,30 +1829,24 @@ static inline int32_t
 __rte_hash_lookup_with_hash_l(const struct rte_hash *h, const void *key,
 				hash_sig_t sig, void **data)
 {
-	uint32_t prim_bucket_idx, sec_bucket_idx;
-	struct rte_hash_bucket *bkt, *cur_bkt;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
 	int ret;
 	uint16_t short_sig;
 
 	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
-
-	bkt = &h->buckets[prim_bucket_idx];
+	get_buckets(h, sig, short_sig, &prim_bkt, &sec_bkt);
 
 	__hash_rw_reader_lock(h);
 
 	/* Check if key is in primary location */
-	ret = search_one_bucket_l(h, key, short_sig, data, bkt);
+	ret = search_one_bucket_l(h, key, short_sig, data, prim_bkt);
 	if (ret != -1) {
 		__hash_rw_reader_unlock(h);
 		return ret;
 	}
-	/* Calculate secondary hash */
-	bkt = &h->buckets[sec_bucket_idx];
 
 	/* Check if key is in secondary location */
-	FOR_EACH_BUCKET(cur_bkt, bkt) {
+	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 		ret = search_one_bucket_l(h, key, short_sig,
 					data, cur_bkt);
 		if (ret != -1) {
@@ -1356,15 +1864,12 @@ static inline int32_t
 __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
-	uint32_t prim_bucket_idx, sec_bucket_idx;
-	struct rte_hash_bucket *bkt, *cur_bkt;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
 	uint32_t cnt_b, cnt_a;
 	int ret;
 	uint16_t short_sig;
 
 	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 
 	do {
 		/* Load the table change counter before the lookup
@@ -1374,16 +1879,16 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 				__ATOMIC_ACQUIRE);
 
+		/* The buckets change when a resizable table grows */
+		get_buckets(h, sig, short_sig, &prim_bkt, &sec_bkt);
+
 		/* Check if key is in primary location */
-		bkt = &h->buckets[prim_bucket_idx];
-		ret = search_one_bucket_lf(h, key, short_sig, data, bkt);
+		ret = search_one_bucket_lf(h, key, short_sig, data, prim_bkt);
 		if (ret != -1)
 			return ret;
-		/* Calculate secondary hash */
-		bkt = &h->buckets[sec_bucket_idx];
 
 		/* Check if key is in secondary location */
-		FOR_EACH_BUCKET(cur_bkt, bkt) {
+		FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 			ret = search_one_bucket_lf(h, key, short_sig,
 						data, cur_bkt);
 			if (ret != -1)
@@ -1480,16 +1985,14 @@ __hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
 {
 	void *key_data = NULL;
 	int ret;
-	struct rte_hash_key *keys, *k;
+	struct rte_hash_key *k;
 	struct rte_hash *h = (struct rte_hash *)p;
 	struct __rte_hash_rcu_dq_entry rcu_dq_entry =
 			*((struct __rte_hash_rcu_dq_entry *)e);
 
 	RTE_SET_USED(n);
-	keys = h->key_store;
 
-	k = (struct rte_hash_key *) ((char *)keys +
-				rcu_dq_entry.key_idx * h->key_entry_size);
+	k = get_key_slot(h, rcu_dq_entry.key_idx);
 	key_data = k->pdata;
 	if (h->hash_rcu_cfg->free_key_data_func)
 		h->hash_rcu_cfg->free_key_data_func(h->hash_rcu_cfg->key_data_ptr,
@@ -1641,7 +2144,7 @@ static inline int32_t
 search_and_remove(const struct rte_hash *h, const void *key,
 			struct rte_hash_bucket *bkt, uint16_t sig, int *pos)
 {
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_key *k;
 	unsigned int i;
 	uint32_t key_idx;
 
@@ -1650,8 +2153,7 @@ search_and_remove(const struct rte_hash *h, const void *key,
 		key_idx = __atomic_load_n(&bkt->key_idx[i],
 					  __ATOMIC_ACQUIRE);
 		if (bkt->sig_current[i] == sig && key_idx != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					key_idx * h->key_entry_size);
+			k = get_key_slot(h, key_idx);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				bkt->sig_current[i] = NULL_SIGNATURE;
 				/* Free the key store index if
@@ -1676,8 +2178,12 @@ search_and_remove(const struct rte_hash *h, const void *key,
 	return -1;
 }
 
+/* Remove a key from the table.
+ * Writer is expected to hold the lock while calling this
+ * function.
+ */
 static inline int32_t
-__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+__rte_hash_del_key_with_hash_locked(const struct rte_hash *h, const void *key,
 						hash_sig_t sig)
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
@@ -1693,8 +2199,11 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
+	sec_bkt = &h->buckets[sec_bucket_idx];
+	if (h->resize != NULL)
+		get_resize_buckets(h->resize, sig, short_sig,
+				   &prim_bkt, &sec_bkt);
 
-	__hash_rw_writer_lock(h);
 	/* look for key in primary bucket */
 	ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
 	if (ret != -1) {
@@ -1704,9 +2213,6 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		goto return_bkt;
 	}
 
-	/* Calculate secondary hash */
-	sec_bkt = &h->buckets[sec_bucket_idx];
-
 	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 		ret = search_and_remove(h, key, cur_bkt, short_sig, &pos);
 		if (ret != -1) {
@@ -1717,7 +2223,6 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
-	__hash_rw_writer_unlock(h);
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
@@ -1774,9 +2279,33 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 						      &rcu_dq_entry, 1);
 		} else if (h->dq)
 			/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
-			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
-				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
+			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0) {
+				/* The FIFO is sized for the table before it
+				 * grew, wait for the readers instead.
+				 */
+				if (h->resizable) {
+					rte_rcu_qsbr_synchronize(
+						h->hash_rcu_cfg->v,
+						RTE_QSBR_THRID_INVALID);
+					__hash_rcu_qsbr_free_resource(
+						(void *)((uintptr_t)h),
+						&rcu_dq_entry, 1);
+				} else
+					RTE_LOG(ERR, HASH,
+						"Failed to push QSBR FIFO\n");
+			}
 	}
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	int32_t ret;
+
+	__hash_rw_writer_lock(h);
+	ret = __rte_hash_del_key_with_hash_locked(h, key, sig);
 	__hash_rw_writer_unlock(h);
 	return ret;
 }
@@ -1796,15 +2325,46 @@ rte_hash_del_key(const struct rte_hash *h, const void *key)
 	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key));
 }
 
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i, n, burst;
+	int32_t ret;
+	int deleted = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL)), -EINVAL);
+
+	for (n = 0; n < num_keys; n += burst) {
+		burst = RTE_MIN(num_keys - n,
+				(uint32_t)RTE_HASH_LOOKUP_BULK_MAX);
+		__bulk_add_del_prefetch(h, &keys[n], burst, sig);
+
+		/* Take the lock once for the burst */
+		__hash_rw_writer_lock(h);
+		for (i = 0; i < burst; i++) {
+			ret = __rte_hash_del_key_with_hash_locked(h,
+						keys[n + i], sig[i]);
+			if (ret >= 0)
+				deleted++;
+			if (positions != NULL)
+				positions[n + i] = ret;
+		}
+		__hash_rw_writer_unlock(h);
+	}
+
+	return deleted;
+}
+
 int
 rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
 			       void **key)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
 
-	struct rte_hash_key *k, *keys = h->key_store;
-	k = (struct rte_hash_key *) ((char *) keys + (position + 1) *
-				     h->key_entry_size);
+	struct rte_hash_key *k;
+	k = get_key_slot(h, position + 1);
 	*key = k->key;
 
 	if (position !=
@@ -1900,6 +2460,36 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	}
 }
 
+/*
+ * Compare the signatures of a burst of keys. The AVX512 version compares
+ * the primary and secondary buckets of 2 keys at once.
+ */
+static inline void
+compare_signatures_bulk(uint32_t *prim_hash_matches,
+			uint32_t *sec_hash_matches,
+			const struct rte_hash_bucket **primary_bkt,
+			const struct rte_hash_bucket **secondary_bkt,
+			const uint16_t *sig, int32_t num_keys,
+			enum rte_hash_sig_compare_function sig_cmp_fn)
+{
+	int32_t i;
+
+#ifdef CC_HASH_AVX512_SUPPORT
+	if (sig_cmp_fn == RTE_HASH_COMPARE_AVX512) {
+		RTE_BUILD_BUG_ON(offsetof(struct rte_hash_bucket,
+					  sig_current) != 0);
+		rte_hash_compare_signatures_avx512(prim_hash_matches,
+			sec_hash_matches, (const void **)primary_bkt,
+			(const void **)secondary_bkt, sig, num_keys);
+		return;
+	}
+#endif
+	for (i = 0; i < num_keys; i++)
+		compare_signatures(&prim_hash_matches[i], &sec_hash_matches[i],
+			primary_bkt[i], secondary_bkt[i],
+			sig[i], sig_cmp_fn);
+}
+
 static inline void
 __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
@@ -1917,11 +2507,10 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 	__hash_rw_reader_lock(h);
 
 	/* Compare signatures and prefetch key slot of first hit */
+	compare_signatures_bulk(prim_hitmask, sec_hitmask,
+		primary_bkt, secondary_bkt, sig, num_keys,
+		h->sig_cmp_fn);
 	for (i = 0; i < num_keys; i++) {
-		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-			primary_bkt[i], secondary_bkt[i],
-			sig[i], h->sig_cmp_fn);
-
 		if (prim_hitmask[i]) {
 			uint32_t first_hit =
 					__builtin_ctzl(prim_hitmask[i])
@@ -1929,9 +2518,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				primary_bkt[i]->key_idx[first_hit];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			rte_prefetch0(key_slot);
 			continue;
 		}
@@ -1943,9 +2530,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				secondary_bkt[i]->key_idx[first_hit];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			rte_prefetch0(key_slot);
 		}
 	}
@@ -1960,9 +2545,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				primary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 
 			/*
 			 * If key index is 0, do not compare key,
@@ -1988,9 +2571,7 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				secondary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 
 			/*
 			 * If key index is 0, do not compare key,
@@ -2047,8 +2628,36 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		*hit_mask = hits;
 }
 
+/*
+ * Compute again the buckets of the keys not found yet by a lock free bulk
+ * lookup, from their hash if known. The buckets computed before the table
+ * changed may belong to a replaced table of a resizable hash, from which
+ * the entries moved since are not removed.
+ */
+static inline void
+refresh_bulk_buckets(const struct rte_hash *h, const void **keys,
+		const hash_sig_t *prim_hash, const uint16_t *sig,
+		int32_t num_keys, uint64_t hits,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt)
+{
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		if ((hits & (1ULL << i)) != 0)
+			continue;
+		get_buckets(h, prim_hash != NULL ? prim_hash[i] :
+				rte_hash_hash(h, keys[i]), sig[i],
+				&prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
+	}
+}
+
 static inline void
 __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
+		const hash_sig_t *prim_hash, uint32_t cnt_bkt,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
 		uint16_t *sig, int32_t num_keys, int32_t *positions,
@@ -2073,12 +2682,18 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 					__ATOMIC_ACQUIRE);
 
+		/* The table changed since the buckets were computed */
+		if (h->resizable && cnt_b != cnt_bkt) {
+			refresh_bulk_buckets(h, keys, prim_hash, sig, num_keys,
+					     hits, primary_bkt, secondary_bkt);
+			cnt_bkt = cnt_b;
+		}
+
 		/* Compare signatures and prefetch key slot of first hit */
+		compare_signatures_bulk(prim_hitmask, sec_hitmask,
+			primary_bkt, secondary_bkt, sig, num_keys,
+			h->sig_cmp_fn);
 		for (i = 0; i < num_keys; i++) {
-			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				sig[i], h->sig_cmp_fn);
-
 			if (prim_hitmask[i]) {
 				uint32_t first_hit =
 						__builtin_ctzl(prim_hitmask[i])
@@ -2086,9 +2701,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 				uint32_t key_idx =
 					primary_bkt[i]->key_idx[first_hit];
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 				rte_prefetch0(key_slot);
 				continue;
 			}
@@ -2100,9 +2713,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 				uint32_t key_idx =
 					secondary_bkt[i]->key_idx[first_hit];
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 				rte_prefetch0(key_slot);
 			}
 		}
@@ -2118,9 +2729,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 					&primary_bkt[i]->key_idx[hit_index],
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 
 				/*
 				 * If key index is 0, do not compare key,
@@ -2150,9 +2759,7 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 					&secondary_bkt[i]->key_idx[hit_index],
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 
 				/*
 				 * If key index is 0, do not compare key,
@@ -2236,8 +2843,7 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 {
 	int32_t i;
 	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
 
 	/* Prefetch first keys */
 	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
@@ -2253,11 +2859,9 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 		prim_hash[i] = rte_hash_hash(h, keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		get_buckets(h, prim_hash[i], sig[i], &prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2268,11 +2872,9 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 		prim_hash[i] = rte_hash_hash(h, keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		get_buckets(h, prim_hash[i], sig[i], &prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2304,12 +2906,16 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t cnt_bkt;
+
+	/* The buckets of a resizable table are valid until it changes */
+	cnt_bkt = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
 
 	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
 		primary_bkt, secondary_bkt);
 
-	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_lf(h, keys, NULL, cnt_bkt, primary_bkt, secondary_bkt,
+		sig, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2345,9 +2951,8 @@ __rte_hash_lookup_bulk_with_hash_l(const struct rte_hash *h, const void **keys,
 	uint64_t hits = 0;
 	int32_t i;
 	int32_t ret;
-	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint16_t short_sig[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	uint16_t short_sig[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
@@ -2366,12 +2971,9 @@ __rte_hash_lookup_bulk_with_hash_l(const struct rte_hash *h, const void **keys,
 		rte_prefetch0(keys[i + PREFETCH_OFFSET]);
 
 		short_sig[i] = get_short_sig(sigs[i]);
-		prim_index[i] = get_prim_bucket_index(h, sigs[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i],
-			short_sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		get_buckets(h, sigs[i], short_sig[i], &prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2380,12 +2982,9 @@ __rte_hash_lookup_bulk_with_hash_l(const struct rte_hash *h, const void **keys,
 	/* Calculate and prefetch rest of the buckets */
 	for (; i < num_keys; i++) {
 		short_sig[i] = get_short_sig(sigs[i]);
-		prim_index[i] = get_prim_bucket_index(h, sigs[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i],
-			short_sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		get_buckets(h, sigs[i], short_sig[i], &prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2394,11 +2993,10 @@ __rte_hash_lookup_bulk_with_hash_l(const struct rte_hash *h, const void **keys,
 	__hash_rw_reader_lock(h);
 
 	/* Compare signatures and prefetch key slot of first hit */
+	compare_signatures_bulk(prim_hitmask, sec_hitmask,
+		primary_bkt, secondary_bkt, short_sig, num_keys,
+		h->sig_cmp_fn);
 	for (i = 0; i < num_keys; i++) {
-		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-			primary_bkt[i], secondary_bkt[i],
-			short_sig[i], h->sig_cmp_fn);
-
 		if (prim_hitmask[i]) {
 			uint32_t first_hit =
 					__builtin_ctzl(prim_hitmask[i])
@@ -2406,9 +3004,7 @@ __rte_hash_lookup_bulk_with_hash_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				primary_bkt[i]->key_idx[first_hit];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			rte_prefetch0(key_slot);
 			continue;
 		}
@@ -2420,9 +3016,7 @@ __rte_hash_lookup_bulk_with_hash_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				secondary_bkt[i]->key_idx[first_hit];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 			rte_prefetch0(key_slot);
 		}
 	}
@@ -2437,9 +3031,7 @@ __rte_hash_lookup_bulk_with_hash_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				primary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 
 			/*
 			 * If key index is 0, do not compare key,
@@ -2465,9 +3057,7 @@ __rte_hash_lookup_bulk_with_hash_l(const struct rte_hash *h, const void **keys,
 			uint32_t key_idx =
 				secondary_bkt[i]->key_idx[hit_index];
 			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
+				get_key_slot(h, key_idx);
 
 			/*
 			 * If key index is 0, do not compare key,
@@ -2532,15 +3122,17 @@ __rte_hash_lookup_bulk_with_hash_lf(const struct rte_hash *h, const void **keys,
 	uint64_t hits = 0;
 	int32_t i;
 	int32_t ret;
-	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint16_t short_sig[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
+	uint16_t short_sig[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
 	struct rte_hash_bucket *cur_bkt, *next_bkt;
-	uint32_t cnt_b, cnt_a;
+	uint32_t cnt_b, cnt_a, cnt_bkt;
+
+	/* The buckets of a resizable table are valid until it changes */
+	cnt_bkt = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
 
 	/* Prefetch first keys */
 	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
@@ -2554,12 +3146,9 @@ __rte_hash_lookup_bulk_with_hash_lf(const struct rte_hash *h, const void **keys,
 		rte_prefetch0(keys[i + PREFETCH_OFFSET]);
 
 		short_sig[i] = get_short_sig(sigs[i]);
-		prim_index[i] = get_prim_bucket_index(h, sigs[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i],
-			short_sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		get_buckets(h, sigs[i], short_sig[i], &prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2568,12 +3157,9 @@ __rte_hash_lookup_bulk_with_hash_lf(const struct rte_hash *h, const void **keys,
 	/* Calculate and prefetch rest of the buckets */
 	for (; i < num_keys; i++) {
 		short_sig[i] = get_short_sig(sigs[i]);
-		prim_index[i] = get_prim_bucket_index(h, sigs[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i],
-			short_sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		get_buckets(h, sigs[i], short_sig[i], &prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2590,12 +3176,19 @@ __rte_hash_lookup_bulk_with_hash_lf(const struct rte_hash *h, const void **keys,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 					__ATOMIC_ACQUIRE);
 
+		/* The table changed since the buckets were computed */
+		if (h->resizable && cnt_b != cnt_bkt) {
+			refresh_bulk_buckets(h, keys, sigs, short_sig,
+					     num_keys, hits, primary_bkt,
+					     secondary_bkt);
+			cnt_bkt = cnt_b;
+		}
+
 		/* Compare signatures and prefetch key slot of first hit */
+		compare_signatures_bulk(prim_hitmask, sec_hitmask,
+			primary_bkt, secondary_bkt, short_sig, num_keys,
+			h->sig_cmp_fn);
 		for (i = 0; i < num_keys; i++) {
-			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				short_sig[i], h->sig_cmp_fn);
-
 			if (prim_hitmask[i]) {
 				uint32_t first_hit =
 						__builtin_ctzl(prim_hitmask[i])
@@ -2603,9 +3196,7 @@ __rte_hash_lookup_bulk_with_hash_lf(const struct rte_hash *h, const void **keys,
 				uint32_t key_idx =
 					primary_bkt[i]->key_idx[first_hit];
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 				rte_prefetch0(key_slot);
 				continue;
 			}
@@ -2617,9 +3208,7 @@ __rte_hash_lookup_bulk_with_hash_lf(const struct rte_hash *h, const void **keys,
 				uint32_t key_idx =
 					secondary_bkt[i]->key_idx[first_hit];
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 				rte_prefetch0(key_slot);
 			}
 		}
@@ -2635,9 +3224,7 @@ __rte_hash_lookup_bulk_with_hash_lf(const struct rte_hash *h, const void **keys,
 					&primary_bkt[i]->key_idx[hit_index],
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 
 				/*
 				 * If key index is 0, do not compare key,
@@ -2667,9 +3254,7 @@ __rte_hash_lookup_bulk_with_hash_lf(const struct rte_hash *h, const void **keys,
 					&secondary_bkt[i]->key_idx[hit_index],
 					__ATOMIC_ACQUIRE);
 				const struct rte_hash_key *key_slot =
-					(const struct rte_hash_key *)(
-					(const char *)h->key_store +
-					key_idx * h->key_entry_size);
+					get_key_slot(h, key_idx);
 
 				/*
 				 * If key index is 0, do not compare key,
@@ -2787,6 +3372,39 @@ rte_hash_lookup_bulk_data(const struct rte_hash *h, const void **keys,
 	return __builtin_popcountl(*hit_mask);
 }
 
+int
+rte_hash_lookup_bulk_data_touch(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, uint64_t now, uint64_t *hit_mask,
+		void *data[])
+{
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(hit_mask == NULL) || (now == 0)), -EINVAL);
+
+	if (!h->aging)
+		return -EINVAL;
+
+	int32_t positions[num_keys];
+	uint64_t hits;
+	uint32_t i;
+
+	__rte_hash_lookup_bulk(h, keys, num_keys, positions, hit_mask, data);
+
+	/* The key slots of the hits were just compared,
+	 * so their timestamps are already in cache.
+	 */
+	hits = *hit_mask;
+	while (hits) {
+		i = __builtin_ctzl(hits);
+		__atomic_store_n(get_key_ts(h, get_key_slot(h, positions[i] + 1)),
+				 now, __ATOMIC_RELAXED);
+		hits &= hits - 1;
+	}
+
+	/* Return number of hits */
+	return __builtin_popcountl(*hit_mask);
+}
+
 
 static inline void
 __rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
@@ -2795,8 +3413,7 @@ __rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
 			uint64_t *hit_mask, void *data[])
 {
 	int32_t i;
-	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
@@ -2809,11 +3426,9 @@ __rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
 		rte_prefetch0(keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		get_buckets(h, prim_hash[i], sig[i], &prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
@@ -2830,11 +3445,14 @@ __rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
 			uint64_t *hit_mask, void *data[])
 {
 	int32_t i;
-	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t cnt_bkt;
+
+	/* The buckets of a resizable table are valid until it changes */
+	cnt_bkt = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
 
 	/*
 	 * Prefetch keys, calculate primary and
@@ -2844,18 +3462,16 @@ __rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
 		rte_prefetch0(keys[i]);
 
 		sig[i] = get_short_sig(prim_hash[i]);
-		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
-		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
-
-		primary_bkt[i] = &h->buckets[prim_index[i]];
-		secondary_bkt[i] = &h->buckets[sec_index[i]];
+		get_buckets(h, prim_hash[i], sig[i], &prim_bkt, &sec_bkt);
+		primary_bkt[i] = prim_bkt;
+		secondary_bkt[i] = sec_bkt;
 
 		rte_prefetch0(primary_bkt[i]);
 		rte_prefetch0(secondary_bkt[i]);
 	}
 
-	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+	__bulk_lookup_lf(h, keys, prim_hash, cnt_bkt, primary_bkt,
+		secondary_bkt, sig, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2904,15 +3520,38 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return __builtin_popcountl(*hit_mask);
 }
 
+/*
+ * Get a bucket of the main table to iterate. While the table grows, the
+ * new table is iterated: its buckets which were not moved yet are empty
+ * and their entries are in the old bucket of the same index.
+ */
+static inline const struct rte_hash_bucket *
+get_iter_bucket(const struct rte_hash *h, const struct rte_hash_resize *r,
+		uint32_t bucket_idx)
+{
+	if (r == NULL)
+		return &h->buckets[bucket_idx];
+
+	if (bucket_idx > r->old_bucket_bitmask ||
+			bucket_idx < __atomic_load_n(&r->pos, __ATOMIC_ACQUIRE))
+		return &r->buckets[bucket_idx];
+
+	return &r->old_buckets[bucket_idx];
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
 	uint32_t bucket_idx, idx, position;
 	struct rte_hash_key *next_key;
+	const struct rte_hash_resize *r;
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
-	const uint32_t total_entries_main = h->num_buckets *
+	r = h->resizable ? __atomic_load_n(&h->table, __ATOMIC_ACQUIRE) :
+			   NULL;
+	const uint32_t total_entries_main = (r != NULL ?
+			r->bucket_bitmask + 1 : h->num_buckets) *
 							RTE_HASH_BUCKET_ENTRIES;
 	const uint32_t total_entries = total_entries_main << 1;
 
@@ -2925,8 +3564,9 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	idx = *next % RTE_HASH_BUCKET_ENTRIES;
 
 	/* If current position is empty, go to the next one */
-	while ((position = __atomic_load_n(&h->buckets[bucket_idx].key_idx[idx],
-					__ATOMIC_ACQUIRE)) == EMPTY_SLOT) {
+	while ((position = __atomic_load_n(
+			&get_iter_bucket(h, r, bucket_idx)->key_idx[idx],
+			__ATOMIC_ACQUIRE)) == EMPTY_SLOT) {
 		(*next)++;
 		/* End of table */
 		if (*next == total_entries_main)
@@ -2936,8 +3576,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	}
 
 	__hash_rw_reader_lock(h);
-	next_key = (struct rte_hash_key *) ((char *)h->key_store +
-				position * h->key_entry_size);
+	next_key = get_key_slot(h, position);
 	/* Return key and data */
 	*key = next_key->key;
 	*data = next_key->pdata;
@@ -2967,8 +3606,7 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 		idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
 	}
 	__hash_rw_reader_lock(h);
-	next_key = (struct rte_hash_key *) ((char *)h->key_store +
-				position * h->key_entry_size);
+	next_key = get_key_slot(h, position);
 	/* Return key and data */
 	*key = next_key->key;
 	*data = next_key->pdata;
@@ -2980,15 +3618,77 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	return position - 1;
 }
 
+int32_t
+rte_hash_expire_step(struct rte_hash *h, uint64_t now, uint64_t timeout,
+		uint32_t n, rte_hash_expire_t cb, void *arg)
+{
+	const struct rte_hash_resize *r;
+	const struct rte_hash_bucket *bkt, *cur_bkt;
+	struct rte_hash_key *k;
+	uint32_t num_buckets, key_idx, i;
+	uint64_t *ts, last_seen;
+	int32_t deleted = 0;
+
+	if (h == NULL || !h->aging)
+		return -EINVAL;
+
+	__hash_rw_writer_lock(h);
+	r = h->resize;
+	num_buckets = r != NULL ? r->bucket_bitmask + 1 : h->num_buckets;
+	/* do not check a bucket twice in one step */
+	n = RTE_MIN(n, num_buckets);
+
+	for (; n > 0; n--) {
+		if (h->expire_pos >= num_buckets)
+			h->expire_pos = 0;
+		bkt = get_iter_bucket(h, r, h->expire_pos++);
+
+		/* An entry moved in a slot already walked by the compaction
+		 * of the linked list is checked on the next walk.
+		 */
+		FOR_EACH_BUCKET(cur_bkt, bkt) {
+			for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+				key_idx = cur_bkt->key_idx[i];
+				if (key_idx == EMPTY_SLOT)
+					continue;
+
+				k = get_key_slot(h, key_idx);
+				ts = get_key_ts(h, k);
+				last_seen = __atomic_load_n(ts,
+							    __ATOMIC_RELAXED);
+				if (last_seen == 0) {
+					/* Not seen since it was added */
+					__atomic_store_n(ts, now,
+							 __ATOMIC_RELAXED);
+					continue;
+				}
+				if (last_seen >= now ||
+						now - last_seen < timeout)
+					continue;
+
+				if (cb != NULL)
+					cb(k->key, k->pdata, key_idx - 1, arg);
+				if (__rte_hash_del_key_with_hash_locked(h,
+						k->key,
+						rte_hash_hash(h, k->key)) >= 0)
+					deleted++;
+			}
+		}
+	}
+	__hash_rw_writer_unlock(h);
+
+	return deleted;
+}
+
 void
 rte_hash_prefetch_buckets(const struct rte_hash *h, hash_sig_t sig)
 {
 	uint16_t short_sig = get_short_sig(sig);
-	uint32_t prim_index = get_prim_bucket_index(h, sig);
-	uint32_t sec_index = get_alt_bucket_index(h, prim_index, short_sig);
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
 
-	rte_prefetch0(&h->buckets[prim_index]);
-	rte_prefetch0(&h->buckets[sec_index]);
+	get_buckets(h, sig, short_sig, &prim_bkt, &sec_bkt);
+	rte_prefetch0(prim_bkt);
+	rte_prefetch0(sec_bkt);
 }
 
 void
@@ -2996,9 +3696,9 @@ rte_hash_prefetch_buckets_non_temporal(const struct rte_hash *h,
 	hash_sig_t sig)
 {
 	uint16_t short_sig = get_short_sig(sig);
-	uint32_t prim_index = get_prim_bucket_index(h, sig);
-	uint32_t sec_index = get_alt_bucket_index(h, prim_index, short_sig);
+	struct rte_hash_bucket *prim_bkt, *sec_bkt;
 
-	rte_prefetch_non_temporal(&h->buckets[prim_index]);
-	rte_prefetch_non_temporal(&h->buckets[sec_index]);
+	get_buckets(h, sig, short_sig, &prim_bkt, &sec_bkt);
+	rte_prefetch_non_temporal(prim_bkt);
+	rte_prefetch_non_temporal(sec_bkt);
 }
@@ -122,6 +122,15 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/** Percentage of used entries from which a resizable table grows. */
+#define RTE_HASH_RESIZE_LOAD_PCT	75
+
+/** Number of buckets moved to the new table on each key addition. */
+#define RTE_HASH_RESIZE_ADD_BUCKETS	2
+
+/** Maximum number of times a resizable table can double. */
+#define RTE_HASH_RESIZE_MAX		32
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -142,6 +151,7 @@ enum rte_hash_sig_compare_function {
 	RTE_HASH_COMPARE_SCALAR = 0,
 	RTE_HASH_COMPARE_SSE,
 	RTE_HASH_COMPARE_NEON,
+	RTE_HASH_COMPARE_AVX512,
 	RTE_HASH_COMPARE_NUM
 };
 
@@ -156,6 +166,22 @@ struct rte_hash_bucket {
 	void *next;
 } __rte_cache_aligned;
 
+/** Bucket tables of a resizable hash table being grown. */
+struct rte_hash_resize {
+	struct rte_hash_bucket *old_buckets; /**< Buckets being moved. */
+	struct rte_hash_bucket *buckets;     /**< Twice as many buckets. */
+	uint32_t old_bucket_bitmask;         /**< Bitmask of the old table. */
+	uint32_t bucket_bitmask;             /**< Bitmask of the new table. */
+	uint32_t pos;
+	/**< Number of old buckets moved so far. The entries of the moved
+	 * buckets are left in place, so that the readers which got there
+	 * before the move still find them. Once all of them are moved, only
+	 * the new table is used.
+	 */
+	struct rte_hash_resize *prev;
+	/**< Table replaced by this one, freed with the old buckets. */
+};
+
 /** A hash table structure. */
 struct rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
@@ -196,6 +222,10 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t resizable;
+	/**< If the table grows when it is getting full */
+	uint8_t aging;
+	/**< If a last seen timestamp is stored with each key */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -207,12 +237,25 @@ struct rte_hash {
 	uint32_t bucket_bitmask;
 	/**< Bitmask for getting bucket index from hash signature. */
 	uint32_t key_entry_size;         /**< Size of each key entry. */
+	uint32_t key_ts_offset;
+	/**< Offset of the last seen timestamp in each key entry. */
 
 	void *key_store;                /**< Table storing all keys and data */
+	uint32_t key_store_slots;
+	/**< Number of slots in key_store. The slots added by resizes
+	 * are in key_store_ext.
+	 */
 	struct rte_hash_bucket *buckets;
 	/**< Table with buckets storing all the	hash values and key indexes
 	 * to the key table.
 	 */
+	struct rte_hash_resize *resize;
+	/**< Table being grown into, NULL if no resize is in progress. */
+	struct rte_hash_resize *table;
+	/**< Bucket table of a resizable table, used by the readers. The
+	 * buckets and their bitmask are replaced together by swapping this
+	 * pointer, so that a reader never mixes the ones of different tables.
+	 */
 	rte_rwlock_t *readwrite_lock; /**< Read-write lock thread-safety. */
 	struct rte_hash_bucket *buckets_ext; /**< Extra buckets array */
 	struct rte_ring *free_ext_bkts; /**< Ring of indexes of free buckets */
@@ -225,6 +268,21 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+
+	/* Fields used to resize the table */
+	int socket_id;                  /**< NUMA socket ID for memory. */
+	void *key_store_ext[RTE_HASH_RESIZE_MAX];
+	/**< Key slots added by each resize, twice as many as the previous. */
+	struct rte_hash_resize *resize_retired;
+	/**< Last completed resize, whose old bucket table lock free readers
+	 * may still use until the RCU QSBR token retired_token is
+	 * acknowledged.
+	 */
+	uint64_t retired_token;
+
+	/* Fields used to age the keys */
+	uint32_t expire_pos;
+	/**< Main table bucket from which rte_hash_expire_step() continues. */
 } __rte_cache_aligned;
 
 struct queue_node {
@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_cuckoo_hash_avx512.h"
+
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+	uint32_t *sec_hash_matches, const void **primary_bkt,
+	const void **secondary_bkt, const uint16_t *sig, int32_t num_keys)
+{
+	__m512i bkt_sigs, key_sigs;
+	uint64_t matches;
+	int32_t i;
+
+	/* The 4 lanes hold the primary and secondary bucket signatures of
+	 * 2 keys, compared in one instruction.
+	 */
+	for (i = 0; i + 1 < num_keys; i += 2) {
+		bkt_sigs = _mm512_castsi128_si512(
+			_mm_load_si128((const __m128i *)primary_bkt[i]));
+		bkt_sigs = _mm512_inserti32x4(bkt_sigs,
+			_mm_load_si128((const __m128i *)secondary_bkt[i]), 1);
+		bkt_sigs = _mm512_inserti32x4(bkt_sigs,
+			_mm_load_si128((const __m128i *)primary_bkt[i + 1]), 2);
+		bkt_sigs = _mm512_inserti32x4(bkt_sigs,
+			_mm_load_si128((const __m128i *)secondary_bkt[i + 1]),
+			3);
+		key_sigs = _mm512_mask_set1_epi16(_mm512_set1_epi16(sig[i]),
+			0xffff0000, sig[i + 1]);
+
+		/* Move each match bit to the first bit of every 2 bits */
+		matches = _pdep_u64(_mm512_cmpeq_epi16_mask(bkt_sigs, key_sigs),
+				    0x5555555555555555ULL);
+		prim_hash_matches[i] = (uint16_t)matches;
+		sec_hash_matches[i] = (uint16_t)(matches >> 16);
+		prim_hash_matches[i + 1] = (uint16_t)(matches >> 32);
+		sec_hash_matches[i + 1] = (uint16_t)(matches >> 48);
+	}
+
+	/* Last key of an odd burst */
+	if (i < num_keys) {
+		prim_hash_matches[i] = _mm_movemask_epi8(_mm_cmpeq_epi16(
+			_mm_load_si128((const __m128i *)primary_bkt[i]),
+			_mm_set1_epi16(sig[i])));
+		sec_hash_matches[i] = _mm_movemask_epi8(_mm_cmpeq_epi16(
+			_mm_load_si128((const __m128i *)secondary_bkt[i]),
+			_mm_set1_epi16(sig[i])));
+	}
+}
@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#ifndef _RTE_CUCKOO_HASH_AVX512_H_
+#define _RTE_CUCKOO_HASH_AVX512_H_
+
+/*
+ * Compare the signatures of a burst of keys with the signatures of their
+ * primary and secondary buckets, which are the first member of the buckets.
+ * The match masks have the same format as the ones of compare_signatures().
+ */
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+	uint32_t *sec_hash_matches, const void **primary_bkt,
+	const void **secondary_bkt, const uint16_t *sig, int32_t num_keys);
+
+#endif /* _RTE_CUCKOO_HASH_AVX512_H_ */
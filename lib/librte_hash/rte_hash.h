@@ -56,6 +56,27 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to let the table grow when it is getting full.
+ * The number of entries is rounded up to a power of 2 minus 1, and doubles
+ * each time three quarters of them are used, buckets being moved to the
+ * larger table a few at a time by the following key additions or by
+ * rte_hash_resize_step(). The hash values passed to the *_with_hash APIs
+ * must be the ones returned by rte_hash_hash().
+ * This flag cannot be combined with RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD,
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY nor RTE_HASH_EXTRA_FLAGS_EXT_TABLE.
+ * With RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, the table only grows once an
+ * RCU QSBR variable is attached by rte_hash_rcu_qsbr_add(), to know when
+ * the readers stop using the replaced bucket table.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZABLE 0x40
+
+/** Flag to keep a last seen timestamp with each key.
+ * The timestamp is stored in the key slot, set by
+ * rte_hash_lookup_bulk_data_touch() and checked by rte_hash_expire_step()
+ * to delete the keys which were not seen for a while.
+ */
+#define RTE_HASH_EXTRA_FLAGS_AGING 0x80
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -76,6 +97,15 @@ typedef int (*rte_hash_cmp_eq_t)(const void *key1, const void *key2, size_t key_
  */
 typedef void (*rte_hash_free_key_data)(void *p, void *key_data);
 
+/**
+ * Type of function called by rte_hash_expire_step() for each expired key,
+ * right before the key is deleted. The position is the one returned when
+ * the key was added, to free it with rte_hash_free_key_with_position() if
+ * the key index is not freed on delete.
+ */
+typedef void (*rte_hash_expire_t)(const void *key, void *data,
+		int32_t position, void *arg);
+
 /**
  * Parameters used when creating the hash table.
  */
@@ -221,6 +251,72 @@ __rte_experimental
 int32_t
 rte_hash_max_key_id(const struct rte_hash *h);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Move buckets of a resizable hash table to the larger table it is
+ * growing into.
+ * Buckets are otherwise moved a few at a time by the key additions: calling
+ * this function, for instance when the writer thread is idle, lets the
+ * resize complete sooner and keeps the cost of key additions low.
+ * This operation is not multi-thread safe
+ * and should only be called from the writer thread.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_RESIZABLE.
+ * @param n
+ *   Maximum number of buckets to move.
+ * @return
+ *   - Number of buckets left to move, 0 if no resize is in progress.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOSPC if an entry could not be moved to the new table.
+ */
+__rte_experimental
+int32_t
+rte_hash_resize_step(struct rte_hash *h, uint32_t n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete the keys not seen for a while, walking a few buckets of the table.
+ * Each call continues from the bucket where the previous one stopped, so
+ * that the whole table is checked by a sequence of calls, each one of
+ * bounded duration.
+ * A key is expired if its last seen timestamp, set by
+ * rte_hash_lookup_bulk_data_touch(), is older than now minus timeout.
+ * A key which was never seen since it was added gets the timestamp now the
+ * first time it is walked.
+ * Keys are deleted as by rte_hash_del_key(): with internal RCU, the key
+ * indexes go through the defer queue, and the key data is freed by the
+ * free_key_data_func callback rather than by the expire callback.
+ * This operation is not multi-thread safe with regarding to other writer
+ * threads, unless the writers take the lock (RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY
+ * or RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD).
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_AGING.
+ * @param now
+ *   Current time, in the unit of the timestamps given to
+ *   rte_hash_lookup_bulk_data_touch().
+ * @param timeout
+ *   Time after which a key not seen is expired.
+ * @param n
+ *   Maximum number of buckets to walk.
+ * @param cb
+ *   Function called before deleting each expired key, can be NULL.
+ * @param arg
+ *   Argument passed to cb.
+ * @return
+ *   - Number of keys deleted.
+ *   - -EINVAL if the parameters are invalid.
+ */
+__rte_experimental
+int32_t
+rte_hash_expire_step(struct rte_hash *h, uint64_t now, uint64_t timeout,
+		uint32_t n, rte_hash_expire_t cb, void *arg);
+
 /**
  * Add a key-value pair to an existing hash table.
  * This operation is not multi-thread safe
@@ -322,6 +418,40 @@ rte_hash_add_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add multiple key-value pairs to an existing hash table.
+ * The hash values of a burst of keys are computed and their buckets and
+ * key slots prefetched before the keys are added one by one, so that the
+ * cache misses of the keys overlap.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread by default.
+ * Thread safety can be enabled by setting flag during
+ * table creation.
+ * If a key exists already in the table, this API updates its value
+ * as rte_hash_add_key_data() does.
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add.
+ * @param data
+ *   A pointer to a list of data to add, one for each key.
+ * @param num_keys
+ *   How many keys are in the keys list.
+ * @param positions
+ *   Output containing, for each key, the value that rte_hash_add_key()
+ *   would return: a unique position or -ENOSPC. Can be NULL.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys added.
+ */
+__rte_experimental
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+		void **data, uint32_t num_keys, int32_t *positions);
+
 /**
  * Remove a key from an existing hash table.
  * This operation is not multi-thread safe
@@ -384,6 +514,37 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Remove multiple keys from an existing hash table.
+ * The hash values of a burst of keys are computed and their buckets and
+ * key slots prefetched before the keys are removed one by one, so that the
+ * cache misses of the keys overlap.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread by default.
+ * Thread safety can be enabled by setting flag during
+ * table creation.
+ * The key indexes are freed as by rte_hash_del_key().
+ *
+ * @param h
+ *   Hash table to remove the keys from.
+ * @param keys
+ *   A pointer to a list of keys to remove.
+ * @param num_keys
+ *   How many keys are in the keys list.
+ * @param positions
+ *   Output containing, for each key, the value that rte_hash_del_key()
+ *   would return: the position of the key or -ENOENT. Can be NULL.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys removed.
+ */
+__rte_experimental
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -563,6 +724,37 @@ int
 rte_hash_lookup_bulk_data(const struct rte_hash *h, const void **keys,
 		      uint32_t num_keys, uint64_t *hit_mask, void *data[]);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Find multiple keys in the hash table and set the last seen timestamp of
+ * the keys found, for rte_hash_expire_step() to keep them.
+ * This operation is multi-thread safe with regarding to other lookup threads.
+ * Read-write concurrency can be enabled by setting flag during
+ * table creation.
+ *
+ * @param h
+ *   Hash table created with RTE_HASH_EXTRA_FLAGS_AGING.
+ * @param keys
+ *   A pointer to a list of keys to look for.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param now
+ *   Timestamp stored in the keys found, must not be 0.
+ * @param hit_mask
+ *   Output containing a bitmask with all successful lookups.
+ * @param data
+ *   Output containing array of data returned from all the successful lookups.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of successful lookups.
+ */
+__rte_experimental
+int
+rte_hash_lookup_bulk_data_touch(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, uint64_t now, uint64_t *hit_mask,
+		void *data[]);
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
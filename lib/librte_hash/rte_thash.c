@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_cpuflags.h>
+#include <rte_errno.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_vect.h>
+
+#include "rte_thash.h"
+#include "rte_thash_gfni.h"
+
+/*
+ * The Toeplitz hash of a tuple is the XOR of the 32-bit windows of the key
+ * starting at each set bit of the tuple, bits being counted from the most
+ * significant one. So the contribution of each tuple byte only depends on
+ * the byte value and position, and can be looked up in a table of 256
+ * values per byte position.
+ *
+ * With GFNI, the contribution of tuple byte p to hash byte q is the product
+ * of the byte by an 8x8 bit matrix made of the key bits, which only depends
+ * on the diagonal d = p + q. The tuple bytes are spread over the diagonals,
+ * so that byte q of diagonal d holds tuple byte d - q, then all the
+ * diagonals are multiplied by their matrix at once and summed up.
+ */
+
+struct rte_thash_bulk_ctx {
+	struct thash_gfni_tbl gfni;	/* GFNI tables. */
+	uint32_t input_len;		/* Tuple length in 4-bytes chunks. */
+	int use_gfni;			/* Hash using GFNI tables. */
+	uint32_t lut[][256];		/* Hash value of each tuple byte. */
+};
+
+/* 32 key bits starting at bit n, the key must have 5 bytes from n / 8 */
+static uint32_t
+key_window(const uint8_t *key, uint32_t n)
+{
+	uint64_t w = 0;
+	uint32_t i;
+
+	for (i = 0; i < 5; i++)
+		w = (w << 8) | key[n / 8 + i];
+	return (uint32_t)(w >> (8 - n % 8));
+}
+
+static void
+thash_lut_init(struct rte_thash_bulk_ctx *ctx, const uint8_t *rss_key)
+{
+	uint32_t p, b, len = ctx->input_len * 4;
+
+	for (p = 0; p < len; p++) {
+		ctx->lut[p][0] = 0;
+		/* Remove the lowest bit to find the already computed value */
+		for (b = 1; b < 256; b++)
+			ctx->lut[p][b] = ctx->lut[p][b & (b - 1)] ^
+				key_window(rss_key, p * 8 + 7 - rte_bsf32(b));
+	}
+}
+
+static void
+thash_gfni_init(struct thash_gfni_tbl *tbl, const uint8_t *rss_key,
+	uint32_t input_len)
+{
+	uint32_t d, q, r, p, i;
+	uint32_t len = input_len * 4;
+	uint32_t nb_diag = len + 3;
+	uint16_t w;
+
+	memset(tbl, 0, sizeof(*tbl));
+	tbl->nb_zmm = (nb_diag + 7) / 8;
+	tbl->load_mask = (len == 64) ? UINT64_MAX : (1ULL << len) - 1;
+
+	for (d = 0; d < nb_diag; d++) {
+		/*
+		 * Row r (hash bit r of the byte, from the most significant
+		 * one) is stored in byte r, and has the key bits from
+		 * d * 8 + r, the first one multiplying the most significant
+		 * tuple bit.
+		 */
+		w = (uint16_t)(rss_key[d] << 8 | rss_key[d + 1]);
+		for (r = 0; r < 8; r++)
+			tbl->mtrx[d] |= (uint64_t)(uint8_t)(w >> (8 - r)) <<
+				(r * 8);
+
+		for (q = 0; q < 4; q++) {
+			if (d < q || d - q >= len)
+				continue;
+			p = d - q;
+			i = d * 8 + q;
+			/* Tuple is made of 4-bytes chunks in CPU order */
+			tbl->perm[i] = (p & ~3U) | (3 - (p & 3));
+			tbl->zmask[i / 64] |= 1ULL << (i % 64);
+		}
+	}
+}
+
+struct rte_thash_bulk_ctx *
+rte_thash_bulk_ctx_create(const uint8_t *rss_key, uint32_t key_len,
+	uint32_t input_len, int socket_id)
+{
+	struct rte_thash_bulk_ctx *ctx;
+
+	if (rss_key == NULL || input_len == 0 ||
+			input_len > RTE_THASH_BULK_LEN_MAX ||
+			key_len < input_len * 4 + 4) {
+		RTE_LOG(ERR, HASH,
+			"rte_thash_bulk_ctx_create has invalid parameters\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	ctx = rte_zmalloc_socket("THASH_BULK", sizeof(*ctx) +
+			sizeof(ctx->lut[0]) * input_len * 4,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (ctx == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	ctx->input_len = input_len;
+	thash_lut_init(ctx, rss_key);
+
+#ifdef CC_THASH_GFNI_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_GFNI) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512VBMI) > 0 &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512) {
+		thash_gfni_init(&ctx->gfni, rss_key, input_len);
+		ctx->use_gfni = 1;
+	}
+#else
+	RTE_SET_USED(thash_gfni_init);
+#endif
+
+	return ctx;
+}
+
+void
+rte_thash_bulk_ctx_free(struct rte_thash_bulk_ctx *ctx)
+{
+	rte_free(ctx);
+}
+
+static inline uint32_t
+thash_lut(const struct rte_thash_bulk_ctx *ctx, const uint32_t *tuple)
+{
+	const uint32_t (*lut)[256] = ctx->lut;
+	uint32_t j, v, hash = 0;
+
+	for (j = 0; j < ctx->input_len; j++, lut += 4) {
+		v = tuple[j];
+		hash ^= lut[0][v >> 24] ^ lut[1][(v >> 16) & 0xff] ^
+			lut[2][(v >> 8) & 0xff] ^ lut[3][v & 0xff];
+	}
+	return hash;
+}
+
+void
+rte_thash_bulk(const struct rte_thash_bulk_ctx *ctx,
+	const uint32_t *input_tuples[], uint32_t *hashes, uint32_t num)
+{
+	uint32_t i;
+
+#ifdef CC_THASH_GFNI_SUPPORT
+	if (ctx->use_gfni) {
+		rte_thash_bulk_gfni(&ctx->gfni, input_tuples, hashes, num);
+		return;
+	}
+#endif
+
+	for (i = 0; i < num; i++)
+		hashes[i] = thash_lut(ctx, input_tuples[i]);
+}
+
+int
+rte_thash_adjust_init(struct rte_thash_adjust *adj, const uint8_t *rss_key,
+	uint32_t key_len, uint32_t offset, uint32_t len, uint32_t hash_mask)
+{
+	uint32_t vec[32], comb[32], pivot[32];
+	uint32_t i, r, b, m, tmp, rank = 0;
+
+	if (adj == NULL || rss_key == NULL || len == 0 || len > 32 ||
+			offset % 32 + len > 32 || hash_mask == 0 ||
+			(uint64_t)key_len * 8 < (uint64_t)offset + len + 32)
+		return -EINVAL;
+
+	/* Hash change when flipping field bit i, bit 0 being the lowest */
+	for (i = 0; i < len; i++) {
+		vec[i] = key_window(rss_key, offset + len - 1 - i);
+		comb[i] = 1U << i;
+	}
+
+	/*
+	 * Gauss-Jordan elimination over GF(2), restricted to the hash_mask
+	 * bits: find a combination of field bits for each hash_mask bit, which
+	 * flips this hash bit only among the hash_mask bits.
+	 */
+	for (m = hash_mask; m != 0; m &= (m - 1)) {
+		b = rte_bsf32(m);
+		for (r = rank; r < len; r++)
+			if (vec[r] & (1U << b))
+				break;
+		if (r == len)
+			return -EINVAL;
+
+		tmp = vec[r];
+		vec[r] = vec[rank];
+		vec[rank] = tmp;
+		tmp = comb[r];
+		comb[r] = comb[rank];
+		comb[rank] = tmp;
+		for (r = 0; r < len; r++) {
+			if (r != rank && (vec[r] & (1U << b))) {
+				vec[r] ^= vec[rank];
+				comb[r] ^= comb[rank];
+			}
+		}
+		pivot[b] = rank++;
+	}
+
+	memset(adj, 0, sizeof(*adj));
+	adj->offset = offset;
+	adj->len = len;
+	adj->hash_mask = hash_mask;
+	for (m = hash_mask; m != 0; m &= (m - 1)) {
+		b = rte_bsf32(m);
+		adj->flip[b] = comb[pivot[b]];
+		adj->delta[b] = vec[pivot[b]];
+	}
+
+	return 0;
+}
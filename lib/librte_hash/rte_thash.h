@@ -27,6 +27,7 @@ extern "C" {
 #include <rte_config.h>
 #include <rte_ip.h>
 #include <rte_common.h>
+#include <rte_compat.h>
 
 #if defined(RTE_ARCH_X86) || defined(__ARM_NEON)
 #include <rte_vect.h>
@@ -222,6 +223,174 @@ rte_softrss_be(uint32_t *input_tuple, uint32_t input_len,
 	return ret;
 }
 
+/** Maximum length in 4-bytes chunks of the tuples hashed by rte_thash_bulk() */
+#define RTE_THASH_BULK_LEN_MAX	16
+
+/** @internal Toeplitz hash context for bulk hashing. */
+struct rte_thash_bulk_ctx;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a context to hash bulks of tuples with rte_thash_bulk().
+ * Per RSS key tables are precomputed, so that each byte of the tuple is
+ * hashed at once, using GFNI and AVX512 instructions when available, or
+ * a table of 256 hash values per byte of the tuple otherwise.
+ *
+ * @param rss_key
+ *   Pointer to the original RSS hash key, the same as used by rte_softrss().
+ * @param key_len
+ *   RSS key length in bytes, at least 4 bytes more than the tuple length.
+ * @param input_len
+ *   Length of the tuples in 4-bytes chunks, up to RTE_THASH_BULK_LEN_MAX.
+ * @param socket_id
+ *   NUMA socket ID for the context memory.
+ * @return
+ *   Pointer to the context, or NULL with rte_errno set on error:
+ *    - EINVAL - invalid parameter passed to function
+ *    - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+struct rte_thash_bulk_ctx *
+rte_thash_bulk_ctx_create(const uint8_t *rss_key, uint32_t key_len,
+	uint32_t input_len, int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a context created by rte_thash_bulk_ctx_create().
+ *
+ * @param ctx
+ *   Pointer to the context, NULL is allowed.
+ */
+__rte_experimental
+void
+rte_thash_bulk_ctx_free(struct rte_thash_bulk_ctx *ctx);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Calculate the Toeplitz hash of a bulk of tuples. The hash values are the
+ * same as the ones calculated by rte_softrss() with the key and the length
+ * of the context.
+ *
+ * @param ctx
+ *   Pointer to the context.
+ * @param input_tuples
+ *   Array of pointers to the input tuples, in the same format as for
+ *   rte_softrss().
+ * @param hashes
+ *   Array to store the calculated hash values.
+ * @param num
+ *   Number of tuples.
+ */
+__rte_experimental
+void
+rte_thash_bulk(const struct rte_thash_bulk_ctx *ctx,
+	const uint32_t *input_tuples[], uint32_t *hashes, uint32_t num);
+
+/**
+ * Bit offset of the source port in the tuples, to use with
+ * rte_thash_adjust_init().
+ */
+#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
+#define RTE_THASH_SPORT_SHIFT	0
+#else
+#define RTE_THASH_SPORT_SHIFT	16
+#endif
+#define RTE_THASH_V4_SPORT_OFFSET	\
+	(offsetof(struct rte_ipv4_tuple, sctp_tag) * 8 + RTE_THASH_SPORT_SHIFT)
+#define RTE_THASH_V6_SPORT_OFFSET	\
+	(offsetof(struct rte_ipv6_tuple, sctp_tag) * 8 + RTE_THASH_SPORT_SHIFT)
+
+/**
+ * Precomputed data to adjust a field of the tuples, so that chosen bits of
+ * the hash value take the desired value. Since the Toeplitz hash is linear,
+ * flipping a tuple bit flips a fixed set of the hash bits, which only depends
+ * on the RSS key and the bit position.
+ *
+ * This allows i.e. a NAT to choose the source port of a flow, so that the
+ * reply flow is received on a desired queue, when hash_mask is the RSS
+ * redirection table size minus one.
+ */
+struct rte_thash_adjust {
+	uint32_t offset;	/**< Field offset in the tuple, in bits. */
+	uint32_t len;		/**< Field length, in bits. */
+	uint32_t hash_mask;	/**< Hash bits to adjust. */
+	/** Field bits to flip to flip one bit of the hash_mask bits. */
+	uint32_t flip[32];
+	/** Change of the whole hash value of each flip. */
+	uint32_t delta[32];
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Find which bits of a tuple field to flip to control some hash bits.
+ *
+ * @param adj
+ *   Pointer to the structure to initialize.
+ * @param rss_key
+ *   Pointer to the original RSS hash key, the same as used by rte_softrss().
+ * @param key_len
+ *   RSS key length in bytes.
+ * @param offset
+ *   Offset of the field in bits, counted from the most significant bit of
+ *   the first 4-bytes chunk of the tuple, i.e. RTE_THASH_V4_SPORT_OFFSET.
+ *   The field must not cross a 4-bytes chunk boundary.
+ * @param len
+ *   Length of the field in bits.
+ * @param hash_mask
+ *   Hash bits to control, i.e. RSS redirection table size minus one.
+ * @return
+ *   0 on success, -EINVAL if the parameters are invalid, or if the field
+ *   bits cannot control all the hash_mask bits with this key.
+ */
+__rte_experimental
+int
+rte_thash_adjust_init(struct rte_thash_adjust *adj, const uint8_t *rss_key,
+	uint32_t key_len, uint32_t offset, uint32_t len, uint32_t hash_mask);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Flip bits of the tuple field, so that the hash_mask bits of the hash value
+ * of the tuple become equal to the ones of desired.
+ *
+ * @param adj
+ *   Pointer to the structure initialized by rte_thash_adjust_init().
+ * @param input_tuple
+ *   Pointer to the input tuple, in the same format as for rte_softrss().
+ * @param hash
+ *   Current hash value of the tuple.
+ * @param desired
+ *   Desired hash value, only the hash_mask bits are used.
+ * @return
+ *   The new hash value of the tuple.
+ */
+__rte_experimental
+static inline uint32_t
+rte_thash_adjust_tuple(const struct rte_thash_adjust *adj,
+	uint32_t *input_tuple, uint32_t hash, uint32_t desired)
+{
+	uint32_t i, diff, flip = 0;
+
+	for (diff = (hash ^ desired) & adj->hash_mask; diff;
+			diff &= (diff - 1)) {
+		i = rte_bsf32(diff);
+		flip ^= adj->flip[i];
+		hash ^= adj->delta[i];
+	}
+	input_tuple[adj->offset / 32] ^=
+		flip << (32 - adj->offset % 32 - adj->len);
+	return hash;
+}
+
 #ifdef __cplusplus
 }
 #endif
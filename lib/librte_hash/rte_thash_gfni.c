@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#include <rte_byteorder.h>
+#include <rte_vect.h>
+
+#include "rte_thash.h"
+#include "rte_thash_gfni.h"
+
+void
+rte_thash_bulk_gfni(const struct thash_gfni_tbl *tbl,
+	const uint32_t *input_tuples[], uint32_t *hashes, uint32_t num)
+{
+	uint32_t i, z;
+	__m512i x, v, acc;
+	__m256i a;
+	__m128i b;
+
+	for (i = 0; i < num; i++) {
+		x = _mm512_maskz_loadu_epi8(tbl->load_mask, input_tuples[i]);
+		acc = _mm512_setzero_si512();
+
+		/*
+		 * Spread the tuple bytes over the diagonals and multiply each
+		 * diagonal by its key bit matrix.
+		 */
+		for (z = 0; z < tbl->nb_zmm; z++) {
+			v = _mm512_maskz_permutexvar_epi8(tbl->zmask[z],
+				_mm512_load_si512(
+					(const void *)&tbl->perm[z * 64]),
+				x);
+			acc = _mm512_xor_si512(acc,
+				_mm512_gf2p8affine_epi64_epi8(v,
+					_mm512_load_si512(
+						(const void *)&tbl->mtrx[z * 8]),
+					0));
+		}
+
+		/* Sum up the diagonals, the hash is in the first 4 bytes */
+		a = _mm256_xor_si256(_mm512_castsi512_si256(acc),
+			_mm512_extracti64x4_epi64(acc, 1));
+		b = _mm_xor_si128(_mm256_castsi256_si128(a),
+			_mm256_extracti128_si256(a, 1));
+		b = _mm_xor_si128(b, _mm_srli_si128(b, 8));
+
+		hashes[i] = rte_be_to_cpu_32(_mm_cvtsi128_si32(b));
+	}
+}
@@ -0,0 +1,39 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#ifndef _RTE_THASH_GFNI_H_
+#define _RTE_THASH_GFNI_H_
+
+#include <stdint.h>
+
+#include <rte_common.h>
+
+#include "rte_thash.h"
+
+/* Number of byte diagonals for the longest tuple, see rte_thash.c */
+#define THASH_GFNI_DIAG_MAX	(RTE_THASH_BULK_LEN_MAX * 4 + 3)
+#define THASH_GFNI_NB_ZMM_MAX	((THASH_GFNI_DIAG_MAX + 7) / 8)
+
+/* Tables used to hash a tuple with GFNI affine transformations */
+struct thash_gfni_tbl {
+	/* Bit matrix for each byte diagonal */
+	uint64_t mtrx[THASH_GFNI_NB_ZMM_MAX * 8];
+	/* Tuple byte to place in each byte of the diagonals */
+	uint8_t perm[THASH_GFNI_NB_ZMM_MAX * 64];
+	/* Bytes of the diagonals used */
+	uint64_t zmask[THASH_GFNI_NB_ZMM_MAX];
+	/* Bytes of the tuple */
+	uint64_t load_mask;
+	uint32_t nb_zmm;
+} __rte_aligned(64);
+
+/*
+ * Calculate the Toeplitz hash of a bulk of tuples using GFNI, AVX512F,
+ * AVX512BW and AVX512VBMI instructions.
+ */
+void
+rte_thash_bulk_gfni(const struct thash_gfni_tbl *tbl,
+	const uint32_t *input_tuples[], uint32_t *hashes, uint32_t num);
+
+#endif /* _RTE_THASH_GFNI_H_ */
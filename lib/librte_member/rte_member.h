@@ -10,11 +10,15 @@
  * The Membership Library is an extension and generalization of a traditional
  * filter (for example Bloom Filter and cuckoo filter) structure that has
  * multiple usages in a variety of workloads and applications. The library is
- * used to test if a key belongs to certain sets. Two types of such
- * "set-summary" structures are implemented: hash-table based (HT) and vector
- * bloom filter (vBF). For HT setsummary, two subtypes or modes are available,
- * cache and non-cache modes. The table below summarize some properties of
- * the different implementations.
+ * used to test if a key belongs to certain sets. Three types of such
+ * "set-summary" structures are implemented: hash-table based (HT), vector
+ * bloom filter (vBF) and cuckoo filter (CF). For HT setsummary, two subtypes
+ * or modes are available, cache and non-cache modes. The table below
+ * summarize some properties of the different implementations.
+ *
+ * Besides, a count-min sketch (SKETCH) type is provided to estimate the
+ * count of each key and report the heavy hitters, for example the largest
+ * flows. It does not track set ids and is used through the count APIs.
  *
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -39,6 +43,21 @@
  * |          |                     | not overwrite  |                         |
  * |          |                     | existing key.  |                         |
  * +----------+---------------------+----------------+-------------------------+
+ *
+ * +==========+=====================+
+ * |   type   |      CF             |
+ * +==========+=====================+
+ * |structure | cuckoo filter with  |
+ * |          | 16-bit fingerprints |
+ * +----------+---------------------+
+ * |set id    | single set,         |
+ * |          | set id is 1.        |
+ * +----------+---------------------+
+ * |usages &  | can delete, smaller |
+ * |properties| than vBF at low     |
+ * |          | false positive rate,|
+ * |          | no false negative.  |
+ * +----------+---------------------+
  * -->
  */
 
@@ -52,6 +71,7 @@ extern "C" {
 #include <stdint.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_config.h>
 
 /** The set ID type that stored internally in hash table based set summary. */
@@ -66,6 +86,8 @@ typedef uint16_t member_set_t;
 #define RTE_MEMBER_BUCKET_ENTRIES 16
 /** Maximum number of characters in setsum name. */
 #define RTE_MEMBER_NAMESIZE 32
+/** Maximum number of heavy hitters tracked by sketch set summary. */
+#define RTE_MEMBER_TOP_K_MAX 1024
 
 /** @internal Hash function used by membership library. */
 #if defined(RTE_ARCH_X86) || defined(__ARM_FEATURE_CRC32)
@@ -105,6 +127,8 @@ struct rte_member_parameters;
 enum rte_member_setsum_type {
 	RTE_MEMBER_TYPE_HT = 0,  /**< Hash table based set summary. */
 	RTE_MEMBER_TYPE_VBF,     /**< Vector of bloom filters. */
+	RTE_MEMBER_TYPE_CF,      /**< Cuckoo filter. */
+	RTE_MEMBER_TYPE_SKETCH,  /**< Count-min sketch with top-k keys. */
 	RTE_MEMBER_NUM_TYPE
 };
 
@@ -144,6 +168,12 @@ struct rte_member_setsum {
 	/* Second cache line should start here. */
 	uint32_t socket_id;          /* NUMA Socket ID for memory. */
 	char name[RTE_MEMBER_NAMESIZE]; /* Name of this set summary. */
+
+	/* Count-min sketch. */
+	uint32_t num_row;	/* Number of counter rows (hash functions). */
+	uint32_t num_col;	/* Number of counters in each row. */
+	uint32_t col_mask;	/* Bit mask to get counter location in row. */
+	uint32_t top_k;		/* Number of heavy hitters to track. */
 } __rte_cache_aligned;
 
 /**
@@ -151,8 +181,9 @@ struct rte_member_setsum {
  * @b EXPERIMENTAL: this API may change without prior notice
  *
  * Parameters used when create the set summary table. Currently user can
- * specify two types of setsummary: HT based and vBF. For HT based, user can
- * specify cache or non-cache mode. Here is a table to describe some differences
+ * specify four types of setsummary: HT based, vBF, CF and sketch. For HT
+ * based, user can specify cache or non-cache mode. Here is a table to describe
+ * some differences
  *
  */
 struct rte_member_parameters {
@@ -167,6 +198,12 @@ struct rte_member_parameters {
 	 *
 	 * vBF setsummary is a vector of bloom filters. It is used when number
 	 * of sets is not big (less than 32 for current implementation).
+	 *
+	 * CF setsummary is a cuckoo filter. It keeps one set only, and is
+	 * used instead of a single set vBF when keys need to be deleted.
+	 *
+	 * SKETCH setsummary is a count-min sketch. It estimates how many times
+	 * each key was added and tracks the top_k most frequent keys.
 	 */
 	enum rte_member_setsum_type type;
 
@@ -206,6 +243,11 @@ struct rte_member_parameters {
 	 * number of bits we need for each BF. User does not specify the size of
 	 * each BF directly because the optimal size depends on the num_keys
 	 * and false positive rate.
+	 *
+	 * For CF, num_keys is the number of keys to be stored. The table is
+	 * sized so that it is at most 95% loaded with num_keys keys.
+	 *
+	 * num_keys is not used for sketch.
 	 */
 	uint32_t num_keys;
 
@@ -244,16 +286,26 @@ struct rte_member_parameters {
 	 * to number of entries (num_keys) divided by entry count per bucket
 	 * (RTE_MEMBER_BUCKET_ENTRIES). Thus, the false_positive_rate is not
 	 * directly set by users for HT mode.
+	 *
+	 * CF false positive rate is about 8/2^16 for a full table, since
+	 * 16-bit fingerprints are compared with 2 buckets of 4 entries.
+	 *
+	 * For sketch, false_positive_rate is the probability (delta) that the
+	 * estimated count error is above the error rate given to
+	 * rte_member_sketch_create(). It is used to calculate the number of
+	 * counter rows as ln(1/delta), up to 8 rows.
 	 */
 	float false_positive_rate;
 
 	/**
 	 * We use two seeds to calculate two independent hashes for each key.
 	 *
-	 * For HT type, one hash is used as signature, and the other is used
-	 * for bucket location.
+	 * For HT and CF type, one hash is used as signature, and the other is
+	 * used for bucket location.
 	 * For vBF type, these two hashes and their combinations are used as
 	 * hash locations to index the bit array.
+	 * For sketch type, combinations of the two hashes index the counter
+	 * rows.
 	 */
 	uint32_t prim_hash_seed;
 
@@ -265,6 +317,30 @@ struct rte_member_parameters {
 	int socket_id;			/**< NUMA Socket ID for memory. */
 };
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change without prior notice
+ *
+ * Parameters specific to the sketch set-summary, used with the
+ * rte_member_parameters by rte_member_sketch_create().
+ */
+struct rte_member_sketch_parameters {
+	/**
+	 * The estimated count of a key is never less than the real one, and
+	 * it is at most error_rate * total count more than the real one with
+	 * probability of 1 - false_positive_rate. It is used to calculate the
+	 * number of counters in each row as e/error_rate.
+	 */
+	float error_rate;
+
+	/**
+	 * Number of keys with the highest estimated counts that are tracked
+	 * and reported by rte_member_report_heavyhitter(), up to
+	 * RTE_MEMBER_TOP_K_MAX. Set to 0 to disable the tracking.
+	 */
+	uint32_t top_k;
+};
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -286,6 +362,7 @@ rte_member_find_existing(const char *name);
  * @b EXPERIMENTAL: this API may change without prior notice
  *
  * Create set-summary (SS).
+ * A sketch set-summary is created by rte_member_sketch_create().
  *
  * @param params
  *   Parameters to initialize the setsummary.
@@ -296,6 +373,26 @@ rte_member_find_existing(const char *name);
 struct rte_member_setsum *
 rte_member_create(const struct rte_member_parameters *params);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a sketch set-summary.
+ *
+ * @param params
+ *   Parameters to initialize the setsummary, the type must be
+ *   RTE_MEMBER_TYPE_SKETCH.
+ * @param sketch_params
+ *   Parameters specific to the sketch.
+ * @return
+ *   Return the pointer to the setsummary.
+ *   Return value is NULL if the creation failed, with rte_errno set.
+ */
+__rte_experimental
+struct rte_member_setsum *
+rte_member_sketch_create(const struct rte_member_parameters *params,
+		const struct rte_member_sketch_parameters *sketch_params);
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -420,6 +517,9 @@ rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
  *   For HT mode, the set_id has range as [1, 0x7FFF], MSB is reserved.
  *   For vBF mode the set id is limited by the num_set parameter when create
  *   the set-summary.
+ *   For CF mode the set_id must be 1.
+ *   For sketch mode the set_id is ignored, and the count of the key is
+ *   incremented by one.
  * @return
  *   HT (cache mode) and vBF should never fail unless the set_id is not in the
  *   valid range. In such case -EINVAL is returned.
@@ -431,6 +531,8 @@ rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
  *   eviction, return 1 otherwise. Return 0 for non-cache mode if success,
  *   -ENOSPC for full, and 1 if cuckoo eviction happens.
  *   Always returns 0 for vBF mode.
+ *   Return 0 for CF mode if success, 1 if cuckoo eviction happens and
+ *   -ENOSPC for full. Always returns 0 for sketch mode.
  */
 int
 rte_member_add(const struct rte_member_setsum *setsum, const void *key,
@@ -465,8 +567,9 @@ rte_member_reset(const struct rte_member_setsum *setsum);
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
  *
- * Delete items from the set-summary. Note that vBF does not support deletion
- * in current implementation. For vBF, error code of -EINVAL will be returned.
+ * Delete items from the set-summary. Note that vBF and sketch do not support
+ * deletion in current implementation. For them, error code of -EINVAL will be
+ * returned.
  *
  * @param setsum
  *   Pointer to the set-summary.
@@ -476,6 +579,9 @@ rte_member_reset(const struct rte_member_setsum *setsum);
  *   For HT mode, we need both key and its corresponding set_id to
  *   properly delete the key. Without set_id, we may delete other keys with the
  *   same signature.
+ *   For CF mode, set_id must be 1. One copy of the key is deleted, the
+ *   key must have been added before, otherwise another key with the
+ *   same fingerprint may be deleted.
  * @return
  *   If no entry found to delete, an error code of -ENOENT could be returned.
  */
@@ -483,6 +589,120 @@ int
 rte_member_delete(const struct rte_member_setsum *setsum, const void *key,
 			member_set_t set_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add count to a key in a sketch set-summary.
+ *
+ * @param setsum
+ *   Pointer to the sketch set-summary.
+ * @param key
+ *   Pointer of the key to be counted.
+ * @param count
+ *   The count to add to the key, e.g. 1 for a packet or the packet length.
+ * @return
+ *   0 on success, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_add_count(const struct rte_member_setsum *setsum, const void *key,
+			uint64_t count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add counts to a bulk of keys in a sketch set-summary.
+ *
+ * @param setsum
+ *   Pointer to the sketch set-summary.
+ * @param keys
+ *   Pointer of the bulk of keys to be counted.
+ * @param num_keys
+ *   Number of keys in the bulk.
+ * @param counts
+ *   The counts to add to each key, or NULL to add 1 to each key.
+ * @return
+ *   0 on success, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_add_count_bulk(const struct rte_member_setsum *setsum,
+			const void **keys, uint32_t num_keys,
+			const uint64_t *counts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Query the estimated count of a key in a sketch set-summary.
+ *
+ * @param setsum
+ *   Pointer to the sketch set-summary.
+ * @param key
+ *   Pointer of the key to be queried.
+ * @param count
+ *   Output the estimated count of the key. It is never less than the
+ *   real count.
+ * @return
+ *   1 if the estimated count is not 0, 0 otherwise. -EINVAL if the
+ *   set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_query_count(const struct rte_member_setsum *setsum,
+			const void *key, uint64_t *count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Query the estimated counts of a bulk of keys in a sketch set-summary.
+ *
+ * @param setsum
+ *   Pointer to the sketch set-summary.
+ * @param keys
+ *   Pointer of the bulk of keys to be queried.
+ * @param num_keys
+ *   Number of keys in the bulk.
+ * @param counts
+ *   Output the estimated counts of all the keys to this array.
+ * @return
+ *   The number of keys with non zero estimated count. -EINVAL if the
+ *   set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_query_count_bulk(const struct rte_member_setsum *setsum,
+			const void **keys, uint32_t num_keys,
+			uint64_t *counts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Report the heavy hitters tracked by a sketch set-summary, that is the keys
+ * with the highest estimated counts.
+ *
+ * @param setsum
+ *   Pointer to the sketch set-summary.
+ * @param keys
+ *   Output pointers to the heavy hitter keys. The keys are stored in the
+ *   set-summary and may be overwritten by the next add or reset. User needs
+ *   to preallocate the array for top_k pointers.
+ * @param counts
+ *   Output the estimated counts of the heavy hitters. User needs to
+ *   preallocate the array for top_k counts.
+ * @return
+ *   The number of heavy hitters reported, sorted by descending count.
+ *   -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_report_heavyhitter(const struct rte_member_setsum *setsum,
+			const void **keys, uint64_t *counts);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,357 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_prefetch.h>
+#include <rte_random.h>
+#include <rte_log.h>
+#include <rte_vect.h>
+
+#include "rte_member.h"
+#include "rte_member_ht.h"
+#include "rte_member_cf.h"
+
+#if defined(RTE_ARCH_X86)
+#include "rte_member_x86.h"
+#endif
+
+/*
+ * Cuckoo filter keeps only a 16-bit fingerprint of each key, in one of two
+ * buckets of 4 entries. The alternative bucket is derived from the current
+ * one and the fingerprint, so entries can be moved (kicked) to make space
+ * and deleted without storing the key, see B. Fan, et al's paper
+ * "Cuckoo Filter: Practically Better Than Bloom".
+ * With 4 entries per bucket the table can be loaded up to ~95%, and the
+ * false positive rate is about 2 * 4 / 2^16, i.e. 1.2e-4.
+ */
+
+/* Multiplier to spread fingerprint bits over the bucket index */
+#define CF_FP_MULT	0x5bd1e995
+
+/* Load factor limit used to size the table, in percents */
+#define CF_LOAD_MAX	95
+
+/* Search bucket for fingerprint */
+static inline int
+search_bucket_cf(const struct member_cf_bucket *bkt, member_fp_t fp)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_MEMBER_CF_BUCKET_ENTRIES; i++) {
+		if (bkt->fps[i] == fp)
+			return 1;
+	}
+	return 0;
+}
+
+static inline int
+search_buckets_cf(const struct member_cf_bucket *buckets, uint32_t prim,
+		uint32_t sec, member_fp_t fp,
+		enum rte_member_sig_compare_function cmp_fn)
+{
+	switch (cmp_fn) {
+#if defined(RTE_ARCH_X86) && defined(__AVX2__)
+	case RTE_MEMBER_COMPARE_AVX2:
+		return search_buckets_cf_avx(&buckets[prim], &buckets[sec], fp);
+#endif
+	default:
+		return search_bucket_cf(&buckets[prim], fp) ||
+			search_bucket_cf(&buckets[sec], fp);
+	}
+}
+
+int
+rte_member_create_cf(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params)
+{
+	uint32_t num_buckets;
+	struct member_cf_bucket *buckets;
+
+	if (params->num_keys == 0 ||
+			params->num_keys > RTE_MEMBER_ENTRIES_MAX) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR,
+			"Membership CF create with invalid parameters\n");
+		return -EINVAL;
+	}
+
+	num_buckets = rte_align32pow2((params->num_keys +
+		RTE_MEMBER_CF_BUCKET_ENTRIES - 1) /
+		RTE_MEMBER_CF_BUCKET_ENTRIES);
+
+	/* Keep the expected load below the limit */
+	if ((uint64_t)num_buckets * RTE_MEMBER_CF_BUCKET_ENTRIES *
+			CF_LOAD_MAX < (uint64_t)params->num_keys * 100)
+		num_buckets <<= 1;
+
+	buckets = rte_zmalloc_socket(NULL,
+			num_buckets * sizeof(struct member_cf_bucket),
+			RTE_CACHE_LINE_SIZE, ss->socket_id);
+	if (buckets == NULL) {
+		RTE_MEMBER_LOG(ERR, "memory allocation failed for CF "
+						"setsummary\n");
+		return -ENOMEM;
+	}
+
+	ss->table = buckets;
+	ss->bucket_cnt = num_buckets;
+	ss->bucket_mask = num_buckets - 1;
+
+#if defined(RTE_ARCH_X86)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256)
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_AVX2;
+	else
+#endif
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_SCALAR;
+
+	RTE_MEMBER_LOG(DEBUG, "Cuckoo filter created, "
+			"the table has %u entries, %u buckets\n",
+			num_buckets * RTE_MEMBER_CF_BUCKET_ENTRIES, num_buckets);
+	return 0;
+}
+
+static inline uint32_t
+get_alt_bucket_index(const struct rte_member_setsum *ss, uint32_t bkt,
+		member_fp_t fp)
+{
+	return (bkt ^ ((uint32_t)fp * CF_FP_MULT)) & ss->bucket_mask;
+}
+
+static inline void
+get_buckets_index(const struct rte_member_setsum *ss, const void *key,
+		uint32_t *prim_bkt, uint32_t *sec_bkt, member_fp_t *fp)
+{
+	uint32_t first_hash = MEMBER_HASH_FUNC(key, ss->key_len,
+						ss->prim_hash_seed);
+	uint32_t sec_hash = MEMBER_HASH_FUNC(&first_hash, sizeof(uint32_t),
+						ss->sec_hash_seed);
+
+	/*
+	 * Same as for HT setsummary, the first hash value is used for the
+	 * fingerprint and the second one for the bucket location.
+	 * Zero fingerprint marks an empty entry, so it is never used.
+	 */
+	*fp = first_hash;
+	if (*fp == 0)
+		*fp = 1;
+	*prim_bkt = sec_hash & ss->bucket_mask;
+	*sec_bkt = get_alt_bucket_index(ss, *prim_bkt, *fp);
+}
+
+int
+rte_member_lookup_cf(const struct rte_member_setsum *ss,
+		const void *key, member_set_t *set_id)
+{
+	uint32_t prim_bucket, sec_bucket;
+	member_fp_t fp;
+	const struct member_cf_bucket *buckets = ss->table;
+
+	get_buckets_index(ss, key, &prim_bucket, &sec_bucket, &fp);
+
+	if (search_buckets_cf(buckets, prim_bucket, sec_bucket, fp,
+			ss->sig_cmp_fn)) {
+		*set_id = RTE_MEMBER_CF_SET_ID;
+		return 1;
+	}
+
+	*set_id = RTE_MEMBER_NO_MATCH;
+	return 0;
+}
+
+uint32_t
+rte_member_lookup_bulk_cf(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, member_set_t *set_ids)
+{
+	uint32_t i, hit;
+	uint32_t num_matches = 0;
+	const struct member_cf_bucket *buckets = ss->table;
+	member_fp_t fps[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t prim_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t sec_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	for (i = 0; i < num_keys; i++) {
+		get_buckets_index(ss, keys[i], &prim_buckets[i],
+				&sec_buckets[i], &fps[i]);
+		rte_prefetch0(&buckets[prim_buckets[i]]);
+		rte_prefetch0(&buckets[sec_buckets[i]]);
+	}
+
+	i = 0;
+	switch (ss->sig_cmp_fn) {
+#if defined(RTE_ARCH_X86) && defined(__AVX2__)
+	case RTE_MEMBER_COMPARE_AVX2:
+		/* compare fingerprints of two keys at once */
+		for (; i + 1 < num_keys; i += 2) {
+			hit = search_buckets_cf_x2_avx(buckets,
+				&prim_buckets[i], &sec_buckets[i], &fps[i]);
+			set_ids[i] = (hit & 1) ?
+				RTE_MEMBER_CF_SET_ID : RTE_MEMBER_NO_MATCH;
+			set_ids[i + 1] = (hit & 2) ?
+				RTE_MEMBER_CF_SET_ID : RTE_MEMBER_NO_MATCH;
+			num_matches += (hit & 1) + (hit >> 1);
+		}
+		break;
+#endif
+	default:
+		break;
+	}
+
+	for (; i < num_keys; i++) {
+		hit = search_buckets_cf(buckets, prim_buckets[i],
+			sec_buckets[i], fps[i], ss->sig_cmp_fn);
+		set_ids[i] = hit ? RTE_MEMBER_CF_SET_ID : RTE_MEMBER_NO_MATCH;
+		num_matches += hit;
+	}
+
+	return num_matches;
+}
+
+uint32_t
+rte_member_lookup_multi_cf(const struct rte_member_setsum *ss,
+		const void *key, uint32_t match_per_key,
+		member_set_t *set_id)
+{
+	/* Cuckoo filter keeps one set only, so there is at most one match */
+	if (match_per_key == 0)
+		return 0;
+
+	return rte_member_lookup_cf(ss, key, set_id);
+}
+
+uint32_t
+rte_member_lookup_multi_bulk_cf(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint32_t match_per_key,
+		uint32_t *match_count,
+		member_set_t *set_ids)
+{
+	uint32_t i, num_matches;
+	member_set_t set_id[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	if (match_per_key == 0) {
+		for (i = 0; i < num_keys; i++)
+			match_count[i] = 0;
+		return 0;
+	}
+
+	num_matches = rte_member_lookup_bulk_cf(ss, keys, num_keys, set_id);
+
+	for (i = 0; i < num_keys; i++) {
+		match_count[i] = (set_id[i] != RTE_MEMBER_NO_MATCH);
+		set_ids[i * match_per_key] = set_id[i];
+	}
+
+	return num_matches;
+}
+
+static inline int
+try_insert(struct member_cf_bucket *bkt, member_fp_t fp)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_MEMBER_CF_BUCKET_ENTRIES; i++) {
+		if (bkt->fps[i] == 0) {
+			bkt->fps[i] = fp;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+int
+rte_member_add_cf(const struct rte_member_setsum *ss,
+		const void *key, member_set_t set_id)
+{
+	uint32_t i, n, slot;
+	uint32_t prim_bucket, sec_bucket, bkt;
+	member_fp_t fp, victim;
+	struct member_cf_bucket *buckets = ss->table;
+	struct {
+		uint32_t bkt;
+		uint32_t slot;
+	} path[RTE_MEMBER_CF_MAX_KICKS];
+
+	if (set_id != RTE_MEMBER_CF_SET_ID)
+		return -EINVAL;
+
+	get_buckets_index(ss, key, &prim_bucket, &sec_bucket, &fp);
+
+	/* If not full then insert into one slot */
+	if (try_insert(&buckets[prim_bucket], fp) == 0 ||
+			try_insert(&buckets[sec_bucket], fp) == 0)
+		return 0;
+
+	/*
+	 * Both buckets are full, kick a random entry to its alternative
+	 * bucket, until an empty entry is found. The path is recorded,
+	 * so that the kicks can be rolled back when the table is full,
+	 * otherwise the last kicked entry would be lost (false negative).
+	 */
+	bkt = (rte_rand() & 1) ? prim_bucket : sec_bucket;
+	for (n = 0; n < RTE_MEMBER_CF_MAX_KICKS; n++) {
+		slot = rte_rand() & (RTE_MEMBER_CF_BUCKET_ENTRIES - 1);
+		path[n].bkt = bkt;
+		path[n].slot = slot;
+
+		victim = buckets[bkt].fps[slot];
+		buckets[bkt].fps[slot] = fp;
+		fp = victim;
+
+		bkt = get_alt_bucket_index(ss, bkt, fp);
+		if (try_insert(&buckets[bkt], fp) == 0)
+			return 1;
+	}
+
+	/* Table is full, put kicked entries back */
+	for (i = n; i-- != 0; ) {
+		victim = buckets[path[i].bkt].fps[path[i].slot];
+		buckets[path[i].bkt].fps[path[i].slot] = fp;
+		fp = victim;
+	}
+
+	return -ENOSPC;
+}
+
+void
+rte_member_free_cf(struct rte_member_setsum *ss)
+{
+	rte_free(ss->table);
+}
+
+int
+rte_member_delete_cf(const struct rte_member_setsum *ss, const void *key,
+		member_set_t set_id)
+{
+	uint32_t i;
+	uint32_t prim_bucket, sec_bucket;
+	member_fp_t fp;
+	struct member_cf_bucket *buckets = ss->table;
+
+	if (set_id != RTE_MEMBER_CF_SET_ID)
+		return -EINVAL;
+
+	get_buckets_index(ss, key, &prim_bucket, &sec_bucket, &fp);
+
+	for (i = 0; i < RTE_MEMBER_CF_BUCKET_ENTRIES; i++) {
+		if (buckets[prim_bucket].fps[i] == fp) {
+			buckets[prim_bucket].fps[i] = 0;
+			return 0;
+		}
+	}
+
+	for (i = 0; i < RTE_MEMBER_CF_BUCKET_ENTRIES; i++) {
+		if (buckets[sec_bucket].fps[i] == fp) {
+			buckets[sec_bucket].fps[i] = 0;
+			return 0;
+		}
+	}
+	return -ENOENT;
+}
+
+void
+rte_member_reset_cf(const struct rte_member_setsum *ss)
+{
+	memset(ss->table, 0, ss->bucket_cnt * sizeof(struct member_cf_bucket));
+}
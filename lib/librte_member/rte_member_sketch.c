@@ -0,0 +1,396 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_prefetch.h>
+#include <rte_log.h>
+#include <rte_vect.h>
+
+#include "rte_member.h"
+#include "rte_member_ht.h"
+#include "rte_member_sketch.h"
+
+#if defined(RTE_ARCH_X86)
+#include "rte_member_x86.h"
+#endif
+
+/*
+ * Count-min sketch is a num_row x num_col array of counters, each row is
+ * indexed by a different hash of the key, see G. Cormode, et al's paper
+ * "An Improved Data Stream Summary: The Count-Min Sketch and its
+ * Applications".
+ * The count of a key is estimated as the minimum of its counters, it never
+ * underestimates, and with probability of at least 1 - delta the error is
+ * less than epsilon * N, N being the total count added to the sketch.
+ * With num_col = e / epsilon and num_row = ln(1 / delta).
+ *
+ * The row hashes are derived from two hash values as h1 + row * h2.
+ * Besides the counters, the keys with the top_k highest estimated counts are
+ * tracked in a min-heap, so the heavy hitters can be reported.
+ */
+
+int
+rte_member_create_sketch(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params,
+		const struct rte_member_sketch_parameters *sketch_params)
+{
+	uint32_t num_col, num_row, top_k;
+	size_t size;
+	uint8_t *p;
+	struct member_sketch *sk;
+
+	if (sketch_params->error_rate <= 0 || sketch_params->error_rate >= 1 ||
+			params->false_positive_rate <= 0 ||
+			params->false_positive_rate >= 1 ||
+			sketch_params->top_k > RTE_MEMBER_TOP_K_MAX) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR,
+			"Membership sketch create with invalid parameters\n");
+		return -EINVAL;
+	}
+
+	num_col = rte_align32pow2((uint32_t)ceil(M_E /
+			sketch_params->error_rate));
+	num_row = (uint32_t)ceil(log(1 / params->false_positive_rate));
+	num_row = RTE_MAX(num_row, 1U);
+	num_row = RTE_MIN(num_row, (uint32_t)RTE_MEMBER_SKETCH_MAX_ROW);
+	top_k = sketch_params->top_k;
+
+	if (num_col == 0 || (uint64_t)num_col * num_row >
+			RTE_MEMBER_ENTRIES_MAX) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR,
+			"Membership sketch error rate is too small\n");
+		return -EINVAL;
+	}
+
+	size = sizeof(struct member_sketch) +
+		(size_t)num_col * num_row * sizeof(uint64_t) +
+		(size_t)top_k * (3 * sizeof(uint32_t) + sizeof(uint64_t) +
+			ss->key_len);
+
+	p = rte_zmalloc_socket(NULL, size, RTE_CACHE_LINE_SIZE,
+			ss->socket_id);
+	if (p == NULL) {
+		RTE_MEMBER_LOG(ERR, "memory allocation failed for sketch "
+						"setsummary\n");
+		return -ENOMEM;
+	}
+
+	/* Counters first to keep them cache line aligned */
+	sk = (struct member_sketch *)(p + (size_t)num_col * num_row *
+			sizeof(uint64_t));
+	sk->counters = (uint64_t *)p;
+	sk->hh_count = (uint64_t *)(sk + 1);
+	sk->heap = (uint32_t *)(sk->hh_count + top_k);
+	sk->pos = sk->heap + top_k;
+	sk->hh_hash = sk->pos + top_k;
+	sk->hh_keys = (uint8_t *)(sk->hh_hash + top_k);
+
+	ss->table = sk;
+	ss->num_row = num_row;
+	ss->num_col = num_col;
+	ss->col_mask = num_col - 1;
+	ss->top_k = top_k;
+
+#if defined(RTE_ARCH_X86)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256)
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_AVX2;
+	else
+#endif
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_SCALAR;
+
+	RTE_MEMBER_LOG(DEBUG, "Count-min sketch created, "
+			"%u rows of %u counters, tracking top %u keys\n",
+			num_row, num_col, top_k);
+	return 0;
+}
+
+static inline void
+get_hashes(const struct rte_member_setsum *ss, const void *key,
+		uint32_t *h1, uint32_t *h2)
+{
+	*h1 = MEMBER_HASH_FUNC(key, ss->key_len, ss->prim_hash_seed);
+	*h2 = MEMBER_HASH_FUNC(h1, sizeof(uint32_t), ss->sec_hash_seed);
+}
+
+static inline void
+get_index(const struct rte_member_setsum *ss, uint32_t h1, uint32_t h2,
+		uint32_t *idx)
+{
+	uint32_t r;
+
+	switch (ss->sig_cmp_fn) {
+#if defined(RTE_ARCH_X86) && defined(__AVX2__)
+	case RTE_MEMBER_COMPARE_AVX2:
+		sketch_index_avx(h1, h2, ss->col_mask, ss->num_col, idx);
+		break;
+#endif
+	default:
+		/* There is always at least one row */
+		idx[0] = h1 & ss->col_mask;
+		for (r = 1; r < ss->num_row; r++)
+			idx[r] = ((h1 + r * h2) & ss->col_mask) +
+				r * ss->num_col;
+	}
+}
+
+static inline uint64_t
+query_index(const struct rte_member_setsum *ss, const uint64_t *counters,
+		const uint32_t *idx)
+{
+	uint32_t r;
+	uint64_t min;
+
+	switch (ss->sig_cmp_fn) {
+#if defined(RTE_ARCH_X86) && defined(__AVX2__)
+	case RTE_MEMBER_COMPARE_AVX2:
+		return sketch_query_avx(counters, idx, ss->num_row);
+#endif
+	default:
+		min = counters[idx[0]];
+		for (r = 1; r < ss->num_row; r++)
+			min = RTE_MIN(min, counters[idx[r]]);
+		return min;
+	}
+}
+
+static inline void
+heap_swap(struct member_sketch *sk, uint32_t i, uint32_t j)
+{
+	uint32_t t = sk->heap[i];
+
+	sk->heap[i] = sk->heap[j];
+	sk->heap[j] = t;
+	sk->pos[sk->heap[i]] = i;
+	sk->pos[sk->heap[j]] = j;
+}
+
+static void
+heap_up(struct member_sketch *sk, uint32_t i)
+{
+	uint32_t parent;
+
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (sk->hh_count[sk->heap[parent]] <=
+				sk->hh_count[sk->heap[i]])
+			break;
+		heap_swap(sk, i, parent);
+		i = parent;
+	}
+}
+
+static void
+heap_down(struct member_sketch *sk, uint32_t i)
+{
+	uint32_t l, min;
+
+	for (;;) {
+		min = i;
+		l = 2 * i + 1;
+		if (l < sk->num_hh && sk->hh_count[sk->heap[l]] <
+				sk->hh_count[sk->heap[min]])
+			min = l;
+		if (l + 1 < sk->num_hh && sk->hh_count[sk->heap[l + 1]] <
+				sk->hh_count[sk->heap[min]])
+			min = l + 1;
+		if (min == i)
+			break;
+		heap_swap(sk, i, min);
+		i = min;
+	}
+}
+
+/* Update the top-k heavy hitters with the new estimated count of the key */
+static void
+update_topk(const struct rte_member_setsum *ss, const void *key,
+		uint32_t h1, uint64_t count)
+{
+	struct member_sketch *sk = ss->table;
+	uint32_t i, slot;
+
+	if (ss->top_k == 0)
+		return;
+
+	/*
+	 * Most keys are not heavy hitters, skip them as early as possible.
+	 * A tracked key with count not above the minimum already has the
+	 * right count, since estimates never decrease.
+	 */
+	if (sk->num_hh == ss->top_k && count <= sk->hh_count[sk->heap[0]])
+		return;
+
+	for (i = 0; i < sk->num_hh; i++) {
+		if (sk->hh_hash[i] == h1 && memcmp(&sk->hh_keys[i *
+				ss->key_len], key, ss->key_len) == 0) {
+			sk->hh_count[i] = count;
+			heap_down(sk, sk->pos[i]);
+			return;
+		}
+	}
+
+	if (sk->num_hh < ss->top_k) {
+		slot = sk->num_hh++;
+		sk->heap[slot] = slot;
+		sk->pos[slot] = slot;
+	} else
+		/* Replace the smallest heavy hitter */
+		slot = sk->heap[0];
+
+	sk->hh_hash[slot] = h1;
+	sk->hh_count[slot] = count;
+	memcpy(&sk->hh_keys[slot * ss->key_len], key, ss->key_len);
+	if (sk->pos[slot] == 0)
+		heap_down(sk, 0);
+	else
+		heap_up(sk, sk->pos[slot]);
+}
+
+static inline void
+add_index(const struct rte_member_setsum *ss, const void *key,
+		uint32_t h1, const uint32_t *idx, uint64_t count)
+{
+	struct member_sketch *sk = ss->table;
+	uint32_t r;
+
+	for (r = 0; r < ss->num_row; r++)
+		sk->counters[idx[r]] += count;
+
+	update_topk(ss, key, h1, query_index(ss, sk->counters, idx));
+}
+
+int
+rte_member_add_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint64_t count)
+{
+	uint32_t h1, h2;
+	uint32_t idx[RTE_MEMBER_SKETCH_MAX_ROW];
+
+	get_hashes(ss, key, &h1, &h2);
+	get_index(ss, h1, h2, idx);
+	add_index(ss, key, h1, idx, count);
+
+	return 0;
+}
+
+void
+rte_member_add_bulk_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, const uint64_t *counts)
+{
+	uint32_t i, n, r, h2;
+	const struct member_sketch *sk = ss->table;
+	uint32_t h1[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t idx[RTE_MEMBER_LOOKUP_BULK_MAX][RTE_MEMBER_SKETCH_MAX_ROW];
+
+	while (num_keys != 0) {
+		n = RTE_MIN(num_keys, (uint32_t)RTE_MEMBER_LOOKUP_BULK_MAX);
+
+		for (i = 0; i < n; i++) {
+			get_hashes(ss, keys[i], &h1[i], &h2);
+			get_index(ss, h1[i], h2, idx[i]);
+			for (r = 0; r < ss->num_row; r++)
+				rte_prefetch0(&sk->counters[idx[i][r]]);
+		}
+
+		for (i = 0; i < n; i++)
+			add_index(ss, keys[i], h1[i], idx[i],
+				counts == NULL ? 1 : counts[i]);
+
+		keys += n;
+		if (counts != NULL)
+			counts += n;
+		num_keys -= n;
+	}
+}
+
+uint64_t
+rte_member_query_sketch(const struct rte_member_setsum *ss,
+		const void *key)
+{
+	uint32_t h1, h2;
+	const struct member_sketch *sk = ss->table;
+	uint32_t idx[RTE_MEMBER_SKETCH_MAX_ROW];
+
+	get_hashes(ss, key, &h1, &h2);
+	get_index(ss, h1, h2, idx);
+
+	return query_index(ss, sk->counters, idx);
+}
+
+uint32_t
+rte_member_query_bulk_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint64_t *counts)
+{
+	uint32_t i, n, r, h1, h2;
+	uint32_t num_matches = 0;
+	const struct member_sketch *sk = ss->table;
+	uint32_t idx[RTE_MEMBER_LOOKUP_BULK_MAX][RTE_MEMBER_SKETCH_MAX_ROW];
+
+	while (num_keys != 0) {
+		n = RTE_MIN(num_keys, (uint32_t)RTE_MEMBER_LOOKUP_BULK_MAX);
+
+		for (i = 0; i < n; i++) {
+			get_hashes(ss, keys[i], &h1, &h2);
+			get_index(ss, h1, h2, idx[i]);
+			for (r = 0; r < ss->num_row; r++)
+				rte_prefetch0(&sk->counters[idx[i][r]]);
+		}
+
+		for (i = 0; i < n; i++) {
+			counts[i] = query_index(ss, sk->counters, idx[i]);
+			num_matches += (counts[i] != 0);
+		}
+
+		keys += n;
+		counts += n;
+		num_keys -= n;
+	}
+
+	return num_matches;
+}
+
+uint32_t
+rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint64_t *counts)
+{
+	const struct member_sketch *sk = ss->table;
+	uint32_t i, j;
+
+	/* Insertion sort by descending count, top_k is small */
+	for (i = 0; i < sk->num_hh; i++) {
+		for (j = i; j > 0 && counts[j - 1] < sk->hh_count[i]; j--) {
+			counts[j] = counts[j - 1];
+			keys[j] = keys[j - 1];
+		}
+		counts[j] = sk->hh_count[i];
+		keys[j] = &sk->hh_keys[i * ss->key_len];
+	}
+
+	return sk->num_hh;
+}
+
+void
+rte_member_free_sketch(struct rte_member_setsum *ss)
+{
+	const struct member_sketch *sk = ss->table;
+
+	/* The table was allocated starting from the counters */
+	rte_free(sk->counters);
+}
+
+void
+rte_member_reset_sketch(const struct rte_member_setsum *ss)
+{
+	struct member_sketch *sk = ss->table;
+
+	memset(sk->counters, 0,
+		(size_t)ss->num_row * ss->num_col * sizeof(uint64_t));
+	sk->num_hh = 0;
+}
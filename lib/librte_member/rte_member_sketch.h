@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 The DPDK contributors
+ */
+
+#ifndef _RTE_MEMBER_SKETCH_H_
+#define _RTE_MEMBER_SKETCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of counter rows (hash functions) in sketch mode. */
+#define RTE_MEMBER_SKETCH_MAX_ROW 8
+
+/*
+ * Count-min sketch runtime structure, it is the table of the setsum.
+ * Counters are laid out row by row, followed by the top-k tracking arrays.
+ * Top-k keys are kept in slots, the slot indices are organized as a min-heap
+ * ordered by the slot count, so the smallest heavy hitter is at the root.
+ */
+struct member_sketch {
+	uint64_t *counters;	/* num_row * num_col counters. */
+	uint32_t num_hh;	/* Number of tracked heavy hitters. */
+	uint32_t *heap;		/* Min-heap of slot indices. */
+	uint32_t *pos;		/* Heap position of each slot. */
+	uint32_t *hh_hash;	/* Primary hash of the key in each slot. */
+	uint64_t *hh_count;	/* Estimated count of the key in each slot. */
+	uint8_t *hh_keys;	/* Key of each slot, key_len bytes each. */
+};
+
+int
+rte_member_create_sketch(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params,
+		const struct rte_member_sketch_parameters *sketch_params);
+
+int
+rte_member_add_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint64_t count);
+
+void
+rte_member_add_bulk_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, const uint64_t *counts);
+
+uint64_t
+rte_member_query_sketch(const struct rte_member_setsum *ss,
+		const void *key);
+
+uint32_t
+rte_member_query_bulk_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint64_t *counts);
+
+uint32_t
+rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *ss,
+		const void **keys, uint64_t *counts);
+
+void
+rte_member_free_sketch(struct rte_member_setsum *ss);
+
+void
+rte_member_reset_sketch(const struct rte_member_setsum *ss);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_SKETCH_H_ */
@@ -69,6 +69,89 @@ search_bucket_multi_avx(uint32_t bucket_id, member_sig_t tmp_sig,
 		hitmask &= ~(3U << ((hit_idx) << 1));
 	}
 }
+
+#ifdef _RTE_MEMBER_CF_H_
+/* Compare the fingerprint against both buckets of the key at once */
+static inline int
+search_buckets_cf_avx(const struct member_cf_bucket *prim,
+		const struct member_cf_bucket *sec, member_fp_t fp)
+{
+	uint32_t hitmask = _mm_movemask_epi8(_mm_cmpeq_epi16(
+		_mm_set_epi64x(sec->val, prim->val),
+		_mm_set1_epi16(fp)));
+	return hitmask != 0;
+}
+
+/*
+ * Compare the fingerprints of two keys against their buckets at once.
+ * Bit 0 of the return value is set if the first key matches, bit 1 if the
+ * second one matches.
+ */
+static inline uint32_t
+search_buckets_cf_x2_avx(const struct member_cf_bucket *buckets,
+		const uint32_t *prim, const uint32_t *sec,
+		const member_fp_t *fp)
+{
+	__m256i fps = _mm256_inserti128_si256(
+		_mm256_castsi128_si256(_mm_set1_epi16(fp[0])),
+		_mm_set1_epi16(fp[1]), 1);
+	uint32_t hitmask = _mm256_movemask_epi8(_mm256_cmpeq_epi16(
+		_mm256_set_epi64x(buckets[sec[1]].val, buckets[prim[1]].val,
+			buckets[sec[0]].val, buckets[prim[0]].val),
+		fps));
+	return ((hitmask & 0xffff) != 0) | ((hitmask >> 16 != 0) << 1);
+}
+#endif
+
+#ifdef _RTE_MEMBER_SKETCH_H_
+/* Calculate the counter index of the key for all (up to 8) rows */
+static inline void
+sketch_index_avx(uint32_t h1, uint32_t h2, uint32_t col_mask,
+		uint32_t num_col, uint32_t *idx)
+{
+	const __m256i rows = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+	__m256i v;
+
+	v = _mm256_add_epi32(_mm256_set1_epi32(h1),
+		_mm256_mullo_epi32(_mm256_set1_epi32(h2), rows));
+	v = _mm256_and_si256(v, _mm256_set1_epi32(col_mask));
+	v = _mm256_add_epi32(v,
+		_mm256_mullo_epi32(_mm256_set1_epi32(num_col), rows));
+	_mm256_storeu_si256((__m256i *)idx, v);
+}
+
+/*
+ * Gather the counters of all rows and return the minimum one.
+ * Counters are compared as signed, they are not expected to reach 2^63.
+ */
+static inline uint64_t
+sketch_query_avx(const uint64_t *counters, const uint32_t *idx,
+		uint32_t num_row)
+{
+	const __m256i max = _mm256_set1_epi64x(INT64_MAX);
+	const __m256i nrow = _mm256_set1_epi64x(num_row);
+	__m256i lo, hi, gt;
+	__m128i l, h;
+
+	lo = _mm256_mask_i32gather_epi64(max, (const long long *)counters,
+		_mm_loadu_si128((const __m128i *)idx),
+		_mm256_cmpgt_epi64(nrow, _mm256_set_epi64x(3, 2, 1, 0)), 8);
+	hi = _mm256_mask_i32gather_epi64(max, (const long long *)counters,
+		_mm_loadu_si128((const __m128i *)(idx + 4)),
+		_mm256_cmpgt_epi64(nrow, _mm256_set_epi64x(7, 6, 5, 4)), 8);
+
+	gt = _mm256_cmpgt_epi64(lo, hi);
+	lo = _mm256_blendv_epi8(lo, hi, gt);
+
+	l = _mm256_castsi256_si128(lo);
+	h = _mm256_extracti128_si256(lo, 1);
+	l = _mm_blendv_epi8(l, h, _mm_cmpgt_epi64(l, h));
+	h = _mm_unpackhi_epi64(l, l);
+	l = _mm_blendv_epi8(l, h, _mm_cmpgt_epi64(l, h));
+
+	return _mm_cvtsi128_si64(l);
+}
+#endif
 #endif
 
 #ifdef __cplusplus
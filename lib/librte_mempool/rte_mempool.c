@@ -31,6 +31,9 @@
 #include <rte_spinlock.h>
 #include <rte_tailq.h>
 #include <rte_eal_paging.h>
+#include <rte_telemetry.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_service_component.h>
 
 #include "rte_mempool.h"
 #include "rte_mempool_trace.h"
@@ -698,6 +701,241 @@ rte_mempool_populate_anon(struct rte_mempool *mp)
 	return 0;
 }
 
+/* Objects returned by one lcore, queued together on the RCU defer queue. */
+struct mempool_rcu_batch {
+	uint32_t n;
+	uint32_t reserved;
+	void *objs[RTE_MEMPOOL_RCU_BATCH_SIZE];
+};
+
+/* Batch being filled by a lcore, and counters of this lcore. */
+struct mempool_rcu_lcore {
+	struct mempool_rcu_batch batch;
+	uint64_t queued;	/* Objects given to rte_mempool_put_rcu(). */
+	uint64_t reclaimed;	/* Objects put back in the mempool. */
+} __rte_cache_aligned;
+
+struct rte_mempool_rcu {
+	struct rte_rcu_qsbr *v;		/* RCU QSBR variable. */
+	struct rte_rcu_qsbr_dq *dq;	/* Defer queue of batches. */
+	uint32_t flags;			/* RTE_MEMPOOL_RCU_F_xxx flags. */
+	uint32_t reclaim_max;		/* Max batches to reclaim in one go. */
+	uint32_t service_id;		/* Reclaim service, if any. */
+	uint64_t queued;		/* Counters of non-EAL threads. */
+	uint64_t reclaimed;
+	struct mempool_rcu_lcore lcore[RTE_MAX_LCORE];
+};
+
+static void
+mempool_rcu_free_batch(void *p, void *e, unsigned int n)
+{
+	struct rte_mempool *mp = p;
+	struct mempool_rcu_batch *b = e;
+	unsigned int lcore_id = rte_lcore_id();
+
+	RTE_SET_USED(n);
+	rte_mempool_put_bulk(mp, b->objs, b->n);
+
+	if (lcore_id < RTE_MAX_LCORE)
+		mp->rcu->lcore[lcore_id].reclaimed += b->n;
+	else
+		__atomic_fetch_add(&mp->rcu->reclaimed, b->n,
+				__ATOMIC_RELAXED);
+}
+
+/* Queue a batch, or free it after a grace period if the queue is full. */
+static void
+mempool_rcu_enqueue(struct rte_mempool *mp, struct mempool_rcu_batch *b)
+{
+	struct rte_mempool_rcu *rcu = mp->rcu;
+
+	if (rte_rcu_qsbr_dq_enqueue(rcu->dq, b) == 0)
+		return;
+
+	rte_rcu_qsbr_synchronize(rcu->v, RTE_QSBR_THRID_INVALID);
+	mempool_rcu_free_batch(mp, b, 1);
+}
+
+static int32_t
+mempool_rcu_service_func(void *args)
+{
+	struct rte_mempool *mp = args;
+	unsigned int freed = 0;
+
+	rte_rcu_qsbr_dq_reclaim(mp->rcu->dq, mp->rcu->reclaim_max,
+			&freed, NULL, NULL);
+
+	return freed != 0 ? 0 : -EAGAIN;
+}
+
+int
+rte_mempool_rcu_qsbr_add(struct rte_mempool *mp,
+	const struct rte_mempool_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+	struct rte_service_spec service;
+	struct rte_mempool_rcu *rcu;
+	int ret;
+
+	if (mp == NULL || cfg == NULL || cfg->v == NULL ||
+			(cfg->flags & ~RTE_MEMPOOL_RCU_F_SERVICE) != 0)
+		return -EINVAL;
+	if (mp->rcu != NULL)
+		return -EEXIST;
+
+	rcu = rte_zmalloc_socket("MEMPOOL_RCU", sizeof(*rcu),
+			RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (rcu == NULL) {
+		RTE_LOG(ERR, MEMPOOL, "Cannot allocate mempool RCU state\n");
+		return -ENOMEM;
+	}
+	rcu->v = cfg->v;
+	rcu->flags = cfg->flags;
+	rcu->reclaim_max = cfg->reclaim_max;
+	if (rcu->reclaim_max == 0)
+		rcu->reclaim_max = RTE_MEMPOOL_RCU_DQ_RECLAIM_MAX;
+
+	snprintf(rcu_dq_name, sizeof(rcu_dq_name), "MP_RCU_%s", mp->name);
+	params.name = rcu_dq_name;
+	params.size = cfg->dq_size;
+	if (params.size == 0)
+		params.size = mp->size / RTE_MEMPOOL_RCU_BATCH_SIZE +
+			RTE_MAX_LCORE;
+	params.esize = sizeof(struct mempool_rcu_batch);
+	params.trigger_reclaim_limit = cfg->reclaim_thd;
+	params.max_reclaim_size = rcu->reclaim_max;
+	params.free_fn = mempool_rcu_free_batch;
+	params.p = mp;
+	params.v = cfg->v;
+	rcu->dq = rte_rcu_qsbr_dq_create(&params);
+	if (rcu->dq == NULL) {
+		RTE_LOG(ERR, MEMPOOL, "Mempool defer queue creation failed\n");
+		ret = -rte_errno;
+		rte_free(rcu);
+		return ret;
+	}
+
+	if (cfg->flags & RTE_MEMPOOL_RCU_F_SERVICE) {
+		memset(&service, 0, sizeof(service));
+		snprintf(service.name, sizeof(service.name), "mp_rcu_%s",
+			mp->name);
+		service.callback = mempool_rcu_service_func;
+		service.callback_userdata = mp;
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
+		service.socket_id = mp->socket_id;
+		ret = rte_service_component_register(&service,
+				&rcu->service_id);
+		if (ret < 0) {
+			RTE_LOG(ERR, MEMPOOL,
+				"Cannot register mempool RCU service\n");
+			rte_rcu_qsbr_dq_delete(rcu->dq);
+			rte_free(rcu);
+			return ret;
+		}
+		rte_service_component_runstate_set(rcu->service_id, 1);
+	}
+
+	mp->rcu = rcu;
+	return 0;
+}
+
+int
+rte_mempool_put_rcu(struct rte_mempool *mp, void *obj,
+	struct rte_rcu_qsbr *v)
+{
+	struct rte_mempool_rcu *rcu = mp->rcu;
+	unsigned int lcore_id = rte_lcore_id();
+	struct mempool_rcu_batch single;
+	struct mempool_rcu_lcore *lc;
+
+	if (rcu == NULL || rcu->v != v)
+		return -EINVAL;
+
+	if (lcore_id >= RTE_MAX_LCORE) {
+		single.n = 1;
+		single.objs[0] = obj;
+		__atomic_fetch_add(&rcu->queued, 1, __ATOMIC_RELAXED);
+		mempool_rcu_enqueue(mp, &single);
+		return 0;
+	}
+
+	lc = &rcu->lcore[lcore_id];
+	lc->batch.objs[lc->batch.n++] = obj;
+	lc->queued++;
+	if (lc->batch.n == RTE_MEMPOOL_RCU_BATCH_SIZE) {
+		mempool_rcu_enqueue(mp, &lc->batch);
+		lc->batch.n = 0;
+	}
+
+	return 0;
+}
+
+int
+rte_mempool_rcu_reclaim(struct rte_mempool *mp)
+{
+	struct rte_mempool_rcu *rcu = mp->rcu;
+	unsigned int lcore_id = rte_lcore_id();
+	struct mempool_rcu_lcore *lc;
+
+	if (rcu == NULL)
+		return -EINVAL;
+
+	if (lcore_id < RTE_MAX_LCORE) {
+		lc = &rcu->lcore[lcore_id];
+		if (lc->batch.n != 0) {
+			mempool_rcu_enqueue(mp, &lc->batch);
+			lc->batch.n = 0;
+		}
+	}
+
+	rte_rcu_qsbr_dq_reclaim(rcu->dq, rcu->reclaim_max, NULL, NULL, NULL);
+	return 0;
+}
+
+/*
+ * Release the RCU state. Objects still queued are put back in the mempool
+ * once the readers reported a quiescent state, so that no free callback
+ * runs after the state is freed.
+ */
+static void
+mempool_rcu_free(struct rte_mempool *mp)
+{
+	struct rte_mempool_rcu *rcu = mp->rcu;
+
+	if (rcu == NULL)
+		return;
+
+	if (rcu->flags & RTE_MEMPOOL_RCU_F_SERVICE) {
+		rte_service_component_runstate_set(rcu->service_id, 0);
+		while (rte_service_may_be_active(rcu->service_id) == 1)
+			rte_pause();
+		rte_service_component_unregister(rcu->service_id);
+	}
+	/* the defer queue is only deleted once empty */
+	while (rte_rcu_qsbr_dq_delete(rcu->dq) != 0)
+		rte_rcu_qsbr_synchronize(rcu->v, RTE_QSBR_THRID_INVALID);
+	rte_free(rcu);
+	mp->rcu = NULL;
+}
+
+static void
+mempool_rcu_dump(FILE *f, const struct rte_mempool *mp)
+{
+	const struct rte_mempool_rcu *rcu = mp->rcu;
+	uint64_t queued = rcu->queued;
+	uint64_t reclaimed = rcu->reclaimed;
+	unsigned int lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		queued += rcu->lcore[lcore_id].queued;
+		reclaimed += rcu->lcore[lcore_id].reclaimed;
+	}
+	fprintf(f, "  rcu:\n");
+	fprintf(f, "    queued_objs=%"PRIu64"\n", queued);
+	fprintf(f, "    reclaimed_objs=%"PRIu64"\n", reclaimed);
+}
+
 /* free a mempool */
 void
 rte_mempool_free(struct rte_mempool *mp)
@@ -711,18 +949,16 @@ rte_mempool_free(struct rte_mempool *mp)
 	mempool_list = RTE_TAILQ_CAST(rte_mempool_tailq.head, rte_mempool_list);
 	rte_mcfg_tailq_write_lock();
 	/* find out tailq entry */
-	TAILQ_FOREACH(te, mempool_list, next) {
-		if (te->data == (void *)mp)
-			break;
-	}
-
-	if (te != NULL) {
+	te = rte_eal_tailq_index_lookup(rte_mempool_tailq.head, mp->name);
+	if (te != NULL && te->data == (void *)mp) {
+		rte_eal_tailq_index_del(rte_mempool_tailq.head, mp->name);
 		TAILQ_REMOVE(mempool_list, te, next);
 		rte_free(te);
 	}
 	rte_mcfg_tailq_write_unlock();
 
 	rte_mempool_trace_free(mp);
+	mempool_rcu_free(mp);
 	rte_mempool_free_memchunks(mp);
 	rte_mempool_ops_free(mp);
 	rte_memzone_free(mp->mz);
@@ -736,6 +972,25 @@ mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
 	cache->len = 0;
 }
 
+/*
+ * Initialize a default cache in adaptive mode. Its size can range from a
+ * quarter to four times the requested size, and it can hold up to twice its
+ * maximum size, which must fit in the pool and in the objs array.
+ */
+static void
+mempool_cache_init_adaptive(struct rte_mempool_cache *cache,
+		struct rte_mempool_cache_adapt *ad, uint32_t size,
+		uint32_t pool_size)
+{
+	mempool_cache_init(cache, size);
+	cache->adaptive = 1;
+	memset(ad, 0, sizeof(*ad));
+	ad->base_size = size;
+	ad->min_size = RTE_MAX(size / 4, 1U);
+	ad->max_size = RTE_MIN(size * 4, (uint32_t)RTE_MEMPOOL_CACHE_MAX_SIZE);
+	ad->max_size = RTE_MAX(RTE_MIN(ad->max_size, pool_size / 2), size);
+}
+
 /*
  * Create and initialize a cache for objects that are retrieved from and
  * returned to an underlying mempool. This structure is identical to the
@@ -851,6 +1106,10 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 	mempool_size = MEMPOOL_HEADER_SIZE(mp, cache_size);
 	mempool_size += private_data_size;
 	mempool_size = RTE_ALIGN_CEIL(mempool_size, RTE_MEMPOOL_ALIGN);
+	/* adaptive state of the default caches follows the private data */
+	if (cache_size != 0 && (flags & MEMPOOL_F_CACHE_ADAPTIVE))
+		mempool_size += sizeof(struct rte_mempool_cache_adapt) *
+			RTE_MAX_LCORE;
 
 	ret = snprintf(mz_name, sizeof(mz_name), RTE_MEMPOOL_MZ_FORMAT, name);
 	if (ret < 0 || ret >= (int)sizeof(mz_name)) {
@@ -891,7 +1150,16 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		RTE_PTR_ADD(mp, MEMPOOL_HEADER_SIZE(mp, 0));
 
 	/* Init all default caches. */
-	if (cache_size != 0) {
+	if (cache_size != 0 && (flags & MEMPOOL_F_CACHE_ADAPTIVE)) {
+		mp->cache_adapt = (struct rte_mempool_cache_adapt *)
+			RTE_PTR_ADD(mp, RTE_ALIGN_CEIL(MEMPOOL_HEADER_SIZE(mp,
+				cache_size) + private_data_size,
+				RTE_MEMPOOL_ALIGN));
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			mempool_cache_init_adaptive(&mp->local_cache[lcore_id],
+					&mp->cache_adapt[lcore_id],
+					cache_size, n);
+	} else if (cache_size != 0) {
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			mempool_cache_init(&mp->local_cache[lcore_id],
 					   cache_size);
@@ -900,6 +1168,12 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 	te->data = mp;
 
 	rte_mcfg_tailq_write_lock();
+	if (rte_eal_tailq_index_add(rte_mempool_tailq.head, mp->name,
+			te) < 0) {
+		rte_mcfg_tailq_write_unlock();
+		RTE_LOG(ERR, MEMPOOL, "Cannot index mempool\n");
+		goto exit_unlock;
+	}
 	TAILQ_INSERT_TAIL(mempool_list, te, next);
 	rte_mcfg_tailq_write_unlock();
 	rte_mcfg_mempool_write_unlock();
@@ -999,6 +1273,29 @@ rte_mempool_in_use_count(const struct rte_mempool *mp)
 	return mp->size - rte_mempool_avail_count(mp);
 }
 
+/* sum the counters of all default caches of an adaptive mempool */
+static void
+mempool_cache_stats_sum(const struct rte_mempool *mp,
+		struct rte_mempool_cache_stats *sum)
+{
+	const struct rte_mempool_cache_stats *st;
+	unsigned int lcore_id;
+
+	memset(sum, 0, sizeof(*sum));
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		st = &mp->cache_adapt[lcore_id].stats;
+		sum->get_bulk += st->get_bulk;
+		sum->get_objs += st->get_objs;
+		sum->get_miss += st->get_miss;
+		sum->put_bulk += st->put_bulk;
+		sum->put_objs += st->put_objs;
+		sum->put_flush += st->put_flush;
+		sum->pool_deq_objs += st->pool_deq_objs;
+		sum->pool_enq_objs += st->pool_enq_objs;
+		sum->resize += st->resize;
+	}
+}
+
 /* dump the cache status */
 static unsigned
 rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
@@ -1020,6 +1317,22 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 		count += cache_count;
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
+
+	if (mp->flags & MEMPOOL_F_CACHE_ADAPTIVE) {
+		struct rte_mempool_cache_stats sum;
+
+		mempool_cache_stats_sum(mp, &sum);
+		fprintf(f, "    adaptive cache stats:\n");
+		fprintf(f, "      get_bulk=%"PRIu64"\n", sum.get_bulk);
+		fprintf(f, "      get_objs=%"PRIu64"\n", sum.get_objs);
+		fprintf(f, "      get_miss=%"PRIu64"\n", sum.get_miss);
+		fprintf(f, "      put_bulk=%"PRIu64"\n", sum.put_bulk);
+		fprintf(f, "      put_objs=%"PRIu64"\n", sum.put_objs);
+		fprintf(f, "      put_flush=%"PRIu64"\n", sum.put_flush);
+		fprintf(f, "      pool_deq_objs=%"PRIu64"\n", sum.pool_deq_objs);
+		fprintf(f, "      pool_enq_objs=%"PRIu64"\n", sum.pool_enq_objs);
+		fprintf(f, "      resize=%"PRIu64"\n", sum.resize);
+	}
 	return count;
 }
 
@@ -1237,6 +1550,9 @@ rte_mempool_dump(FILE *f, struct rte_mempool *mp)
 		common_count = mp->size - cache_count;
 	fprintf(f, "  common_pool_count=%u\n", common_count);
 
+	if (mp->rcu != NULL)
+		mempool_rcu_dump(f, mp);
+
 	/* sum and dump statistics */
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
 	rte_mempool_ops_get_info(mp, &info);
@@ -1296,18 +1612,15 @@ rte_mempool_lookup(const char *name)
 {
 	struct rte_mempool *mp = NULL;
 	struct rte_tailq_entry *te;
-	struct rte_mempool_list *mempool_list;
-
-	mempool_list = RTE_TAILQ_CAST(rte_mempool_tailq.head, rte_mempool_list);
 
 	rte_mcfg_mempool_read_lock();
+	rte_mcfg_tailq_read_lock();
 
-	TAILQ_FOREACH(te, mempool_list, next) {
+	te = rte_eal_tailq_index_lookup(rte_mempool_tailq.head, name);
+	if (te != NULL)
 		mp = (struct rte_mempool *) te->data;
-		if (strncmp(name, mp->name, RTE_MEMPOOL_NAMESIZE) == 0)
-			break;
-	}
 
+	rte_mcfg_tailq_read_unlock();
 	rte_mcfg_mempool_read_unlock();
 
 	if (te == NULL) {
@@ -1335,3 +1648,74 @@ void rte_mempool_walk(void (*func)(struct rte_mempool *, void *),
 
 	rte_mcfg_mempool_read_unlock();
 }
+
+static void
+mempool_list_cb(struct rte_mempool *mp, void *arg)
+{
+	struct rte_tel_data *d = arg;
+
+	rte_tel_data_add_array_string(d, mp->name);
+}
+
+static int
+mempool_handle_list(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	rte_mempool_walk(mempool_list_cb, d);
+	return 0;
+}
+
+#define ADD_DICT_STAT(s) rte_tel_data_add_dict_u64(d, #s, sum.s)
+
+static int
+mempool_handle_info(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_mempool_cache_stats sum;
+	struct rte_mempool *mp;
+
+	if (params == NULL || strlen(params) == 0)
+		return -1;
+
+	mp = rte_mempool_lookup(params);
+	if (mp == NULL)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", mp->name);
+	rte_tel_data_add_dict_int(d, "socket_id", mp->socket_id);
+	rte_tel_data_add_dict_u64(d, "flags", mp->flags);
+	rte_tel_data_add_dict_u64(d, "size", mp->size);
+	rte_tel_data_add_dict_u64(d, "cache_size", mp->cache_size);
+	rte_tel_data_add_dict_u64(d, "elt_size", mp->elt_size);
+	rte_tel_data_add_dict_u64(d, "avail_count", rte_mempool_avail_count(mp));
+	rte_tel_data_add_dict_u64(d, "in_use_count",
+			rte_mempool_in_use_count(mp));
+
+	if (mp->cache_size == 0 || !(mp->flags & MEMPOOL_F_CACHE_ADAPTIVE))
+		return 0;
+
+	mempool_cache_stats_sum(mp, &sum);
+	ADD_DICT_STAT(get_bulk);
+	ADD_DICT_STAT(get_objs);
+	rte_tel_data_add_dict_u64(d, "get_hit", sum.get_bulk - sum.get_miss);
+	ADD_DICT_STAT(get_miss);
+	ADD_DICT_STAT(put_bulk);
+	ADD_DICT_STAT(put_objs);
+	rte_tel_data_add_dict_u64(d, "put_hit", sum.put_bulk - sum.put_flush);
+	ADD_DICT_STAT(put_flush);
+	ADD_DICT_STAT(pool_deq_objs);
+	ADD_DICT_STAT(pool_enq_objs);
+	ADD_DICT_STAT(resize);
+
+	return 0;
+}
+
+RTE_INIT(mempool_init_telemetry)
+{
+	rte_telemetry_register_cmd("/mempool/list", mempool_handle_list,
+			"Returns list of available mempools. Takes no parameters");
+	rte_telemetry_register_cmd("/mempool/info", mempool_handle_info,
+			"Returns mempool info and adaptive cache stats. Parameters: pool name");
+}
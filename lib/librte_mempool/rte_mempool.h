@@ -79,6 +79,40 @@ struct rte_mempool_debug_stats {
 } __rte_cache_aligned;
 #endif
 
+/**
+ * Counters of a per-core object cache. They are only maintained by the
+ * default caches of mempools created with MEMPOOL_F_CACHE_ADAPTIVE.
+ */
+struct rte_mempool_cache_stats {
+	uint64_t get_bulk;      /**< Number of get requests. */
+	uint64_t get_objs;      /**< Number of objects requested. */
+	uint64_t get_miss;      /**< Get requests which accessed the pool. */
+	uint64_t put_bulk;      /**< Number of put requests. */
+	uint64_t put_objs;      /**< Number of objects put. */
+	uint64_t put_flush;     /**< Put requests which accessed the pool. */
+	uint64_t pool_deq_objs; /**< Objects dequeued from the pool. */
+	uint64_t pool_enq_objs; /**< Objects enqueued to the pool. */
+	uint64_t resize;        /**< Number of size adjustments. */
+};
+
+/**
+ * Adaptive mode state of a per-core default cache. It is kept out of
+ * struct rte_mempool_cache, in an array indexed like mp->local_cache.
+ */
+struct rte_mempool_cache_adapt {
+	uint32_t base_size;   /**< Size requested at creation */
+	uint32_t min_size;    /**< Lower bound of the cache size */
+	uint32_t max_size;    /**< Upper bound of the cache size */
+	uint32_t max_burst;   /**< Largest request since last adjustment */
+	uint32_t pool_ops;    /**< Pool accesses since last adjustment */
+	uint64_t last_get_objs; /**< stats.get_objs at last adjustment */
+	uint64_t last_put_objs; /**< stats.put_objs at last adjustment */
+	struct rte_mempool_cache_stats stats; /**< Cache counters */
+} __rte_cache_aligned;
+
+struct rte_mempool_rcu;
+struct rte_rcu_qsbr;
+
 /**
  * A structure that stores a per-core object cache.
  */
@@ -86,6 +120,8 @@ struct rte_mempool_cache {
 	uint32_t size;	      /**< Size of the cache */
 	uint32_t flushthresh; /**< Threshold before we flush excess elements */
 	uint32_t len;	      /**< Current cache count */
+	uint32_t adaptive;
+	/**< Non-zero if size and flushthresh are adjusted to the traffic */
 	/*
 	 * Cache is allocated to this size to allow it to overflow in certain
 	 * cases to avoid needless emptying of cache.
@@ -249,6 +285,10 @@ struct rte_mempool {
 	/** Per-lcore statistics. */
 	struct rte_mempool_debug_stats stats[RTE_MAX_LCORE];
 #endif
+	struct rte_mempool_cache_adapt *cache_adapt;
+	/**< Adaptive state of the default caches, indexed like local_cache. */
+	struct rte_mempool_rcu *rcu;
+	/**< RCU deferred free state, see rte_mempool_rcu_qsbr_add(). */
 }  __rte_cache_aligned;
 
 #define MEMPOOL_F_NO_SPREAD      0x0001
@@ -258,6 +298,8 @@ struct rte_mempool {
 #define MEMPOOL_F_SC_GET         0x0008 /**< Default get is "single-consumer".*/
 #define MEMPOOL_F_POOL_CREATED   0x0010 /**< Internal: pool is created. */
 #define MEMPOOL_F_NO_IOVA_CONTIG 0x0020 /**< Don't need IOVA contiguous objs. */
+#define MEMPOOL_F_CACHE_ADAPTIVE 0x0040
+		/**< Adjust per-lcore cache sizes to the traffic pattern. */
 
 /**
  * @internal When debug is enabled, store some statistics.
@@ -354,6 +396,80 @@ void rte_mempool_check_cookies(const struct rte_mempool *mp,
 #define __mempool_check_cookies(mp, obj_table_const, n, free) do {} while(0)
 #endif /* RTE_LIBRTE_MEMPOOL_DEBUG */
 
+/* number of pool accesses between two adjustments of an adaptive cache */
+#define MEMPOOL_CACHE_ADAPT_PERIOD 32
+/* get/put ratio above which a lcore is considered as consumer or producer */
+#define MEMPOOL_CACHE_ADAPT_IMBALANCE 4
+/* same as CALC_CACHE_FLUSHTHRESH() used for caches of fixed size */
+#define MEMPOOL_CACHE_ADAPT_FLUSHTHRESH(c) ((c) * 3 / 2)
+
+/**
+ * @internal Get the adaptive state of a default cache of a mempool.
+ */
+static inline struct rte_mempool_cache_adapt *
+__mempool_cache_adapt_state(const struct rte_mempool *mp,
+		const struct rte_mempool_cache *cache)
+{
+	return &mp->cache_adapt[cache - mp->local_cache];
+}
+
+/**
+ * @internal Adjust the size of an adaptive cache after it accessed the pool.
+ *
+ * @param cache
+ *   Pointer to the cache, in adaptive mode.
+ * @param ad
+ *   Pointer to the adaptive state of the cache.
+ * @param n
+ *   Number of objects of the request which caused the access.
+ */
+static inline void
+__mempool_cache_adapt(struct rte_mempool_cache *cache,
+		struct rte_mempool_cache_adapt *ad, unsigned int n)
+{
+	uint64_t gets, puts;
+	uint32_t size, thresh;
+
+	if (n > ad->max_burst)
+		ad->max_burst = n;
+	if (++ad->pool_ops < MEMPOOL_CACHE_ADAPT_PERIOD)
+		return;
+
+	gets = ad->stats.get_objs - ad->last_get_objs;
+	puts = ad->stats.put_objs - ad->last_put_objs;
+
+	if (gets > MEMPOOL_CACHE_ADAPT_IMBALANCE * puts) {
+		/* consumer: refill the cache with more objects at once */
+		size = RTE_MIN(cache->size * 2, ad->max_size);
+		thresh = MEMPOOL_CACHE_ADAPT_FLUSHTHRESH(size);
+	} else if (puts > MEMPOOL_CACHE_ADAPT_IMBALANCE * gets) {
+		/* producer: keep fewer objects and flush larger batches */
+		size = RTE_MAX(cache->size / 2, ad->min_size);
+		thresh = RTE_MIN(cache->flushthresh * 2, 2 * ad->max_size);
+	} else {
+		/* balanced: the configured size works best */
+		size = ad->base_size;
+		thresh = MEMPOOL_CACHE_ADAPT_FLUSHTHRESH(size);
+	}
+
+	/* requests larger than the cache bypass it, make room for them */
+	if (size <= ad->max_burst)
+		size = RTE_MIN(ad->max_burst + 1, ad->max_size);
+	thresh = RTE_MIN(RTE_MAX(thresh, MEMPOOL_CACHE_ADAPT_FLUSHTHRESH(size)),
+			2 * ad->max_size);
+
+	if (size != cache->size || thresh != cache->flushthresh) {
+		cache->size = size;
+		cache->flushthresh = thresh;
+		ad->stats.resize++;
+	}
+
+	ad->max_burst = 0;
+	ad->pool_ops = 0;
+	ad->last_get_objs = ad->stats.get_objs;
+	ad->last_put_objs = ad->stats.put_objs;
+}
+
 /**
  * @internal Check contiguous object blocks and update cookies or panic.
  *
@@ -986,6 +1102,14 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *   - MEMPOOL_F_SC_GET: If this flag is set, the default behavior
  *     when using rte_mempool_get() or rte_mempool_get_bulk() is
  *     "single-consumer". Otherwise, it is "multi-consumers".
+ *   - MEMPOOL_F_CACHE_ADAPTIVE: (experimental) If set, the size and flush
+ *     threshold of the per-lcore caches are adjusted at runtime, between a
+ *     quarter and four times cache_size, depending on the get/put balance
+ *     and burst sizes of each lcore, and per-lcore counters are maintained.
+ *     A lcore which mostly gets objects refills its cache with more objects
+ *     at once, and a lcore which mostly puts objects keeps fewer of them and
+ *     flushes them in larger batches. The caches can then hold up to 8 times
+ *     cache_size objects.
  *   - MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
  * @return
@@ -1285,11 +1409,18 @@ static __rte_always_inline void
 __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		      unsigned int n, struct rte_mempool_cache *cache)
 {
+	struct rte_mempool_cache_adapt *ad = NULL;
 	void **cache_objs;
 
 	/* increment stat now, adding in mempool always success */
 	__MEMPOOL_STAT_ADD(mp, put, n);
 
+	if (cache != NULL && cache->adaptive) {
+		ad = __mempool_cache_adapt_state(mp, cache);
+		ad->stats.put_bulk++;
+		ad->stats.put_objs += n;
+	}
+
 	/* No cache provided or if put would overflow mem allocated for cache */
 	if (unlikely(cache == NULL || n > RTE_MEMPOOL_CACHE_MAX_SIZE))
 		goto ring_enqueue;
@@ -1311,12 +1442,23 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	if (cache->len >= cache->flushthresh) {
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
+		if (ad != NULL) {
+			ad->stats.put_flush++;
+			ad->stats.pool_enq_objs += cache->len - cache->size;
+		}
 		cache->len = cache->size;
+		if (ad != NULL)
+			__mempool_cache_adapt(cache, ad, n);
 	}
 
 	return;
 
 ring_enqueue:
+	if (ad != NULL) {
+		ad->stats.put_flush++;
+		ad->stats.pool_enq_objs += n;
+		__mempool_cache_adapt(cache, ad, n);
+	}
 
 	/* push remaining objects in ring */
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
@@ -1409,10 +1551,17 @@ static __rte_always_inline int
 __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		      unsigned int n, struct rte_mempool_cache *cache)
 {
+	struct rte_mempool_cache_adapt *ad = NULL;
 	int ret;
 	uint32_t index, len;
 	void **cache_objs;
 
+	if (cache != NULL && cache->adaptive) {
+		ad = __mempool_cache_adapt_state(mp, cache);
+		ad->stats.get_bulk++;
+		ad->stats.get_objs += n;
+	}
+
 	/* No cache provided or cannot be satisfied from cache */
 	if (unlikely(cache == NULL || n >= cache->size))
 		goto ring_dequeue;
@@ -1438,6 +1587,12 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		}
 
 		cache->len += req;
+
+		if (ad != NULL) {
+			ad->stats.get_miss++;
+			ad->stats.pool_deq_objs += req;
+			__mempool_cache_adapt(cache, ad, n);
+		}
 	}
 
 	/* Now fill in the response ... */
@@ -1460,6 +1615,13 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 	else
 		__MEMPOOL_STAT_ADD(mp, get_success, n);
 
+	if (ad != NULL) {
+		ad->stats.get_miss++;
+		if (ret == 0)
+			ad->stats.pool_deq_objs += n;
+		__mempool_cache_adapt(cache, ad, n);
+	}
+
 	return ret;
 }
 
@@ -1757,6 +1919,125 @@ uint32_t rte_mempool_calc_obj_size(uint32_t elt_size, uint32_t flags,
 void rte_mempool_walk(void (*func)(struct rte_mempool *, void *arg),
 		      void *arg);
 
+/** Number of objects grouped in one entry of the RCU defer queue. */
+#define RTE_MEMPOOL_RCU_BATCH_SIZE 32
+
+/** Reclaim the RCU defer queue from a service, see rte_mempool_rcu_config. */
+#define RTE_MEMPOOL_RCU_F_SERVICE 0x0001
+
+/** Mempool RCU QSBR configuration structure. */
+struct rte_mempool_rcu_config {
+	struct rte_rcu_qsbr *v;	/**< RCU QSBR variable. */
+	uint32_t flags;		/**< RTE_MEMPOOL_RCU_F_xxx flags. */
+	uint32_t dq_size;
+	/**< Number of batches in the defer queue. 0 for one batch per
+	 *   RTE_MEMPOOL_RCU_BATCH_SIZE objects of the mempool plus one
+	 *   per lcore.
+	 */
+	uint32_t reclaim_thd;
+	/**< Number of pending batches above which rte_mempool_put_rcu()
+	 *   reclaims the defer queue. 0 to reclaim on every queued batch.
+	 */
+	uint32_t reclaim_max;
+	/**< Max number of batches to reclaim in one go. 0 for
+	 *   RTE_MEMPOOL_RCU_DQ_RECLAIM_MAX.
+	 */
+};
+
+/** Default max number of batches reclaimed in one go. */
+#define RTE_MEMPOOL_RCU_DQ_RECLAIM_MAX 16
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate a RCU QSBR variable with a mempool, to be able to return
+ * objects which may still be referenced by lock-free readers with
+ * rte_mempool_put_rcu().
+ *
+ * A defer queue is created on the mempool socket. Each entry of this queue
+ * holds up to RTE_MEMPOOL_RCU_BATCH_SIZE objects, which are put back into
+ * the mempool together once the readers reported a quiescent state.
+ *
+ * If RTE_MEMPOOL_RCU_F_SERVICE is set in the configuration, a service
+ * named "mp_rcu_<mempool name>" is also registered, which reclaims
+ * the defer queue when mapped to a service core.
+ *
+ * The association is released by rte_mempool_free(), which waits for the
+ * queued objects to be reclaimed. It must not be called from a reader
+ * thread registered and online on the RCU QSBR variable.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cfg
+ *   RCU QSBR configuration.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if a parameter is invalid.
+ *   - -EEXIST if a RCU QSBR variable is already associated with the mempool.
+ *   - -ENOMEM if the defer queue cannot be allocated.
+ *   - Other negative values if the service cannot be registered.
+ */
+__rte_experimental
+int
+rte_mempool_rcu_qsbr_add(struct rte_mempool *mp,
+	const struct rte_mempool_rcu_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Put one object back in the mempool once all the readers of a RCU QSBR
+ * variable stopped referencing it.
+ *
+ * The object is added to a batch of the calling lcore. Once the batch is
+ * full, it is queued with the current token of the QSBR variable on the
+ * defer queue of the mempool, which may also reclaim older batches, see
+ * rte_mempool_rcu_config. Non-EAL threads queue each object on its own.
+ *
+ * A partial batch is only queued by rte_mempool_rcu_reclaim() called from
+ * the same lcore, which should be done periodically, for instance along
+ * with the rte_rcu_qsbr_quiescent() calls of the lcore.
+ *
+ * If the defer queue is full and cannot be reclaimed, the call waits for
+ * the readers to report a quiescent state with rte_rcu_qsbr_synchronize(),
+ * so it must not be done by an online reader of the variable.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param obj
+ *   A pointer to the object to be returned.
+ * @param v
+ *   RCU QSBR variable, which must be the one associated with the mempool
+ *   by rte_mempool_rcu_qsbr_add().
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the variable is not the one of the mempool.
+ */
+__rte_experimental
+int
+rte_mempool_put_rcu(struct rte_mempool *mp, void *obj,
+	struct rte_rcu_qsbr *v);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Queue the partial batch of the calling lcore on the defer queue of the
+ * mempool, and put back in the mempool the objects of up to reclaim_max
+ * batches whose grace period expired, see rte_mempool_rcu_config. The
+ * objects are put in the cache of the calling lcore.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if no RCU QSBR variable is associated with the mempool.
+ */
+__rte_experimental
+int
+rte_mempool_rcu_reclaim(struct rte_mempool *mp);
+
 /**
  * @internal Get page size used for mempool object allocation.
  * This function is internal to mempool library and mempool drivers.
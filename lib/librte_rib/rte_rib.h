@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,6 +53,33 @@ struct rte_rib_conf {
 	int	max_nodes;
 };
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_RIB_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_rib_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_RIB_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_RIB_QSBR_MODE_SYNC
+};
+
+/** RIB RCU QSBR configuration structure. */
+struct rte_rib_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_RIB_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_rib_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: max_nodes of the RIB.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_RIB_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Get an IPv4 mask from prefix length
  * It is caller responsibility to make sure depth is not bigger than 32
@@ -289,6 +317,33 @@ __rte_experimental
 void
 rte_rib_free(struct rte_rib *rib);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with a RIB object.
+ *
+ * Once associated, tree nodes released by rte_rib_remove() are not
+ * returned to the node pool until all the readers registered with
+ * the QSBR variable have reported a quiescent state. This allows
+ * lookups to run concurrently with a single writer.
+ *
+ * @param rib
+ *   the RIB object to add RCU QSBR
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   On success - 0
+ *   On error - 1 with error code set in rte_errno.
+ *   Possible rte_errno codes are:
+ *   - EINVAL - invalid pointer
+ *   - EEXIST - already added QSBR
+ *   - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int
+rte_rib_rcu_qsbr_add(struct rte_rib *rib, struct rte_rib_rcu_config *cfg);
+
 #ifdef __cplusplus
 }
 #endif
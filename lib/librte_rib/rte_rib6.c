@@ -46,6 +46,10 @@ struct rte_rib6 {
 	uint32_t		cur_nodes;
 	uint32_t		cur_routes;
 	int			max_nodes;
+	/* RCU config. */
+	struct rte_rcu_qsbr	*v;		/* RCU QSBR variable. */
+	enum rte_rib6_qsbr_mode	rcu_mode;	/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq	*dq;		/* RCU QSBR defer queue. */
 };
 
 static inline bool
@@ -93,6 +97,8 @@ static inline struct rte_rib6_node *
 get_nxt_node(struct rte_rib6_node *node,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
 {
+	if (node->depth == RIB6_MAXDEPTH)
+		return NULL;
 	return (get_dir(ip, node->depth)) ? node->right : node->left;
 }
 
@@ -103,6 +109,11 @@ node_alloc(struct rte_rib6 *rib)
 	int ret;
 
 	ret = rte_mempool_get(rib->node_pool, (void *)&ent);
+	if (unlikely(ret != 0) && (rib->dq != NULL)) {
+		/* If there are no free nodes try to reclaim one. */
+		if (rte_rcu_qsbr_dq_reclaim(rib->dq, 1, NULL, NULL, NULL) == 0)
+			ret = rte_mempool_get(rib->node_pool, (void *)&ent);
+	}
 	if (unlikely(ret != 0))
 		return NULL;
 	++rib->cur_nodes;
@@ -116,6 +127,31 @@ node_free(struct rte_rib6 *rib, struct rte_rib6_node *ent)
 	rte_mempool_put(rib->node_pool, ent);
 }
 
+/*
+ * Release a node that was reachable from the tree and thus
+ * could still be referenced by concurrent readers.
+ */
+static void
+node_retire(struct rte_rib6 *rib, struct rte_rib6_node *ent)
+{
+	if (rib->v == NULL) {
+		node_free(rib, ent);
+	} else if (rib->rcu_mode == RTE_RIB6_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(rib->v, RTE_QSBR_THRID_INVALID);
+		node_free(rib, ent);
+	} else if (rib->rcu_mode == RTE_RIB6_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(rib->dq, (void *)&ent) != 0) {
+			RTE_LOG(ERR, LPM, "Failed to push QSBR FIFO\n");
+			/* Fall back to blocking reclaim instead of leaking */
+			rte_rcu_qsbr_synchronize(rib->v,
+				RTE_QSBR_THRID_INVALID);
+			node_free(rib, ent);
+		}
+	}
+}
+
 struct rte_rib6_node *
 rte_rib6_lookup(struct rte_rib6 *rib,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
@@ -256,7 +292,7 @@ rte_rib6_remove(struct rte_rib6 *rib,
 			child->parent = cur->parent;
 		if (cur->parent == NULL) {
 			rib->tree = child;
-			node_free(rib, cur);
+			node_retire(rib, cur);
 			return;
 		}
 		if (cur->parent->left == cur)
@@ -265,7 +301,7 @@ rte_rib6_remove(struct rte_rib6 *rib,
 			cur->parent->right = child;
 		prev = cur;
 		cur = cur->parent;
-		node_free(rib, prev);
+		node_retire(rib, prev);
 	}
 }
 
@@ -588,6 +624,11 @@ rte_rib6_free(struct rte_rib6 *rib)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (rib->dq != NULL)
+		rte_rcu_qsbr_dq_delete(rib->dq);
+	/* The object is going away, there are no readers left to wait for */
+	rib->v = NULL;
+
 	while ((tmp = rte_rib6_get_nxt(rib, 0, 0, tmp,
 			RTE_RIB6_GET_NXT_ALL)) != NULL)
 		rte_rib6_remove(rib, tmp->ip, tmp->depth);
@@ -597,3 +638,61 @@ rte_rib6_free(struct rte_rib6 *rib)
 	rte_free(rib);
 	rte_free(te);
 }
+
+static void
+__rib6_rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct rte_rib6_node *ent = *(struct rte_rib6_node **)data;
+
+	RTE_SET_USED(n);
+	node_free((struct rte_rib6 *)p, ent);
+}
+
+int
+rte_rib6_rcu_qsbr_add(struct rte_rib6 *rib, struct rte_rib6_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (rib == NULL || cfg == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (rib->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_RIB6_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_RIB6_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"RIB6_RCU_%s", rib->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = rib->max_nodes;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_RIB6_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(struct rte_rib6_node *);
+		params.free_fn = __rib6_rcu_qsbr_free_resource;
+		params.p = rib;
+		params.v = cfg->v;
+		rib->dq = rte_rcu_qsbr_dq_create(&params);
+		if (rib->dq == NULL) {
+			RTE_LOG(ERR, LPM, "RIB6 defer queue creation failed\n");
+			return 1;
+		}
+	} else {
+		rte_errno = EINVAL;
+		return 1;
+	}
+	rib->rcu_mode = cfg->mode;
+	rib->v = cfg->v;
+
+	return 0;
+}
@@ -31,6 +31,7 @@
 #include <rte_string_fns.h>
 #include <rte_spinlock.h>
 #include <rte_tailq.h>
+#include <rte_telemetry.h>
 
 #include "rte_ring.h"
 #include "rte_ring_elem.h"
@@ -45,7 +46,11 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 /* mask of all valid flag values to ring_create() */
 #define RING_F_MASK (RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ | \
 		     RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ |	       \
-		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ)
+		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ |	       \
+		     RING_F_MP_SEQ_ENQ | RING_F_MC_SEQ_DEQ)
+
+/* SEQ mode flags, the mode is shared by producers and consumers */
+#define RING_F_SEQ (RING_F_MP_SEQ_ENQ | RING_F_MC_SEQ_DEQ)
 
 /* true if x is a power of 2 */
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
@@ -114,17 +119,35 @@ reset_headtail(void *p)
 	case RTE_RING_SYNC_MT_HTS:
 		ht_hts->ht.raw = 0;
 		break;
+	case RTE_RING_SYNC_MT_SEQ:
+		ht->tail = 0;
+		break;
 	default:
 		/* unknown sync mode */
 		RTE_ASSERT(0);
 	}
 }
 
+/*
+ * internal helper function to reset the slots of a SEQ ring: a slot is
+ * free for the producer claiming position p when its sequence number is p.
+ */
+static void
+reset_seq(struct rte_ring *r)
+{
+	uint32_t i;
+
+	for (i = 0; i != r->size; i++)
+		r->seq_prod.seq[i] = i;
+}
+
 void
 rte_ring_reset(struct rte_ring *r)
 {
 	reset_headtail(&r->prod);
 	reset_headtail(&r->cons);
+	if (r->prod.sync_type == RTE_RING_SYNC_MT_SEQ)
+		reset_seq(r);
 }
 
 /*
@@ -137,9 +160,15 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	enum rte_ring_sync_type *cons_st)
 {
 	static const uint32_t prod_st_flags =
-		(RING_F_SP_ENQ | RING_F_MP_RTS_ENQ | RING_F_MP_HTS_ENQ);
+		(RING_F_SP_ENQ | RING_F_MP_RTS_ENQ | RING_F_MP_HTS_ENQ |
+		RING_F_MP_SEQ_ENQ);
 	static const uint32_t cons_st_flags =
-		(RING_F_SC_DEQ | RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ);
+		(RING_F_SC_DEQ | RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ |
+		RING_F_MC_SEQ_DEQ);
+
+	/* slots are handed over by both sides, SEQ mode can't be mixed */
+	if ((flags & RING_F_SEQ) != 0 && (flags & RING_F_SEQ) != RING_F_SEQ)
+		return -EINVAL;
 
 	switch (flags & prod_st_flags) {
 	case 0:
@@ -154,6 +183,9 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	case RING_F_MP_HTS_ENQ:
 		*prod_st = RTE_RING_SYNC_MT_HTS;
 		break;
+	case RING_F_MP_SEQ_ENQ:
+		*prod_st = RTE_RING_SYNC_MT_SEQ;
+		break;
 	default:
 		return -EINVAL;
 	}
@@ -171,6 +203,9 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	case RING_F_MC_HTS_DEQ:
 		*cons_st = RTE_RING_SYNC_MT_HTS;
 		break;
+	case RING_F_MC_SEQ_DEQ:
+		*cons_st = RTE_RING_SYNC_MT_SEQ;
+		break;
 	default:
 		return -EINVAL;
 	}
@@ -178,8 +213,8 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	return 0;
 }
 
-int
-rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
+static int
+ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	unsigned int flags)
 {
 	int ret;
@@ -202,6 +237,11 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
 		offsetof(struct rte_ring_rts_headtail, tail.val.pos));
 
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, sync_type) !=
+		offsetof(struct rte_ring_seq_headtail, sync_type));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
+		offsetof(struct rte_ring_seq_headtail, tail));
+
 	/* future proof flags, only allow supported values */
 	if (flags & ~RING_F_MASK) {
 		RTE_LOG(ERR, RING,
@@ -244,6 +284,20 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	return 0;
 }
 
+int
+rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
+	unsigned int flags)
+{
+	/* the slot sequence numbers follow the elements, of unknown size */
+	if (flags & RING_F_SEQ) {
+		RTE_LOG(ERR, RING,
+			"SEQ mode rings must be created with rte_ring_create_elem()\n");
+		return -EINVAL;
+	}
+
+	return ring_init(r, name, count, flags);
+}
+
 /* create the ring for a given element size */
 struct rte_ring *
 rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
@@ -253,9 +307,10 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 	struct rte_ring *r;
 	struct rte_tailq_entry *te;
 	const struct rte_memzone *mz;
-	ssize_t ring_size;
+	ssize_t ring_size, seq_offset;
 	int mz_flags = 0;
 	struct rte_ring_list* ring_list = NULL;
+	struct rte_ring_stats *stats = NULL;
 	const unsigned int requested_count = count;
 	int ret;
 
@@ -270,6 +325,9 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 		rte_errno = ring_size;
 		return NULL;
 	}
+	seq_offset = ring_size;
+	if (flags & RING_F_SEQ)
+		ring_size += (ssize_t)count * sizeof(uint32_t);
 
 	ret = snprintf(mz_name, sizeof(mz_name), "%s%s",
 		RTE_RING_MZ_PREFIX, name);
@@ -285,6 +343,17 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 		return NULL;
 	}
 
+#ifdef RTE_LIBRTE_RING_STATS
+	stats = rte_zmalloc_socket("RING_STATS",
+			sizeof(*stats) * RTE_MAX_LCORE, 0, socket_id);
+	if (stats == NULL) {
+		RTE_LOG(ERR, RING, "Cannot reserve memory for statistics\n");
+		rte_free(te);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+#endif
+
 	rte_mcfg_tailq_write_lock();
 
 	/* reserve a memory zone for this ring. If we can't get rte_config or
@@ -294,18 +363,40 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 					 mz_flags, __alignof__(*r));
 	if (mz != NULL) {
 		r = mz->addr;
-		/* no need to check return value here, we already checked the
-		 * arguments above */
-		rte_ring_init(r, name, requested_count, flags);
+		/* size was checked above, flags are not */
+		ret = ring_init(r, name, requested_count, flags);
+		if (ret == 0 && (flags & RING_F_SEQ)) {
+			r->seq_prod.seq = RTE_PTR_ADD(r, seq_offset);
+			r->seq_cons.seq = r->seq_prod.seq;
+			reset_seq(r);
+		}
 
 		te->data = (void *) r;
 		r->memzone = mz;
-
-		TAILQ_INSERT_TAIL(ring_list, te, next);
+		r->stats = stats;
+
+		if (ret != 0) {
+			RTE_LOG(ERR, RING, "Invalid flags %#x\n", flags);
+			rte_memzone_free(mz);
+			rte_free(te);
+			rte_free(stats);
+			rte_errno = -ret;
+			r = NULL;
+		} else if (rte_eal_tailq_index_add(rte_ring_tailq.head, r->name,
+				te) < 0) {
+			RTE_LOG(ERR, RING, "Cannot index ring\n");
+			rte_memzone_free(mz);
+			rte_free(te);
+			rte_free(stats);
+			r = NULL;
+		} else {
+			TAILQ_INSERT_TAIL(ring_list, te, next);
+		}
 	} else {
 		r = NULL;
 		RTE_LOG(ERR, RING, "Cannot reserve memory\n");
 		rte_free(te);
+		rte_free(stats);
 	}
 	rte_mcfg_tailq_write_unlock();
 
@@ -325,7 +416,9 @@ rte_ring_create(const char *name, unsigned int count, int socket_id,
 void
 rte_ring_free(struct rte_ring *r)
 {
+	char name[RTE_RING_NAMESIZE];
 	struct rte_ring_list *ring_list = NULL;
+	struct rte_ring_stats *stats;
 	struct rte_tailq_entry *te;
 
 	if (r == NULL)
@@ -341,25 +434,27 @@ rte_ring_free(struct rte_ring *r)
 		return;
 	}
 
+	/* ring memory is cleared when the memzone is freed */
+	strlcpy(name, r->name, sizeof(name));
+	stats = r->stats;
+
 	if (rte_memzone_free(r->memzone) != 0) {
 		RTE_LOG(ERR, RING, "Cannot free memory\n");
 		return;
 	}
+	rte_free(stats);
 
 	ring_list = RTE_TAILQ_CAST(rte_ring_tailq.head, rte_ring_list);
 	rte_mcfg_tailq_write_lock();
 
 	/* find out tailq entry */
-	TAILQ_FOREACH(te, ring_list, next) {
-		if (te->data == (void *) r)
-			break;
-	}
-
-	if (te == NULL) {
+	te = rte_eal_tailq_index_lookup(rte_ring_tailq.head, name);
+	if (te == NULL || te->data != (void *) r) {
 		rte_mcfg_tailq_write_unlock();
 		return;
 	}
 
+	rte_eal_tailq_index_del(rte_ring_tailq.head, name);
 	TAILQ_REMOVE(ring_list, te, next);
 
 	rte_mcfg_tailq_write_unlock();
@@ -371,6 +466,8 @@ rte_ring_free(struct rte_ring *r)
 void
 rte_ring_dump(FILE *f, const struct rte_ring *r)
 {
+	struct rte_ring_stats sum;
+
 	fprintf(f, "ring <%s>@%p\n", r->name, r);
 	fprintf(f, "  flags=%x\n", r->flags);
 	fprintf(f, "  size=%"PRIu32"\n", r->size);
@@ -381,6 +478,67 @@ rte_ring_dump(FILE *f, const struct rte_ring *r)
 	fprintf(f, "  ph=%"PRIu32"\n", r->prod.head);
 	fprintf(f, "  used=%u\n", rte_ring_count(r));
 	fprintf(f, "  avail=%u\n", rte_ring_free_count(r));
+
+	if (rte_ring_stats_get(r, &sum) == 0) {
+		fprintf(f, "  stats:\n");
+		fprintf(f, "    enq_success_bulk=%"PRIu64"\n",
+			sum.enq_success_bulk);
+		fprintf(f, "    enq_success_objs=%"PRIu64"\n",
+			sum.enq_success_objs);
+		fprintf(f, "    enq_fail_bulk=%"PRIu64"\n", sum.enq_fail_bulk);
+		fprintf(f, "    enq_partial_bulk=%"PRIu64"\n",
+			sum.enq_partial_bulk);
+		fprintf(f, "    enq_cas_retries=%"PRIu64"\n",
+			sum.enq_cas_retries);
+		fprintf(f, "    enq_tail_spins=%"PRIu64"\n", sum.enq_tail_spins);
+		fprintf(f, "    deq_success_bulk=%"PRIu64"\n",
+			sum.deq_success_bulk);
+		fprintf(f, "    deq_success_objs=%"PRIu64"\n",
+			sum.deq_success_objs);
+		fprintf(f, "    deq_fail_bulk=%"PRIu64"\n", sum.deq_fail_bulk);
+		fprintf(f, "    deq_partial_bulk=%"PRIu64"\n",
+			sum.deq_partial_bulk);
+		fprintf(f, "    deq_cas_retries=%"PRIu64"\n",
+			sum.deq_cas_retries);
+		fprintf(f, "    deq_tail_spins=%"PRIu64"\n", sum.deq_tail_spins);
+		fprintf(f, "    max_used=%"PRIu32"\n", sum.max_used);
+	}
+}
+
+int
+rte_ring_stats_get(const struct rte_ring *r, struct rte_ring_stats *stats)
+{
+	const struct rte_ring_stats *s;
+	unsigned int lcore_id;
+
+	memset(stats, 0, sizeof(*stats));
+	if (r->stats == NULL)
+		return -ENOTSUP;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		s = &r->stats[lcore_id];
+		stats->enq_success_bulk += s->enq_success_bulk;
+		stats->enq_success_objs += s->enq_success_objs;
+		stats->enq_fail_bulk += s->enq_fail_bulk;
+		stats->enq_partial_bulk += s->enq_partial_bulk;
+		stats->enq_cas_retries += s->enq_cas_retries;
+		stats->enq_tail_spins += s->enq_tail_spins;
+		stats->deq_success_bulk += s->deq_success_bulk;
+		stats->deq_success_objs += s->deq_success_objs;
+		stats->deq_fail_bulk += s->deq_fail_bulk;
+		stats->deq_partial_bulk += s->deq_partial_bulk;
+		stats->deq_cas_retries += s->deq_cas_retries;
+		stats->deq_tail_spins += s->deq_tail_spins;
+		stats->max_used = RTE_MAX(stats->max_used, s->max_used);
+	}
+	return 0;
+}
+
+void
+rte_ring_stats_reset(struct rte_ring *r)
+{
+	if (r->stats != NULL)
+		memset(r->stats, 0, sizeof(*r->stats) * RTE_MAX_LCORE);
 }
 
 /* dump the status of all rings on the console */
@@ -407,17 +565,12 @@ rte_ring_lookup(const char *name)
 {
 	struct rte_tailq_entry *te;
 	struct rte_ring *r = NULL;
-	struct rte_ring_list *ring_list;
-
-	ring_list = RTE_TAILQ_CAST(rte_ring_tailq.head, rte_ring_list);
 
 	rte_mcfg_tailq_read_lock();
 
-	TAILQ_FOREACH(te, ring_list, next) {
+	te = rte_eal_tailq_index_lookup(rte_ring_tailq.head, name);
+	if (te != NULL)
 		r = (struct rte_ring *) te->data;
-		if (strncmp(name, r->name, RTE_RING_NAMESIZE) == 0)
-			break;
-	}
 
 	rte_mcfg_tailq_read_unlock();
 
@@ -428,3 +581,80 @@ rte_ring_lookup(const char *name)
 
 	return r;
 }
+
+static int
+ring_handle_list(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	const struct rte_tailq_entry *te;
+	struct rte_ring_list *ring_list;
+
+	ring_list = RTE_TAILQ_CAST(rte_ring_tailq.head, rte_ring_list);
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+
+	rte_mcfg_tailq_read_lock();
+	TAILQ_FOREACH(te, ring_list, next)
+		rte_tel_data_add_array_string(d,
+				((const struct rte_ring *)te->data)->name);
+	rte_mcfg_tailq_read_unlock();
+
+	return 0;
+}
+
+#define ADD_DICT_STAT(s) rte_tel_data_add_dict_u64(d, #s, sum.s)
+
+static int
+ring_handle_info(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_ring_stats sum;
+	struct rte_ring *r;
+
+	if (params == NULL || strlen(params) == 0)
+		return -1;
+
+	r = rte_ring_lookup(params);
+	if (r == NULL)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", r->name);
+	rte_tel_data_add_dict_u64(d, "flags", r->flags);
+	rte_tel_data_add_dict_int(d, "socket_id", r->memzone->socket_id);
+	rte_tel_data_add_dict_u64(d, "size", r->size);
+	rte_tel_data_add_dict_u64(d, "capacity", r->capacity);
+	rte_tel_data_add_dict_u64(d, "prod_sync_type", r->prod.sync_type);
+	rte_tel_data_add_dict_u64(d, "cons_sync_type", r->cons.sync_type);
+	rte_tel_data_add_dict_u64(d, "prod_tail", r->prod.tail);
+	rte_tel_data_add_dict_u64(d, "cons_tail", r->cons.tail);
+	rte_tel_data_add_dict_u64(d, "used", rte_ring_count(r));
+	rte_tel_data_add_dict_u64(d, "avail", rte_ring_free_count(r));
+
+	if (rte_ring_stats_get(r, &sum) != 0)
+		return 0;
+
+	ADD_DICT_STAT(enq_success_bulk);
+	ADD_DICT_STAT(enq_success_objs);
+	ADD_DICT_STAT(enq_fail_bulk);
+	ADD_DICT_STAT(enq_partial_bulk);
+	ADD_DICT_STAT(enq_cas_retries);
+	ADD_DICT_STAT(enq_tail_spins);
+	ADD_DICT_STAT(deq_success_bulk);
+	ADD_DICT_STAT(deq_success_objs);
+	ADD_DICT_STAT(deq_fail_bulk);
+	ADD_DICT_STAT(deq_partial_bulk);
+	ADD_DICT_STAT(deq_cas_retries);
+	ADD_DICT_STAT(deq_tail_spins);
+	ADD_DICT_STAT(max_used);
+
+	return 0;
+}
+
+RTE_INIT(ring_init_telemetry)
+{
+	rte_telemetry_register_cmd("/ring/list", ring_handle_list,
+			"Returns list of available rings. Takes no parameters");
+	rte_telemetry_register_cmd("/ring/info", ring_handle_info,
+			"Returns ring info and statistics. Parameters: ring name");
+}
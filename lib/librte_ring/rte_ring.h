@@ -107,6 +107,8 @@ ssize_t rte_ring_get_memsize(unsigned int count);
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   The SEQ modes need the element size to lay out the ring, they are
+ *   only available through rte_ring_create_elem().
  * @return
  *   0 on success, or a negative value on error.
  */
@@ -146,6 +148,9 @@ int rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
  *      - RING_F_MP_HTS_ENQ: If this flag is set, the default behavior when
  *        using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
  *        is "multi-producer HTS mode".
+ *      - RING_F_MP_SEQ_ENQ: If this flag is set, the default behavior when
+ *        using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
+ *        is "multi-producer SEQ mode". It requires RING_F_MC_SEQ_DEQ.
  *     If none of these flags is set, then default "multi-producer"
  *     behavior is selected.
  *   - One of mutually exclusive flags that define consumer behavior:
@@ -158,6 +163,9 @@ int rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
  *      - RING_F_MC_HTS_DEQ: If this flag is set, the default behavior when
  *        using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
  *        is "multi-consumer HTS mode".
+ *      - RING_F_MC_SEQ_DEQ: If this flag is set, the default behavior when
+ *        using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
+ *        is "multi-consumer SEQ mode". It requires RING_F_MP_SEQ_ENQ.
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
  * @return
@@ -191,6 +199,39 @@ void rte_ring_free(struct rte_ring *r);
  */
 void rte_ring_dump(FILE *f, const struct rte_ring *r);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the statistics of a ring, summed over all lcores. The occupancy
+ * high-water mark is the highest seen by any lcore.
+ *
+ * Statistics are only collected for the rings created by
+ * rte_ring_create() or rte_ring_create_elem(), when the ring library is
+ * built with RTE_LIBRTE_RING_STATS defined.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param stats
+ *   A pointer to a structure filled with the statistics.
+ * @return
+ *   0 on success, -ENOTSUP if statistics are not collected.
+ */
+__rte_experimental
+int rte_ring_stats_get(const struct rte_ring *r, struct rte_ring_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset the statistics of a ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ */
+__rte_experimental
+void rte_ring_stats_reset(struct rte_ring *r);
+
 /**
  * Enqueue several objects on the ring (multi-producers safe).
  *
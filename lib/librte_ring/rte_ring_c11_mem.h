@@ -14,15 +14,15 @@ static __rte_always_inline void
 update_tail(struct rte_ring_headtail *ht, uint32_t old_val, uint32_t new_val,
 		uint32_t single, uint32_t enqueue)
 {
-	RTE_SET_USED(enqueue);
-
 	/*
 	 * If there are other enqueues/dequeues in progress that preceded us,
 	 * we need to wait for them to complete
 	 */
 	if (!single)
-		while (unlikely(ht->tail != old_val))
+		while (unlikely(ht->tail != old_val)) {
+			__rte_ring_stat_tail_spin(ht, enqueue);
 			rte_pause();
+		}
 
 	__atomic_store_n(&ht->tail, new_val, __ATOMIC_RELEASE);
 }
@@ -99,6 +99,8 @@ __rte_ring_move_prod_head(struct rte_ring *r, unsigned int is_sp,
 					old_head, *new_head,
 					0, __ATOMIC_RELAXED,
 					__ATOMIC_RELAXED);
+		if (unlikely(success == 0))
+			__RING_STAT_ADD(r, enq_cas_retries, 1);
 	} while (unlikely(success == 0));
 	return n;
 }
@@ -174,6 +176,8 @@ __rte_ring_move_cons_head(struct rte_ring *r, int is_sc,
 							old_head, *new_head,
 							0, __ATOMIC_RELAXED,
 							__ATOMIC_RELAXED);
+		if (unlikely(success == 0))
+			__RING_STAT_ADD(r, deq_cas_retries, 1);
 	} while (unlikely(success == 0));
 	return n;
 }
@@ -60,6 +60,7 @@ enum rte_ring_sync_type {
 #ifdef ALLOW_EXPERIMENTAL_API
 	RTE_RING_SYNC_MT_RTS, /**< multi-thread relaxed tail sync */
 	RTE_RING_SYNC_MT_HTS, /**< multi-thread head/tail sync */
+	RTE_RING_SYNC_MT_SEQ, /**< multi-thread per-slot sequence sync */
 #endif
 };
 
@@ -110,6 +111,35 @@ struct rte_ring_hts_headtail {
 	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
 };
 
+struct rte_ring_seq_headtail {
+	uint32_t rsvd;             /**< unused, no head in that mode */
+	volatile uint32_t tail;    /**< next position to claim */
+	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
+	uint32_t *seq;             /**< sequence number of each slot */
+};
+
+/**
+ * Ring statistics, per lcore, available when the library is built with
+ * RTE_LIBRTE_RING_STATS defined, for the rings it creates.
+ * CAS retries and tail wait spins are only counted by the MP/MC and
+ * SP/SC sync modes.
+ */
+struct rte_ring_stats {
+	uint64_t enq_success_bulk; /**< Successful enqueue calls. */
+	uint64_t enq_success_objs; /**< Objects successfully enqueued. */
+	uint64_t enq_fail_bulk;    /**< Enqueue calls with no object enqueued. */
+	uint64_t enq_partial_bulk; /**< Enqueue calls short of objects. */
+	uint64_t enq_cas_retries;  /**< Producer head CAS failures. */
+	uint64_t enq_tail_spins;   /**< Spins waiting for previous producers. */
+	uint64_t deq_success_bulk; /**< Successful dequeue calls. */
+	uint64_t deq_success_objs; /**< Objects successfully dequeued. */
+	uint64_t deq_fail_bulk;    /**< Dequeue calls with no object dequeued. */
+	uint64_t deq_partial_bulk; /**< Dequeue calls short of objects. */
+	uint64_t deq_cas_retries;  /**< Consumer head CAS failures. */
+	uint64_t deq_tail_spins;   /**< Spins waiting for previous consumers. */
+	uint32_t max_used;         /**< Highest occupancy seen on enqueue. */
+} __rte_cache_aligned;
+
 /**
  * An RTE ring structure.
  *
@@ -136,6 +166,13 @@ struct rte_ring {
 	uint32_t capacity;       /**< Usable size of ring */
 
 	char pad0 __rte_cache_aligned; /**< empty cache line */
+	/**
+	 * Per-lcore statistics, allocated by the library along with the ring
+	 * when it collects them, NULL otherwise. It sits in the padding of
+	 * the empty cache line, so the layout of the ring does not depend
+	 * on the statistics.
+	 */
+	struct rte_ring_stats *stats;
 
 	/** Ring producer status. */
 	RTE_STD_C11
@@ -143,6 +180,7 @@ struct rte_ring {
 		struct rte_ring_headtail prod;
 		struct rte_ring_hts_headtail hts_prod;
 		struct rte_ring_rts_headtail rts_prod;
+		struct rte_ring_seq_headtail seq_prod;
 	}  __rte_cache_aligned;
 
 	char pad1 __rte_cache_aligned; /**< empty cache line */
@@ -153,11 +191,102 @@ struct rte_ring {
 		struct rte_ring_headtail cons;
 		struct rte_ring_hts_headtail hts_cons;
 		struct rte_ring_rts_headtail rts_cons;
+		struct rte_ring_seq_headtail seq_cons;
 	}  __rte_cache_aligned;
 
 	char pad2 __rte_cache_aligned; /**< empty cache line */
 };
 
+#ifdef RTE_LIBRTE_RING_STATS
+/**
+ * @internal Add a value to a statistic field of the calling lcore.
+ */
+#define __RING_STAT_ADD(r, name, n) do {                        \
+		unsigned int __lcore_id = rte_lcore_id();       \
+		if ((r)->stats != NULL &&                       \
+				__lcore_id < RTE_MAX_LCORE)     \
+			(r)->stats[__lcore_id].name += (n);     \
+	} while (0)
+#else
+#define __RING_STAT_ADD(r, name, n) do {} while (0)
+#endif
+
+/**
+ * @internal Account the result of an enqueue operation.
+ */
+static __rte_always_inline void
+__rte_ring_stat_enqueue(struct rte_ring *r, uint32_t num, uint32_t n,
+	uint32_t free_entries)
+{
+#ifdef RTE_LIBRTE_RING_STATS
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_ring_stats *stats;
+	uint32_t used;
+
+	if (r->stats == NULL || lcore_id >= RTE_MAX_LCORE)
+		return;
+
+	stats = &r->stats[lcore_id];
+	if (n == 0) {
+		stats->enq_fail_bulk++;
+		return;
+	}
+	stats->enq_success_bulk++;
+	stats->enq_success_objs += n;
+	if (n != num)
+		stats->enq_partial_bulk++;
+	used = r->capacity - free_entries + n;
+	if (used > stats->max_used)
+		stats->max_used = used;
+#else
+	RTE_SET_USED(r);
+	RTE_SET_USED(num);
+	RTE_SET_USED(n);
+	RTE_SET_USED(free_entries);
+#endif
+}
+
+/**
+ * @internal Account the result of a dequeue operation.
+ */
+static __rte_always_inline void
+__rte_ring_stat_dequeue(struct rte_ring *r, uint32_t num, uint32_t n)
+{
+#ifdef RTE_LIBRTE_RING_STATS
+	if (n == 0) {
+		__RING_STAT_ADD(r, deq_fail_bulk, 1);
+		return;
+	}
+	__RING_STAT_ADD(r, deq_success_bulk, 1);
+	__RING_STAT_ADD(r, deq_success_objs, n);
+	if (n != num)
+		__RING_STAT_ADD(r, deq_partial_bulk, 1);
+#else
+	RTE_SET_USED(r);
+	RTE_SET_USED(num);
+	RTE_SET_USED(n);
+#endif
+}
+
+/**
+ * @internal Account one spin waiting for the tail of a ring.
+ */
+static __rte_always_inline void
+__rte_ring_stat_tail_spin(struct rte_ring_headtail *ht, uint32_t enqueue)
+{
+#ifdef RTE_LIBRTE_RING_STATS
+	if (enqueue)
+		__RING_STAT_ADD(container_of(ht, struct rte_ring, prod),
+				enq_tail_spins, 1);
+	else
+		__RING_STAT_ADD(container_of(ht, struct rte_ring, cons),
+				deq_tail_spins, 1);
+#else
+	RTE_SET_USED(ht);
+	RTE_SET_USED(enqueue);
+#endif
+}
+
 #define RING_F_SP_ENQ 0x0001 /**< The default enqueue is "single-producer". */
 #define RING_F_SC_DEQ 0x0002 /**< The default dequeue is "single-consumer". */
 /**
@@ -177,6 +306,14 @@ struct rte_ring {
 #define RING_F_MP_HTS_ENQ 0x0020 /**< The default enqueue is "MP HTS". */
 #define RING_F_MC_HTS_DEQ 0x0040 /**< The default dequeue is "MC HTS". */
 
+/**
+ * The default enqueue is "MP SEQ". It can only be used together with
+ * RING_F_MC_SEQ_DEQ, and with rings created by rte_ring_create_elem().
+ */
+#define RING_F_MP_SEQ_ENQ 0x0080
+/** The default dequeue is "MC SEQ", see RING_F_MP_SEQ_ENQ. */
+#define RING_F_MC_SEQ_DEQ 0x0100
+
 #ifdef __cplusplus
 }
 #endif
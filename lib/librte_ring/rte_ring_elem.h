@@ -77,6 +77,9 @@ ssize_t rte_ring_get_memsize_elem(unsigned int esize, unsigned int count);
  *      - RING_F_MP_HTS_ENQ: If this flag is set, the default behavior when
  *        using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
  *        is "multi-producer HTS mode".
+ *      - RING_F_MP_SEQ_ENQ: If this flag is set, the default behavior when
+ *        using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
+ *        is "multi-producer SEQ mode". It requires RING_F_MC_SEQ_DEQ.
  *     If none of these flags is set, then default "multi-producer"
  *     behavior is selected.
  *   - One of mutually exclusive flags that define consumer behavior:
@@ -89,6 +92,9 @@ ssize_t rte_ring_get_memsize_elem(unsigned int esize, unsigned int count);
  *      - RING_F_MC_HTS_DEQ: If this flag is set, the default behavior when
  *        using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
  *        is "multi-consumer HTS mode".
+ *      - RING_F_MC_SEQ_DEQ: If this flag is set, the default behavior when
+ *        using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
+ *        is "multi-consumer SEQ mode". It requires RING_F_MP_SEQ_ENQ.
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
  * @return
@@ -413,6 +419,7 @@ __rte_ring_do_enqueue_elem(struct rte_ring *r, const void *obj_table,
 		enum rte_ring_queue_behavior behavior, unsigned int is_sp,
 		unsigned int *free_space)
 {
+	const unsigned int num = n;
 	uint32_t prod_head, prod_next;
 	uint32_t free_entries;
 
@@ -425,6 +432,7 @@ __rte_ring_do_enqueue_elem(struct rte_ring *r, const void *obj_table,
 
 	update_tail(&r->prod, prod_head, prod_next, is_sp, 1);
 end:
+	__rte_ring_stat_enqueue(r, num, n, free_entries);
 	if (free_space != NULL)
 		*free_space = free_entries - n;
 	return n;
@@ -460,6 +468,7 @@ __rte_ring_do_dequeue_elem(struct rte_ring *r, void *obj_table,
 		enum rte_ring_queue_behavior behavior, unsigned int is_sc,
 		unsigned int *available)
 {
+	const unsigned int num = n;
 	uint32_t cons_head, cons_next;
 	uint32_t entries;
 
@@ -473,6 +482,7 @@ __rte_ring_do_dequeue_elem(struct rte_ring *r, void *obj_table,
 	update_tail(&r->cons, cons_head, cons_next, is_sc, 0);
 
 end:
+	__rte_ring_stat_dequeue(r, num, n);
 	if (available != NULL)
 		*available = entries - n;
 	return n;
@@ -540,6 +550,7 @@ rte_ring_sp_enqueue_bulk_elem(struct rte_ring *r, const void *obj_table,
 #ifdef ALLOW_EXPERIMENTAL_API
 #include <rte_ring_hts.h>
 #include <rte_ring_rts.h>
+#include <rte_ring_seq.h>
 #endif
 
 /**
@@ -583,6 +594,9 @@ rte_ring_enqueue_bulk_elem(struct rte_ring *r, const void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mp_hts_enqueue_bulk_elem(r, obj_table, esize, n,
 			free_space);
+	case RTE_RING_SYNC_MT_SEQ:
+		return rte_ring_mp_seq_enqueue_bulk_elem(r, obj_table, esize, n,
+			free_space);
 #endif
 	}
 
@@ -767,6 +781,9 @@ rte_ring_dequeue_bulk_elem(struct rte_ring *r, void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mc_hts_dequeue_bulk_elem(r, obj_table, esize,
 			n, available);
+	case RTE_RING_SYNC_MT_SEQ:
+		return rte_ring_mc_seq_dequeue_bulk_elem(r, obj_table, esize,
+			n, available);
 #endif
 	}
 
@@ -955,6 +972,9 @@ rte_ring_enqueue_burst_elem(struct rte_ring *r, const void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mp_hts_enqueue_burst_elem(r, obj_table, esize,
 			n, free_space);
+	case RTE_RING_SYNC_MT_SEQ:
+		return rte_ring_mp_seq_enqueue_burst_elem(r, obj_table, esize,
+			n, free_space);
 #endif
 	}
 
@@ -1067,6 +1087,9 @@ rte_ring_dequeue_burst_elem(struct rte_ring *r, void *obj_table,
 	case RTE_RING_SYNC_MT_HTS:
 		return rte_ring_mc_hts_dequeue_burst_elem(r, obj_table, esize,
 			n, available);
+	case RTE_RING_SYNC_MT_SEQ:
+		return rte_ring_mc_seq_dequeue_burst_elem(r, obj_table, esize,
+			n, available);
 #endif
 	}
 
@@ -23,8 +23,10 @@ update_tail(struct rte_ring_headtail *ht, uint32_t old_val, uint32_t new_val,
 	 * we need to wait for them to complete
 	 */
 	if (!single)
-		while (unlikely(ht->tail != old_val))
+		while (unlikely(ht->tail != old_val)) {
+			__rte_ring_stat_tail_spin(ht, enqueue);
 			rte_pause();
+		}
 
 	ht->tail = new_val;
 }
@@ -95,6 +97,8 @@ __rte_ring_move_prod_head(struct rte_ring *r, unsigned int is_sp,
 		else
 			success = rte_atomic32_cmpset(&r->prod.head,
 					*old_head, *new_head);
+		if (unlikely(success == 0))
+			__RING_STAT_ADD(r, enq_cas_retries, 1);
 	} while (unlikely(success == 0));
 	return n;
 }
@@ -166,6 +170,8 @@ __rte_ring_move_cons_head(struct rte_ring *r, unsigned int is_sc,
 			success = rte_atomic32_cmpset(&r->cons.head, *old_head,
 					*new_head);
 		}
+		if (unlikely(success == 0))
+			__RING_STAT_ADD(r, deq_cas_retries, 1);
 	} while (unlikely(success == 0));
 	return n;
 }
@@ -58,6 +58,7 @@ __rte_ring_do_hts_enqueue_elem(struct rte_ring *r, const void *obj_table,
 	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
 	uint32_t *free_space)
 {
+	const uint32_t num = n;
 	uint32_t free, head;
 
 	n =  __rte_ring_hts_move_prod_head(r, n, behavior, &head, &free);
@@ -67,6 +68,7 @@ __rte_ring_do_hts_enqueue_elem(struct rte_ring *r, const void *obj_table,
 		__rte_ring_hts_update_tail(&r->hts_prod, head, n, 1);
 	}
 
+	__rte_ring_stat_enqueue(r, num, n, free);
 	if (free_space != NULL)
 		*free_space = free - n;
 	return n;
@@ -99,6 +101,7 @@ __rte_ring_do_hts_dequeue_elem(struct rte_ring *r, void *obj_table,
 	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
 	uint32_t *available)
 {
+	const uint32_t num = n;
 	uint32_t entries, head;
 
 	n = __rte_ring_hts_move_cons_head(r, n, behavior, &head, &entries);
@@ -108,6 +111,7 @@ __rte_ring_do_hts_dequeue_elem(struct rte_ring *r, void *obj_table,
 		__rte_ring_hts_update_tail(&r->hts_cons, head, n, 0);
 	}
 
+	__rte_ring_stat_dequeue(r, num, n);
 	if (available != NULL)
 		*available = entries - n;
 	return n;
@@ -85,6 +85,7 @@ __rte_ring_do_rts_enqueue_elem(struct rte_ring *r, const void *obj_table,
 	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
 	uint32_t *free_space)
 {
+	const uint32_t num = n;
 	uint32_t free, head;
 
 	n =  __rte_ring_rts_move_prod_head(r, n, behavior, &head, &free);
@@ -94,6 +95,7 @@ __rte_ring_do_rts_enqueue_elem(struct rte_ring *r, const void *obj_table,
 		__rte_ring_rts_update_tail(&r->rts_prod);
 	}
 
+	__rte_ring_stat_enqueue(r, num, n, free);
 	if (free_space != NULL)
 		*free_space = free - n;
 	return n;
@@ -126,6 +128,7 @@ __rte_ring_do_rts_dequeue_elem(struct rte_ring *r, void *obj_table,
 	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
 	uint32_t *available)
 {
+	const uint32_t num = n;
 	uint32_t entries, head;
 
 	n = __rte_ring_rts_move_cons_head(r, n, behavior, &head, &entries);
@@ -135,6 +138,7 @@ __rte_ring_do_rts_dequeue_elem(struct rte_ring *r, void *obj_table,
 		__rte_ring_rts_update_tail(&r->rts_cons);
 	}
 
+	__rte_ring_stat_dequeue(r, num, n);
 	if (available != NULL)
 		*available = entries - n;
 	return n;
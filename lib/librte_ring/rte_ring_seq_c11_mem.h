@@ -0,0 +1,102 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#ifndef _RTE_RING_SEQ_C11_MEM_H_
+#define _RTE_RING_SEQ_C11_MEM_H_
+
+/**
+ * @file rte_ring_seq_c11_mem.h
+ * It is not recommended to include this file directly,
+ * include <rte_ring.h> instead.
+ * Contains internal helper functions for per-slot sequence (SEQ) ring mode.
+ * For more information please refer to <rte_ring_seq.h>.
+ */
+
+/**
+ * @internal This function claims positions for enqueue or dequeue.
+ * Positions are bounded by the opposite side's position plus *capacity*:
+ * the ring capacity for producers, 0 for consumers.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_seq_move_pos(struct rte_ring_seq_headtail *ht,
+	const volatile uint32_t *opp_tail, uint32_t capacity, unsigned int num,
+	enum rte_ring_queue_behavior behavior, uint32_t *old_pos,
+	uint32_t *entries)
+{
+	unsigned int n;
+	int success;
+
+	*old_pos = __atomic_load_n(&ht->tail, __ATOMIC_RELAXED);
+	do {
+		/* Reset n to the initial burst count */
+		n = num;
+
+		/* Ensure the position is read before the opposite one */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		/*
+		 *  The subtraction is done between two unsigned 32bits value
+		 * (the result is always modulo 32 bits even if we have
+		 * *old_pos > opposite position).
+		 */
+		*entries = capacity +
+			__atomic_load_n(opp_tail, __ATOMIC_RELAXED) - *old_pos;
+
+		/* check that we have enough room in ring */
+		if (unlikely(n > *entries))
+			n = (behavior == RTE_RING_QUEUE_FIXED) ?
+					0 : *entries;
+
+		if (n == 0)
+			return 0;
+
+		/* on failure, *old_pos is updated */
+		success = __atomic_compare_exchange_n(&ht->tail, old_pos,
+				*old_pos + n, 0, __ATOMIC_RELAXED,
+				__ATOMIC_RELAXED);
+	} while (unlikely(success == 0));
+
+	return n;
+}
+
+/**
+ * @internal Waits till the claimed slots are handed over: slot of position
+ * *pos* is ready when its sequence number is *pos* + *ofs*.
+ * Slots are owned by the thread which claimed them, no other thread waits
+ * on them.
+ */
+static __rte_always_inline void
+__rte_ring_seq_wait(const uint32_t *seq, uint32_t mask, uint32_t pos,
+	uint32_t num, uint32_t ofs)
+{
+	uint32_t i;
+
+	for (i = 0; i != num; i++) {
+		/* load-acquire synchronizes with the store-release in
+		 * __rte_ring_seq_publish() of the opposite side.
+		 */
+		while (__atomic_load_n(&seq[(pos + i) & mask],
+				__ATOMIC_ACQUIRE) != pos + i + ofs)
+			rte_pause();
+	}
+}
+
+/**
+ * @internal Hands the claimed slots over to the opposite side, by setting
+ * the sequence number of the slot of position *pos* to *pos* + *ofs*:
+ * 1 for producers (slot filled), ring size for consumers (slot free for
+ * the next lap).
+ */
+static __rte_always_inline void
+__rte_ring_seq_publish(uint32_t *seq, uint32_t mask, uint32_t pos,
+	uint32_t num, uint32_t ofs)
+{
+	uint32_t i;
+
+	for (i = 0; i != num; i++)
+		__atomic_store_n(&seq[(pos + i) & mask], pos + i + ofs,
+				__ATOMIC_RELEASE);
+}
+
+#endif /* _RTE_RING_SEQ_C11_MEM_H_ */
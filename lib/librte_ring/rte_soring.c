@@ -0,0 +1,146 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_memzone.h>
+#include <rte_errno.h>
+#include <rte_string_fns.h>
+
+#include "rte_soring.h"
+
+#define SORING_F_MASK (RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ)
+
+/*
+ * The staged ordered ring, its stages, the release state of each stage and
+ * the underlying ring are laid out one after the other in a single memzone.
+ */
+static size_t
+soring_get_memsize(uint32_t esize, uint32_t count, uint32_t nb_stages,
+		size_t *stage_ofs, size_t *state_ofs, size_t *ring_ofs)
+{
+	ssize_t ring_size;
+	size_t sz;
+
+	ring_size = rte_ring_get_memsize_elem(esize, count);
+	if (ring_size < 0)
+		return 0;
+
+	sz = sizeof(struct rte_soring);
+	*stage_ofs = sz;
+	sz += (size_t)nb_stages * sizeof(struct rte_soring_stage);
+	*state_ofs = sz;
+	sz += (size_t)nb_stages * count * sizeof(uint64_t);
+	sz = RTE_ALIGN_CEIL(sz, RTE_CACHE_LINE_SIZE);
+	*ring_ofs = sz;
+	return sz + ring_size;
+}
+
+struct rte_soring *
+rte_soring_create(const char *name, uint32_t esize, uint32_t count,
+		uint32_t nb_stages, int socket_id, uint32_t flags)
+{
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	struct rte_soring *s;
+	size_t stage_ofs, state_ofs, ring_ofs, sz;
+	const uint32_t requested_count = count;
+	int ret;
+
+	if (nb_stages == 0 || (flags & ~SORING_F_MASK) != 0) {
+		RTE_LOG(ERR, RING,
+			"Invalid number of stages %u or flags %#x\n",
+			nb_stages, flags);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	/* for an exact size ring, round up from count to a power of two */
+	if (flags & RING_F_EXACT_SZ)
+		count = rte_align32pow2(count + 1);
+
+	sz = soring_get_memsize(esize, count, nb_stages, &stage_ofs,
+			&state_ofs, &ring_ofs);
+	if (sz == 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (strnlen(name, RTE_RING_NAMESIZE) == RTE_RING_NAMESIZE) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+	ret = snprintf(mz_name, sizeof(mz_name), "%s%s",
+		RTE_SORING_MZ_PREFIX, name);
+	if (ret < 0 || ret >= (int)sizeof(mz_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	/* the memzone functions set rte_errno on failure */
+	mz = rte_memzone_reserve_aligned(mz_name, sz, socket_id, 0,
+			RTE_CACHE_LINE_SIZE);
+	if (mz == NULL) {
+		RTE_LOG(ERR, RING, "Cannot reserve memory\n");
+		return NULL;
+	}
+
+	s = mz->addr;
+	memset(s, 0, ring_ofs);
+	strlcpy(s->name, name, sizeof(s->name));
+	s->memzone = mz;
+	s->esize = esize;
+	s->nb_stages = nb_stages;
+	s->stage = RTE_PTR_ADD(s, stage_ofs);
+	s->state = RTE_PTR_ADD(s, state_ofs);
+	s->r = RTE_PTR_ADD(s, ring_ofs);
+
+	ret = rte_ring_init(s->r, name, requested_count, flags);
+	if (ret != 0) {
+		rte_memzone_free(mz);
+		rte_errno = -ret;
+		return NULL;
+	}
+
+	return s;
+}
+
+void
+rte_soring_free(struct rte_soring *s)
+{
+	if (s == NULL)
+		return;
+
+	/* staged ordered ring memory is cleared when the memzone is freed */
+	if (rte_memzone_free(s->memzone) != 0)
+		RTE_LOG(ERR, RING, "Cannot free memory\n");
+}
+
+void
+rte_soring_dump(FILE *f, const struct rte_soring *s)
+{
+	uint32_t i;
+
+	fprintf(f, "soring <%s>@%p\n", s->name, s);
+	fprintf(f, "  flags=%x\n", s->r->flags);
+	fprintf(f, "  esize=%"PRIu32"\n", s->esize);
+	fprintf(f, "  size=%"PRIu32"\n", s->r->size);
+	fprintf(f, "  capacity=%"PRIu32"\n", s->r->capacity);
+	fprintf(f, "  ct=%"PRIu32"\n", s->r->cons.tail);
+	fprintf(f, "  ch=%"PRIu32"\n", s->r->cons.head);
+	fprintf(f, "  pt=%"PRIu32"\n", s->r->prod.tail);
+	fprintf(f, "  ph=%"PRIu32"\n", s->r->prod.head);
+	for (i = 0; i < s->nb_stages; i++) {
+		fprintf(f, "  stage[%u].t=%"PRIu32"\n", i, s->stage[i].tail);
+		fprintf(f, "  stage[%u].h=%"PRIu32"\n", i, s->stage[i].head);
+	}
+	fprintf(f, "  used=%u\n", rte_soring_count(s));
+	fprintf(f, "  avail=%u\n", rte_soring_free_count(s));
+}
@@ -0,0 +1,586 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 The DPDK contributors
+ */
+
+#ifndef _RTE_SORING_H_
+#define _RTE_SORING_H_
+
+/**
+ * @file
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * RTE Staged Ordered Ring
+ *
+ * A staged ordered ring (soring) passes objects through a fixed number of
+ * processing stages, without moving them from one ring to another:
+ * - producers enqueue objects once,
+ * - each stage acquires objects which went through the previous stage (or
+ *   were enqueued, for the first stage), processes them and releases them.
+ *   Several workers can acquire and release objects of the same stage
+ *   concurrently, and release them in any order,
+ * - consumers dequeue objects released by the last stage, in the order
+ *   they were enqueued.
+ *
+ * A stage only gets objects once all the preceding ones were released by
+ * the previous stage, so that objects never overtake each other.
+ *
+ * The objects are stored in a ring of elements of any size multiple of
+ * 4 bytes, as with rte_ring_elem.h. Stages get acquired objects either by
+ * copy, or in place through the zero copy information of rte_ring_peek_zc.h.
+ *
+ * Producers and consumers can be single or multi-threaded, depending on the
+ * RING_F_SP_ENQ and RING_F_SC_DEQ creation flags. Stages are always
+ * multi-threaded.
+ *
+ * Example with a single classification stage:
+ *
+ * // Producer
+ * rte_soring_enqueue_burst(s, pkts, nb_rx, NULL);
+ *
+ * // Workers of stage 0
+ * n = rte_soring_acquire_burst(s, pkts, 0, 32, &ftoken, NULL);
+ * if (n != 0) {
+ *	classify(pkts, n);
+ *	rte_soring_release(s, NULL, 0, n, ftoken);
+ * }
+ *
+ * // Consumer
+ * n = rte_soring_dequeue_burst(s, pkts, 32, NULL);
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_debug.h>
+#include <rte_memzone.h>
+#include <rte_ring_elem.h>
+#include <rte_ring_peek_zc.h>
+
+/** The reserved memzone name prefix of staged ordered rings. */
+#define RTE_SORING_MZ_PREFIX "SOR_"
+
+/**
+ * @internal Positions of a stage of a staged ordered ring.
+ */
+struct rte_soring_stage {
+	volatile uint32_t head; /**< Next position to acquire. */
+	volatile uint32_t tail; /**< Positions below are released. */
+} __rte_cache_aligned;
+
+/**
+ * A staged ordered ring.
+ */
+struct rte_soring {
+	char name[RTE_RING_NAMESIZE] __rte_cache_aligned;
+	/**< Name of the staged ordered ring. */
+	const struct rte_memzone *memzone;
+	/**< Memzone, if any, containing the staged ordered ring. */
+	uint32_t esize;     /**< Size of the objects, in bytes. */
+	uint32_t nb_stages; /**< Number of stages. */
+	struct rte_soring_stage *stage; /**< Positions of each stage. */
+	uint64_t *state;
+	/**< Per stage and per slot, released ranges not yet passed by tail. */
+	struct rte_ring *r; /**< Objects, producer and consumer positions. */
+};
+
+/**
+ * @internal Tail bounding the objects a stage can acquire.
+ */
+static __rte_always_inline const volatile uint32_t *
+__rte_soring_stage_bound(const struct rte_soring *s, uint32_t stage)
+{
+	if (stage == 0)
+		return &s->r->prod.tail;
+	return &s->stage[stage - 1].tail;
+}
+
+/**
+ * @internal Move a stage or consumer head forward, up to a bounding tail.
+ */
+static __rte_always_inline uint32_t
+__rte_soring_move_head(volatile uint32_t *head, const volatile uint32_t *bound,
+		uint32_t num, enum rte_ring_queue_behavior behavior,
+		int is_st, uint32_t *old_head, uint32_t *entries)
+{
+	uint32_t n, new_head;
+	int success;
+
+	*old_head = __atomic_load_n(head, __ATOMIC_RELAXED);
+	do {
+		n = num;
+
+		/* Ensure the head is read before the bounding tail */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		/* load-acquire synchronizes with the release of the
+		 * objects by the previous stage.
+		 */
+		*entries = __atomic_load_n(bound, __ATOMIC_ACQUIRE) -
+				*old_head;
+		if (n > *entries)
+			n = (behavior == RTE_RING_QUEUE_FIXED) ? 0 : *entries;
+		if (unlikely(n == 0))
+			return 0;
+
+		new_head = *old_head + n;
+		if (is_st) {
+			*head = new_head;
+			success = 1;
+		} else {
+			/* on failure, *old_head is updated */
+			success = __atomic_compare_exchange_n(head, old_head,
+					new_head, 0, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED);
+		}
+	} while (unlikely(success == 0));
+
+	return n;
+}
+
+/**
+ * @internal Acquire objects for a stage.
+ */
+static __rte_always_inline uint32_t
+__rte_soring_do_acquire(struct rte_soring *s, void *objs,
+		struct rte_ring_zc_data *zcd, uint32_t stage, uint32_t num,
+		enum rte_ring_queue_behavior behavior, uint32_t *ftoken,
+		uint32_t *available)
+{
+	uint32_t n, head, entries;
+
+	RTE_ASSERT(stage < s->nb_stages);
+
+	n = __rte_soring_move_head(&s->stage[stage].head,
+			__rte_soring_stage_bound(s, stage), num, behavior, 0,
+			&head, &entries);
+	if (n != 0) {
+		if (objs != NULL)
+			__rte_ring_dequeue_elems(s->r, head, objs, s->esize, n);
+		if (zcd != NULL)
+			__rte_ring_get_elem_addr(s->r, head, s->esize, n,
+					&zcd->ptr1, &zcd->n1, &zcd->ptr2);
+		*ftoken = head;
+	}
+
+	if (available != NULL)
+		*available = entries - n;
+	return n;
+}
+
+/**
+ * @internal Mark a range of objects as released by a stage, and move the
+ * tail of the stage over all the ranges released in order.
+ */
+static __rte_always_inline void
+__rte_soring_finish(struct rte_soring *s, uint32_t stage, uint32_t ftoken,
+		uint32_t num)
+{
+	struct rte_soring_stage *stg = &s->stage[stage];
+	uint64_t *state = s->state + (uint64_t)stage * s->r->size;
+	const uint32_t mask = s->r->mask;
+	uint64_t st;
+	uint32_t t, n;
+
+	/*
+	 * Publish the range, then look at the tail. The range owning the
+	 * tail does the opposite, seq_cst ordering guarantees at least one
+	 * of them sees the other.
+	 */
+	__atomic_store_n(&state[ftoken & mask], ((uint64_t)num << 32) | ftoken,
+			__ATOMIC_SEQ_CST);
+	t = __atomic_load_n(&stg->tail, __ATOMIC_SEQ_CST);
+
+	for (;;) {
+		st = __atomic_load_n(&state[t & mask], __ATOMIC_SEQ_CST);
+		n = st >> 32;
+		if (n == 0 || (uint32_t)st != t)
+			return;
+
+		/* on failure, t is updated with the current tail */
+		if (__atomic_compare_exchange_n(&stg->tail, &t, t + n, 0,
+				__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+			/* forget the range, unless the slot was reused */
+			__atomic_compare_exchange_n(&state[t & mask], &st, 0,
+					0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+			t += n;
+		}
+	}
+}
+
+/**
+ * @internal Dequeue objects released by the last stage.
+ */
+static __rte_always_inline uint32_t
+__rte_soring_do_dequeue(struct rte_soring *s, void *objs, uint32_t num,
+		enum rte_ring_queue_behavior behavior, uint32_t *available)
+{
+	struct rte_ring *r = s->r;
+	int is_sc = (r->cons.sync_type == RTE_RING_SYNC_ST);
+	uint32_t n, head, entries;
+
+	n = __rte_soring_move_head(&r->cons.head,
+			&s->stage[s->nb_stages - 1].tail, num, behavior, is_sc,
+			&head, &entries);
+	if (n != 0) {
+		__rte_ring_dequeue_elems(r, head, objs, s->esize, n);
+		update_tail(&r->cons, head, head + n, is_sc, 0);
+	}
+
+	if (available != NULL)
+		*available = entries - n;
+	return n;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue several objects on a staged ordered ring.
+ *
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ * @param objs
+ *   A pointer to a table of objects, of the size given at creation.
+ * @param n
+ *   The number of objects to add in the ring from the objs.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued, either 0 or n.
+ */
+__rte_experimental
+static __rte_always_inline uint32_t
+rte_soring_enqueue_bulk(struct rte_soring *s, const void *objs, uint32_t n,
+		uint32_t *free_space)
+{
+	return rte_ring_enqueue_bulk_elem(s->r, objs, s->esize, n, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue up to a maximum number of objects on a staged ordered ring.
+ *
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ * @param objs
+ *   A pointer to a table of objects, of the size given at creation.
+ * @param n
+ *   The number of objects to add in the ring from the objs.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued, between 0 and n.
+ */
+__rte_experimental
+static __rte_always_inline uint32_t
+rte_soring_enqueue_burst(struct rte_soring *s, const void *objs, uint32_t n,
+		uint32_t *free_space)
+{
+	return rte_ring_enqueue_burst_elem(s->r, objs, s->esize, n,
+			free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Acquire several objects for a stage, copying them.
+ *
+ * The objects must then be released with rte_soring_release(), before
+ * the next stage can acquire them or the following ones.
+ *
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ * @param objs
+ *   A pointer to a table of objects to fill, of the size given at creation.
+ * @param stage
+ *   The stage to acquire objects for, less than the number of stages.
+ * @param n
+ *   The number of objects to acquire.
+ * @param ftoken
+ *   Filled with the token to give to rte_soring_release().
+ * @param available
+ *   If non-NULL, returns the number of remaining objects available to the
+ *   stage after the acquire has finished.
+ * @return
+ *   The number of objects acquired, either 0 or n.
+ */
+__rte_experimental
+static __rte_always_inline uint32_t
+rte_soring_acquire_bulk(struct rte_soring *s, void *objs, uint32_t stage,
+		uint32_t n, uint32_t *ftoken, uint32_t *available)
+{
+	return __rte_soring_do_acquire(s, objs, NULL, stage, n,
+			RTE_RING_QUEUE_FIXED, ftoken, available);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Acquire up to a maximum number of objects for a stage, copying them.
+ *
+ * @see rte_soring_acquire_bulk()
+ *
+ * @return
+ *   The number of objects acquired, between 0 and n.
+ */
+__rte_experimental
+static __rte_always_inline uint32_t
+rte_soring_acquire_burst(struct rte_soring *s, void *objs, uint32_t stage,
+		uint32_t n, uint32_t *ftoken, uint32_t *available)
+{
+	return __rte_soring_do_acquire(s, objs, NULL, stage, n,
+			RTE_RING_QUEUE_VARIABLE, ftoken, available);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Acquire several objects for a stage, giving access to them in the ring.
+ *
+ * The objects can be read and modified in place until they are released
+ * with rte_soring_release().
+ *
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ * @param stage
+ *   The stage to acquire objects for, less than the number of stages.
+ * @param n
+ *   The number of objects to acquire.
+ * @param zcd
+ *   Structure filled with the location of the acquired objects in the ring.
+ * @param ftoken
+ *   Filled with the token to give to rte_soring_release().
+ * @param available
+ *   If non-NULL, returns the number of remaining objects available to the
+ *   stage after the acquire has finished.
+ * @return
+ *   The number of objects acquired, either 0 or n.
+ */
+__rte_experimental
+static __rte_always_inline uint32_t
+rte_soring_acquire_zc_bulk(struct rte_soring *s, uint32_t stage, uint32_t n,
+		struct rte_ring_zc_data *zcd, uint32_t *ftoken,
+		uint32_t *available)
+{
+	return __rte_soring_do_acquire(s, NULL, zcd, stage, n,
+			RTE_RING_QUEUE_FIXED, ftoken, available);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Acquire up to a maximum number of objects for a stage, giving access to
+ * them in the ring.
+ *
+ * @see rte_soring_acquire_zc_bulk()
+ *
+ * @return
+ *   The number of objects acquired, between 0 and n.
+ */
+__rte_experimental
+static __rte_always_inline uint32_t
+rte_soring_acquire_zc_burst(struct rte_soring *s, uint32_t stage, uint32_t n,
+		struct rte_ring_zc_data *zcd, uint32_t *ftoken,
+		uint32_t *available)
+{
+	return __rte_soring_do_acquire(s, NULL, zcd, stage, n,
+			RTE_RING_QUEUE_VARIABLE, ftoken, available);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Release objects acquired for a stage, making them available to the next
+ * stage, or to consumers after the last stage, once all preceding objects
+ * are released too.
+ *
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ * @param objs
+ *   If non-NULL, a table of objects replacing the acquired ones in the ring.
+ * @param stage
+ *   The stage the objects were acquired for.
+ * @param n
+ *   The number of objects returned by the acquire function.
+ * @param ftoken
+ *   The token returned by the acquire function.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_soring_release(struct rte_soring *s, const void *objs, uint32_t stage,
+		uint32_t n, uint32_t ftoken)
+{
+	RTE_ASSERT(stage < s->nb_stages);
+
+	if (objs != NULL)
+		__rte_ring_enqueue_elems(s->r, ftoken, objs, s->esize, n);
+	__rte_soring_finish(s, stage, ftoken, n);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dequeue several objects released by the last stage of a staged ordered
+ * ring, in enqueue order.
+ *
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ * @param objs
+ *   A pointer to a table of objects to fill, of the size given at creation.
+ * @param n
+ *   The number of objects to dequeue.
+ * @param available
+ *   If non-NULL, returns the number of remaining objects ready to be
+ *   dequeued after the dequeue has finished.
+ * @return
+ *   The number of objects dequeued, either 0 or n.
+ */
+__rte_experimental
+static __rte_always_inline uint32_t
+rte_soring_dequeue_bulk(struct rte_soring *s, void *objs, uint32_t n,
+		uint32_t *available)
+{
+	return __rte_soring_do_dequeue(s, objs, n, RTE_RING_QUEUE_FIXED,
+			available);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dequeue up to a maximum number of objects released by the last stage of
+ * a staged ordered ring, in enqueue order.
+ *
+ * @see rte_soring_dequeue_bulk()
+ *
+ * @return
+ *   The number of objects dequeued, between 0 and n.
+ */
+__rte_experimental
+static __rte_always_inline uint32_t
+rte_soring_dequeue_burst(struct rte_soring *s, void *objs, uint32_t n,
+		uint32_t *available)
+{
+	return __rte_soring_do_dequeue(s, objs, n, RTE_RING_QUEUE_VARIABLE,
+			available);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Return the number of objects in a staged ordered ring, in any stage.
+ *
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ * @return
+ *   The number of objects between enqueue and dequeue.
+ */
+__rte_experimental
+static inline uint32_t
+rte_soring_count(const struct rte_soring *s)
+{
+	return rte_ring_count(s->r);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Return the number of free entries in a staged ordered ring.
+ *
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ * @return
+ *   The number of objects which can be enqueued.
+ */
+__rte_experimental
+static inline uint32_t
+rte_soring_free_count(const struct rte_soring *s)
+{
+	return rte_ring_free_count(s->r);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new staged ordered ring in memory.
+ *
+ * @param name
+ *   The name of the staged ordered ring.
+ * @param esize
+ *   The size of the objects, in bytes. It must be a multiple of 4.
+ * @param count
+ *   The size of the ring, a power of 2 unless RING_F_EXACT_SZ is given.
+ * @param nb_stages
+ *   The number of stages, at least 1.
+ * @param socket_id
+ *   The *socket_id* argument is the socket identifier in case of
+ *   NUMA. The value can be *SOCKET_ID_ANY* if there is no NUMA
+ *   constraint for the reserved zone.
+ * @param flags
+ *   An OR of RING_F_SP_ENQ, RING_F_SC_DEQ and RING_F_EXACT_SZ, with the
+ *   same meaning as for rte_ring_create_elem().
+ * @return
+ *   On success, the pointer to the new allocated staged ordered ring. NULL
+ *   on error with rte_errno set appropriately. Possible errno values
+ *   include:
+ *    - EINVAL - invalid esize, count, nb_stages or flags
+ *    - ENAMETOOLONG - name too long
+ *    - ENOSPC - the maximum number of memzones has already been allocated
+ *    - EEXIST - a memzone with the same name already exists
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+__rte_experimental
+struct rte_soring *rte_soring_create(const char *name, uint32_t esize,
+		uint32_t count, uint32_t nb_stages, int socket_id,
+		uint32_t flags);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * De-allocate all memory used by a staged ordered ring.
+ *
+ * @param s
+ *   Staged ordered ring to free. If NULL, nothing is done.
+ */
+__rte_experimental
+void rte_soring_free(struct rte_soring *s);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dump the status of a staged ordered ring to a file.
+ *
+ * @param f
+ *   A pointer to a file for output.
+ * @param s
+ *   A pointer to the staged ordered ring structure.
+ */
+__rte_experimental
+void rte_soring_dump(FILE *f, const struct rte_soring *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_SORING_H_ */
@@ -25,9 +25,54 @@
 #include <rte_memzone.h>
 #include <rte_malloc.h>
 #include <rte_errno.h>
+#include <rte_ring_elem.h>
 
 #include "rte_timer.h"
 
+#define WHEEL_LEVELS		4
+#define WHEEL_SLOT_BITS		8
+#define WHEEL_NB_SLOTS		(1 << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK		(WHEEL_NB_SLOTS - 1)
+#define WHEEL_BMAP_WORDS	(WHEEL_NB_SLOTS / 64)
+#define WHEEL_SPAN		(UINT64_C(1) << (WHEEL_LEVELS * WHEEL_SLOT_BITS))
+
+/* skiplist pointers of a timer reused to link it in a wheel slot */
+#define WHEEL_NEXT	0	/* next timer of the slot */
+#define WHEEL_PPREV	1	/* pointer to the pointer to this timer */
+
+/**
+ * Hierarchical timing wheel, made of levels of slots covering
+ * WHEEL_NB_SLOTS times the duration of a slot of the level below. A timer
+ * is added to the lowest level whose span covers its expiry time, and is
+ * moved to a lower level when the time reaches its slot.
+ */
+struct timer_wheel {
+	/** lists of the timers of each slot */
+	struct rte_timer *slots[WHEEL_LEVELS][WHEEL_NB_SLOTS];
+	/** bitmap of the non-empty slots */
+	uint64_t bmap[WHEEL_LEVELS][WHEEL_BMAP_WORDS];
+	uint64_t cur_tick;    /**< next tick to process */
+	uint64_t next_tick;   /**< no timer expires before this tick */
+	uint32_t nb_pending;  /**< number of timers in the wheel */
+	uint32_t tick_shift;  /**< log2 of the number of cycles per tick */
+} __rte_cache_aligned;
+
+#define TIMER_REQ_BURST	32	/* requests processed at once */
+
+/**
+ * Request to reset a timer, handed off to the lcore owning its list. The
+ * timer stays in config state until the request is processed.
+ */
+struct timer_req {
+	struct rte_timer *tim;
+	uint64_t expire;
+	uint64_t period;
+	rte_timer_cb_t f;
+	void *arg;
+	uint32_t tim_lcore; /**< lcore to run the timer */
+	uint32_t del;       /**< timer is pending in the list of this lcore */
+};
+
 /**
  * Per-lcore info for timers.
  */
@@ -47,6 +92,12 @@ struct priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** timing wheel holding the pending timers, NULL for the skiplist */
+	struct timer_wheel *wheel;
+
+	/** requests of other lcores to update the list, or NULL */
+	struct rte_ring *req_ring;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -56,6 +107,7 @@ struct priv_timer {
 #define FL_ALLOCATED	(1 << 0)
 struct rte_timer_data {
 	struct priv_timer priv_timer[RTE_MAX_LCORE];
+	struct timer_wheel *wheels; /**< per-lcore timing wheels, or NULL */
 	uint8_t internal_flags;
 };
 
@@ -115,12 +167,41 @@ rte_timer_data_alloc(uint32_t *id_ptr)
 	return -ENOSPC;
 }
 
+/* Switch the timer lists of a timer data instance back to the skiplist */
+static void
+timer_data_free_wheels(struct rte_timer_data *timer_data)
+{
+	int lcore_id;
+
+	if (timer_data->wheels == NULL)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		timer_data->priv_timer[lcore_id].wheel = NULL;
+	rte_free(timer_data->wheels);
+	timer_data->wheels = NULL;
+}
+
+/* Free the request rings of a timer data instance */
+static void
+timer_data_free_rings(struct rte_timer_data *timer_data)
+{
+	int lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		rte_ring_free(timer_data->priv_timer[lcore_id].req_ring);
+		timer_data->priv_timer[lcore_id].req_ring = NULL;
+	}
+}
+
 int
 rte_timer_data_dealloc(uint32_t id)
 {
 	struct rte_timer_data *timer_data;
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	timer_data_free_wheels(timer_data);
+	timer_data_free_rings(timer_data);
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
@@ -177,7 +258,10 @@ rte_timer_subsystem_init(void)
 					&data->priv_timer[lcore_id].list_lock);
 				data->priv_timer[lcore_id].prev_lcore =
 					lcore_id;
+				data->priv_timer[lcore_id].wheel = NULL;
+				data->priv_timer[lcore_id].req_ring = NULL;
 			}
+			data->wheels = NULL;
 		}
 	}
 
@@ -194,6 +278,8 @@ rte_timer_subsystem_init(void)
 void
 rte_timer_subsystem_finalize(void)
 {
+	int i;
+
 	rte_mcfg_timer_lock();
 
 	if (!rte_timer_subsystem_initialized) {
@@ -201,8 +287,13 @@ rte_timer_subsystem_finalize(void)
 		return;
 	}
 
-	if (--(*rte_timer_mz_refcnt) == 0)
+	if (--(*rte_timer_mz_refcnt) == 0) {
+		for (i = 0; i < RTE_MAX_DATA_ELS; i++) {
+			timer_data_free_wheels(&rte_timer_data_arr[i]);
+			timer_data_free_rings(&rte_timer_data_arr[i]);
+		}
 		rte_memzone_free(rte_timer_data_mz);
+	}
 
 	rte_timer_subsystem_initialized = 0;
 
@@ -220,15 +311,21 @@ rte_timer_init(struct rte_timer *tim)
 	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_RELAXED);
 }
 
+static void
+timer_req_drain(struct priv_timer *priv_timer, unsigned int lcore);
+
 /*
  * if timer is pending or stopped (or running on the same core than
  * us), mark timer as configuring, and on success return the previous
- * status of the timer
+ * status of the timer.
+ * A timer handed off to an lcore stays in CONFIG state, owned by this
+ * lcore, until its requests are processed: if allowed to take a list
+ * lock, process them instead of waiting for the lcore to do it.
  */
 static int
 timer_set_config_state(struct rte_timer *tim,
 		       union rte_timer_status *ret_prev_status,
-		       struct priv_timer *priv_timer)
+		       struct priv_timer *priv_timer, int drain)
 {
 	union rte_timer_status prev_status, status;
 	int success = 0;
@@ -249,9 +346,20 @@ timer_set_config_state(struct rte_timer *tim,
 		     tim != priv_timer[lcore_id].running_tim))
 			return -1;
 
-		/* timer is being configured on another core */
-		if (prev_status.state == RTE_TIMER_CONFIG)
-			return -1;
+		/* timer is being configured on another core, or its
+		 * requests are waiting in the ring of the owner lcore
+		 */
+		if (prev_status.state == RTE_TIMER_CONFIG) {
+			if (!drain ||
+			    (uint16_t)prev_status.owner >= RTE_MAX_LCORE ||
+			    priv_timer[prev_status.owner].req_ring == NULL)
+				return -1;
+			timer_req_drain(priv_timer, prev_status.owner);
+			drain = 0;
+			prev_status.u32 = __atomic_load_n(&tim->status.u32,
+							  __ATOMIC_RELAXED);
+			continue;
+		}
 
 		/* here, we know that timer is stopped or pending,
 		 * mark it atomically as being configured */
@@ -389,6 +497,230 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+static inline struct rte_timer **
+timer_wheel_pprev(const struct rte_timer *tim)
+{
+	return (struct rte_timer **)(uintptr_t)tim->sl_next[WHEEL_PPREV];
+}
+
+static inline void
+timer_wheel_set_pprev(struct rte_timer *tim, struct rte_timer **pprev)
+{
+	tim->sl_next[WHEEL_PPREV] = (struct rte_timer *)(uintptr_t)pprev;
+}
+
+/*
+ * Find the first non-empty slot of a wheel level from slot start, wrapping
+ * around. Return WHEEL_NB_SLOTS if the level is empty.
+ */
+static unsigned int
+timer_wheel_find_slot(const struct timer_wheel *w, unsigned int lvl,
+		      unsigned int start)
+{
+	const uint64_t first_mask = UINT64_MAX << (start % 64);
+	unsigned int i, idx;
+	uint64_t bits;
+
+	for (i = 0; i <= WHEEL_BMAP_WORDS; i++) {
+		idx = (start / 64 + i) % WHEEL_BMAP_WORDS;
+		bits = w->bmap[lvl][idx];
+		if (i == 0)
+			bits &= first_mask;
+		else if (i == WHEEL_BMAP_WORDS)
+			bits &= ~first_mask;
+		if (bits != 0)
+			return idx * 64 + rte_bsf64(bits);
+	}
+
+	return WHEEL_NB_SLOTS;
+}
+
+/*
+ * Return the first tick from the current one at which a slot of the wheel
+ * has to be processed: either run for the lowest level, or cascaded to the
+ * lower levels for the others.
+ */
+static uint64_t
+timer_wheel_next_tick(const struct timer_wheel *w)
+{
+	uint64_t next_tick = UINT64_MAX;
+	uint64_t pos, tick;
+	unsigned int lvl, shift, slot;
+
+	for (lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		/* first slot of the level not processed yet */
+		shift = lvl * WHEEL_SLOT_BITS;
+		pos = (w->cur_tick + (UINT64_C(1) << shift) - 1) >> shift;
+		slot = timer_wheel_find_slot(w, lvl, pos & WHEEL_SLOT_MASK);
+		if (slot == WHEEL_NB_SLOTS)
+			continue;
+		tick = (pos + ((slot - pos) & WHEEL_SLOT_MASK)) << shift;
+		if (tick < next_tick)
+			next_tick = tick;
+	}
+
+	return next_tick;
+}
+
+/* round up, so that the timer does not run before its expiry time */
+static inline uint64_t
+timer_wheel_tick(const struct timer_wheel *w, const struct rte_timer *tim)
+{
+	const uint64_t tick_mask = (UINT64_C(1) << w->tick_shift) - 1;
+
+	return (tim->expire >> w->tick_shift) +
+		((tim->expire & tick_mask) != 0);
+}
+
+/* add a timer to a timing wheel, the list lock must be held */
+static void
+timer_wheel_add(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer **head;
+	unsigned int lvl, shift, slot;
+	uint64_t tick, delta;
+
+	tick = timer_wheel_tick(w, tim);
+	if (tick < w->cur_tick)
+		tick = w->cur_tick;
+
+	/* beyond the span of the wheel, the timer is added again when the
+	 * time reaches its last slot
+	 */
+	delta = tick - w->cur_tick;
+	if (delta >= WHEEL_SPAN) {
+		tick = w->cur_tick + WHEEL_SPAN - 1;
+		delta = WHEEL_SPAN - 1;
+	}
+
+	for (lvl = 0; lvl < WHEEL_LEVELS - 1; lvl++)
+		if (delta >> ((lvl + 1) * WHEEL_SLOT_BITS) == 0)
+			break;
+	shift = lvl * WHEEL_SLOT_BITS;
+	slot = (tick >> shift) & WHEEL_SLOT_MASK;
+
+	head = &w->slots[lvl][slot];
+	tim->sl_next[WHEEL_NEXT] = *head;
+	if (*head != NULL)
+		timer_wheel_set_pprev(*head, &tim->sl_next[WHEEL_NEXT]);
+	*head = tim;
+	timer_wheel_set_pprev(tim, head);
+	w->bmap[lvl][slot / 64] |= UINT64_C(1) << (slot % 64);
+
+	/* the slot is processed at the beginning of its time range */
+	tick = (tick >> shift) << shift;
+	if (w->nb_pending++ == 0 || tick < w->next_tick)
+		w->next_tick = tick;
+}
+
+/* remove a timer from a timing wheel, the list lock must be held */
+static void
+timer_wheel_del(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer **pprev = timer_wheel_pprev(tim);
+	struct rte_timer *next = tim->sl_next[WHEEL_NEXT];
+	uintptr_t idx;
+	unsigned int lvl, slot;
+
+	/* already taken out of the wheel to be run */
+	if (pprev == NULL)
+		return;
+
+	*pprev = next;
+	if (next != NULL) {
+		timer_wheel_set_pprev(next, pprev);
+	} else {
+		/* clear the bit of the slot if it is now empty */
+		idx = ((uintptr_t)pprev - (uintptr_t)&w->slots[0][0]) /
+			sizeof(*pprev);
+		if (idx < WHEEL_LEVELS * WHEEL_NB_SLOTS) {
+			lvl = idx / WHEEL_NB_SLOTS;
+			slot = idx % WHEEL_NB_SLOTS;
+			w->bmap[lvl][slot / 64] &= ~(UINT64_C(1) << (slot % 64));
+		}
+	}
+	timer_wheel_set_pprev(tim, NULL);
+	w->nb_pending--;
+}
+
+/*
+ * Detach the list of timers of a wheel slot, return the first timer.
+ * The caller must update the timers and nb_pending.
+ */
+static struct rte_timer *
+timer_wheel_take_slot(struct timer_wheel *w, unsigned int lvl,
+		      unsigned int slot)
+{
+	struct rte_timer *first_tim = w->slots[lvl][slot];
+
+	w->slots[lvl][slot] = NULL;
+	w->bmap[lvl][slot / 64] &= ~(UINT64_C(1) << (slot % 64));
+
+	return first_tim;
+}
+
+/*
+ * Process the timing wheel up to the current time: move the timers of the
+ * upper level slots reached to the lower levels, and take the expired timers
+ * out of the wheel. The timers of an upper level slot which already expired
+ * are taken out directly, instead of going through the lower levels. Return
+ * the list of expired timers, linked by sl_next[0].
+ * The list lock must be held.
+ */
+static struct rte_timer *
+timer_wheel_expire(struct timer_wheel *w, uint64_t cur_time)
+{
+	const uint64_t now_tick = cur_time >> w->tick_shift;
+	struct rte_timer *run_first_tim = NULL, **run_last = &run_first_tim;
+	struct rte_timer *tim, *next_tim;
+	unsigned int lvl, shift;
+	uint64_t tick;
+
+	while (w->nb_pending != 0) {
+		/* skip the ticks with nothing to process */
+		tick = timer_wheel_next_tick(w);
+		if (tick > now_tick)
+			break;
+		w->cur_tick = tick;
+
+		for (lvl = WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+			shift = lvl * WHEEL_SLOT_BITS;
+			if ((tick & ((UINT64_C(1) << shift) - 1)) != 0)
+				continue;
+			tim = timer_wheel_take_slot(w, lvl,
+					(tick >> shift) & WHEEL_SLOT_MASK);
+			for (; tim != NULL; tim = next_tim) {
+				next_tim = tim->sl_next[WHEEL_NEXT];
+				w->nb_pending--;
+				if (timer_wheel_tick(w, tim) > now_tick) {
+					timer_wheel_add(w, tim);
+					continue;
+				}
+				/* mark the timer as out of the wheel */
+				timer_wheel_set_pprev(tim, NULL);
+				*run_last = tim;
+				run_last = &tim->sl_next[0];
+			}
+		}
+
+		tim = timer_wheel_take_slot(w, 0, tick & WHEEL_SLOT_MASK);
+		*run_last = tim;
+		for (; tim != NULL; tim = tim->sl_next[0]) {
+			timer_wheel_set_pprev(tim, NULL);
+			w->nb_pending--;
+			run_last = &tim->sl_next[0];
+		}
+
+		w->cur_tick = tick + 1;
+	}
+
+	if (w->cur_tick <= now_tick)
+		w->cur_tick = now_tick + 1;
+	w->next_tick = timer_wheel_next_tick(w);
+
+	return run_first_tim;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -401,6 +733,11 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
+	if (priv_timer[tim_lcore].wheel != NULL) {
+		timer_wheel_add(priv_timer[tim_lcore].wheel, tim);
+		return;
+	}
+
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev, priv_timer);
@@ -427,49 +764,228 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 }
 
 /*
- * del from list, lock if needed
+ * del from the list of an lcore, the list lock must be held
  * timer must be in config state
- * timer must be in a list
  */
 static void
-timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
-	  int local_is_locked, struct priv_timer *priv_timer)
+timer_list_del(struct rte_timer *tim, unsigned int owner,
+	       struct priv_timer *priv_timer)
 {
-	unsigned lcore_id = rte_lcore_id();
-	unsigned prev_owner = prev_status.owner;
 	int i;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
-	/* if timer needs is pending another core, we need to lock the
-	 * list; if it is on local core, we need to lock if we are not
-	 * called from rte_timer_manage() */
-	if (prev_owner != lcore_id || !local_is_locked)
-		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+	if (priv_timer[owner].wheel != NULL) {
+		timer_wheel_del(priv_timer[owner].wheel, tim);
+		return;
+	}
 
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
-	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
-		priv_timer[prev_owner].pending_head.expire =
+	if (tim == priv_timer[owner].pending_head.sl_next[0])
+		priv_timer[owner].pending_head.expire =
 				((tim->sl_next[0] == NULL) ? 0 : tim->sl_next[0]->expire);
 
 	/* adjust pointers from previous entries to point past this */
-	timer_get_prev_entries_for_node(tim, prev_owner, prev, priv_timer);
-	for (i = priv_timer[prev_owner].curr_skiplist_depth - 1; i >= 0; i--) {
+	timer_get_prev_entries_for_node(tim, owner, prev, priv_timer);
+	for (i = priv_timer[owner].curr_skiplist_depth - 1; i >= 0; i--) {
 		if (prev[i]->sl_next[i] == tim)
 			prev[i]->sl_next[i] = tim->sl_next[i];
 	}
 
 	/* in case we deleted last entry at a level, adjust down max level */
-	for (i = priv_timer[prev_owner].curr_skiplist_depth - 1; i >= 0; i--)
-		if (priv_timer[prev_owner].pending_head.sl_next[i] == NULL)
-			priv_timer[prev_owner].curr_skiplist_depth --;
+	for (i = priv_timer[owner].curr_skiplist_depth - 1; i >= 0; i--)
+		if (priv_timer[owner].pending_head.sl_next[i] == NULL)
+			priv_timer[owner].curr_skiplist_depth --;
 		else
 			break;
+}
+
+/*
+ * del from list, lock if needed
+ * timer must be in config state
+ * timer must be in a list
+ */
+static void
+timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
+	  int local_is_locked, struct priv_timer *priv_timer)
+{
+	unsigned lcore_id = rte_lcore_id();
+	unsigned prev_owner = prev_status.owner;
+
+	/* if timer needs is pending another core, we need to lock the
+	 * list; if it is on local core, we need to lock if we are not
+	 * called from rte_timer_manage() */
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+
+	timer_list_del(tim, prev_owner, priv_timer);
 
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
 
+/*
+ * add in the list of an lcore and mark as pending, the list lock must be held
+ * timer must be in config state
+ * timer must not be in a list
+ */
+static void
+timer_add_pending(struct rte_timer *tim, unsigned int tim_lcore,
+		  struct priv_timer *priv_timer)
+{
+	union rte_timer_status status;
+
+	__TIMER_STAT_ADD(priv_timer, pending, 1);
+	timer_add(tim, tim_lcore, priv_timer);
+
+	/* update state: as we are in CONFIG state, only us can modify
+	 * the state so we don't need to use cmpset() here */
+	status.state = RTE_TIMER_PENDING;
+	status.owner = (int16_t)tim_lcore;
+	/* The "RELEASE" ordering guarantees the memory operations above
+	 * the status update are observed before the update by all threads
+	 */
+	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_RELEASE);
+}
+
+/* get the lcore to run a timer, round robin for LCORE_ID_ANY */
+static unsigned int
+timer_select_lcore(unsigned int tim_lcore, struct priv_timer *priv_timer)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (tim_lcore != (unsigned int)LCORE_ID_ANY)
+		return tim_lcore;
+
+	if (lcore_id < RTE_MAX_LCORE) {
+		/* EAL thread with valid lcore_id */
+		tim_lcore = rte_get_next_lcore(
+			priv_timer[lcore_id].prev_lcore,
+			0, 1);
+		priv_timer[lcore_id].prev_lcore = tim_lcore;
+	} else
+		/* non-EAL thread do not run rte_timer_manage(),
+		 * so schedule the timer on the first enabled lcore. */
+		tim_lcore = rte_get_next_lcore(LCORE_ID_ANY, 0, 1);
+
+	return tim_lcore;
+}
+
+/*
+ * Take the list lock of an lcore, releasing the one previously taken,
+ * unless it is the same. RTE_MAX_LCORE means no lock.
+ */
+static void
+timer_lock_switch(struct priv_timer *priv_timer, unsigned int *locked,
+		  unsigned int lcore)
+{
+	if (*locked == lcore)
+		return;
+	if (*locked != RTE_MAX_LCORE)
+		rte_spinlock_unlock(&priv_timer[*locked].list_lock);
+	if (lcore != RTE_MAX_LCORE)
+		rte_spinlock_lock(&priv_timer[lcore].list_lock);
+	*locked = lcore;
+}
+
+/* hand a request off to the lcore owning a timer list, 0 on success */
+static inline int
+timer_req_send(struct priv_timer *priv_timer, unsigned int lcore,
+	       struct timer_req *req)
+{
+	union rte_timer_status status;
+
+	if (priv_timer[lcore].req_ring == NULL)
+		return -1;
+
+	/* the timer is in CONFIG state, record where its request waits
+	 * so that other updates of the timer can process it
+	 */
+	status.state = RTE_TIMER_CONFIG;
+	status.owner = (int16_t)lcore;
+	__atomic_store_n(&req->tim->status.u32, status.u32, __ATOMIC_RELAXED);
+
+	return rte_ring_mp_enqueue_elem(priv_timer[lcore].req_ring, req,
+					sizeof(*req));
+}
+
+/*
+ * Mark a timer of a burst as being configured, releasing the list lock
+ * held to process the requests handed off for it, if needed.
+ */
+static int
+timer_bulk_set_config_state(struct rte_timer *tim,
+			    union rte_timer_status *ret_prev_status,
+			    struct priv_timer *priv_timer, unsigned int *locked)
+{
+	if (timer_set_config_state(tim, ret_prev_status, priv_timer,
+				   *locked == RTE_MAX_LCORE) == 0)
+		return 0;
+	if (*locked == RTE_MAX_LCORE)
+		return -1;
+
+	timer_lock_switch(priv_timer, locked, RTE_MAX_LCORE);
+	return timer_set_config_state(tim, ret_prev_status, priv_timer, 1);
+}
+
+/* process the requests handed off to an lcore by the other ones */
+static void
+timer_req_drain(struct priv_timer *priv_timer, unsigned int lcore)
+{
+	struct rte_ring *r = priv_timer[lcore].req_ring;
+	struct timer_req reqs[TIMER_REQ_BURST];
+	uint8_t fwd[TIMER_REQ_BURST];
+	unsigned int i, n, nb_fwd, tim_lcore;
+	struct rte_timer *tim;
+
+	if (r == NULL || rte_ring_empty(r))
+		return;
+
+	do {
+		nb_fwd = 0;
+		rte_spinlock_lock(&priv_timer[lcore].list_lock);
+
+		n = rte_ring_sc_dequeue_burst_elem(r, reqs, sizeof(reqs[0]),
+						   RTE_DIM(reqs), NULL);
+		for (i = 0; i < n; i++) {
+			tim = reqs[i].tim;
+			if (reqs[i].del) {
+				timer_list_del(tim, lcore, priv_timer);
+				__TIMER_STAT_ADD(priv_timer, pending, -1);
+			}
+
+			tim->period = reqs[i].period;
+			tim->expire = reqs[i].expire;
+			tim->f = reqs[i].f;
+			tim->arg = reqs[i].arg;
+
+			if (reqs[i].tim_lcore == lcore) {
+				timer_add_pending(tim, lcore, priv_timer);
+				continue;
+			}
+
+			/* the timer moves to another lcore */
+			reqs[i].del = 0;
+			if (timer_req_send(priv_timer, reqs[i].tim_lcore,
+					   &reqs[i]) != 0)
+				fwd[nb_fwd++] = i;
+		}
+
+		rte_spinlock_unlock(&priv_timer[lcore].list_lock);
+
+		/* the ring of the other lcore is full, add the timers to its
+		 * list without holding our lock
+		 */
+		for (i = 0; i < nb_fwd; i++) {
+			tim_lcore = reqs[fwd[i]].tim_lcore;
+			rte_spinlock_lock(&priv_timer[tim_lcore].list_lock);
+			timer_add_pending(reqs[fwd[i]].tim, tim_lcore,
+					  priv_timer);
+			rte_spinlock_unlock(&priv_timer[tim_lcore].list_lock);
+		}
+	} while (n == RTE_DIM(reqs));
+}
+
 /* Reset and start the timer associated with the timer handle (private func) */
 static int
 __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
@@ -478,28 +994,19 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 		  int local_is_locked,
 		  struct rte_timer_data *timer_data)
 {
-	union rte_timer_status prev_status, status;
+	union rte_timer_status prev_status;
+	struct timer_req req;
 	int ret;
 	unsigned lcore_id = rte_lcore_id();
 	struct priv_timer *priv_timer = timer_data->priv_timer;
 
 	/* round robin for tim_lcore */
-	if (tim_lcore == (unsigned)LCORE_ID_ANY) {
-		if (lcore_id < RTE_MAX_LCORE) {
-			/* EAL thread with valid lcore_id */
-			tim_lcore = rte_get_next_lcore(
-				priv_timer[lcore_id].prev_lcore,
-				0, 1);
-			priv_timer[lcore_id].prev_lcore = tim_lcore;
-		} else
-			/* non-EAL thread do not run rte_timer_manage(),
-			 * so schedule the timer on the first enabled lcore. */
-			tim_lcore = rte_get_next_lcore(LCORE_ID_ANY, 0, 1);
-	}
+	tim_lcore = timer_select_lcore(tim_lcore, priv_timer);
 
 	/* wait that the timer is in correct status before update,
 	 * and mark it as being configured */
-	ret = timer_set_config_state(tim, &prev_status, priv_timer);
+	ret = timer_set_config_state(tim, &prev_status, priv_timer,
+				     !local_is_locked);
 	if (ret < 0)
 		return -1;
 
@@ -509,8 +1016,22 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 		priv_timer[lcore_id].updated = 1;
 	}
 
+	req.tim = tim;
+	req.expire = expire;
+	req.period = period;
+	req.f = fct;
+	req.arg = arg;
+	req.tim_lcore = tim_lcore;
+
 	/* remove it from list */
 	if (prev_status.state == RTE_TIMER_PENDING) {
+		/* let the lcore owning the list move the timer */
+		req.del = 1;
+		if (!local_is_locked &&
+		    (unsigned int)prev_status.owner != lcore_id &&
+		    timer_req_send(priv_timer, prev_status.owner, &req) == 0)
+			return 0;
+
 		timer_del(tim, prev_status, local_is_locked, priv_timer);
 		__TIMER_STAT_ADD(priv_timer, pending, -1);
 	}
@@ -520,6 +1041,12 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 	tim->f = fct;
 	tim->arg = arg;
 
+	/* let the lcore owning the destination list add the timer */
+	req.del = 0;
+	if (!local_is_locked && tim_lcore != lcore_id &&
+	    timer_req_send(priv_timer, tim_lcore, &req) == 0)
+		return 0;
+
 	/* if timer needs to be scheduled on another core, we need to
 	 * lock the destination list; if it is on local core, we need to lock if
 	 * we are not called from rte_timer_manage()
@@ -527,17 +1054,7 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 	if (tim_lcore != lcore_id || !local_is_locked)
 		rte_spinlock_lock(&priv_timer[tim_lcore].list_lock);
 
-	__TIMER_STAT_ADD(priv_timer, pending, 1);
-	timer_add(tim, tim_lcore, priv_timer);
-
-	/* update state: as we are in CONFIG state, only us can modify
-	 * the state so we don't need to use cmpset() here */
-	status.state = RTE_TIMER_PENDING;
-	status.owner = (int16_t)tim_lcore;
-	/* The "RELEASE" ordering guarantees the memory operations above
-	 * the status update are observed before the update by all threads
-	 */
-	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_RELEASE);
+	timer_add_pending(tim, tim_lcore, priv_timer);
 
 	if (tim_lcore != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[tim_lcore].list_lock);
@@ -597,7 +1114,8 @@ __rte_timer_stop(struct rte_timer *tim, int local_is_locked,
 
 	/* wait that the timer is in correct status before update,
 	 * and mark it as being configured */
-	ret = timer_set_config_state(tim, &prev_status, priv_timer);
+	ret = timer_set_config_state(tim, &prev_status, priv_timer,
+				     !local_is_locked);
 	if (ret < 0)
 		return -1;
 
@@ -649,6 +1167,137 @@ rte_timer_stop_sync(struct rte_timer *tim)
 		rte_pause();
 }
 
+/* Reset and start a burst of timers, with the same expiry and lcore */
+int
+rte_timer_reset_bulk(struct rte_timer **tims, unsigned int nb_tims,
+		     uint64_t ticks, enum rte_timer_type type,
+		     unsigned int tim_lcore, rte_timer_cb_t fct, void **args)
+{
+	return rte_timer_alt_reset_bulk(default_data_id, tims, nb_tims, ticks,
+					type, tim_lcore, fct, args);
+}
+
+int
+rte_timer_alt_reset_bulk(uint32_t timer_data_id, struct rte_timer **tims,
+			 unsigned int nb_tims, uint64_t ticks,
+			 enum rte_timer_type type, unsigned int tim_lcore,
+			 rte_timer_cb_t fct, void **args)
+{
+	union rte_timer_status prev_status;
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int locked = RTE_MAX_LCORE;
+	struct rte_timer_data *timer_data;
+	struct priv_timer *priv_timer;
+	struct rte_timer *tim;
+	struct timer_req req;
+	unsigned int i;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+	priv_timer = timer_data->priv_timer;
+
+	req.expire = rte_get_timer_cycles() + ticks;
+	req.period = type == PERIODICAL ? ticks : 0;
+	req.f = fct;
+	req.tim_lcore = timer_select_lcore(tim_lcore, priv_timer);
+
+	/* keep the lock of a list while the timers are in the same list */
+	for (i = 0; i < nb_tims; i++) {
+		tim = tims[i];
+		if (timer_bulk_set_config_state(tim, &prev_status, priv_timer,
+						&locked) < 0)
+			break;
+
+		__TIMER_STAT_ADD(priv_timer, reset, 1);
+		if (prev_status.state == RTE_TIMER_RUNNING &&
+		    lcore_id < RTE_MAX_LCORE)
+			priv_timer[lcore_id].updated = 1;
+
+		req.tim = tim;
+		req.arg = args != NULL ? args[i] : NULL;
+
+		if (prev_status.state == RTE_TIMER_PENDING) {
+			req.del = 1;
+			if ((unsigned int)prev_status.owner != lcore_id &&
+			    timer_req_send(priv_timer, prev_status.owner,
+					   &req) == 0)
+				continue;
+
+			timer_lock_switch(priv_timer, &locked,
+					  prev_status.owner);
+			timer_list_del(tim, prev_status.owner, priv_timer);
+			__TIMER_STAT_ADD(priv_timer, pending, -1);
+		}
+
+		tim->period = req.period;
+		tim->expire = req.expire;
+		tim->f = req.f;
+		tim->arg = req.arg;
+
+		req.del = 0;
+		if (req.tim_lcore != lcore_id &&
+		    timer_req_send(priv_timer, req.tim_lcore, &req) == 0)
+			continue;
+
+		timer_lock_switch(priv_timer, &locked, req.tim_lcore);
+		timer_add_pending(tim, req.tim_lcore, priv_timer);
+	}
+
+	timer_lock_switch(priv_timer, &locked, RTE_MAX_LCORE);
+
+	return i;
+}
+
+/* Stop a burst of timers */
+int
+rte_timer_stop_bulk(struct rte_timer **tims, unsigned int nb_tims)
+{
+	return rte_timer_alt_stop_bulk(default_data_id, tims, nb_tims);
+}
+
+int
+rte_timer_alt_stop_bulk(uint32_t timer_data_id, struct rte_timer **tims,
+			unsigned int nb_tims)
+{
+	union rte_timer_status prev_status, status;
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int locked = RTE_MAX_LCORE;
+	struct rte_timer_data *timer_data;
+	struct priv_timer *priv_timer;
+	struct rte_timer *tim;
+	unsigned int i;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+	priv_timer = timer_data->priv_timer;
+
+	for (i = 0; i < nb_tims; i++) {
+		tim = tims[i];
+		if (timer_bulk_set_config_state(tim, &prev_status, priv_timer,
+						&locked) < 0)
+			break;
+
+		__TIMER_STAT_ADD(priv_timer, stop, 1);
+		if (prev_status.state == RTE_TIMER_RUNNING &&
+		    lcore_id < RTE_MAX_LCORE)
+			priv_timer[lcore_id].updated = 1;
+
+		if (prev_status.state == RTE_TIMER_PENDING) {
+			timer_lock_switch(priv_timer, &locked,
+					  prev_status.owner);
+			timer_list_del(tim, prev_status.owner, priv_timer);
+			__TIMER_STAT_ADD(priv_timer, pending, -1);
+		}
+
+		status.state = RTE_TIMER_STOP;
+		status.owner = RTE_TIMER_NO_OWNER;
+		__atomic_store_n(&tim->status.u32, status.u32,
+				 __ATOMIC_RELEASE);
+	}
+
+	timer_lock_switch(priv_timer, &locked, RTE_MAX_LCORE);
+
+	return i;
+}
+
 /* Test the PENDING status of the timer handle tim */
 int
 rte_timer_pending(struct rte_timer *tim)
@@ -657,59 +1306,89 @@ rte_timer_pending(struct rte_timer *tim)
 				__ATOMIC_RELAXED) == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-static void
-__rte_timer_manage(struct rte_timer_data *timer_data)
+/*
+ * Take the expired timers out of the pending list of an lcore and mark them
+ * as running. Return the list of timers to run, linked by sl_next[0].
+ */
+static struct rte_timer *
+timer_get_expired(struct priv_timer *priv_timer, unsigned int poll_lcore)
 {
-	union rte_timer_status status;
+	struct priv_timer *privp = &priv_timer[poll_lcore];
 	struct rte_timer *tim, *next_tim;
 	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
 	uint64_t cur_time;
 	int i, ret;
-	struct priv_timer *priv_timer = timer_data->priv_timer;
 
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
+	/* process the updates of the list requested by other lcores */
+	timer_req_drain(priv_timer, poll_lcore);
 
-	__TIMER_STAT_ADD(priv_timer, manage, 1);
-	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
-	cur_time = rte_get_timer_cycles();
+	if (privp->wheel != NULL) {
+		/* optimize for the case where the wheel is empty */
+		if (privp->wheel->nb_pending == 0)
+			return NULL;
+		cur_time = rte_get_timer_cycles();
 
 #ifdef RTE_ARCH_64
-	/* on 64-bit the value cached in the pending_head.expired will be
-	 * updated atomically, so we can consult that for a quick check here
-	 * outside the lock */
-	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
+		/* on 64-bit the next tick of the wheel is updated
+		 * atomically, so we can check it outside the lock
+		 */
+		if (likely(privp->wheel->next_tick >
+				cur_time >> privp->wheel->tick_shift))
+			return NULL;
 #endif
 
-	/* browse ordered list, add expired timers in 'expired' list */
-	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
+		rte_spinlock_lock(&privp->list_lock);
+		tim = timer_wheel_expire(privp->wheel, cur_time);
+		if (tim == NULL) {
+			rte_spinlock_unlock(&privp->list_lock);
+			return NULL;
+		}
+	} else {
+		/* optimize for the case where per-cpu list is empty */
+		if (privp->pending_head.sl_next[0] == NULL)
+			return NULL;
+		cur_time = rte_get_timer_cycles();
 
-	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
-		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
-	}
+#ifdef RTE_ARCH_64
+		/* on 64-bit the value cached in the pending_head.expired will
+		 * be updated atomically, so we can consult that for a quick
+		 * check here outside the lock
+		 */
+		if (likely(privp->pending_head.expire > cur_time))
+			return NULL;
+#endif
 
-	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
+		/* browse ordered list, add expired timers in 'expired' list */
+		rte_spinlock_lock(&privp->list_lock);
 
-	/* break the existing list at current time point */
-	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
-			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
-		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
+		/* if nothing to do just unlock and return */
+		if (privp->pending_head.sl_next[0] == NULL ||
+		    privp->pending_head.sl_next[0]->expire > cur_time) {
+			rte_spinlock_unlock(&privp->list_lock);
+			return NULL;
+		}
+
+		/* save start of list of expired timers */
+		tim = privp->pending_head.sl_next[0];
+
+		/* break the existing list at current time point */
+		timer_get_prev_entries(cur_time, poll_lcore, prev, priv_timer);
+		for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+			if (prev[i] == &privp->pending_head)
+				continue;
+			privp->pending_head.sl_next[i] =
+				prev[i]->sl_next[i];
+			if (prev[i]->sl_next[i] == NULL)
+				privp->curr_skiplist_depth--;
+
+			prev[i]->sl_next[i] = NULL;
+		}
+
+		/* update the next to expire timer value */
+		privp->pending_head.expire =
+		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+			privp->pending_head.sl_next[0]->expire;
 	}
 
 	/* transition run-list from PENDING to RUNNING */
@@ -730,12 +1409,29 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 		}
 	}
 
-	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
+	rte_spinlock_unlock(&privp->list_lock);
 
-	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+	return run_first_tim;
+}
+
+/* must be called periodically, run all timer that expired */
+static void
+__rte_timer_manage(struct rte_timer_data *timer_data)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+
+	run_first_tim = timer_get_expired(priv_timer, lcore_id);
+	if (run_first_tim == NULL)
+		return;
 
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
@@ -804,16 +1500,12 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 {
 	unsigned int default_poll_lcores[] = {rte_lcore_id()};
 	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *tim;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, j, ret;
+	int i;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
-	struct priv_timer *privp;
-	uint32_t poll_lcore;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
 
@@ -828,75 +1520,9 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	}
 
 	for (i = 0; i < nb_poll_lcores; i++) {
-		poll_lcore = poll_lcores[i];
-		privp = &data->priv_timer[poll_lcore];
-
-		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
-			continue;
-		cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-		/* on 64-bit the value cached in the pending_head.expired will
-		 * be updated atomically, so we can consult that for a quick
-		 * check here outside the lock
-		 */
-		if (likely(privp->pending_head.expire > cur_time))
-			continue;
-#endif
-
-		/* browse ordered list, add expired timers in 'expired' list */
-		rte_spinlock_lock(&privp->list_lock);
-
-		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
-			rte_spinlock_unlock(&privp->list_lock);
-			continue;
-		}
-
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
-		/* transition run-list from PENDING to RUNNING */
-		run_first_tims[nb_runlists] = tim;
-		pprev = &run_first_tims[nb_runlists];
-		nb_runlists++;
-
-		for ( ; tim != NULL; tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			ret = timer_set_running_state(tim);
-			if (likely(ret == 0)) {
-				pprev = &tim->sl_next[0];
-			} else {
-				/* another core is trying to re-config this one,
-				 * remove it from local expired list
-				 */
-				*pprev = next_tim;
-			}
-		}
-
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
-		rte_spinlock_unlock(&privp->list_lock);
+		tim = timer_get_expired(data->priv_timer, poll_lcores[i]);
+		if (tim != NULL)
+			run_first_tims[nb_runlists++] = tim;
 	}
 
 	/* Now process the run lists */
@@ -983,6 +1609,7 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		   rte_timer_stop_all_cb_t f, void *f_arg)
 {
 	int i;
+	unsigned int lvl, slot;
 	struct priv_timer *priv_timer;
 	uint32_t walk_lcore;
 	struct rte_timer *tim, *next_tim;
@@ -994,8 +1621,26 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
 
+		timer_req_drain(timer_data->priv_timer, walk_lcore);
 		rte_spinlock_lock(&priv_timer->list_lock);
 
+		for (lvl = 0; priv_timer->wheel != NULL &&
+				lvl < WHEEL_LEVELS; lvl++) {
+			for (slot = 0; slot < WHEEL_NB_SLOTS; slot++) {
+				for (tim = priv_timer->wheel->slots[lvl][slot];
+				     tim != NULL;
+				     tim = next_tim) {
+					next_tim = tim->sl_next[WHEEL_NEXT];
+
+					/* Call timer_stop with lock held */
+					__rte_timer_stop(tim, 1, timer_data);
+
+					if (f)
+						f(tim, f_arg);
+				}
+			}
+		}
+
 		for (tim = priv_timer->pending_head.sl_next[0];
 		     tim != NULL;
 		     tim = next_tim) {
@@ -1021,6 +1666,7 @@ rte_timer_next_ticks(void)
 	struct rte_timer_data *timer_data;
 	struct priv_timer *priv_timer;
 	const struct rte_timer *tm;
+	const struct timer_wheel *w;
 	uint64_t cur_time;
 	int64_t left = -ENOENT;
 
@@ -1030,17 +1676,123 @@ rte_timer_next_ticks(void)
 	cur_time = rte_get_timer_cycles();
 
 	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
-	tm = priv_timer[lcore_id].pending_head.sl_next[0];
-	if (tm) {
-		left = tm->expire - cur_time;
-		if (left < 0)
-			left = 0;
+	w = priv_timer[lcore_id].wheel;
+	if (w != NULL) {
+		/* the next tick is when the wheel has to be processed
+		 * again, no timer expires before
+		 */
+		if (w->nb_pending != 0) {
+			left = (w->next_tick << w->tick_shift) - cur_time;
+			if (left < 0)
+				left = 0;
+		}
+	} else {
+		tm = priv_timer[lcore_id].pending_head.sl_next[0];
+		if (tm) {
+			left = tm->expire - cur_time;
+			if (left < 0)
+				left = 0;
+		}
 	}
 	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
 
 	return left;
 }
 
+int
+rte_timer_data_set_backend(uint32_t timer_data_id,
+			   enum rte_timer_backend backend, uint64_t resolution)
+{
+	struct rte_timer_data *timer_data;
+	struct priv_timer *priv_timer;
+	struct timer_wheel *wheels;
+	uint64_t cur_tick;
+	unsigned int tick_shift;
+	int lcore_id;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+
+	if (backend != RTE_TIMER_BACKEND_SKIPLIST &&
+	    backend != RTE_TIMER_BACKEND_WHEEL)
+		return -EINVAL;
+	if (resolution > UINT32_MAX)
+		return -EINVAL;
+
+	priv_timer = timer_data->priv_timer;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (priv_timer[lcore_id].pending_head.sl_next[0] != NULL ||
+		    (priv_timer[lcore_id].wheel != NULL &&
+		     priv_timer[lcore_id].wheel->nb_pending != 0) ||
+		    (priv_timer[lcore_id].req_ring != NULL &&
+		     !rte_ring_empty(priv_timer[lcore_id].req_ring)))
+			return -EBUSY;
+	}
+
+	timer_data_free_wheels(timer_data);
+	if (backend == RTE_TIMER_BACKEND_SKIPLIST)
+		return 0;
+
+	if (resolution == 0)
+		resolution = rte_get_timer_hz() / US_PER_S;
+	tick_shift = rte_log2_u64(resolution);
+
+	wheels = rte_zmalloc("timer_wheel", sizeof(*wheels) * RTE_MAX_LCORE,
+			     RTE_CACHE_LINE_SIZE);
+	if (wheels == NULL)
+		return -ENOMEM;
+
+	cur_tick = rte_get_timer_cycles() >> tick_shift;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheels[lcore_id].cur_tick = cur_tick;
+		wheels[lcore_id].next_tick = UINT64_MAX;
+		wheels[lcore_id].tick_shift = tick_shift;
+		priv_timer[lcore_id].wheel = &wheels[lcore_id];
+	}
+	timer_data->wheels = wheels;
+
+	return 0;
+}
+
+int
+rte_timer_data_set_handoff(uint32_t timer_data_id, unsigned int ring_size)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct rte_timer_data *timer_data;
+	struct priv_timer *priv_timer;
+	struct rte_ring *r;
+	unsigned int lcore_id;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+
+	/* the requests not processed yet would be lost */
+	priv_timer = timer_data->priv_timer;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		if (priv_timer[lcore_id].req_ring != NULL &&
+		    !rte_ring_empty(priv_timer[lcore_id].req_ring))
+			return -EBUSY;
+	}
+
+	timer_data_free_rings(timer_data);
+	if (ring_size == 0)
+		return 0;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		snprintf(name, sizeof(name), "TMR_RQ_%u_%u", timer_data_id,
+			 lcore_id);
+		r = rte_ring_create_elem(name, sizeof(struct timer_req),
+					 ring_size,
+					 rte_lcore_to_socket_id(lcore_id),
+					 RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (r == NULL) {
+			timer_data_free_rings(timer_data);
+			return -rte_errno;
+		}
+		priv_timer[lcore_id].req_ring = r;
+	}
+
+	return 0;
+}
+
 /* dump statistics about timers */
 static void
 __rte_timer_dump_stats(struct rte_timer_data *timer_data __rte_unused, FILE *f)
@@ -516,6 +516,220 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 int
 rte_timer_alt_dump_stats(uint32_t timer_data_id, FILE *f);
 
+/**
+ * Implementations of the pending timer lists of a timer data instance.
+ */
+enum rte_timer_backend {
+	/** Skiplist sorted by expiry time, the default. */
+	RTE_TIMER_BACKEND_SKIPLIST,
+	/** Hierarchical timing wheel, with O(1) reset, stop and expiry. */
+	RTE_TIMER_BACKEND_WHEEL,
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Select the implementation of the pending timer lists of a timer data
+ * instance.
+ *
+ * The timing wheel rounds the expiry time of the timers up to its
+ * resolution, so a timer may run up to one resolution period after it
+ * expires. The timers expiring in the same period, or between two calls to
+ * rte_timer_manage(), do not run in a particular order.
+ *
+ * This function must be called while no timer is pending in the timer data
+ * instance, and must not be called concurrently with other functions using
+ * it.
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used for
+ *   this operation.
+ * @param backend
+ *   The implementation of the pending timer lists.
+ * @param resolution
+ *   For the timing wheel, the number of cycles (see rte_get_timer_hz())
+ *   of a wheel slot, rounded up to a power of 2, and up to UINT32_MAX. If 0,
+ *   about one microsecond is used. Ignored for the skiplist.
+ * @return
+ *   - 0: success
+ *   - -EINVAL: invalid timer_data_id, backend or resolution
+ *   - -EBUSY: timers are pending in the timer data instance
+ *   - -ENOMEM: not enough memory for the timing wheels
+ */
+__rte_experimental
+int
+rte_timer_data_set_backend(uint32_t timer_data_id,
+			   enum rte_timer_backend backend, uint64_t resolution);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Hand the timer resets of other lcores off to them.
+ *
+ * When enabled, the functions resetting a timer pending on another lcore,
+ * or resetting it on another lcore, don't take the list lock of this lcore:
+ * the request is enqueued in a ring of the lcore, which processes it when
+ * calling rte_timer_manage() or rte_timer_alt_manage(). Until then, the
+ * timer is in the CONFIG state and not pending: resetting or stopping it
+ * again, including from the lcore it was handed off to, first processes the
+ * requests of this lcore under its list lock, and fails only if that lock is
+ * already held by the caller. When the ring is full, the list lock is taken
+ * as usual.
+ * Stopping a timer always takes the list lock, so that the timer is not
+ * referenced anymore by the library once stopped.
+ *
+ * The rings are created for the lcores enabled in the calling process. This
+ * function must not be called concurrently with other functions using the
+ * timer data instance.
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used for
+ *   this operation.
+ * @param ring_size
+ *   The number of requests each ring can hold, 0 to disable the handoff.
+ * @return
+ *   - 0: success
+ *   - -EINVAL: invalid timer_data_id or ring_size
+ *   - -EBUSY: requests are not processed yet
+ *   - -ENOMEM: not enough memory for the rings
+ */
+__rte_experimental
+int
+rte_timer_data_set_handoff(uint32_t timer_data_id, unsigned int ring_size);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset and start a burst of timers.
+ *
+ * This function is the same as calling rte_timer_reset() for each timer
+ * with the same parameters except the callback argument, but the expiry is
+ * computed once, and the list lock of an lcore is taken once for the
+ * consecutive timers pending in its list.
+ *
+ * @see rte_timer_reset()
+ *
+ * @param tims
+ *   The array of timer handles.
+ * @param nb_tims
+ *   The number of timers in the array.
+ * @param ticks
+ *   The number of cycles (see rte_get_hpet_hz()) before the callback
+ *   function is called.
+ * @param type
+ *   The type can be either PERIODICAL or SINGLE.
+ * @param tim_lcore
+ *   The ID of the lcore where the timer callbacks have to be executed. If
+ *   tim_lcore is LCORE_ID_ANY, the next lcore of the round-robin is used for
+ *   all the timers.
+ * @param fct
+ *   The callback function of the timers.
+ * @param args
+ *   The array of user arguments of the callback function, one per timer.
+ *   If NULL, the argument is NULL for all the timers.
+ * @return
+ *   The number of timers scheduled from the start of the array, the next one
+ *   being in the RUNNING or CONFIG state.
+ */
+__rte_experimental
+int
+rte_timer_reset_bulk(struct rte_timer **tims, unsigned int nb_tims,
+		     uint64_t ticks, enum rte_timer_type type,
+		     unsigned int tim_lcore, rte_timer_cb_t fct, void **args);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * This function is the same as rte_timer_reset_bulk(), except that it allows
+ * a caller to specify the rte_timer_data instance containing the lists where
+ * the timers will be placed.
+ *
+ * @see rte_timer_reset_bulk()
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used for
+ *   this operation.
+ * @param tims
+ *   The array of timer handles.
+ * @param nb_tims
+ *   The number of timers in the array.
+ * @param ticks
+ *   The number of cycles (see rte_get_hpet_hz()) before the callback
+ *   function is called.
+ * @param type
+ *   The type can be either PERIODICAL or SINGLE.
+ * @param tim_lcore
+ *   The ID of the lcore where the timer callbacks have to be executed.
+ * @param fct
+ *   The callback function of the timers. This parameter can be NULL if (and
+ *   only if) rte_timer_alt_manage() will be used to manage the timers.
+ * @param args
+ *   The array of user arguments of the callback function, or NULL.
+ * @return
+ *   - The number of timers scheduled from the start of the array.
+ *   - -EINVAL: invalid timer_data_id
+ */
+__rte_experimental
+int
+rte_timer_alt_reset_bulk(uint32_t timer_data_id, struct rte_timer **tims,
+			 unsigned int nb_tims, uint64_t ticks,
+			 enum rte_timer_type type, unsigned int tim_lcore,
+			 rte_timer_cb_t fct, void **args);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Stop a burst of timers.
+ *
+ * This function is the same as calling rte_timer_stop() for each timer, but
+ * the list lock of an lcore is taken once for the consecutive timers
+ * pending in its list.
+ *
+ * @see rte_timer_stop()
+ *
+ * @param tims
+ *   The array of timer handles.
+ * @param nb_tims
+ *   The number of timers in the array.
+ * @return
+ *   The number of timers stopped from the start of the array, the next one
+ *   being in the RUNNING or CONFIG state.
+ */
+__rte_experimental
+int
+rte_timer_stop_bulk(struct rte_timer **tims, unsigned int nb_tims);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * This function is the same as rte_timer_stop_bulk(), except that it allows
+ * a caller to specify the rte_timer_data instance containing the lists from
+ * which the timers should be removed.
+ *
+ * @see rte_timer_stop_bulk()
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used for
+ *   this operation.
+ * @param tims
+ *   The array of timer handles.
+ * @param nb_tims
+ *   The number of timers in the array.
+ * @return
+ *   - The number of timers stopped from the start of the array.
+ *   - -EINVAL: invalid timer_data_id
+ */
+__rte_experimental
+int
+rte_timer_alt_stop_bulk(uint32_t timer_data_id, struct rte_timer **tims,
+			unsigned int nb_tims);
+
 #ifdef __cplusplus
 }
 #endif